@@ -8,5 +8,19 @@
 #define TAPPING_TERM 200 // adjust this if you get accidental home row mod activations
 #define MANUFACTURER "Glorious"
 #define MAX_DEFERRED_EXECUTORS 10
-// #define LEADER_TIMEOUT 700
-#define SECRETS_ENABLED YES
+#define LEADER_TIMEOUT 700 // features/leader.c, per key
+
+// Typed-key history shared by sentence case and autocorrect (features/key_history.h).
+// It is bit-packed, so a deep buffer and undo stack are cheap. test/bench_sentence_case.c
+// compares other sizes by defining them first
+#ifndef KEY_HISTORY_SIZE
+#define KEY_HISTORY_SIZE 32
+#endif
+#ifndef SENTENCE_CASE_STATE_HISTORY_SIZE
+#define SENTENCE_CASE_STATE_HISTORY_SIZE 16
+#endif
+
+// EEPROM user datablock, carved up between features in eeprom_layout.h
+#include "features/eeprom_layout.h"
+#define EECONFIG_USER_DATA_SIZE    EEPROM_USER_DATA_SIZE
+#define EECONFIG_USER_DATA_VERSION EEPROM_USER_DATA_VERSION
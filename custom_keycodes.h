@@ -28,6 +28,7 @@ enum custom_keycodes {
 
     // Other custom keycodes
     PIN_ENTRY,                   /**< Activates PIN entry mode */
+    SECRET_SELECT,               /**< Types a tagged vault secret: tag digits, then Enter */
     SENTENCE_CASE_TOGGLE,        /**< Toggles sentence case feature on/off */
     
     // Virtual desktop keycodes
@@ -69,6 +70,26 @@ enum custom_keycodes {
     RUN_NOTEPAD,                 /**< Launch Notepad */
     RUN_CMD_END,                 /**< Marker for end of application launcher keycodes */
     
+    // Macro recorder keycodes (features/macro_recorder.h)
+    MACRO_REC_1,                 /**< Record macro 1; any MACRO_REC key stops recording */
+    MACRO_REC_2,                 /**< Record macro 2 */
+    MACRO_REC_3,                 /**< Record macro 3 */
+    MACRO_REC_4,                 /**< Record macro 4 */
+    MACRO_PLAY_1,                /**< Replay macro 1; again while replaying for full speed */
+    MACRO_PLAY_2,                /**< Replay macro 2 */
+    MACRO_PLAY_3,                /**< Replay macro 3 */
+    MACRO_PLAY_4,                /**< Replay macro 4 */
+    
     // Custom safe range for other modules
     NEW_SAFE_RANGE               /**< Starting point for other modules to define their keycodes */
+};
+
+/**
+ * @enum tap_dance_codes
+ * @brief Enumeration of tap dance actions, used as TD(n)
+ *
+ * Tap Dance allows different actions when a key is tapped multiple times.
+ */
+enum tap_dance_codes {
+    TD_ESC,  /**< Esc on single tap, lock secrets on double tap, _FL while held (features/esc_dance.c) */
 };
\ No newline at end of file
@@ -0,0 +1,191 @@
+/**
+ * @file autocorrect.c
+ * @brief Implementation of the trie-based autocorrect
+ *
+ * See tools/autocorrect_trie.py for the trie layout.
+ */
+
+#include "features/autocorrect.h"
+#include "features/key_history.h"
+#include "features/autocorrect_data.h"
+#include "features/event_log.h"
+#include "features/sentence_case.h"
+
+#ifdef AUTOCORRECT_ENABLE
+#    error "autocorrect: QMK's AUTOCORRECT_ENABLE would process every key a second time, use AUTOCORRECT_TRIE_ENABLE"
+#endif
+
+_Static_assert(AUTOCORRECT_MAX_TYPO_LEN <= KEY_HISTORY_SIZE, "autocorrect: KEY_HISTORY_SIZE is shorter than the longest typo");
+
+/**
+ * @brief History classes the dictionary distinguishes; every other class is a word boundary (0)
+ */
+#define CLASS_A KEY_HISTORY_CLASS(KC_A)
+#define CLASS_Z KEY_HISTORY_CLASS(KC_Z)
+#define CLASS_QUOTE KEY_HISTORY_CLASS(KC_QUOT)
+
+// ==== STATE VARIABLES ====
+
+/**
+ * @brief Whether autocorrect is enabled
+ */
+static bool autocorrect_enabled = true;
+
+// ==== HELPER FUNCTIONS ====
+
+/**
+ * @brief Class of the key typed n keys ago, as used in the trie
+ */
+static uint8_t autocorrect_class(uint8_t n) {
+    uint8_t c = key_history_class(n);
+    return ((c >= CLASS_A && c <= CLASS_Z) || c == CLASS_QUOTE) ? c : 0;
+}
+
+/**
+ * @brief History class of a character in a correction (a-z, A-Z, ' or space)
+ */
+static uint8_t autocorrect_char_class(char ch) {
+    if (ch >= 'a' && ch <= 'z') {
+        return CLASS_A + (ch - 'a');
+    }
+    if (ch >= 'A' && ch <= 'Z') {
+        return CLASS_A + (ch - 'A');
+    }
+    return ch == '\'' ? CLASS_QUOTE : KEY_HISTORY_CLASS(KC_SPC);
+}
+
+/**
+ * @brief Walk the trie back from the newest key
+ *
+ * @return uint16_t Index of the matching leaf node, or 0 (the root is never a leaf)
+ */
+static uint16_t autocorrect_match(void) {
+    uint16_t i = 0;
+    uint8_t  n = 0;
+
+    for (;;) {
+        uint8_t node  = pgm_read_byte(&autocorrect_trie[i]);
+        uint8_t count = node & AUTOCORRECT_NODE_COUNT;
+
+        switch (node & AUTOCORRECT_NODE_TYPE) {
+            case AUTOCORRECT_NODE_LEAF:
+                return i;
+
+            case AUTOCORRECT_NODE_CHAIN:
+                for (i++; count; count--, i++) {
+                    if (pgm_read_byte(&autocorrect_trie[i]) != autocorrect_class(n++)) {
+                        return 0;
+                    }
+                }
+                break;
+
+            default: { // AUTOCORRECT_NODE_BRANCH, children sorted by class
+                uint8_t c = autocorrect_class(n++);
+                for (i++; count; count--, i += 3) {
+                    uint8_t child = pgm_read_byte(&autocorrect_trie[i]);
+                    if (child >= c) {
+                        break;
+                    }
+                }
+                if (!count || pgm_read_byte(&autocorrect_trie[i]) != c) {
+                    return 0;
+                }
+                i = pgm_read_byte(&autocorrect_trie[i + 1]) | (pgm_read_byte(&autocorrect_trie[i + 2]) << 8);
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Replace the typo with its correction, on screen and in the history
+ *
+ * @param leaf Index of the matched leaf node
+ * @param current History class of the key being processed
+ * @param boundary Whether the current key ended the typo as a word boundary
+ *                 (and is still to be typed) rather than as its last letter
+ */
+static void autocorrect_apply(uint16_t leaf, uint8_t current, bool boundary) {
+    uint8_t     backspaces = pgm_read_byte(&autocorrect_trie[leaf]) & AUTOCORRECT_NODE_COUNT;
+    const char *completion = (const char *)&autocorrect_trie[leaf + 1];
+
+    EVLOG_INFO(EV_AUTOCORRECT, backspaces, leaf);
+
+    // Held Shift would otherwise capitalise the whole correction
+    const uint8_t mods = get_mods();
+    clear_mods();
+    clear_weak_mods();
+    for (uint8_t i = 0; i < backspaces; i++) {
+        tap_code(KC_BSPC);
+    }
+    send_string_P(completion);
+    set_mods(mods);
+
+    // Sentence case only sees the boundary key, if any, after this: bring
+    // its states in line with the letters now on screen
+    sentence_case_rewrite_P(backspaces, completion);
+
+    // The current key was recorded already, followed by the typo's letters
+    for (uint8_t i = 0; i <= backspaces; i++) {
+        key_history_pop();
+    }
+    for (char ch; (ch = pgm_read_byte(completion)); completion++) {
+        key_history_push(autocorrect_char_class(ch));
+    }
+    if (boundary) {
+        key_history_push(current);
+    }
+}
+
+// ==== PUBLIC FUNCTIONS ====
+
+bool process_autocorrect(uint16_t keycode, keyrecord_t *record) {
+    if (!record->event.pressed) {
+        return true;
+    }
+
+    switch (keycode) {
+        case AC_TOGG:
+            autocorrect_toggle();
+            return false;
+        case AC_ON:
+            autocorrect_on();
+            return false;
+        case AC_OFF:
+            autocorrect_off();
+            return false;
+    }
+
+    // Only newly typed keys can complete a typo. Keys outside the typing
+    // area (arrows, shortcuts, Esc) never trigger a correction either.
+    uint8_t current = key_history_class(0);
+    if (!autocorrect_enabled || !key_history_recorded() || current == KEY_HISTORY_OTHER || current == KEY_HISTORY_CLASS(KC_ESC)) {
+        return true;
+    }
+
+    uint16_t leaf = autocorrect_match();
+    if (!leaf) {
+        return true;
+    }
+    // A typo ending in a word boundary lets the boundary key through after
+    // the correction; otherwise the key was the typo's last letter
+    bool boundary = autocorrect_class(0) == 0;
+    autocorrect_apply(leaf, current, boundary);
+    return boundary;
+}
+
+void autocorrect_on(void) {
+    autocorrect_enabled = true;
+}
+
+void autocorrect_off(void) {
+    autocorrect_enabled = false;
+}
+
+void autocorrect_toggle(void) {
+    autocorrect_enabled = !autocorrect_enabled;
+}
+
+bool is_autocorrect_on(void) {
+    return autocorrect_enabled;
+}
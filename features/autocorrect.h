@@ -0,0 +1,66 @@
+/**
+ * @file autocorrect.h
+ * @brief Trie-based autocorrect sharing the key history with Sentence Case
+ *
+ * Replaces QMK's autocorrect so that typos are matched against the shared
+ * key history (features/key_history.h) instead of a second buffer of its
+ * own. Typos are listed in autocorrect_dictionary.txt and compiled by
+ * tools/autocorrect_trie.py into a PROGMEM trie of reversed typos
+ * (features/autocorrect_data.h), walked from the newest key backwards:
+ *   - runs of single-child nodes are stored as one chain and compared in a
+ *     tight loop
+ *   - the walk usually ends on the first or second key, since few typos
+ *     share the last letters of what is being typed
+ *
+ * A match backspaces the typo, types the correction and rewrites the key
+ * history and Sentence Case's states to match, so Sentence Case, Backspace
+ * and later typos see corrected text.
+ *
+ * Usage in keymap.c:
+ *   1. Set AUTOCORRECT_TRIE_ENABLE = yes in rules.mk (leave AUTOCORRECT_ENABLE off)
+ *   2. Call process_key_history() and then process_autocorrect(keycode, record)
+ *      in process_record_user()
+ *   3. AC_TOGG / AC_ON / AC_OFF switch it at runtime
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+/**
+ * @brief Trie node types, in the top two bits of each node's first byte
+ *
+ * The low six bits hold the chain length, child count or backspace count.
+ */
+#define AUTOCORRECT_NODE_CHAIN 0x00
+#define AUTOCORRECT_NODE_BRANCH 0x40
+#define AUTOCORRECT_NODE_LEAF 0x80
+#define AUTOCORRECT_NODE_TYPE 0xC0
+#define AUTOCORRECT_NODE_COUNT 0x3F
+
+#ifdef AUTOCORRECT_TRIE_ENABLE
+
+/**
+ * @brief Process keycodes for autocorrect
+ *
+ * @param keycode The keycode to process
+ * @param record The keyrecord containing event information
+ * @return false if the key was consumed (toggle keys, or a typo's last
+ *         letter replaced by its correction), true otherwise
+ */
+bool process_autocorrect(uint16_t keycode, keyrecord_t *record);
+
+void autocorrect_on(void);     /**< Enables autocorrect */
+void autocorrect_off(void);    /**< Disables autocorrect */
+void autocorrect_toggle(void); /**< Toggles autocorrect */
+bool is_autocorrect_on(void);  /**< Gets whether autocorrect is enabled */
+
+#else
+
+static inline bool process_autocorrect(uint16_t keycode, keyrecord_t *record) { return true; }
+static inline void autocorrect_on(void) {}
+static inline void autocorrect_off(void) {}
+static inline void autocorrect_toggle(void) {}
+static inline bool is_autocorrect_on(void) { return false; }
+
+#endif
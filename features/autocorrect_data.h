@@ -0,0 +1,205 @@
+// Generated by tools/autocorrect_trie.py from autocorrect_dictionary.txt - do not edit.
+// Layout is described in tools/autocorrect_trie.py. Paths read newest key first.
+
+#pragma once
+
+#define AUTOCORRECT_TYPOS 75
+#define AUTOCORRECT_MAX_TYPO_LEN 10
+#define AUTOCORRECT_WORST_CASE_STEPS 23
+#define AUTOCORRECT_TRIE_SIZE 1099
+
+static const uint8_t autocorrect_trie[AUTOCORRECT_TRIE_SIZE] PROGMEM = {
+    /* root         */ 0x4D, 0, 40, 0, 1, 47, 1, 4, 69, 1, 5, 162, 1, 8, 44, 2, 12, 99, 2, 14, 132, 2, 15, 231, 2, 18, 239, 2, 19, 28, 3, 20, 62, 3, 23, 238, 3, 25, 43, 4,
+    /* ':'          */ 0x49, 4, 68, 0, 5, 77, 0, 8, 114, 0, 9, 122, 0, 12, 129, 0, 13, 137, 0, 14, 145, 0, 15, 153, 0, 20, 160, 0,
+    /* ':d'         */ 0x03, 1, 14, 0,
+    /* ':dan:'      */ 0x83, 'a', 'n', 'd', 0,
+    /* ':e'         */ 0x43, 18, 87, 0, 20, 97, 0, 22, 105, 0,
+    /* ':er'        */ 0x04, 21, 15, 25, 0,
+    /* ':eruoy:'    */ 0x82, '\'', 'r', 'e', 0,
+    /* ':et'        */ 0x02, 8, 0,
+    /* ':eth:'      */ 0x83, 't', 'h', 'e', 0,
+    /* ':ev'        */ 0x02, 9, 0,
+    /* ':evi:'      */ 0x83, 'I', '\'', 'v', 'e', 0,
+    /* ':h'         */ 0x03, 5, 20, 0,
+    /* ':het:'      */ 0x82, 'h', 'e', 0,
+    /* ':i'         */ 0x02, 19, 0,
+    /* ':is:'       */ 0x82, 'i', 's', 0,
+    /* ':l'         */ 0x05, 12, 9, 20, 14, 21,
+    /* ':llitnu'    */ 0x81, 0,
+    /* ':m'         */ 0x02, 9, 0,
+    /* ':mi:'       */ 0x82, 'I', '\'', 'm', 0,
+    /* ':n'         */ 0x03, 4, 1, 0,
+    /* ':nda:'      */ 0x82, 'n', 'd', 0,
+    /* ':o'         */ 0x02, 6, 0,
+    /* ':of:'       */ 0x82, 'o', 'f', 0,
+    /* ':t'         */ 0x42, 14, 167, 0, 15, 27, 1,
+    /* ':tn'        */ 0x44, 1, 180, 0, 4, 187, 0, 15, 233, 0, 19, 252, 0,
+    /* ':tna'       */ 0x02, 3, 0,
+    /* ':tnac:'     */ 0x81, '\'', 't', 0,
+    /* ':tnd'       */ 0x42, 9, 194, 0, 12, 201, 0,
+    /* ':tndi'      */ 0x02, 4, 0,
+    /* ':tndid:'    */ 0x81, '\'', 't', 0,
+    /* ':tndl'      */ 0x02, 21, 15,
+    /* ':tndluo'    */ 0x43, 3, 214, 0, 8, 220, 0, 23, 227, 0,
+    /* ':tndluoc'   */ 0x01, 0,
+    /* ':tndluoc:'  */ 0x81, '\'', 't', 0,
+    /* ':tndluoh'   */ 0x02, 19, 0,
+    /* ':tndluohs:' */ 0x81, '\'', 't', 0,
+    /* ':tndluow'   */ 0x01, 0,
+    /* ':tndluow:'  */ 0x81, '\'', 't', 0,
+    /* ':tno'       */ 0x42, 4, 240, 0, 23, 246, 0,
+    /* ':tnod'      */ 0x01, 0,
+    /* ':tnod:'     */ 0x81, '\'', 't', 0,
+    /* ':tnow'      */ 0x01, 0,
+    /* ':tnow:'     */ 0x81, '\'', 't', 0,
+    /* ':tns'       */ 0x43, 1, 6, 1, 5, 13, 1, 9, 21, 1,
+    /* ':tnsa'      */ 0x02, 23, 0,
+    /* ':tnsaw:'    */ 0x81, '\'', 't', 0,
+    /* ':tnse'      */ 0x03, 15, 4, 0,
+    /* ':tnseod:'   */ 0x81, '\'', 't', 0,
+    /* ':tnsi'      */ 0x01, 0,
+    /* ':tnsi:'     */ 0x81, '\'', 't', 0,
+    /* ':to'        */ 0x42, 0, 34, 1, 12, 38, 1,
+    /* ':to:'       */ 0x82, 't', 'o', 0,
+    /* ':tol'       */ 0x02, 1, 0,
+    /* ':tola:'     */ 0x83, ' ', 'l', 'o', 't', 0,
+    /* 'a'          */ 0x02, 20, 8,
+    /* 'ath'        */ 0x42, 20, 57, 1, 23, 63, 1,
+    /* 'atht'       */ 0x01, 0,
+    /* 'atht:'      */ 0x81, 'a', 't', 0,
+    /* 'athw'       */ 0x01, 0,
+    /* 'athw:'      */ 0x81, 'a', 't', 0,
+    /* 'd'          */ 0x44, 5, 82, 1, 12, 126, 1, 14, 139, 1, 18, 151, 1,
+    /* 'de'         */ 0x42, 18, 89, 1, 20, 114, 1,
+    /* 'der'        */ 0x42, 5, 96, 1, 21, 105, 1,
+    /* 'dere'       */ 0x03, 6, 5, 18,
+    /* 'derefer'    */ 0x81, 'r', 'e', 'd', 0,
+    /* 'deru'       */ 0x03, 3, 3, 15,
+    /* 'derucco'    */ 0x81, 'r', 'e', 'd', 0,
+    /* 'det'        */ 0x06, 9, 13, 13, 15, 3, 0,
+    /* 'detimmoc:'  */ 0x81, 't', 'e', 'd', 0,
+    /* 'dl'         */ 0x05, 21, 8, 15, 19, 0,
+    /* 'dluhos:'    */ 0x84, 'h', 'o', 'u', 'l', 'd', 0,
+    /* 'dn'         */ 0x05, 9, 5, 18, 6, 0,
+    /* 'dnierf:'    */ 0x83, 'i', 'e', 'n', 'd', 0,
+    /* 'dr'         */ 0x04, 5, 9, 23, 0,
+    /* 'dreiw:'     */ 0x83, 'e', 'i', 'r', 'd', 0,
+    /* 'e'          */ 0x44, 3, 175, 1, 7, 209, 1, 19, 220, 1, 22, 252, 1,
+    /* 'ec'         */ 0x01, 14,
+    /* 'ecn'        */ 0x42, 1, 184, 1, 5, 196, 1,
+    /* 'ecna'       */ 0x05, 20, 19, 9, 24, 5,
+    /* 'ecnatsixe'  */ 0x83, 'e', 'n', 'c', 'e', 0,
+    /* 'ecne'       */ 0x05, 18, 21, 3, 3, 15,
+    /* 'ecnerucco'  */ 0x83, 'r', 'e', 'n', 'c', 'e', 0,
+    /* 'eg'         */ 0x04, 14, 21, 15, 20,
+    /* 'egnuot'     */ 0x83, 'n', 'g', 'u', 'e', 0,
+    /* 'es'         */ 0x42, 1, 227, 1, 21, 239, 1,
+    /* 'esa'        */ 0x05, 21, 3, 5, 2, 0,
+    /* 'esauceb:'   */ 0x83, 'a', 'u', 's', 'e', 0,
+    /* 'esu'        */ 0x05, 3, 1, 5, 2, 0,
+    /* 'esucaeb:'   */ 0x84, 'c', 'a', 'u', 's', 'e', 0,
+    /* 'ev'         */ 0x42, 5, 3, 2, 9, 15, 2,
+    /* 'eve'        */ 0x05, 9, 3, 5, 18, 0,
+    /* 'eveicer:'   */ 0x83, 'e', 'i', 'v', 'e', 0,
+    /* 'evi'        */ 0x01, 5,
+    /* 'evie'       */ 0x42, 8, 24, 2, 12, 34, 2,
+    /* 'evieh'      */ 0x03, 3, 1, 0,
+    /* 'eviehca:'   */ 0x83, 'i', 'e', 'v', 'e', 0,
+    /* 'eviel'      */ 0x03, 5, 2, 0,
+    /* 'evieleb:'   */ 0x83, 'i', 'e', 'v', 'e', 0,
+    /* 'h'          */ 0x43, 3, 54, 2, 9, 64, 2, 20, 74, 2,
+    /* 'hc'         */ 0x03, 9, 23, 0,
+    /* 'hciw:'      */ 0x82, 'h', 'i', 'c', 'h', 0,
+    /* 'hi'         */ 0x04, 3, 8, 23, 0,
+    /* 'hichw:'     */ 0x82, 'i', 'c', 'h', 0,
+    /* 'ht'         */ 0x42, 7, 81, 2, 9, 90, 2,
+    /* 'htg'        */ 0x04, 9, 5, 8, 0,
+    /* 'htgieh:'    */ 0x81, 'h', 't', 0,
+    /* 'hti'        */ 0x03, 8, 23, 0,
+    /* 'htihw:'     */ 0x83, 'i', 't', 'h', 0,
+    /* 'l'          */ 0x03, 4, 21, 15,
+    /* 'lduo'       */ 0x43, 3, 113, 2, 8, 119, 2, 23, 126, 2,
+    /* 'lduoc'      */ 0x01, 0,
+    /* 'lduoc:'     */ 0x81, 'l', 'd', 0,
+    /* 'lduoh'      */ 0x02, 19, 0,
+    /* 'lduohs:'    */ 0x81, 'l', 'd', 0,
+    /* 'lduow'      */ 0x01, 0,
+    /* 'lduow:'     */ 0x81, 'l', 'd', 0,
+    /* 'n'          */ 0x44, 1, 145, 2, 15, 158, 2, 20, 211, 2, 21, 220, 2,
+    /* 'na'         */ 0x08, 4, 14, 5, 16, 5, 4, 14, 9,
+    /* 'nadnepedni' */ 0x81, 'e', 'n', 0,
+    /* 'no'         */ 0x42, 9, 165, 2, 20, 198, 2,
+    /* 'noi'        */ 0x42, 19, 172, 2, 20, 184, 2,
+    /* 'nois'       */ 0x03, 1, 3, 15,
+    /* 'noisaco'    */ 0x84, 'c', 'a', 's', 'i', 'o', 'n', 0,
+    /* 'noit'       */ 0x05, 14, 3, 21, 6, 0,
+    /* 'noitncuf:'  */ 0x85, 'n', 'c', 't', 'i', 'o', 'n', 0,
+    /* 'not'        */ 0x06, 9, 3, 14, 21, 6, 0,
+    /* 'noticnuf:'  */ 0x83, 't', 'i', 'o', 'n', 0,
+    /* 'nt'         */ 0x04, 9, 18, 16, 0,
+    /* 'ntirp:'     */ 0x81, 'n', 't', 0,
+    /* 'nu'         */ 0x05, 18, 20, 5, 18, 0,
+    /* 'nurter:'    */ 0x82, 'u', 'r', 'n', 0,
+    /* 'o'          */ 0x03, 21, 25, 0,
+    /* 'ouy:'       */ 0x81, 'o', 'u', 0,
+    /* 'r'          */ 0x01, 5,
+    /* 're'         */ 0x43, 4, 251, 2, 9, 6, 3, 20, 15, 3,
+    /* 'red'        */ 0x06, 14, 5, 12, 1, 3, 0,
+    /* 'rednelac:'  */ 0x81, 'a', 'r', 0,
+    /* 'rei'        */ 0x03, 8, 20, 0,
+    /* 'reiht:'     */ 0x82, 'e', 'i', 'r', 0,
+    /* 'ret'        */ 0x06, 13, 1, 18, 1, 16, 0,
+    /* 'retmarap:'  */ 0x82, 'e', 't', 'e', 'r', 0,
+    /* 's'          */ 0x42, 19, 35, 3, 21, 46, 3,
+    /* 'ss'         */ 0x05, 5, 3, 3, 5, 14,
+    /* 'sseccen'    */ 0x83, 'e', 's', 's', 0,
+    /* 'su'         */ 0x07, 15, 9, 3, 14, 15, 3, 0,
+    /* 'suoicnoc:'  */ 0x84, 's', 'c', 'i', 'o', 'u', 's', 0,
+    /* 't'          */ 0x45, 1, 78, 3, 8, 110, 3, 14, 168, 3, 15, 218, 3, 21, 229, 3,
+    /* 'ta'         */ 0x42, 4, 85, 3, 18, 99, 3,
+    /* 'tad'        */ 0x06, 15, 13, 15, 3, 3, 1,
+    /* 'tadomocca'  */ 0x83, 'm', 'o', 'd', 'a', 't', 0,
+    /* 'tar'        */ 0x04, 5, 16, 5, 19,
+    /* 'tarepes'    */ 0x83, 'a', 'r', 'a', 't', 0,
+    /* 'th'         */ 0x44, 1, 123, 3, 4, 144, 3, 7, 152, 3, 9, 161, 3,
+    /* 'tha'        */ 0x42, 20, 130, 3, 23, 137, 3,
+    /* 'that'       */ 0x01, 0,
+    /* 'that:'      */ 0x82, 'h', 'a', 't', 0,
+    /* 'thaw'       */ 0x01, 0,
+    /* 'thaw:'      */ 0x82, 'h', 'a', 't', 0,
+    /* 'thd'        */ 0x03, 9, 23, 0,
+    /* 'thdiw:'     */ 0x81, 't', 'h', 0,
+    /* 'thg'        */ 0x04, 14, 5, 12, 0,
+    /* 'thgnel:'    */ 0x81, 't', 'h', 0,
+    /* 'thi'        */ 0x02, 23, 0,
+    /* 'thiw:'      */ 0x81, 't', 'h', 0,
+    /* 'tn'         */ 0x02, 5, 13,
+    /* 'tnem'       */ 0x43, 5, 181, 3, 15, 193, 3, 18, 206, 3,
+    /* 'tneme'      */ 0x05, 21, 7, 18, 1, 0,
+    /* 'tnemeugra:' */ 0x84, 'm', 'e', 'n', 't', 0,
+    /* 'tnemo'      */ 0x05, 18, 9, 22, 14, 5,
+    /* 'tnemorivne' */ 0x83, 'n', 'm', 'e', 'n', 't', 0,
+    /* 'tnemr'      */ 0x04, 5, 22, 15, 7,
+    /* 'tnemrevog'  */ 0x83, 'n', 'm', 'e', 'n', 't', 0,
+    /* 'to'         */ 0x05, 18, 16, 13, 9, 0,
+    /* 'torpmi:'    */ 0x82, 'o', 'r', 't', 0,
+    /* 'tu'         */ 0x03, 19, 10, 0,
+    /* 'tusj:'      */ 0x82, 'u', 's', 't', 0,
+    /* 'w'          */ 0x42, 14, 245, 3, 15, 254, 3,
+    /* 'wn'         */ 0x03, 15, 11, 0,
+    /* 'wnok:'      */ 0x82, 'n', 'o', 'w', 0,
+    /* 'wo'         */ 0x42, 11, 5, 4, 18, 14, 4,
+    /* 'wok'        */ 0x02, 14, 0,
+    /* 'wokn:'      */ 0x83, 'k', 'n', 'o', 'w', 0,
+    /* 'wor'        */ 0x02, 15, 13,
+    /* 'worom'      */ 0x42, 13, 24, 4, 15, 35, 4,
+    /* 'woromm'     */ 0x03, 15, 20, 0,
+    /* 'worommot:'  */ 0x84, 'o', 'r', 'r', 'o', 'w', 0,
+    /* 'woromo'     */ 0x02, 20, 0,
+    /* 'woromot:'   */ 0x81, 'r', 'o', 'w', 0,
+    /* 'y'          */ 0x42, 8, 50, 4, 12, 59, 4,
+    /* 'yh'         */ 0x03, 5, 20, 0,
+    /* 'yhet:'      */ 0x82, 'h', 'e', 'y', 0,
+    /* 'yl'         */ 0x08, 5, 20, 1, 14, 9, 6, 5, 4,
+    /* 'yletanifed' */ 0x84, 'i', 't', 'e', 'l', 'y', 0,
+};
@@ -0,0 +1,54 @@
+/**
+ * @file chacha20.c
+ * @brief Implementation of the ChaCha20 block function
+ */
+
+#include "features/chacha20.h"
+
+#define ROTL32(v, n) (((v) << (n)) | ((v) >> (32 - (n))))
+
+#define QUARTER_ROUND(a, b, c, d)                      \
+    do {                                               \
+        x[a] += x[b], x[d] = ROTL32(x[d] ^ x[a], 16); \
+        x[c] += x[d], x[b] = ROTL32(x[b] ^ x[c], 12); \
+        x[a] += x[b], x[d] = ROTL32(x[d] ^ x[a], 8);  \
+        x[c] += x[d], x[b] = ROTL32(x[b] ^ x[c], 7);  \
+    } while (0)
+
+void chacha20_block(const uint32_t key[CHACHA20_KEY_WORDS], uint32_t counter, const uint32_t nonce[CHACHA20_NONCE_WORDS], uint32_t out[CHACHA20_BLOCK_WORDS]) {
+    // "expand 32-byte k"
+    uint32_t state[CHACHA20_BLOCK_WORDS] = {0x61707865, 0x3320646e, 0x79622d32, 0x6b206574};
+    for (uint8_t i = 0; i < CHACHA20_KEY_WORDS; i++) {
+        state[4 + i] = key[i];
+    }
+    state[12] = counter;
+    for (uint8_t i = 0; i < CHACHA20_NONCE_WORDS; i++) {
+        state[13 + i] = nonce[i];
+    }
+
+    uint32_t *x = out;
+    for (uint8_t i = 0; i < CHACHA20_BLOCK_WORDS; i++) {
+        x[i] = state[i];
+    }
+    for (uint8_t round = 0; round < 10; round++) {
+        QUARTER_ROUND(0, 4, 8, 12);
+        QUARTER_ROUND(1, 5, 9, 13);
+        QUARTER_ROUND(2, 6, 10, 14);
+        QUARTER_ROUND(3, 7, 11, 15);
+        QUARTER_ROUND(0, 5, 10, 15);
+        QUARTER_ROUND(1, 6, 11, 12);
+        QUARTER_ROUND(2, 7, 8, 13);
+        QUARTER_ROUND(3, 4, 9, 14);
+    }
+    for (uint8_t i = 0; i < CHACHA20_BLOCK_WORDS; i++) {
+        x[i] += state[i];
+    }
+    chacha20_wipe(state, sizeof(state));
+}
+
+void chacha20_wipe(void *data, uint16_t length) {
+    volatile uint8_t *p = data;
+    while (length--) {
+        *p++ = 0;
+    }
+}
@@ -0,0 +1,45 @@
+/**
+ * @file chacha20.h
+ * @brief ChaCha20 block function (RFC 8439)
+ *
+ * Only the block function is provided: callers generate one 64-byte block of
+ * keystream at a time and consume it at their own pace, which is what lets
+ * the secrets vault decrypt one character per keystroke. Words are handled
+ * as uint32_t throughout; byte n of a block is byte n % 4 (little endian) of
+ * word n / 4, as in the RFC.
+ *
+ * tools/secrets_vault.py holds the matching host implementation.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief Words in a key, a nonce and a block
+ */
+#define CHACHA20_KEY_WORDS 8
+#define CHACHA20_NONCE_WORDS 3
+#define CHACHA20_BLOCK_WORDS 16
+
+/**
+ * @brief Compute one block of keystream
+ *
+ * @param key 256-bit key
+ * @param counter Block counter
+ * @param nonce 96-bit nonce
+ * @param out The 512-bit block
+ */
+void chacha20_block(const uint32_t key[CHACHA20_KEY_WORDS], uint32_t counter, const uint32_t nonce[CHACHA20_NONCE_WORDS], uint32_t out[CHACHA20_BLOCK_WORDS]);
+
+/**
+ * @brief Byte n of a block
+ */
+static inline uint8_t chacha20_byte(const uint32_t block[CHACHA20_BLOCK_WORDS], uint8_t n) {
+    return block[n / 4] >> (8 * (n % 4));
+}
+
+/**
+ * @brief Zero key material in a way the compiler cannot drop as a dead store
+ */
+void chacha20_wipe(void *data, uint16_t length);
@@ -0,0 +1,174 @@
+/**
+ * @file cycle_profile.c
+ * @brief Implementation of cycle-count profiling using the Cortex-M DWT unit
+ *
+ * The DWT cycle counter is a free-running 32-bit register clocked at the core
+ * frequency. Measurements are taken as an unsigned difference, so a single
+ * counter wrap between start and end is harmless.
+ */
+
+#include "features/cycle_profile.h"
+#include "features/hid_protocol.h"
+#include "features/secrets_manager.h"
+#include "print.h"
+#include <string.h>
+
+#if !defined(__ARM_ARCH_7M__) && !defined(__ARM_ARCH_7EM__)
+#    error "cycle_profile: the DWT cycle counter needs a Cortex-M3/M4/M7 MCU"
+#endif
+
+// ==== DWT REGISTERS ====
+
+#define DEMCR       (*(volatile uint32_t *)0xE000EDFC) /**< Debug Exception and Monitor Control */
+#define DEMCR_TRCENA (1UL << 24)                       /**< Enables the DWT unit */
+#define DWT_CTRL    (*(volatile uint32_t *)0xE0001000) /**< DWT control register */
+#define DWT_CYCCNT  (*(volatile uint32_t *)0xE0001004) /**< DWT cycle counter */
+#define DWT_CTRL_CYCCNTENA (1UL << 0)                  /**< Enables CYCCNT */
+
+// ==== STATE VARIABLES ====
+
+/**
+ * @brief Accumulated measurements, one per probe
+ */
+static cycle_stat_t stats[PROBE_COUNT];
+
+/**
+ * @brief Slowest key events, sorted slowest first
+ */
+static cycle_event_t worst[CYCLE_PROFILE_WORST_COUNT];
+
+/**
+ * @brief Number of valid entries in worst[]
+ */
+static uint8_t worst_count = 0;
+
+/**
+ * @brief Probe names for the printed table
+ */
+static const char *const probe_names[PROBE_COUNT] = {
+    [PROBE_PROCESS_RECORD]  = "process_record",
+    [PROBE_MATRIX_SCAN]     = "matrix_scan",
+    [PROBE_RGB_INDICATORS]  = "rgb_indicators",
+    [PROBE_SENTENCE_CASE]   = "sentence_case",
+    [PROBE_SECRETS]         = "secrets",
+    [PROBE_VIRTUAL_DESKTOP] = "virtual_desktop",
+    [PROBE_HEATMAP]         = "heatmap",
+    [PROBE_AUTOCORRECT]     = "autocorrect",
+    [PROBE_SETTINGS_LOAD]   = "settings_load",
+    [PROBE_SNIPPETS]        = "snippets",
+};
+
+// ==== PUBLIC FUNCTIONS ====
+
+void cycle_profile_init(void) {
+    DEMCR |= DEMCR_TRCENA;
+    DWT_CYCCNT = 0;
+    DWT_CTRL |= DWT_CTRL_CYCCNTENA;
+    cycle_profile_reset();
+}
+
+void cycle_profile_record(cycle_probe_t probe, uint32_t start) {
+    uint32_t cycles = cycle_profile_now() - start;
+    cycle_stat_t *stat = &stats[probe];
+
+    stat->count++;
+    stat->total += cycles;
+    if (cycles > stat->max) {
+        stat->max = cycles;
+    }
+}
+
+void cycle_profile_record_event(cycle_probe_t probe, uint32_t start, uint16_t keycode, const keyrecord_t *record) {
+    uint32_t cycles = cycle_profile_now() - start;
+    cycle_profile_record(probe, start);
+
+    // Cheap reject: most events are not among the slowest
+    if (worst_count == CYCLE_PROFILE_WORST_COUNT && cycles <= worst[worst_count - 1].cycles) {
+        return;
+    }
+
+    // Insertion into the short sorted list, dropping the fastest if full
+    uint8_t i = (worst_count < CYCLE_PROFILE_WORST_COUNT) ? worst_count++ : worst_count - 1;
+    while (i > 0 && worst[i - 1].cycles < cycles) {
+        worst[i] = worst[i - 1];
+        i--;
+    }
+    // The list goes out over raw HID: a slow PIN digit must not go with it
+    worst[i] = (cycle_event_t){
+        .cycles  = cycles,
+        .keycode = is_secret_input_mode() ? KC_NO : keycode,
+        .time    = record->event.time,
+        .mods    = get_mods() | get_weak_mods() | get_oneshot_mods(),
+        .layer   = get_highest_layer(layer_state),
+        .pressed = record->event.pressed,
+    };
+}
+
+const cycle_event_t *cycle_profile_worst(uint8_t *count) {
+    *count = worst_count;
+    return worst;
+}
+
+const cycle_stat_t *cycle_profile_get(cycle_probe_t probe) {
+    return (probe < PROBE_COUNT) ? &stats[probe] : NULL;
+}
+
+void cycle_profile_reset(void) {
+    memset(stats, 0, sizeof(stats));
+    worst_count = 0;
+}
+
+void cycle_profile_print(void) {
+    dprintf("%-16s %10s %10s %10s\n", "probe", "count", "avg", "max");
+    // Arguments computed inline: dprintf() compiles away without a console
+    for (uint8_t i = 0; i < PROBE_COUNT; i++) {
+        dprintf("%-16s %10lu %10lu %10lu\n", probe_names[i],
+                (unsigned long)stats[i].count,
+                (unsigned long)(stats[i].count ? stats[i].total / stats[i].count : 0),
+                (unsigned long)stats[i].max);
+    }
+
+    // One replayable line per slow event, slowest first
+    for (uint8_t i = 0; i < worst_count; i++) {
+        dprintf("trace kc=0x%04X %s mods=0x%02X layer=%u t=%u cycles=%lu\n",
+                worst[i].keycode, worst[i].pressed ? "down" : "up", worst[i].mods,
+                worst[i].layer, worst[i].time, (unsigned long)worst[i].cycles);
+    }
+}
+
+void cycle_profile_raw_hid(uint8_t *data, uint8_t length) {
+    uint8_t index = data[1];
+
+    if (index > worst_count) {
+        data[1] = HID_STATUS_BAD_ARG;
+        return;
+    }
+
+    uint8_t n = worst_count - index;
+    if (n > CYCLE_TRACE_PER_PACKET) {
+        n = CYCLE_TRACE_PER_PACKET;
+    }
+
+    memset(data + 2, 0, length - 2);
+    data[1] = HID_STATUS_OK;
+    data[2] = worst_count;
+    data[3] = index;
+    data[4] = n;
+
+    uint8_t *out = data + 5;
+    for (uint8_t i = index; i < index + n; i++) {
+        const cycle_event_t *event = &worst[i];
+        out[0]  = event->cycles;
+        out[1]  = event->cycles >> 8;
+        out[2]  = event->cycles >> 16;
+        out[3]  = event->cycles >> 24;
+        out[4]  = event->keycode;
+        out[5]  = event->keycode >> 8;
+        out[6]  = event->time;
+        out[7]  = event->time >> 8;
+        out[8]  = event->mods;
+        out[9]  = event->layer;
+        out[10] = event->pressed;
+        out += 11;
+    }
+}
@@ -0,0 +1,202 @@
+/**
+ * @file cycle_profile.h
+ * @brief Cycle-count profiling of feature hot paths
+ *
+ * This module measures how many CPU cycles the keymap's handlers take, using
+ * the Cortex-M DWT cycle counter. Each probe accumulates a call count, a total
+ * and a worst case, giving a cycles-per-event table that can be compared
+ * between commits on the real MCU.
+ *
+ * Usage in keymap.c:
+ *   1. Set CYCLE_PROFILE_ENABLE = yes in rules.mk
+ *   2. Call cycle_profile_init() from keyboard_post_init_user()
+ *   3. Wrap a call with CYCLE_PROFILE(probe, call); it evaluates to the call's
+ *      value, so it slots into the process_record_user() && chain
+ *
+ * process_record_user() is wrapped with CYCLE_PROFILE_EVENT() instead, which
+ * also keeps the CYCLE_PROFILE_WORST_COUNT slowest key events together with the
+ * keycode, modifiers and layer they ran under, so worst-case handler paths can
+ * be read back as a trace and replayed: route HID_CMD_CYCLE_TRACE packets to
+ * cycle_profile_raw_hid(), then tools/cycle_trace.py dumps them in the trace
+ * format test/bench_replay.c replays through the host build.
+ *
+ * When disabled, CYCLE_PROFILE(probe, call) expands to just (call).
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+/**
+ * @enum cycle_probe
+ * @brief The instrumented code paths
+ */
+typedef enum {
+    PROBE_PROCESS_RECORD,   /**< Whole process_record_user() */
+    PROBE_MATRIX_SCAN,      /**< Whole matrix_scan_user() */
+    PROBE_RGB_INDICATORS,   /**< rgb_indicators_implementation() */
+    PROBE_SENTENCE_CASE,    /**< process_record_sentence_case() */
+    PROBE_SECRETS,          /**< PIN entry and secret keycode handlers */
+    PROBE_VIRTUAL_DESKTOP,  /**< process_virtual_desktop() */
+    PROBE_HEATMAP,          /**< One iteration of the heatmap RGB effect */
+    PROBE_AUTOCORRECT,      /**< process_autocorrect() */
+    PROBE_SETTINGS_LOAD,    /**< settings_init(), once per boot */
+    PROBE_SNIPPETS,         /**< process_snippets() */
+    PROBE_COUNT             /**< Number of probes */
+} cycle_probe_t;
+
+/**
+ * @brief Number of slowest key events to keep
+ */
+#ifndef CYCLE_PROFILE_WORST_COUNT
+#    define CYCLE_PROFILE_WORST_COUNT 8
+#endif
+
+/**
+ * @brief One slow key event, with the context needed to replay it
+ */
+typedef struct {
+    uint32_t cycles;   /**< Time spent handling the event */
+    uint16_t keycode;  /**< Keycode passed to process_record_user(), KC_NO in secret input */
+    uint16_t time;     /**< Event timestamp (timer_read()) */
+    uint8_t  mods;     /**< Real + weak + one-shot mods at the time */
+    uint8_t  layer;    /**< Highest active layer at the time */
+    bool     pressed;  /**< Press or release */
+} cycle_event_t;
+
+/**
+ * @brief Accumulated measurements for one probe
+ */
+typedef struct {
+    uint32_t count;   /**< Number of measured calls */
+    uint32_t max;     /**< Slowest call, in cycles */
+    uint64_t total;   /**< Sum of all calls, in cycles */
+} cycle_stat_t;
+
+#ifdef CYCLE_PROFILE_ENABLE
+
+/**
+ * @brief Read the free-running DWT cycle counter
+ */
+static inline uint32_t cycle_profile_now(void) {
+    return *(volatile uint32_t *)0xE0001004; // DWT->CYCCNT
+}
+
+/**
+ * @brief Enable the DWT cycle counter and clear all probes
+ *
+ * Call once from keyboard_post_init_user().
+ */
+void cycle_profile_init(void);
+
+/**
+ * @brief Record one measurement for a probe
+ *
+ * @param probe The probe being measured
+ * @param start cycle_profile_now() taken before the measured code
+ */
+void cycle_profile_record(cycle_probe_t probe, uint32_t start);
+
+/**
+ * @brief Record one measurement for a probe that handles a key event
+ *
+ * Like cycle_profile_record(), and additionally keeps the event if it ranks
+ * among the slowest seen. Events during PIN entry or SECRET_SELECT are kept
+ * as KC_NO, so the list never holds a secret digit.
+ *
+ * @param probe The probe being measured
+ * @param start cycle_profile_now() taken before the measured code
+ * @param keycode The keycode being processed
+ * @param record The key event being processed
+ */
+void cycle_profile_record_event(cycle_probe_t probe, uint32_t start, uint16_t keycode, const keyrecord_t *record);
+
+/**
+ * @brief Get the slowest key events seen, slowest first
+ *
+ * @param count Set to the number of valid entries
+ * @return const cycle_event_t* Array of up to CYCLE_PROFILE_WORST_COUNT events
+ */
+const cycle_event_t *cycle_profile_worst(uint8_t *count);
+
+/**
+ * @brief Get the accumulated measurements for a probe
+ *
+ * @param probe The probe to read
+ * @return const cycle_stat_t* Pointer to the probe's measurements
+ */
+const cycle_stat_t *cycle_profile_get(cycle_probe_t probe);
+
+/**
+ * @brief Clear all probes
+ */
+void cycle_profile_reset(void);
+
+/**
+ * @brief Print a cycles-per-event table and the slowest-event trace to the
+ *        debug console
+ */
+void cycle_profile_print(void);
+
+/**
+ * @brief Number of slowest events in one HID_CMD_CYCLE_TRACE response
+ */
+#define CYCLE_TRACE_PER_PACKET 2
+
+/**
+ * @brief Handle a HID_CMD_CYCLE_TRACE request in place
+ *
+ * Request [cmd][index]; response [cmd][status][count][index][n] followed by
+ * n of the slowest events from index on, 11 bytes each, little-endian:
+ * [cycles:4][keycode:2][time:2][mods][layer][pressed].
+ *
+ * @param data The raw HID packet, overwritten with the response
+ * @param length Packet length (HID_PACKET_SIZE)
+ */
+void cycle_profile_raw_hid(uint8_t *data, uint8_t length);
+
+/**
+ * @brief Measure a call, evaluating to its result
+ */
+#define CYCLE_PROFILE(probe, call)                          \
+    ({                                                      \
+        uint32_t _cp_start = cycle_profile_now();           \
+        __typeof__(call) _cp_result = (call);               \
+        cycle_profile_record((probe), _cp_start);           \
+        _cp_result;                                         \
+    })
+
+/**
+ * @brief Measure a key event handler, evaluating to its result
+ */
+#define CYCLE_PROFILE_EVENT(probe, keycode, record, call)             \
+    ({                                                                \
+        uint32_t _cp_start = cycle_profile_now();                     \
+        __typeof__(call) _cp_result = (call);                         \
+        cycle_profile_record_event((probe), _cp_start, (keycode), (record)); \
+        _cp_result;                                                   \
+    })
+
+/**
+ * @brief Measure a void call
+ */
+#define CYCLE_PROFILE_VOID(probe, call)                     \
+    do {                                                    \
+        uint32_t _cp_start = cycle_profile_now();           \
+        call;                                               \
+        cycle_profile_record((probe), _cp_start);           \
+    } while (0)
+
+#else // CYCLE_PROFILE_ENABLE
+
+static inline void cycle_profile_init(void) {}
+static inline void cycle_profile_reset(void) {}
+static inline void cycle_profile_print(void) {}
+static inline const cycle_stat_t *cycle_profile_get(cycle_probe_t probe) { return NULL; }
+static inline const cycle_event_t *cycle_profile_worst(uint8_t *count) { *count = 0; return NULL; }
+
+#define CYCLE_PROFILE(probe, call) (call)
+#define CYCLE_PROFILE_EVENT(probe, keycode, record, call) (call)
+#define CYCLE_PROFILE_VOID(probe, call) call
+
+#endif // CYCLE_PROFILE_ENABLE
@@ -0,0 +1,62 @@
+/**
+ * @file eeprom_layout.h
+ * @brief Layout of the keymap's EEPROM user datablock
+ *
+ * Every feature that persists data owns a fixed region of QMK's user
+ * datablock (eeconfig_read/update_user_datablock). Regions are listed here so
+ * offsets never overlap; each region starts with its own version byte and
+ * resets itself when that does not match.
+ *
+ * Append new regions at the end. The datablock version is pinned rather than
+ * derived from the size, so growing the block does not wipe the regions
+ * already in use.
+ *
+ * Only preprocessor constants here: config.h includes this file.
+ */
+
+#pragma once
+
+// ==== REGIONS ====
+
+/**
+ * @brief Keystroke statistics (features/key_stats.c)
+ */
+#define EEPROM_KEY_STATS_OFFSET 0
+#define EEPROM_KEY_STATS_SIZE   768
+
+/**
+ * @brief Runtime settings (features/settings.c), written round-robin to slots
+ */
+#define EEPROM_SETTINGS_OFFSET    (EEPROM_KEY_STATS_OFFSET + EEPROM_KEY_STATS_SIZE)
+#define EEPROM_SETTINGS_SLOT_SIZE 8
+#define EEPROM_SETTINGS_SLOTS     8
+#define EEPROM_SETTINGS_SIZE      (EEPROM_SETTINGS_SLOT_SIZE * EEPROM_SETTINGS_SLOTS)
+
+/**
+ * @brief Runtime key binding overrides (features/keymap_overrides.c)
+ */
+#define EEPROM_KEYMAP_OVERRIDES_OFFSET (EEPROM_SETTINGS_OFFSET + EEPROM_SETTINGS_SIZE)
+#define EEPROM_KEYMAP_OVERRIDES_SIZE   260
+
+/**
+ * @brief Recorded macros (features/macro_recorder.c), one slot each
+ */
+#define EEPROM_MACROS_OFFSET    (EEPROM_KEYMAP_OVERRIDES_OFFSET + EEPROM_KEYMAP_OVERRIDES_SIZE)
+#define EEPROM_MACROS_SLOT_SIZE 128
+#define EEPROM_MACROS_SLOTS     4
+#define EEPROM_MACROS_SIZE      (EEPROM_MACROS_SLOT_SIZE * EEPROM_MACROS_SLOTS)
+
+/**
+ * @brief Raw HID delivery counter epoch (features/secrets_manager.c)
+ */
+#define EEPROM_SECRETS_HID_OFFSET (EEPROM_MACROS_OFFSET + EEPROM_MACROS_SIZE)
+#define EEPROM_SECRETS_HID_SIZE   4
+
+// ==== TOTAL ====
+
+#define EEPROM_USER_DATA_SIZE (EEPROM_SECRETS_HID_OFFSET + EEPROM_SECRETS_HID_SIZE)
+
+/**
+ * @brief Version of the datablock as a whole; bump only to wipe every region
+ */
+#define EEPROM_USER_DATA_VERSION 1
@@ -0,0 +1,142 @@
+/**
+ * @file esc_dance.c
+ * @brief Implementation of the low-latency Esc tap dance
+ */
+
+#include "features/esc_dance.h"
+#include "custom_keycodes.h"
+#include "layers.h"
+#include "features/secrets_manager.h"
+#include "features/event_log.h"
+
+/**
+ * @brief Tap dance progress
+ */
+enum esc_dance_state {
+    DANCE_IDLE,    /**< Nothing pending */
+    DANCE_PRESSED, /**< First press held, tap or hold still open */
+    DANCE_HOLDING, /**< Resolved as a hold, waiting for the release */
+    DANCE_WAITING, /**< Released, a second tap may still follow */
+    DANCE_DOUBLE,  /**< Resolved as a double tap, waiting for the release */
+};
+
+/**
+ * @brief Outcomes, as logged by EV_ESC_DANCE
+ */
+enum esc_dance_outcome {
+    OUTCOME_TAP = 1,
+    OUTCOME_DOUBLE_TAP,
+    OUTCOME_HOLD,
+};
+
+// ==== STATE VARIABLES ====
+
+/**
+ * @brief Current tap dance progress
+ */
+static uint8_t dance_state = DANCE_IDLE;
+
+/**
+ * @brief Time of the first press
+ */
+static uint16_t dance_timer = 0;
+
+/**
+ * @brief Tapping term in force at the first press
+ */
+static uint16_t dance_term = 0;
+
+// ==== HELPER FUNCTIONS ====
+
+/**
+ * @brief Log an outcome with the time it took to decide
+ */
+static void esc_dance_resolved(uint8_t outcome) {
+    EVLOG_DEBUG(EV_ESC_DANCE, outcome, timer_elapsed(dance_timer));
+}
+
+/**
+ * @brief Send the single tap: Esc, seen by process_record_user() like a real key
+ */
+static void esc_dance_tap(void) {
+    esc_dance_resolved(OUTCOME_TAP);
+    dance_state = DANCE_IDLE; // Before replaying, which comes back through here
+
+    keyrecord_t record = {.event = MAKE_KEYEVENT(KEYLOC_COMBO, KEYLOC_COMBO, true)};
+    if (process_record_user(KC_ESC, &record)) {
+        tap_code(KC_ESC);
+    }
+    record.event.pressed = false;
+    process_record_user(KC_ESC, &record);
+}
+
+/**
+ * @brief Whether a double tap would do anything right now
+ */
+static bool esc_dance_double_tap_possible(void) {
+    return is_secrets_unlocked();
+}
+
+// ==== PUBLIC FUNCTIONS ====
+
+bool process_esc_dance(uint16_t keycode, keyrecord_t *record) {
+    if (keycode != TD(TD_ESC)) {
+        if (record->event.pressed) {
+            if (dance_state == DANCE_WAITING) {
+                esc_dance_tap(); // Typing on: no second tap is coming
+            } else if (dance_state == DANCE_PRESSED) {
+                esc_dance_resolved(OUTCOME_HOLD);
+                dance_state = DANCE_HOLDING; // Used as the _FL key
+            }
+        }
+        return true;
+    }
+
+    if (record->event.pressed) {
+        if (dance_state == DANCE_WAITING) {
+            esc_dance_resolved(OUTCOME_DOUBLE_TAP);
+            dance_state = DANCE_DOUBLE;
+            secrets_lock();
+            return false;
+        }
+        dance_state = DANCE_PRESSED;
+        dance_timer = timer_read();
+        dance_term  = GET_TAPPING_TERM(keycode, record);
+        layer_on(_FL);
+        return false;
+    }
+
+    switch (dance_state) {
+        case DANCE_PRESSED:
+            layer_off(_FL);
+            if (timer_elapsed(dance_timer) >= dance_term) {
+                esc_dance_resolved(OUTCOME_HOLD); // Term ran out since the last scan
+                dance_state = DANCE_IDLE;
+            } else if (esc_dance_double_tap_possible()) {
+                dance_state = DANCE_WAITING;
+            } else {
+                esc_dance_tap();
+            }
+            break;
+        case DANCE_HOLDING:
+            layer_off(_FL);
+            dance_state = DANCE_IDLE;
+            break;
+        case DANCE_DOUBLE:
+            dance_state = DANCE_IDLE;
+            break;
+    }
+    return false;
+}
+
+void esc_dance_task(void) {
+    if (dance_state == DANCE_IDLE || timer_elapsed(dance_timer) < dance_term) {
+        return;
+    }
+    if (dance_state == DANCE_PRESSED) {
+        esc_dance_resolved(OUTCOME_HOLD);
+        dance_state = DANCE_HOLDING;
+    } else if (dance_state == DANCE_WAITING) {
+        esc_dance_tap();
+    }
+}
@@ -0,0 +1,63 @@
+/**
+ * @file esc_dance.h
+ * @brief Low-latency Esc tap dance (TD_ESC)
+ *
+ * The key in the Esc position of _BL and _QW (ESC_TD in keymaps.h):
+ *   - tap: Esc, replayed through process_record_user() so it still cancels
+ *     PIN entry
+ *   - double tap: lock secrets
+ *   - hold: _FL, like MO(_FL)
+ *
+ * Stock tap dance decides only once TAPPING_TERM has passed since the last
+ * tap, so even a plain Esc arrives a full tapping term after the press. This
+ * engine resolves each outcome as soon as it can no longer change:
+ *   - _FL turns on at the press, so keys pressed while Esc is held land on
+ *     _FL straight away
+ *   - while secrets are locked a double tap would do nothing, so releasing
+ *     the key sends Esc at once
+ *   - otherwise Esc is sent on the first of: TAPPING_TERM after the press,
+ *     or the press of any other key
+ *   - the second press of a double tap locks the secrets on the press
+ *
+ * test/test_esc_dance.c times each outcome against stock tap dance.
+ *
+ * QMK's TAP_DANCE_ENABLE stays off: TD(TD_ESC) reaches process_record_user()
+ * untouched and is handled here.
+ *
+ * Usage in keymap.c:
+ *   1. Set ESC_DANCE_ENABLE = yes in rules.mk (leave TAP_DANCE_ENABLE off)
+ *   2. Call process_esc_dance(keycode, record) first in process_record_user()
+ *   3. Call esc_dance_task() from matrix_scan_user()
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+#ifdef ESC_DANCE_ENABLE
+
+/**
+ * @brief Process keycodes for the Esc tap dance
+ *
+ * Handles TD(TD_ESC) and watches every other key press, which settles a
+ * pending tap or hold.
+ *
+ * @param keycode The keycode to process
+ * @param record The keyrecord containing event information
+ * @return false if the key was TD(TD_ESC), true otherwise
+ */
+bool process_esc_dance(uint16_t keycode, keyrecord_t *record);
+
+/**
+ * @brief Settle a tap dance whose tapping term has run out
+ *
+ * Call from matrix_scan_user().
+ */
+void esc_dance_task(void);
+
+#else // ESC_DANCE_ENABLE
+
+static inline bool process_esc_dance(uint16_t keycode, keyrecord_t *record) { return true; }
+static inline void esc_dance_task(void) {}
+
+#endif // ESC_DANCE_ENABLE
@@ -0,0 +1,54 @@
+/**
+ * @file event_log.c
+ * @brief Implementation of the binary ring-buffer event logger
+ *
+ * Writing is inlined from event_log.h; this file only owns the ring storage
+ * and the readers used to drain it, locally and over raw HID.
+ */
+
+#include "features/event_log.h"
+#include "features/hid_protocol.h"
+#include <string.h>
+
+// ==== STATE VARIABLES ====
+
+/**
+ * @brief Ring of the most recent EVENT_LOG_SIZE records
+ */
+event_record_t event_log_ring[EVENT_LOG_SIZE];
+
+/**
+ * @brief Total records ever written (wraps at 65536)
+ */
+uint16_t event_log_head = 0;
+
+// ==== PUBLIC FUNCTIONS ====
+
+uint8_t event_log_read(uint16_t *cursor, event_record_t *out, uint8_t max) {
+    uint16_t pending = event_log_head - *cursor;
+
+    // Overrun: everything older than one ring's worth is gone
+    if (pending > EVENT_LOG_SIZE) {
+        *cursor = event_log_head - EVENT_LOG_SIZE;
+        pending = EVENT_LOG_SIZE;
+    }
+
+    uint8_t n = (pending < max) ? pending : max;
+    for (uint8_t i = 0; i < n; i++) {
+        out[i] = event_log_ring[(*cursor + i) & (EVENT_LOG_SIZE - 1)];
+    }
+    *cursor += n;
+    return n;
+}
+
+void event_log_raw_hid(uint8_t *data, uint8_t length) {
+    static uint16_t hid_cursor = 0;
+    event_record_t  records[(HID_PAYLOAD_SIZE - 1) / sizeof(event_record_t)];
+
+    uint8_t n = event_log_read(&hid_cursor, records, sizeof(records) / sizeof(records[0]));
+
+    memset(data + 2, 0, length - 2);
+    data[1] = HID_STATUS_OK;
+    data[2] = n;
+    memcpy(data + 3, records, n * sizeof(event_record_t));
+}
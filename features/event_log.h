@@ -0,0 +1,175 @@
+/**
+ * @file event_log.h
+ * @brief Binary ring-buffer event logger
+ *
+ * A replacement for dprintf() on hot paths. Each log call stores a fixed-size
+ * record (timestamp, event id, two 16-bit arguments) into a RAM ring: no
+ * format strings on the device and no formatting work, just a handful of
+ * stores. tools/event_log_decode.py turns a raw dump of the ring back into
+ * readable text using the event table below. With raw HID enabled the ring
+ * can also be drained live with tools/telemetry.py --events.
+ *
+ * Usage:
+ *   1. Set EVENT_LOG_ENABLE = yes in rules.mk
+ *   2. Optionally set EVENT_LOG_LEVEL in config.h (default: EVENT_LOG_LEVEL_INFO)
+ *   3. Log with EVLOG_DEBUG(id, a, b) / EVLOG_INFO(id, a, b)
+ *
+ * Calls below EVENT_LOG_LEVEL, and every call when the logger is disabled,
+ * are removed by the preprocessor; their arguments are not evaluated.
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+// ==== EVENT TABLE ====
+
+/**
+ * @brief All loggable events: _(id, decoder format)
+ *
+ * The format is applied by the host decoder to the record's two arguments,
+ * so it may use at most two %u/%X conversions. Append new events at the end:
+ * the ids are positional and old dumps decode against the same table.
+ */
+#define EVENT_LOG_EVENTS(_) \
+    _(EV_SECRETS_LOCK,     "secrets locked by command") \
+    _(EV_PIN_MODE,         "entering PIN mode") \
+    _(EV_PIN_KEY,          "PIN mode keycode=0x%04X") \
+    _(EV_PIN_DIGIT,        "PIN digit added (length=%u)") \
+    _(EV_PIN_FULL,         "PIN buffer full") \
+    _(EV_PIN_SUBMIT,       "PIN submitted (correct=%u)") \
+    _(EV_PIN_CANCEL,       "PIN entry canceled") \
+    _(EV_AUTO_LOCK,        "auto-lock timeout reached, secrets locked") \
+    _(EV_GUI_LOCK,         "GUI+L detected, secrets locked") \
+    _(EV_VD_KEY,           "VD %u key pressed (current=%u)") \
+    _(EV_VD_SWITCH,        "switching to VD %u (from %u)") \
+    _(EV_VD_MOVE_WINDOW,   "moving window to VD %u (from %u)") \
+    _(EV_META_LAYER,       "meta layer on=%u") \
+    _(EV_SENTENCE_STATE,   "sentence case state %u -> %u (0 INIT 1 WORD 2 ABBREV 3 ENDING 4 PRIMED 5 DISABLED)") \
+    _(EV_SENTENCE_REJECT,  "sentence case: not a real ending") \
+    _(EV_LEADER_START,     "leader sequence started") \
+    _(EV_LEADER_DONE,      "leader sequence fired keycode=0x%04X (%u keys)") \
+    _(EV_LEADER_FAIL,      "leader sequence canceled after %u key(s), key=0x%04X") \
+    _(EV_AUTOCORRECT,      "autocorrect: %u backspace(s), trie node %u") \
+    _(EV_ESC_DANCE,        "esc dance resolved as %u (1 tap 2 double 3 hold) after %u ms") \
+    _(EV_VAULT_SELECT,     "vault selection: %u tag digit(s), found=%u") \
+    _(EV_SECRET_HID_SENT,  "secret sealed into %u raw HID packet(s), counter=%u") \
+    _(EV_SECRET_HID_DONE,  "raw HID delivery %u (1 acked 2 no ack, typed), counter=%u") \
+    _(EV_SETTINGS_LOAD,    "settings loaded from slot %u (255 none), sequence=%u") \
+    _(EV_SETTINGS_SAVE,    "settings written to slot %u, sequence=%u") \
+    _(EV_KEYMAP_WRITE,     "keymap overrides: %u position(s) written (0 reset), %u stored") \
+    _(EV_MACRO_SAVE,       "macro %u recorded, %u bytes") \
+    _(EV_MACRO_PLAY,       "macro %u replaying at %u (0 recorded speed 1 full speed)") \
+    _(EV_SNIPPET,          "snippet %u expanded after %u backspace(s)") \
+    _(EV_MACRO_DROP,       "macro %u recording dropped at secret input, %u bytes")
+
+/**
+ * @enum event_log_id
+ * @brief Event ids, in EVENT_LOG_EVENTS order
+ */
+enum event_log_id {
+#define X(id, fmt) id,
+    EVENT_LOG_EVENTS(X)
+#undef X
+    EV_COUNT
+};
+
+// ==== LEVELS ====
+
+#define EVENT_LOG_LEVEL_DEBUG 0 /**< Per-keystroke detail */
+#define EVENT_LOG_LEVEL_INFO  1 /**< State changes and actions */
+#define EVENT_LOG_LEVEL_OFF   2 /**< Log nothing */
+
+#ifndef EVENT_LOG_LEVEL
+#    define EVENT_LOG_LEVEL EVENT_LOG_LEVEL_INFO
+#endif
+
+/**
+ * @brief Number of records in the ring; must be a power of two
+ */
+#ifndef EVENT_LOG_SIZE
+#    define EVENT_LOG_SIZE 32
+#endif
+
+#if (EVENT_LOG_SIZE & (EVENT_LOG_SIZE - 1)) != 0
+#    error "EVENT_LOG_SIZE must be a power of two"
+#endif
+
+// ==== RECORDS ====
+
+/**
+ * @brief One log record, 8 bytes, little-endian on the wire
+ */
+typedef struct {
+    uint16_t time; /**< timer_read() when logged */
+    uint8_t  id;   /**< enum event_log_id */
+    uint8_t  seq;  /**< Low byte of the write counter, to spot overruns */
+    uint16_t a;    /**< First argument */
+    uint16_t b;    /**< Second argument */
+} event_record_t;
+
+_Static_assert(sizeof(event_record_t) == 8, "event_record_t must stay 8 bytes");
+
+#ifdef EVENT_LOG_ENABLE
+
+/**
+ * @brief The ring itself and its monotonic write counter
+ *
+ * Exposed so event_log_write() can be inlined at every call site.
+ */
+extern event_record_t event_log_ring[EVENT_LOG_SIZE];
+extern uint16_t event_log_head;
+
+/**
+ * @brief Append a record to the ring, overwriting the oldest
+ */
+static inline void event_log_write(uint8_t id, uint16_t a, uint16_t b) {
+    event_record_t *r = &event_log_ring[event_log_head & (EVENT_LOG_SIZE - 1)];
+    r->time = timer_read();
+    r->id   = id;
+    r->seq  = (uint8_t)event_log_head;
+    r->a    = a;
+    r->b    = b;
+    event_log_head++;
+}
+
+/**
+ * @brief Copy out records written since a cursor
+ *
+ * If the reader fell more than EVENT_LOG_SIZE records behind, the cursor is
+ * moved to the oldest record still held (the decoder sees the gap in seq).
+ *
+ * @param cursor Write count the reader has consumed up to; advanced on return
+ * @param out Destination for the records
+ * @param max Capacity of out, in records
+ * @return uint8_t Number of records copied
+ */
+uint8_t event_log_read(uint16_t *cursor, event_record_t *out, uint8_t max);
+
+/**
+ * @brief Handle a HID_CMD_EVENT_LOG request in place
+ *
+ * Drains up to three records written since the previous request.
+ * Response: [cmd][status][count][records...], 8 bytes per record.
+ *
+ * @param data The raw HID packet, overwritten with the response
+ * @param length Packet length (HID_PACKET_SIZE)
+ */
+void event_log_raw_hid(uint8_t *data, uint8_t length);
+
+#    define EVLOG_WRITE(id, a, b) event_log_write((id), (uint16_t)(a), (uint16_t)(b))
+#else
+#    define EVLOG_WRITE(id, a, b) ((void)0)
+#endif // EVENT_LOG_ENABLE
+
+#if EVENT_LOG_LEVEL <= EVENT_LOG_LEVEL_DEBUG
+#    define EVLOG_DEBUG(id, a, b) EVLOG_WRITE(id, a, b)
+#else
+#    define EVLOG_DEBUG(id, a, b) ((void)0)
+#endif
+
+#if EVENT_LOG_LEVEL <= EVENT_LOG_LEVEL_INFO
+#    define EVLOG_INFO(id, a, b) EVLOG_WRITE(id, a, b)
+#else
+#    define EVLOG_INFO(id, a, b) ((void)0)
+#endif
@@ -0,0 +1,178 @@
+/**
+ * @file heatmap.c
+ * @brief Implementation of the typing heatmap RGB matrix effect
+ *
+ * Two bitmaps keep the per-frame work proportional to what changed:
+ * `active` marks LEDs that still hold heat (the only ones decay visits) and
+ * `dirty` marks LEDs whose displayed value changed (the only ones redrawn).
+ */
+
+#include "features/heatmap.h"
+#include "features/secrets_manager.h"
+
+// ==== STATE VARIABLES ====
+
+#define LED_WORDS ((RGB_MATRIX_LED_COUNT + 31) / 32)
+
+/**
+ * @brief Heat per LED, Q8.8 fixed point; the high byte is what gets shown
+ */
+static uint16_t heat[RGB_MATRIX_LED_COUNT];
+
+/**
+ * @brief LEDs with non-zero heat, and LEDs that need redrawing
+ */
+static uint32_t active[LED_WORDS];
+static uint32_t dirty[LED_WORDS];
+
+/**
+ * @brief Time of the last decay step
+ */
+static uint32_t decay_timer = 0;
+
+/**
+ * @brief Effect settings at the last frame, to redraw everything on change
+ */
+static HSV     last_hsv;
+static uint8_t last_speed;
+
+// ==== HELPER FUNCTIONS ====
+
+/**
+ * @brief Milliseconds per decay step: 8 at full speed, 71 at speed 0
+ */
+static uint16_t decay_interval(void) {
+    return 8 + ((255 - rgb_matrix_config.speed) >> 2);
+}
+
+/**
+ * @brief Mark every LED for redrawing
+ */
+static void mark_all_dirty(void) {
+    for (uint8_t w = 0; w < LED_WORDS; w++) {
+        dirty[w] = UINT32_MAX;
+    }
+}
+
+/**
+ * @brief Apply decay steps to every LED that still holds heat
+ *
+ * Each step removes heat >> HEATMAP_DECAY_SHIFT, plus one so small values
+ * reach zero instead of lingering.
+ */
+static void decay(uint8_t steps) {
+    for (uint8_t w = 0; w < LED_WORDS; w++) {
+        uint32_t bits = active[w];
+        while (bits) {
+            uint8_t  b = __builtin_ctz(bits);
+            uint16_t i = w * 32 + b;
+            bits &= bits - 1;
+
+            uint16_t h      = heat[i];
+            uint8_t  before = h >> 8;
+            for (uint8_t s = 0; s < steps && h; s++) {
+                h -= (h >> HEATMAP_DECAY_SHIFT) + 1;
+            }
+            heat[i] = h;
+
+            if (!h) {
+                active[w] &= ~(1UL << b);
+            }
+            if ((h >> 8) != before) {
+                dirty[w] |= 1UL << b;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Draw one LED from its heat
+ */
+static void draw(uint16_t i) {
+    uint8_t level = heat[i] >> 8;
+    HSV     hsv   = {
+        .h = rgb_matrix_config.hsv.h + 170 - scale8(170, level), // Cold keys sit 170 hue steps away
+        .s = rgb_matrix_config.hsv.s,
+        .v = scale8(rgb_matrix_config.hsv.v, level),
+    };
+    RGB rgb = hsv_to_rgb(hsv);
+    rgb_matrix_set_color(i, rgb.r, rgb.g, rgb.b);
+}
+
+// ==== PUBLIC FUNCTIONS ====
+
+void heatmap_record(keyrecord_t *record) {
+    if (!record->event.pressed || !rgb_matrix_is_enabled() || rgb_matrix_get_mode() != RGB_MATRIX_CUSTOM_HEATMAP) {
+        return;
+    }
+    // A PIN digit lit up on the keys is a PIN digit shown to the room
+    if (is_secret_input_mode()) {
+        return;
+    }
+
+    uint8_t row = record->event.key.row;
+    uint8_t col = record->event.key.col;
+    if (row >= MATRIX_ROWS || col >= MATRIX_COLS) {
+        return; // Combos use out-of-range positions
+    }
+
+    uint8_t led = g_led_config.matrix_co[row][col];
+    if (led == NO_LED) {
+        return;
+    }
+
+    uint16_t h = heat[led];
+    heat[led]  = (h > UINT16_MAX - HEATMAP_HIT) ? UINT16_MAX : h + HEATMAP_HIT;
+    active[led >> 5] |= 1UL << (led & 31);
+    dirty[led >> 5] |= 1UL << (led & 31);
+}
+
+void heatmap_redraw_led(uint8_t led) {
+    if (led < RGB_MATRIX_LED_COUNT) {
+        dirty[led >> 5] |= 1UL << (led & 31);
+    }
+}
+
+bool heatmap_render(effect_params_t *params) {
+    RGB_MATRIX_USE_LIMITS(led_min, led_max);
+
+    // Per-frame bookkeeping happens once, in the first iteration
+    if (led_min == 0) {
+        if (params->init) {
+            decay_timer = timer_read32();
+        }
+        if (params->init || last_speed != rgb_matrix_config.speed || last_hsv.h != rgb_matrix_config.hsv.h || last_hsv.s != rgb_matrix_config.hsv.s || last_hsv.v != rgb_matrix_config.hsv.v) {
+            last_hsv   = rgb_matrix_config.hsv;
+            last_speed = rgb_matrix_config.speed;
+            mark_all_dirty();
+        }
+
+        uint16_t interval = decay_interval();
+        uint32_t steps    = timer_elapsed32(decay_timer) / interval;
+        if (steps > HEATMAP_MAX_DECAY_STEPS) {
+            // Fell behind (effect paused or slow frames): drop the backlog
+            decay(HEATMAP_MAX_DECAY_STEPS);
+            decay_timer = timer_read32();
+        } else if (steps) {
+            decay(steps);
+            decay_timer += steps * interval;
+        }
+    }
+
+    for (uint16_t i = led_min; i < led_max; i++) {
+        uint32_t word = dirty[i >> 5];
+        if (!word) {
+            i |= 31; // Nothing to redraw in this word
+            continue;
+        }
+        if (!(word & (1UL << (i & 31)))) {
+            continue;
+        }
+        dirty[i >> 5] &= ~(1UL << (i & 31));
+
+        RGB_MATRIX_TEST_LED_FLAGS();
+        draw(i);
+    }
+
+    return rgb_matrix_check_finished_leds(led_max);
+}
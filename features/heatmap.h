@@ -0,0 +1,84 @@
+/**
+ * @file heatmap.h
+ * @brief Typing heatmap RGB matrix effect
+ *
+ * Every key press adds heat to the key's LED; heat decays exponentially, in
+ * Q8.8 fixed point, so recently busy keys glow and idle ones fade to black.
+ * The effect follows the _RG layer controls: hue sets the colour of the
+ * hottest keys (cooler keys shift towards hue + 170), saturation and
+ * brightness scale the output, and speed sets how fast heat decays.
+ *
+ * Only LEDs whose displayed value changed since the last frame are redrawn,
+ * and decay only visits LEDs that still hold heat, so an idle keyboard costs
+ * a few bitmap word checks per frame. The indicators in rgb_indicators.c run
+ * after the effect and still draw on top of it; one that stops drawing an
+ * LED hands it back with heatmap_redraw_led(), or its colour would stay
+ * until the key is next pressed.
+ *
+ * Usage:
+ *   1. Set HEATMAP_ENABLE = yes in rules.mk (needs RGB_MATRIX_ENABLE)
+ *   2. Call heatmap_record(record) from process_record_user()
+ *   3. Select the effect by cycling modes (RGB_RMOD on _FL)
+ *      or call rgb_matrix_mode(RGB_MATRIX_CUSTOM_HEATMAP)
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+/**
+ * @brief Heat added per press, Q8.8 (0x4000 = a quarter of full scale)
+ */
+#ifndef HEATMAP_HIT
+#    define HEATMAP_HIT 0x4000
+#endif
+
+/**
+ * @brief Each decay step removes heat / 2^HEATMAP_DECAY_SHIFT
+ */
+#ifndef HEATMAP_DECAY_SHIFT
+#    define HEATMAP_DECAY_SHIFT 4
+#endif
+
+/**
+ * @brief Decay steps applied in one frame at most, bounding catch-up work
+ */
+#ifndef HEATMAP_MAX_DECAY_STEPS
+#    define HEATMAP_MAX_DECAY_STEPS 4
+#endif
+
+#if defined(RGB_MATRIX_ENABLE) && defined(HEATMAP_ENABLE)
+
+/**
+ * @brief Add heat to the LED under a pressed key
+ *
+ * Does nothing unless the heatmap is the running effect, nor for keys
+ * typed during PIN entry or SECRET_SELECT.
+ *
+ * @param record The key event
+ */
+void heatmap_record(keyrecord_t *record);
+
+/**
+ * @brief Render one iteration of the effect
+ *
+ * Called from the RGB_MATRIX_EFFECT in rgb_matrix_user.inc.
+ *
+ * @param params The effect parameters from rgb_matrix
+ * @return bool Whether more LEDs remain to be rendered this frame
+ */
+bool heatmap_render(effect_params_t *params);
+
+/**
+ * @brief Redraw an LED from its heat in the next frame
+ *
+ * @param led The LED an indicator no longer draws over
+ */
+void heatmap_redraw_led(uint8_t led);
+
+#else
+
+static inline void heatmap_record(keyrecord_t *record) {}
+static inline void heatmap_redraw_led(uint8_t led) {}
+
+#endif
@@ -0,0 +1,48 @@
+/**
+ * @file hid_protocol.h
+ * @brief Command ids for the raw HID channel
+ *
+ * Every raw HID packet is HID_PACKET_SIZE (QMK's RAW_EPSIZE, 32) bytes.
+ * Requests start with a command byte; the keyboard answers in the same buffer with the command byte
+ * echoed, a status byte, and the command's payload:
+ *
+ *   request:  [command][args...]
+ *   response: [command][status][payload...]
+ *
+ * tools/qmkhid.py mirrors these values on the host side.
+ */
+
+#pragma once
+
+/**
+ * @enum hid_command
+ * @brief First byte of every raw HID request
+ */
+enum hid_command {
+    HID_CMD_TELEMETRY   = 0x01, /**< Read one page of the telemetry block: [page] */
+    HID_CMD_EVENT_LOG   = 0x02, /**< Drain event log records since the last read */
+    HID_CMD_KEY_STATS   = 0x03, /**< Read or clear keystroke statistics: [op][args...] */
+    HID_CMD_SECRET      = 0x04, /**< Secrets companion channel: [op][args...] (features/secrets_manager.h) */
+    HID_CMD_KEYMAP      = 0x05, /**< Read or write key binding overrides: [op][args...] (features/keymap_overrides.h) */
+    HID_CMD_CYCLE_TRACE = 0x06, /**< Read the slowest key events: [index] (features/cycle_profile.h) */
+};
+
+/**
+ * @enum hid_status
+ * @brief Second byte of every raw HID response
+ */
+enum hid_status {
+    HID_STATUS_OK          = 0x00, /**< Payload follows */
+    HID_STATUS_UNSUPPORTED = 0x01, /**< Unknown command or feature compiled out */
+    HID_STATUS_BAD_ARG     = 0x02, /**< Argument out of range */
+};
+
+/**
+ * @brief Size of every raw HID packet, matching QMK's RAW_EPSIZE
+ */
+#define HID_PACKET_SIZE 32
+
+/**
+ * @brief Bytes available for payload after the command and status bytes
+ */
+#define HID_PAYLOAD_SIZE (HID_PACKET_SIZE - 2)
@@ -0,0 +1,120 @@
+/**
+ * @file key_history.c
+ * @brief Implementation of the shared key history
+ */
+
+#include "features/key_history.h"
+
+#include <string.h>
+
+// Bits of the top history word that hold keys; the rest are kept clear so
+// that popping shifts "no key" classes back in
+#define HISTORY_TOP_BITS (KEY_HISTORY_SIZE * KEY_HISTORY_CLASS_BITS - 32 * (KEY_HISTORY_WORDS - 1))
+#define HISTORY_TOP_MASK (UINT32_C(0xFFFFFFFF) >> (32 - HISTORY_TOP_BITS))
+
+// ==== STATE VARIABLES ====
+
+/**
+ * @brief Packed key classes, most recent in the low bits of word 0
+ */
+static uint32_t history[KEY_HISTORY_WORDS] = {0};
+
+/**
+ * @brief Whether the last press processed was pushed
+ */
+static bool recorded = false;
+
+// ==== PUBLIC FUNCTIONS ====
+
+void key_history_push(uint8_t key_class) {
+    for (int8_t i = KEY_HISTORY_WORDS - 1; i > 0; --i) {
+        history[i] = (history[i] << KEY_HISTORY_CLASS_BITS) | (history[i - 1] >> (32 - KEY_HISTORY_CLASS_BITS));
+    }
+    history[0] = (history[0] << KEY_HISTORY_CLASS_BITS) | key_class;
+    history[KEY_HISTORY_WORDS - 1] &= HISTORY_TOP_MASK;
+}
+
+void key_history_pop(void) {
+    for (int8_t i = 0; i < KEY_HISTORY_WORDS - 1; ++i) {
+        history[i] = (history[i] >> KEY_HISTORY_CLASS_BITS) | (history[i + 1] << (32 - KEY_HISTORY_CLASS_BITS));
+    }
+    history[KEY_HISTORY_WORDS - 1] >>= KEY_HISTORY_CLASS_BITS;
+}
+
+void key_history_clear(void) {
+    memset(history, 0, sizeof(history));
+}
+
+bool key_history_recorded(void) {
+    return recorded;
+}
+
+const uint32_t *key_history_buffer(void) {
+    return history;
+}
+
+uint8_t key_history_class(uint8_t n) {
+    if (n >= KEY_HISTORY_SIZE) {
+        return 0;
+    }
+    // A class may straddle two words
+    uint16_t bit   = n * KEY_HISTORY_CLASS_BITS;
+    uint8_t  word  = bit / 32;
+    uint8_t  shift = bit % 32;
+    uint32_t value = history[word] >> shift;
+    if (shift > 32 - KEY_HISTORY_CLASS_BITS && word + 1 < KEY_HISTORY_WORDS) {
+        value |= history[word + 1] << (32 - shift);
+    }
+    return value & KEY_HISTORY_CLASS_MASK;
+}
+
+bool process_key_history(uint16_t keycode, keyrecord_t *record) {
+    if (!record->event.pressed) {
+        return true;
+    }
+    recorded = false;
+
+    switch (keycode) {
+        case KC_LCTL ... KC_RGUI:
+        case QK_ONE_SHOT_MOD ... QK_ONE_SHOT_MOD_MAX:
+        case QK_MOMENTARY ... QK_MOMENTARY_MAX:
+        case QK_TO ... QK_TO_MAX:
+        case QK_TOGGLE_LAYER ... QK_TOGGLE_LAYER_MAX:
+        case QK_LAYER_TAP_TOGGLE ... QK_LAYER_TAP_TOGGLE_MAX:
+        case QK_ONE_SHOT_LAYER ... QK_ONE_SHOT_LAYER_MAX:
+            return true; // Modifies the next key rather than typing one
+
+        case QK_MOD_TAP ... QK_MOD_TAP_MAX:
+            if (record->tap.count == 0) {
+                return true;
+            }
+            keycode = QK_MOD_TAP_GET_TAP_KEYCODE(keycode);
+            break;
+        case QK_LAYER_TAP ... QK_LAYER_TAP_MAX:
+            if (record->tap.count == 0) {
+                return true;
+            }
+            keycode = QK_LAYER_TAP_GET_TAP_KEYCODE(keycode);
+            break;
+    }
+
+    // Shortcuts type nothing; Ctrl/Alt+Backspace deletes more than one key
+    const uint8_t mods = get_mods() | get_weak_mods() | get_oneshot_mods();
+    if (mods & ~(MOD_MASK_SHIFT | MOD_BIT(KC_RALT))) {
+        if (keycode == KC_BSPC) {
+            key_history_clear();
+        } else {
+            key_history_push(KEY_HISTORY_OTHER);
+            recorded = true;
+        }
+        return true;
+    }
+
+    if (keycode == KC_BSPC) {
+        key_history_pop();
+    } else {
+        key_history_push(KEY_HISTORY_CLASS(keycode));
+        recorded = true;
+    }
+    return true;
+}
@@ -0,0 +1,121 @@
+/**
+ * @file key_history.h
+ * @brief Shared bit-packed history of recently typed keys
+ *
+ * One history feeds every feature that matches on what was just typed
+ * (Sentence Case endings, autocorrect typos, snippet triggers), so each key
+ * is classified and stored once instead of once per feature. Each key is
+ * reduced to a 6-bit class and the classes are shifted through an array of
+ * 32-bit words, most recent key in the low bits of word 0:
+ *   - 0 means "no key" (start of history, or shifted in by backspacing)
+ *   - 1..53 are KC_A through KC_SLSH, plain or shifted
+ *   - KEY_HISTORY_OTHER is any other key, or a key typed with Ctrl/Alt/GUI
+ *
+ * Backspace pops the most recent key, so features that rewind on backspace
+ * see the same history as if the deleted key had never been typed.
+ *
+ * Usage:
+ *   1. rules.mk sets KEY_HISTORY_ENABLE whenever a feature reading it is enabled
+ *   2. Call process_key_history(keycode, record) in process_record_user(),
+ *      before any feature that reads the history
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+/**
+ * @brief Number of keys kept, which bounds the longest pattern any feature can match
+ */
+#ifndef KEY_HISTORY_SIZE
+#    define KEY_HISTORY_SIZE 8
+#endif
+
+/**
+ * @brief Bits per key class, and the mask of one class
+ */
+#define KEY_HISTORY_CLASS_BITS 6
+#define KEY_HISTORY_CLASS_MASK ((1 << KEY_HISTORY_CLASS_BITS) - 1)
+
+/**
+ * @brief 32-bit words of packed history
+ */
+#define KEY_HISTORY_WORDS ((KEY_HISTORY_SIZE * KEY_HISTORY_CLASS_BITS + 31) / 32)
+
+/**
+ * @brief Class of keys that break every pattern (navigation, shortcuts, ...)
+ */
+#define KEY_HISTORY_OTHER KEY_HISTORY_CLASS_MASK
+
+/**
+ * @brief Maps a keycode to its history class
+ *
+ * Basic keycodes KC_A through KC_SLSH, plain or with left Shift (so KC_QUES
+ * and KC_SLSH share a class), map to 1..53. KC_NO maps to 0, and anything
+ * else maps to KEY_HISTORY_OTHER. Being a constant expression, patterns
+ * built from it fold at compile time.
+ */
+#define KEY_HISTORY_CLASS(kc)                                    \
+    ((((kc) & ~(QK_LSFT | 0xff)) == 0 && ((kc) & 0xff) >= KC_A && \
+      ((kc) & 0xff) <= KC_SLSH)                                  \
+         ? (((kc) & 0xff) - KC_A + 1)                            \
+         : ((kc) == KC_NO ? 0 : KEY_HISTORY_OTHER))
+
+#ifdef KEY_HISTORY_ENABLE
+
+/**
+ * @brief Record a key press in the history
+ *
+ * Modifiers, layer keys and held dual-role keys are not recorded; tapped
+ * dual-role keys are recorded as their tap keycode. Backspace pops the most
+ * recent key (Ctrl/Alt+Backspace, which deletes a word, clears the history).
+ *
+ * @param keycode The keycode to process
+ * @param record The keyrecord containing event information
+ * @return true Always, the key is never consumed
+ */
+bool process_key_history(uint16_t keycode, keyrecord_t *record);
+
+/**
+ * @brief Shift a class into the low end of the history
+ */
+void key_history_push(uint8_t key_class);
+
+/**
+ * @brief Drop the most recent key, shifting 0 in at the oldest end
+ */
+void key_history_pop(void);
+
+/**
+ * @brief Forget every key
+ */
+void key_history_clear(void);
+
+/**
+ * @brief The packed history, KEY_HISTORY_WORDS words long
+ */
+const uint32_t *key_history_buffer(void);
+
+/**
+ * @brief Whether the key being processed was added to the history
+ *
+ * False for keys that were ignored or popped the history, so features
+ * called after process_key_history() know whether there is anything new
+ * to match.
+ */
+bool key_history_recorded(void);
+
+/**
+ * @brief Class of the key typed n keys ago (0 = most recent)
+ *
+ * @return uint8_t The class, or 0 past the end of the history
+ */
+uint8_t key_history_class(uint8_t n);
+
+#else // KEY_HISTORY_ENABLE
+
+static inline bool process_key_history(uint16_t keycode, keyrecord_t *record) { return true; }
+static inline void key_history_clear(void) {}
+static inline bool key_history_recorded(void) { return false; }
+
+#endif // KEY_HISTORY_ENABLE
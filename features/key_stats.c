@@ -0,0 +1,249 @@
+/**
+ * @file key_stats.c
+ * @brief Implementation of the keystroke statistics engine
+ *
+ * The per-press path is a few saturating increments plus, for home row
+ * dual-role keys, one running-average update. Everything periodic (the WPM
+ * window and EEPROM write-back) happens in key_stats_task().
+ */
+
+#include "features/key_stats.h"
+#include "features/eeprom_layout.h"
+#include "features/hid_protocol.h"
+#include "features/secrets_manager.h"
+#include <string.h>
+
+_Static_assert(sizeof(key_stats_t) <= EEPROM_KEY_STATS_SIZE, "key_stats_t outgrew its EEPROM region, see eeprom_layout.h");
+
+// ==== STATE VARIABLES ====
+
+/**
+ * @brief The statistics themselves, mirrored to EEPROM
+ */
+static key_stats_t stats;
+
+/**
+ * @brief Tap keycodes of the tracked home row keys
+ */
+static const uint16_t home_row[] = {KEY_STATS_HOME_ROW};
+
+/**
+ * @brief Previous home row press, for bigram timing
+ */
+#define NO_HOME_KEY 0xFF
+static uint8_t  last_home      = NO_HOME_KEY;
+static uint16_t last_home_time = 0;
+
+/**
+ * @brief Typing presses per second over the WPM window
+ */
+static uint8_t  wpm_buckets[KEY_STATS_WPM_WINDOW];
+static uint8_t  wpm_bucket = 0;
+static uint32_t wpm_timer  = 0;
+
+/**
+ * @brief EEPROM write-back state
+ *
+ * flush_pos is the next byte of stats to write; sizeof(stats) means idle.
+ */
+static bool     dirty       = false;
+static uint32_t flush_timer = 0;
+static uint16_t flush_pos   = sizeof(key_stats_t);
+
+// ==== HELPER FUNCTIONS ====
+
+#define SATURATING_INC(x)                        \
+    do {                                         \
+        if ((x) != (__typeof__(x))~0) (x)++;     \
+    } while (0)
+
+/**
+ * @brief Fill in the header fields describing this build
+ */
+static void stats_reset(void) {
+    memset(&stats, 0, sizeof(stats));
+    stats.version   = KEY_STATS_VERSION;
+    stats.rows      = MATRIX_ROWS;
+    stats.cols      = MATRIX_COLS;
+    stats.layers    = KEY_STATS_LAYERS;
+    stats.home_keys = KEY_STATS_HOME_KEYS;
+}
+
+/**
+ * @brief Position of a dual-role key in KEY_STATS_HOME_ROW
+ *
+ * @return uint8_t Index, or NO_HOME_KEY for any other key
+ */
+static uint8_t home_index(uint16_t keycode) {
+    uint16_t tap;
+    if (IS_QK_MOD_TAP(keycode)) {
+        tap = QK_MOD_TAP_GET_TAP_KEYCODE(keycode);
+    } else if (IS_QK_LAYER_TAP(keycode)) {
+        tap = QK_LAYER_TAP_GET_TAP_KEYCODE(keycode);
+    } else {
+        return NO_HOME_KEY;
+    }
+
+    for (uint8_t i = 0; i < KEY_STATS_HOME_KEYS; i++) {
+        if (home_row[i] == tap) {
+            return i;
+        }
+    }
+    return NO_HOME_KEY;
+}
+
+/**
+ * @brief Whether a press types a character, for the WPM count
+ */
+static bool is_typing_key(uint16_t keycode, keyrecord_t *record) {
+    if (IS_QK_MOD_TAP(keycode) || IS_QK_LAYER_TAP(keycode)) {
+        if (record->tap.count == 0) {
+            return false; // Held as a modifier or layer
+        }
+        keycode &= 0xFF;
+    } else if (IS_QK_MODS(keycode)) {
+        keycode = QK_MODS_GET_BASIC_KEYCODE(keycode);
+    }
+    return (keycode >= KC_A && keycode <= KC_0) || keycode == KC_SPC || (keycode >= KC_MINS && keycode <= KC_SLSH);
+}
+
+/**
+ * @brief Advance the WPM window by one second and recompute the rate
+ */
+static void roll_wpm(void) {
+    wpm_bucket = (wpm_bucket + 1) % KEY_STATS_WPM_WINDOW;
+    wpm_buckets[wpm_bucket] = 0;
+
+    uint16_t chars = 0;
+    for (uint8_t i = 0; i < KEY_STATS_WPM_WINDOW; i++) {
+        chars += wpm_buckets[i];
+    }
+
+    // Five characters to a word
+    uint16_t wpm = chars * 60 / (5 * KEY_STATS_WPM_WINDOW);
+    stats.wpm    = wpm > UINT8_MAX ? UINT8_MAX : wpm;
+    if (stats.wpm > stats.peak_wpm) {
+        stats.peak_wpm = stats.wpm;
+        dirty          = true;
+    }
+}
+
+// ==== PUBLIC FUNCTIONS ====
+
+void key_stats_init(void) {
+    eeconfig_read_user_datablock(&stats, EEPROM_KEY_STATS_OFFSET, sizeof(stats));
+
+    // A fresh or reset datablock reads as zeros, which also fails this check
+    if (stats.version != KEY_STATS_VERSION || stats.rows != MATRIX_ROWS || stats.cols != MATRIX_COLS || stats.layers != KEY_STATS_LAYERS || stats.home_keys != KEY_STATS_HOME_KEYS) {
+        stats_reset();
+        dirty = true;
+    }
+    stats.wpm   = 0;
+    wpm_timer   = timer_read32();
+    flush_timer = timer_read32();
+}
+
+void key_stats_record(uint16_t keycode, keyrecord_t *record) {
+    // PIN and tag digits would show which digits a PIN has after a clear
+    if (!record->event.pressed || is_secret_input_mode()) {
+        return;
+    }
+
+    uint8_t row = record->event.key.row;
+    uint8_t col = record->event.key.col;
+    if (row < MATRIX_ROWS && col < MATRIX_COLS) { // Combos use out-of-range positions
+        SATURATING_INC(stats.matrix[row][col]);
+    }
+
+    uint8_t layer = get_highest_layer(layer_state | default_layer_state);
+    if (layer >= KEY_STATS_LAYERS) {
+        layer = KEY_STATS_LAYERS - 1;
+    }
+    SATURATING_INC(stats.layer[layer]);
+    SATURATING_INC(stats.presses);
+
+    if (is_typing_key(keycode, record)) {
+        SATURATING_INC(wpm_buckets[wpm_bucket]);
+    }
+
+    uint8_t home = home_index(keycode);
+    if (home != NO_HOME_KEY && last_home != NO_HOME_KEY) {
+        uint16_t interval = TIMER_DIFF_16(record->event.time, last_home_time);
+        if (interval <= KEY_STATS_BIGRAM_MAX_MS) {
+            SATURATING_INC(stats.bigram_count[last_home][home]);
+            // Running mean for the first samples, then a 1/8 moving average
+            uint16_t count  = stats.bigram_count[last_home][home];
+            int32_t  avg    = stats.bigram_ms[last_home][home];
+            int32_t  weight = count < 8 ? count : 8;
+            stats.bigram_ms[last_home][home] = avg + ((int32_t)interval - avg) / weight;
+        }
+    }
+    last_home      = home;
+    last_home_time = record->event.time;
+
+    dirty = true;
+}
+
+void key_stats_task(void) {
+    if (timer_elapsed32(wpm_timer) >= 1000) {
+        wpm_timer += 1000;
+        roll_wpm();
+    }
+
+    // Write back one chunk per scan so a flush never stalls the matrix
+    if (flush_pos < sizeof(stats)) {
+        uint16_t n = sizeof(stats) - flush_pos;
+        if (n > KEY_STATS_FLUSH_CHUNK) {
+            n = KEY_STATS_FLUSH_CHUNK;
+        }
+        eeconfig_update_user_datablock((const uint8_t *)&stats + flush_pos, EEPROM_KEY_STATS_OFFSET + flush_pos, n);
+        flush_pos += n;
+        return;
+    }
+
+    if (dirty && timer_elapsed32(flush_timer) >= KEY_STATS_FLUSH_MS) {
+        dirty       = false;
+        flush_pos   = 0;
+        flush_timer = timer_read32();
+    }
+}
+
+const key_stats_t *key_stats_get(void) {
+    return &stats;
+}
+
+void key_stats_clear(void) {
+    stats_reset();
+    memset(wpm_buckets, 0, sizeof(wpm_buckets));
+    last_home = NO_HOME_KEY;
+    dirty     = false;
+    flush_pos = 0; // Write the zeros out now rather than at the next interval
+}
+
+void key_stats_raw_hid(uint8_t *data, uint8_t length) {
+    switch (data[1]) {
+        case KEY_STATS_READ: {
+            uint16_t offset = data[2] | (data[3] << 8);
+            if (offset > sizeof(stats)) {
+                data[1] = HID_STATUS_BAD_ARG;
+                return;
+            }
+            uint16_t n = sizeof(stats) - offset;
+            if (n > HID_PAYLOAD_SIZE - 1) {
+                n = HID_PAYLOAD_SIZE - 1;
+            }
+            memset(data + 2, 0, length - 2);
+            data[1] = HID_STATUS_OK;
+            data[2] = n;
+            memcpy(data + 3, (const uint8_t *)&stats + offset, n);
+            break;
+        }
+        case KEY_STATS_CLEAR:
+            key_stats_clear();
+            data[1] = HID_STATUS_OK;
+            break;
+        default:
+            data[1] = HID_STATUS_BAD_ARG;
+            break;
+    }
+}
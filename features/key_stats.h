@@ -0,0 +1,168 @@
+/**
+ * @file key_stats.h
+ * @brief On-device keystroke statistics
+ *
+ * This module counts how the keyboard is actually used, to guide tapping term
+ * tuning and layout changes:
+ *   - Presses per matrix position
+ *   - Presses per active layer
+ *   - Count and average interval of every bigram between home row dual-role
+ *     keys (the keys whose tapping term matters)
+ *   - A rolling words-per-minute figure and its peak
+ *
+ * A keypress costs a handful of saturating increments. The counters are
+ * written to the EEPROM user datablock in small chunks, at most every
+ * KEY_STATS_FLUSH_MS, and can be read over raw HID with tools/key_stats.py.
+ *
+ * Usage in keymap.c:
+ *   1. Set KEY_STATS_ENABLE = yes in rules.mk
+ *   2. Call key_stats_init() from keyboard_post_init_user()
+ *   3. Call key_stats_task() from matrix_scan_user()
+ *   4. Call key_stats_record(keycode, record) from process_record_user()
+ *   5. Route HID_CMD_KEY_STATS packets to key_stats_raw_hid()
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+// ==== CONFIGURATION ====
+
+/**
+ * @brief Layout version of key_stats_t; bump on any change to reset stored stats
+ */
+#define KEY_STATS_VERSION 1
+
+/**
+ * @brief Number of layers counted; presses on higher layers go to the last slot
+ */
+#ifndef KEY_STATS_LAYERS
+#    define KEY_STATS_LAYERS 16
+#endif
+
+/**
+ * @brief Tap keycodes of the home row dual-role keys, left to right
+ *
+ * Only mod-tap and layer-tap keys whose tap keycode is listed are tracked.
+ */
+#ifndef KEY_STATS_HOME_ROW
+#    define KEY_STATS_HOME_ROW KC_A, KC_R, KC_S, KC_T, KC_D, KC_H, KC_N, KC_E, KC_I, KC_O
+#endif
+
+/**
+ * @brief Bigrams slower than this are typing pauses, not rolls, and are ignored
+ */
+#ifndef KEY_STATS_BIGRAM_MAX_MS
+#    define KEY_STATS_BIGRAM_MAX_MS 1000
+#endif
+
+/**
+ * @brief Length of the rolling WPM window, in seconds
+ */
+#ifndef KEY_STATS_WPM_WINDOW
+#    define KEY_STATS_WPM_WINDOW 10
+#endif
+
+/**
+ * @brief Minimum time between EEPROM flushes of changed statistics
+ */
+#ifndef KEY_STATS_FLUSH_MS
+#    define KEY_STATS_FLUSH_MS 300000
+#endif
+
+/**
+ * @brief Bytes written to EEPROM per scan while a flush is in progress
+ */
+#ifndef KEY_STATS_FLUSH_CHUNK
+#    define KEY_STATS_FLUSH_CHUNK 32
+#endif
+
+// ==== DATA ====
+
+/**
+ * @brief Number of entries in KEY_STATS_HOME_ROW
+ */
+#define KEY_STATS_HOME_KEYS (sizeof((const uint16_t[]){KEY_STATS_HOME_ROW}) / sizeof(uint16_t))
+
+/**
+ * @brief All statistics, stored verbatim in EEPROM and sent as-is over raw HID
+ *
+ * The header fields let the host decode the arrays without knowing the
+ * keyboard's matrix size or this build's configuration.
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t  version;                                        /**< KEY_STATS_VERSION */
+    uint8_t  rows;                                           /**< MATRIX_ROWS */
+    uint8_t  cols;                                           /**< MATRIX_COLS */
+    uint8_t  layers;                                         /**< KEY_STATS_LAYERS */
+    uint8_t  home_keys;                                      /**< KEY_STATS_HOME_KEYS */
+    uint8_t  wpm;                                            /**< Rolling WPM (live only) */
+    uint8_t  peak_wpm;                                       /**< Highest rolling WPM seen */
+    uint32_t presses;                                        /**< All key presses */
+    uint16_t matrix[MATRIX_ROWS][MATRIX_COLS];               /**< Presses per position */
+    uint32_t layer[KEY_STATS_LAYERS];                        /**< Presses per layer */
+    uint16_t bigram_count[KEY_STATS_HOME_KEYS][KEY_STATS_HOME_KEYS]; /**< [first][second] */
+    uint16_t bigram_ms[KEY_STATS_HOME_KEYS][KEY_STATS_HOME_KEYS];    /**< Average interval */
+} key_stats_t;
+
+/**
+ * @enum key_stats_op
+ * @brief Second byte of a HID_CMD_KEY_STATS request
+ */
+enum key_stats_op {
+    KEY_STATS_READ  = 0, /**< [offset lo][offset hi] -> [length][bytes...] */
+    KEY_STATS_CLEAR = 1, /**< Zero every counter, in RAM and EEPROM */
+};
+
+#ifdef KEY_STATS_ENABLE
+
+/**
+ * @brief Load the statistics from EEPROM, resetting them if the layout changed
+ */
+void key_stats_init(void);
+
+/**
+ * @brief Count one key event
+ *
+ * Only presses are counted; releases return immediately, and so does
+ * everything typed during PIN entry or SECRET_SELECT, which never reaches
+ * the counters or EEPROM.
+ *
+ * @param keycode The keycode from process_record_user()
+ * @param record The key event
+ */
+void key_stats_record(uint16_t keycode, keyrecord_t *record);
+
+/**
+ * @brief Roll the WPM window and write changed statistics back to EEPROM
+ *
+ * Call from matrix_scan_user(). Does nothing most scans; while a flush is in
+ * progress it writes KEY_STATS_FLUSH_CHUNK bytes per call.
+ */
+void key_stats_task(void);
+
+/**
+ * @brief The live statistics
+ */
+const key_stats_t *key_stats_get(void);
+
+/**
+ * @brief Zero all statistics and schedule an EEPROM write
+ */
+void key_stats_clear(void);
+
+/**
+ * @brief Handle a HID_CMD_KEY_STATS request in place
+ *
+ * @param data The raw HID packet, overwritten with the response
+ * @param length Packet length (HID_PACKET_SIZE)
+ */
+void key_stats_raw_hid(uint8_t *data, uint8_t length);
+
+#else // KEY_STATS_ENABLE
+
+static inline void key_stats_init(void) {}
+static inline void key_stats_record(uint16_t keycode, keyrecord_t *record) {}
+static inline void key_stats_task(void) {}
+
+#endif // KEY_STATS_ENABLE
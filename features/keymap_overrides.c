@@ -0,0 +1,284 @@
+/**
+ * @file keymap_overrides.c
+ * @brief Implementation of the runtime key binding overrides
+ */
+
+#include "features/keymap_overrides.h"
+#include "features/eeprom_layout.h"
+#include "features/hid_protocol.h"
+#include "features/event_log.h"
+#include <stddef.h>
+#include <string.h>
+
+#define POSITIONS (MATRIX_ROWS * MATRIX_COLS)
+
+_Static_assert(POSITIONS <= 256, "keymap_override_t.pos holds a matrix position in one byte");
+_Static_assert(KEYMAP_OVERRIDES_LAYERS <= 16, "layer_mask has one bit per layer");
+_Static_assert(KEYMAP_OVERRIDES_MAX <= 255, "keymap_overrides_t.count is one byte");
+_Static_assert(sizeof(keymap_overrides_t) <= EEPROM_KEYMAP_OVERRIDES_SIZE, "keymap_overrides_t outgrew its EEPROM region, see eeprom_layout.h");
+
+/**
+ * @brief Header bytes written ahead of the entries
+ */
+#define STORE_HEADER offsetof(keymap_overrides_t, entries)
+
+// ==== STATE VARIABLES ====
+
+/**
+ * @brief The overrides, mirrored to EEPROM
+ */
+static keymap_overrides_t store;
+
+/**
+ * @brief Overridden positions per layer, and the layers with any
+ */
+static uint8_t  position_bits[KEYMAP_OVERRIDES_LAYERS][(POSITIONS + 7) / 8];
+static uint16_t layer_mask = 0;
+
+/**
+ * @brief EEPROM write-back state
+ *
+ * flush_pos is the next byte of store to write and flush_end the first one
+ * not to; equal means idle.
+ */
+static bool     dirty       = false;
+static uint32_t flush_timer = 0;
+static uint16_t flush_pos   = 0;
+static uint16_t flush_end   = 0;
+
+// ==== HELPER FUNCTIONS ====
+
+/**
+ * @brief Sort key of an entry
+ */
+static inline uint16_t override_key(uint8_t layer, uint8_t pos) {
+    return (uint16_t)layer << 8 | pos;
+}
+
+/**
+ * @brief Index of the first entry not ordered before (layer, pos)
+ */
+static uint8_t override_lower_bound(uint8_t layer, uint8_t pos) {
+    uint16_t key = override_key(layer, pos);
+    uint8_t  lo = 0, hi = store.count;
+    while (lo < hi) {
+        uint8_t mid = (lo + hi) / 2;
+        if (override_key(store.entries[mid].layer, store.entries[mid].pos) < key) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+static inline bool position_overridden(uint8_t layer, uint8_t pos) {
+    return position_bits[layer][pos / 8] & (1 << (pos % 8));
+}
+
+/**
+ * @brief The compiled-in keycode of a position
+ */
+static inline uint16_t keycode_default(uint8_t layer, uint8_t pos) {
+    return keycode_at_keymap_location_raw(layer, pos / MATRIX_COLS, pos % MATRIX_COLS);
+}
+
+/**
+ * @brief Recompute the bitmaps from the entries
+ */
+static void overrides_rebuild(void) {
+    memset(position_bits, 0, sizeof(position_bits));
+    layer_mask = 0;
+    for (uint8_t i = 0; i < store.count; i++) {
+        const keymap_override_t *e = &store.entries[i];
+        position_bits[e->layer][e->pos / 8] |= 1 << (e->pos % 8);
+        layer_mask |= 1 << e->layer;
+    }
+}
+
+/**
+ * @brief Drop every override and describe this build in the header
+ */
+static void overrides_reset(void) {
+    memset(&store, 0, sizeof(store));
+    store.version = KEYMAP_OVERRIDES_VERSION;
+    store.rows    = MATRIX_ROWS;
+    store.cols    = MATRIX_COLS;
+    overrides_rebuild();
+}
+
+/**
+ * @brief Number of layers that can be overridden in this build
+ */
+static uint8_t overrides_layers(void) {
+    uint8_t layers = keymap_layer_count();
+    return layers < KEYMAP_OVERRIDES_LAYERS ? layers : KEYMAP_OVERRIDES_LAYERS;
+}
+
+/**
+ * @brief Whether the stored entries are sorted, unique and in range
+ */
+static bool overrides_valid(void) {
+    if (store.version != KEYMAP_OVERRIDES_VERSION || store.rows != MATRIX_ROWS || store.cols != MATRIX_COLS || store.count > KEYMAP_OVERRIDES_MAX) {
+        return false;
+    }
+    for (uint8_t i = 0; i < store.count; i++) {
+        const keymap_override_t *e = &store.entries[i];
+        if (e->layer >= overrides_layers() || e->pos >= POSITIONS) {
+            return false;
+        }
+        if (i && override_key(e->layer, e->pos) <= override_key(e[-1].layer, e[-1].pos)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Set n positions of a layer from little-endian keycodes
+ *
+ * @return false, changing nothing, if the result wouldn't fit
+ */
+static bool overrides_write(uint8_t layer, uint8_t pos, uint8_t n, const uint8_t *keycodes) {
+    int16_t count = store.count;
+    for (uint8_t i = 0; i < n; i++) {
+        bool custom = (keycodes[2 * i] | keycodes[2 * i + 1] << 8) != keycode_default(layer, pos + i);
+        count += custom - position_overridden(layer, pos + i);
+    }
+    if (count > KEYMAP_OVERRIDES_MAX) {
+        return false;
+    }
+
+    for (uint8_t i = 0; i < n; i++, pos++) {
+        uint16_t keycode = keycodes[2 * i] | keycodes[2 * i + 1] << 8;
+        uint8_t  index   = override_lower_bound(layer, pos);
+        keymap_override_t *e = &store.entries[index];
+        bool exists = position_overridden(layer, pos); // Bits are only rebuilt below
+
+        if (keycode == keycode_default(layer, pos)) {
+            if (exists) {
+                memmove(e, e + 1, (store.count - index - 1) * sizeof(*e));
+                store.count--;
+            }
+        } else {
+            if (!exists) {
+                memmove(e + 1, e, (store.count - index) * sizeof(*e));
+                store.count++;
+                e->layer = layer;
+                e->pos   = pos;
+            }
+            e->keycode = keycode;
+        }
+    }
+    overrides_rebuild();
+    return true;
+}
+
+// ==== PUBLIC FUNCTIONS ====
+
+/**
+ * @brief QMK's keymap lookup, with overrides
+ *
+ * Replaces the weak default from keymap_introspection.c.
+ */
+uint16_t keycode_at_keymap_location(uint8_t layer, uint8_t row, uint8_t col) {
+    if (layer < KEYMAP_OVERRIDES_LAYERS && (layer_mask & (1 << layer)) && row < MATRIX_ROWS && col < MATRIX_COLS) {
+        uint8_t pos = row * MATRIX_COLS + col;
+        if (position_overridden(layer, pos)) {
+            return store.entries[override_lower_bound(layer, pos)].keycode;
+        }
+    }
+    return keycode_at_keymap_location_raw(layer, row, col);
+}
+
+void keymap_overrides_init(void) {
+    eeconfig_read_user_datablock(&store, EEPROM_KEYMAP_OVERRIDES_OFFSET, sizeof(store));
+
+    // A fresh or reset datablock reads as zeros, which also fails this check
+    if (!overrides_valid()) {
+        overrides_reset();
+        flush_pos = 0;
+        flush_end = STORE_HEADER;
+    }
+    overrides_rebuild();
+}
+
+void keymap_overrides_task(void) {
+    // Write back one chunk per scan so a flush never stalls the matrix
+    if (flush_pos < flush_end) {
+        uint16_t n = flush_end - flush_pos;
+        if (n > KEYMAP_OVERRIDES_FLUSH_CHUNK) {
+            n = KEYMAP_OVERRIDES_FLUSH_CHUNK;
+        }
+        eeconfig_update_user_datablock((const uint8_t *)&store + flush_pos, EEPROM_KEYMAP_OVERRIDES_OFFSET + flush_pos, n);
+        flush_pos += n;
+        return;
+    }
+
+    if (dirty && timer_elapsed32(flush_timer) >= KEYMAP_OVERRIDES_FLUSH_MS) {
+        dirty     = false;
+        flush_pos = 0;
+        flush_end = STORE_HEADER + store.count * sizeof(keymap_override_t);
+    }
+}
+
+void keymap_overrides_raw_hid(uint8_t *data, uint8_t length) {
+    uint8_t layer = data[2];
+    uint8_t pos   = data[3];
+    uint8_t n     = data[4];
+
+    switch (data[1]) {
+        case KEYMAP_OVERRIDES_INFO:
+            memset(data + 2, 0, length - 2);
+            data[2] = overrides_layers();
+            data[3] = MATRIX_ROWS;
+            data[4] = MATRIX_COLS;
+            data[5] = KEYMAP_OVERRIDES_MAX;
+            data[6] = store.count;
+            break;
+
+        case KEYMAP_OVERRIDES_READ:
+        case KEYMAP_OVERRIDES_WRITE:
+            if (layer >= overrides_layers() || !n || n > KEYMAP_OVERRIDES_CHUNK || pos + n > POSITIONS) {
+                data[1] = HID_STATUS_BAD_ARG;
+                return;
+            }
+            if (data[1] == KEYMAP_OVERRIDES_WRITE) {
+                if (!overrides_write(layer, pos, n, data + 5)) {
+                    data[1] = HID_STATUS_BAD_ARG;
+                    return;
+                }
+                EVLOG_INFO(EV_KEYMAP_WRITE, n, store.count);
+                dirty       = true;
+                flush_timer = timer_read32();
+                memset(data + 2, 0, length - 2);
+                data[2] = store.count;
+                break;
+            }
+            memset(data + 2, 0, length - 2);
+            data[2] = n;
+            for (uint8_t i = 0; i < n; i++) {
+                uint16_t keycode = keycode_at_keymap_location(layer, (pos + i) / MATRIX_COLS, (pos + i) % MATRIX_COLS);
+                if (position_overridden(layer, pos + i)) {
+                    data[3 + i / 8] |= 1 << (i % 8);
+                }
+                data[5 + 2 * i] = keycode;
+                data[6 + 2 * i] = keycode >> 8;
+            }
+            break;
+
+        case KEYMAP_OVERRIDES_RESET:
+            overrides_reset();
+            EVLOG_INFO(EV_KEYMAP_WRITE, 0, 0);
+            dirty     = false;
+            flush_pos = 0; // Write the empty header out now rather than after the delay
+            flush_end = STORE_HEADER;
+            memset(data + 2, 0, length - 2);
+            break;
+
+        default:
+            data[1] = HID_STATUS_BAD_ARG;
+            return;
+    }
+    data[1] = HID_STATUS_OK;
+}
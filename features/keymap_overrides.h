@@ -0,0 +1,142 @@
+/**
+ * @file keymap_overrides.h
+ * @brief Runtime key bindings layered over keymaps.h
+ *
+ * Any position of any layer can be rebound over raw HID without a reflash
+ * (tools/keymap_overrides.py). Overrides are stored in the EEPROM user
+ * datablock and cached in RAM as a sorted list plus, per layer, a bitmap of
+ * overridden positions and one bit saying whether the layer has any.
+ *
+ * Key resolution goes through QMK's weak keycode_at_keymap_location(). A
+ * layer without overrides costs a single bit test before the usual PROGMEM
+ * read; a position whose bitmap bit is clear costs one more. Only overridden
+ * positions search the list.
+ *
+ * Writing a position's compiled-in keycode removes its override, so the
+ * keymap can always be put back one key at a time, or all at once with
+ * KEYMAP_OVERRIDES_RESET.
+ *
+ * Usage in keymap.c:
+ *   1. Set KEYMAP_OVERRIDES_ENABLE = yes in rules.mk
+ *   2. Call keymap_overrides_init() from keyboard_post_init_user()
+ *   3. Call keymap_overrides_task() from matrix_scan_user()
+ *   4. Route HID_CMD_KEYMAP packets to keymap_overrides_raw_hid()
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+// ==== CONFIGURATION ====
+
+/**
+ * @brief Layout version of keymap_overrides_t; bump on any change to drop stored overrides
+ */
+#define KEYMAP_OVERRIDES_VERSION 1
+
+/**
+ * @brief Most positions that can be overridden at once, across all layers
+ */
+#ifndef KEYMAP_OVERRIDES_MAX
+#    define KEYMAP_OVERRIDES_MAX 64
+#endif
+
+/**
+ * @brief Layers that can be overridden: 0 to KEYMAP_OVERRIDES_LAYERS - 1
+ */
+#ifndef KEYMAP_OVERRIDES_LAYERS
+#    define KEYMAP_OVERRIDES_LAYERS 16
+#endif
+
+/**
+ * @brief Quiet time after the last change before overrides are written back
+ */
+#ifndef KEYMAP_OVERRIDES_FLUSH_MS
+#    define KEYMAP_OVERRIDES_FLUSH_MS 1000
+#endif
+
+/**
+ * @brief Bytes written to EEPROM per scan while a flush is in progress
+ */
+#ifndef KEYMAP_OVERRIDES_FLUSH_CHUNK
+#    define KEYMAP_OVERRIDES_FLUSH_CHUNK 32
+#endif
+
+/**
+ * @brief Keycodes per KEYMAP_OVERRIDES_READ or KEYMAP_OVERRIDES_WRITE packet
+ */
+#define KEYMAP_OVERRIDES_CHUNK 13
+
+// ==== DATA ====
+
+/**
+ * @brief One overridden position
+ *
+ * pos is row * MATRIX_COLS + col, the order positions are read and written
+ * in over raw HID.
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t  layer;   /**< Layer number */
+    uint8_t  pos;     /**< Matrix position */
+    uint16_t keycode; /**< Keycode used instead of keymaps[layer] */
+} keymap_override_t;
+
+/**
+ * @brief All overrides, stored verbatim in EEPROM
+ *
+ * Entries are sorted by layer, then position; only the first count are
+ * valid and only those are written back.
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t           version; /**< KEYMAP_OVERRIDES_VERSION */
+    uint8_t           rows;    /**< MATRIX_ROWS */
+    uint8_t           cols;    /**< MATRIX_COLS */
+    uint8_t           count;   /**< Valid entries */
+    keymap_override_t entries[KEYMAP_OVERRIDES_MAX];
+} keymap_overrides_t;
+
+/**
+ * @enum keymap_overrides_op
+ * @brief Second byte of a HID_CMD_KEYMAP request
+ *
+ * Keycodes are little endian. READ and WRITE cover n consecutive positions
+ * from pos, n at most KEYMAP_OVERRIDES_CHUNK; a range may run over the end
+ * of a row but not past the last position.
+ */
+enum keymap_overrides_op {
+    KEYMAP_OVERRIDES_INFO  = 0, /**< -> [layers][rows][cols][max][count] */
+    KEYMAP_OVERRIDES_READ  = 1, /**< [layer][pos][n] -> [n][overridden bits lo][hi][keycode...] */
+    KEYMAP_OVERRIDES_WRITE = 2, /**< [layer][pos][n][keycode...] -> [count]; BAD_ARG if it won't fit */
+    KEYMAP_OVERRIDES_RESET = 3, /**< Drop every override, in RAM and EEPROM */
+};
+
+#ifdef KEYMAP_OVERRIDES_ENABLE
+
+/**
+ * @brief Load the overrides from EEPROM, dropping them if the layout changed
+ */
+void keymap_overrides_init(void);
+
+/**
+ * @brief Write changed overrides back to EEPROM
+ *
+ * Call from matrix_scan_user(). Does nothing most scans; while a flush is in
+ * progress it writes KEYMAP_OVERRIDES_FLUSH_CHUNK bytes per call.
+ */
+void keymap_overrides_task(void);
+
+/**
+ * @brief Handle a HID_CMD_KEYMAP request in place
+ *
+ * @param data The 32-byte packet; the response is written over it
+ * @param length Packet length
+ */
+void keymap_overrides_raw_hid(uint8_t *data, uint8_t length);
+
+#else // KEYMAP_OVERRIDES_ENABLE
+
+// Disabled in rules.mk: no-op stubs so callers compile away.
+static inline void keymap_overrides_init(void) {}
+static inline void keymap_overrides_task(void) {}
+
+#endif // KEYMAP_OVERRIDES_ENABLE
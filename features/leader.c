@@ -0,0 +1,180 @@
+/**
+ * @file leader.c
+ * @brief Implementation of the trie-based leader key engine
+ *
+ * The whole matcher state is one trie index: each key either moves it to a
+ * child node or ends the sequence. See tools/leader_trie.py for the node
+ * layout.
+ */
+
+#include "features/leader.h"
+#include "custom_keycodes.h"
+#include "leader_sequences.h"
+#include "features/leader_trie.h"
+#include "features/event_log.h"
+
+// Catch leader_sequences.h edits that were not followed by tools/leader_trie.py
+#define X(seq, kc) +1
+_Static_assert(0 LEADER_SEQUENCES(X) == LEADER_TRIE_SEQUENCES, "leader_trie.h is stale, run tools/leader_trie.py");
+#undef X
+#define X(seq, kc) +(sizeof(seq) - 1)
+_Static_assert(0 LEADER_SEQUENCES(X) == LEADER_TRIE_CHARS, "leader_trie.h is stale, run tools/leader_trie.py");
+#undef X
+
+// ==== STATE VARIABLES ====
+
+/**
+ * @brief Whether a sequence is being typed
+ */
+static bool leader_active = false;
+
+/**
+ * @brief Trie index of the node matched so far (0 = root)
+ */
+static uint16_t leader_node = 0;
+
+/**
+ * @brief Keys matched so far, for the event log
+ */
+static uint8_t leader_depth = 0;
+
+/**
+ * @brief Time of the last key in the sequence
+ */
+static uint16_t leader_timer = 0;
+
+/**
+ * @brief Keys whose press was consumed here, by typed keycode
+ *
+ * Only their releases are consumed too: a key held down since before
+ * QK_LEAD has to come up, or it stays stuck on the host.
+ */
+static uint32_t leader_consumed[256 / 32];
+
+// ==== HELPER FUNCTIONS ====
+
+/**
+ * @brief Find the child of a node reached by a key
+ *
+ * @return uint16_t Trie index of the child, or 0 (the root is nobody's child)
+ */
+static uint16_t leader_find_child(uint16_t node, uint16_t keycode) {
+    uint16_t header = pgm_read_word(&leader_trie[node]);
+    uint16_t i      = node + ((header & LEADER_TRIE_ACTION) ? 2 : 1);
+
+    for (uint8_t n = header & LEADER_TRIE_CHILDREN; n; n--, i += 2) {
+        if (pgm_read_word(&leader_trie[i]) == keycode) {
+            return pgm_read_word(&leader_trie[i + 1]);
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Tap a keycode as if it had been pressed on the keyboard
+ *
+ * Custom keycodes are handled by process_record_user(); anything it lets
+ * through is tapped as a plain (optionally modded) keycode.
+ */
+static void leader_fire(uint16_t keycode) {
+    keyrecord_t record = {.event = MAKE_KEYEVENT(KEYLOC_COMBO, KEYLOC_COMBO, true)};
+    if (process_record_user(keycode, &record) && keycode <= QK_MODS_MAX) {
+        tap_code16(keycode);
+    }
+    record.event.pressed = false;
+    process_record_user(keycode, &record);
+}
+
+/**
+ * @brief End the sequence, firing the current node's action if it has one
+ */
+static void leader_finish(void) {
+    leader_active = false;
+
+    uint16_t header = pgm_read_word(&leader_trie[leader_node]);
+    if (leader_depth && (header & LEADER_TRIE_ACTION)) {
+        uint16_t action = pgm_read_word(&leader_trie[leader_node + 1]);
+        EVLOG_INFO(EV_LEADER_DONE, action, leader_depth);
+        leader_fire(action);
+    } else {
+        EVLOG_INFO(EV_LEADER_FAIL, leader_depth, 0);
+    }
+}
+
+/**
+ * @brief The key a press types, or KC_NO for keys that only modify others
+ */
+static uint16_t leader_typed_keycode(uint16_t keycode, keyrecord_t *record) {
+    if (IS_QK_MOD_TAP(keycode)) {
+        return record->tap.count ? QK_MOD_TAP_GET_TAP_KEYCODE(keycode) : KC_NO;
+    }
+    if (IS_QK_LAYER_TAP(keycode)) {
+        return record->tap.count ? QK_LAYER_TAP_GET_TAP_KEYCODE(keycode) : KC_NO;
+    }
+    if (IS_QK_MODS(keycode)) {
+        return QK_MODS_GET_BASIC_KEYCODE(keycode);
+    }
+    if (IS_MODIFIER_KEYCODE(keycode) || !IS_BASIC_KEYCODE(keycode)) {
+        return KC_NO; // Modifiers, layer keys and custom keycodes
+    }
+    return keycode;
+}
+
+// ==== PUBLIC FUNCTIONS ====
+
+bool process_leader(uint16_t keycode, keyrecord_t *record) {
+    if (keycode == QK_LEAD) {
+        if (record->event.pressed) {
+            EVLOG_INFO(EV_LEADER_START, 0, 0);
+            leader_active = true;
+            leader_node   = 0;
+            leader_depth  = 0;
+            leader_timer  = timer_read();
+        }
+        return false;
+    }
+
+    // Let modifiers, held dual-role keys and layer switches work as usual
+    uint16_t typed = leader_typed_keycode(keycode, record);
+    if (typed == KC_NO) {
+        return true;
+    }
+    uint32_t bit = 1UL << (typed & 31);
+    if (!record->event.pressed) {
+        if (leader_consumed[typed >> 5] & bit) {
+            leader_consumed[typed >> 5] &= ~bit;
+            return false;
+        }
+        return true;
+    }
+
+    if (!leader_active) {
+        return true;
+    }
+    leader_consumed[typed >> 5] |= bit;
+
+    leader_node = leader_find_child(leader_node, typed);
+    if (!leader_node) {
+        EVLOG_INFO(EV_LEADER_FAIL, leader_depth, typed);
+        leader_active = false;
+        return false;
+    }
+    leader_depth++;
+    leader_timer = timer_read();
+
+    // Nothing longer starts with this sequence: no need to wait for the timeout
+    if (!(pgm_read_word(&leader_trie[leader_node]) & LEADER_TRIE_CHILDREN)) {
+        leader_finish();
+    }
+    return false;
+}
+
+void leader_task(void) {
+    if (leader_active && timer_elapsed(leader_timer) > LEADER_TIMEOUT) {
+        leader_finish();
+    }
+}
+
+bool is_leader_active(void) {
+    return leader_active;
+}
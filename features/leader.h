@@ -0,0 +1,78 @@
+/**
+ * @file leader.h
+ * @brief Trie-based leader key engine
+ *
+ * Replaces QMK's leader feature for the QK_LEAD keys on the _QW and _RG
+ * layers. Sequences are declared in leader_sequences.h and compiled by
+ * tools/leader_trie.py into a PROGMEM trie (features/leader_trie.h), which
+ * is walked one node per key:
+ *   - the cost of each key depends only on the branching at that point in
+ *     the trie, not on the number of sequences
+ *   - a sequence with no longer continuation fires on its last key, without
+ *     waiting for LEADER_TIMEOUT
+ *   - a key that matches nothing cancels the sequence straight away
+ *
+ * A matched sequence fires its keycode through process_record_user(), so
+ * run commands, virtual desktop switches and secrets behave exactly as if
+ * their key had been pressed.
+ *
+ * Usage in keymap.c:
+ *   1. Set LEADER_TRIE_ENABLE = yes in rules.mk (leave LEADER_ENABLE = no)
+ *   2. Call process_leader(keycode, record) first in process_record_user()
+ *   3. Call leader_task() from matrix_scan_user()
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+/**
+ * @brief Time allowed between keys of a sequence, in milliseconds
+ */
+#ifndef LEADER_TIMEOUT
+#    define LEADER_TIMEOUT 700
+#endif
+
+/**
+ * @brief Trie node header flag: a sequence ends at this node
+ */
+#define LEADER_TRIE_ACTION 0x8000
+
+/**
+ * @brief Trie node header mask: number of children
+ */
+#define LEADER_TRIE_CHILDREN 0x00FF
+
+#ifdef LEADER_TRIE_ENABLE
+
+/**
+ * @brief Process keycodes for the leader engine
+ *
+ * Starts a sequence on QK_LEAD and consumes every key pressed while one is
+ * active, and later the releases of those keys only.
+ *
+ * @param keycode The keycode to process
+ * @param record The keyrecord containing event information
+ * @return false if the key was consumed, true otherwise
+ */
+bool process_leader(uint16_t keycode, keyrecord_t *record);
+
+/**
+ * @brief Fire or cancel a sequence that has timed out
+ *
+ * Call from matrix_scan_user().
+ */
+void leader_task(void);
+
+/**
+ * @brief Check if a leader sequence is being typed
+ */
+bool is_leader_active(void);
+
+#else // LEADER_TRIE_ENABLE
+
+static inline bool process_leader(uint16_t keycode, keyrecord_t *record) { return true; }
+static inline void leader_task(void) {}
+static inline bool is_leader_active(void) { return false; }
+
+#endif // LEADER_TRIE_ENABLE
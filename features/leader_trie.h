@@ -0,0 +1,34 @@
+// Generated by tools/leader_trie.py from leader_sequences.h - do not edit.
+// Layout is described in tools/leader_trie.py.
+
+#pragma once
+
+#define LEADER_TRIE_SEQUENCES 20
+#define LEADER_TRIE_CHARS 35
+#define LEADER_TRIE_MAX_DEPTH 2
+#define LEADER_TRIE_SIZE 84
+
+static const uint16_t leader_trie[LEADER_TRIE_SIZE] PROGMEM = {
+    /* root */ 0x0006, KC_B, 13, KC_D, 15, KC_E, 34, KC_N, 36, KC_P, 38, KC_T, 52,
+    /* 'b'  */ 0x8000, RUN_BROWSER,
+    /* 'd'  */ 0x0009, KC_1, 54, KC_2, 56, KC_3, 58, KC_4, 60, KC_5, 62, KC_6, 64, KC_7, 66, KC_8, 68, KC_9, 70,
+    /* 'e'  */ 0x8000, RUN_FILES,
+    /* 'n'  */ 0x8000, RUN_NOTEPAD,
+    /* 'p'  */ 0x8006, PIN_ENTRY, KC_P, 72, KC_S, 74, KC_1, 76, KC_2, 78, KC_3, 80, KC_4, 82,
+    /* 't'  */ 0x8000, RUN_WT,
+    /* 'd1' */ 0x8000, VD_1,
+    /* 'd2' */ 0x8000, VD_2,
+    /* 'd3' */ 0x8000, VD_3,
+    /* 'd4' */ 0x8000, VD_4,
+    /* 'd5' */ 0x8000, VD_5,
+    /* 'd6' */ 0x8000, VD_6,
+    /* 'd7' */ 0x8000, VD_7,
+    /* 'd8' */ 0x8000, VD_8,
+    /* 'd9' */ 0x8000, VD_9,
+    /* 'pp' */ 0x8000, E_PHRASE,
+    /* 'ps' */ 0x8000, SECRET_SELECT,
+    /* 'p1' */ 0x8000, E_PASS1,
+    /* 'p2' */ 0x8000, E_PASS2,
+    /* 'p3' */ 0x8000, E_PASS3,
+    /* 'p4' */ 0x8000, E_PASS4,
+};
@@ -0,0 +1,452 @@
+/**
+ * @file macro_recorder.c
+ * @brief Implementation of the runtime macro recorder
+ */
+
+#include "features/macro_recorder.h"
+#include "features/eeprom_layout.h"
+#include "features/event_log.h"
+#include "features/secrets_manager.h"
+#include "custom_keycodes.h"
+#include <stdlib.h>
+#include <string.h>
+
+_Static_assert(sizeof(macro_slot_t) <= EEPROM_MACROS_SLOT_SIZE, "macro_slot_t outgrew its EEPROM slot, see eeprom_layout.h");
+_Static_assert(MACRO_RECORDER_SLOTS <= EEPROM_MACROS_SLOTS, "more macro slots than EEPROM slots, see eeprom_layout.h");
+_Static_assert(MACRO_RECORDER_SIZE <= 255, "macro_slot_t.length is one byte");
+
+/**
+ * @brief Longest token: header, two keycode bytes, a three-byte varint
+ */
+#define TOKEN_MAX 6
+
+/**
+ * @brief Largest delta stored, in ticks (a little over eight minutes)
+ */
+#define DELTA_MAX 0xFFFF
+
+/**
+ * @brief No pair to extend into a run
+ */
+#define NO_POS 0xFF
+
+/**
+ * @brief Bytes written to EEPROM per scan while a save is in progress
+ */
+#define SAVE_CHUNK 32
+
+enum macro_mode {
+    MODE_IDLE,      /**< Nothing going on */
+    MODE_RECORDING, /**< Appending key events to the buffer */
+    MODE_PLAYING,   /**< Emitting the buffer's events */
+    MODE_SAVING,    /**< Writing the buffer to its EEPROM slot */
+};
+
+/**
+ * @brief One decoded event
+ */
+typedef struct {
+    uint16_t keycode;
+    bool     pressed;
+    uint16_t delta; /**< Ticks since the previous event */
+} macro_event_t;
+
+// ==== STATE VARIABLES ====
+
+/**
+ * @brief The macro being recorded, replayed or saved, and its slot
+ */
+static macro_slot_t buffer;
+static uint8_t      buffer_slot = 0;
+static uint8_t      mode        = MODE_IDLE;
+
+/**
+ * @brief Recording state
+ *
+ * record_clock is the time in ticks a replay will have reached after the events
+ * written so far, so rounding and runs never drift. The pair is the last
+ * tap written as a press token directly followed by its release; pair_end
+ * is where a repeat of it would start, and run_pos the run token already
+ * extending it, if any.
+ */
+static uint32_t record_start;
+static uint32_t record_clock;
+static uint16_t last_press;
+static uint8_t  press_pos;
+static uint16_t press_delta;
+static uint32_t press_clock;
+static uint16_t pair_keycode;
+static uint16_t pair_down, pair_up;
+static uint8_t  pair_end = NO_POS;
+static uint8_t  run_pos  = NO_POS;
+
+/**
+ * @brief Replay state
+ *
+ * The same last_press and pair as the recorder tracked, rebuilt while
+ * decoding, plus the event due next and the keys held down.
+ */
+static uint8_t       play_pos;
+static uint8_t       run_left;
+static bool          run_release;
+static bool          play_fast;
+static macro_event_t next_event;
+static uint32_t      next_due;
+static uint32_t      last_emit;
+static bool          decoded_press;
+static uint16_t      held[MACRO_RECORDER_HELD];
+static uint8_t       held_count;
+
+/**
+ * @brief Save state: next byte of buffer to write, and the end
+ */
+static uint8_t save_pos, save_end;
+
+// ==== HELPER FUNCTIONS ====
+
+static inline uint16_t slot_offset(uint8_t slot) {
+    return EEPROM_MACROS_OFFSET + slot * EEPROM_MACROS_SLOT_SIZE;
+}
+
+/**
+ * @brief What a key did, or KC_NO if it isn't recorded
+ *
+ * Tapped dual-role keys become their tap keycode and held mod-taps their
+ * modifiers, as a QK_MODS keycode with no key (like process_key_history()).
+ */
+static uint16_t macro_normalize(uint16_t keycode, keyrecord_t *record) {
+    switch (keycode) {
+        case QK_MOD_TAP ... QK_MOD_TAP_MAX:
+            if (record->tap.count == 0) {
+                return QK_MODS | QK_MOD_TAP_GET_MODS(keycode) << 8;
+            }
+            return QK_MOD_TAP_GET_TAP_KEYCODE(keycode);
+        case QK_LAYER_TAP ... QK_LAYER_TAP_MAX:
+            return record->tap.count ? QK_LAYER_TAP_GET_TAP_KEYCODE(keycode) : KC_NO;
+        case KC_A ... KC_RGUI:
+        case QK_MODS ... QK_MODS_MAX:
+            return keycode;
+        default:
+            return KC_NO; // Layer keys, custom keycodes, QK_BOOT, ...
+    }
+}
+
+/**
+ * @brief Encode an event into out, returning its length
+ */
+static uint8_t macro_encode(uint8_t *out, uint16_t keycode, bool pressed, uint32_t delta) {
+    uint8_t kind = keycode == last_press ? MACRO_SAME : keycode <= 0xFF ? MACRO_BASIC : MACRO_FULL;
+    uint8_t n    = 1;
+
+    out[0] = MACRO_TOKEN(kind, pressed, delta < MACRO_DELTA_VARINT ? delta : MACRO_DELTA_VARINT);
+    if (kind != MACRO_SAME) {
+        out[n++] = keycode;
+        if (kind == MACRO_FULL) {
+            out[n++] = keycode >> 8;
+        }
+    }
+    if (delta >= MACRO_DELTA_VARINT) {
+        delta -= MACRO_DELTA_VARINT;
+        do {
+            out[n++] = (delta & 0x7F) | (delta > 0x7F ? 0x80 : 0);
+            delta >>= 7;
+        } while (delta);
+    }
+    return n;
+}
+
+static void macro_record_stop(void) {
+    mode     = MODE_SAVING;
+    save_pos = 0;
+    save_end = offsetof(macro_slot_t, events) + buffer.length;
+    EVLOG_INFO(EV_MACRO_SAVE, buffer_slot + 1, buffer.length);
+}
+
+static void macro_record(uint16_t keycode, bool pressed) {
+    uint32_t now = timer_elapsed32(record_start) / MACRO_RECORDER_TICK_MS;
+    if (!buffer.length) {
+        record_clock = now; // No wait before the first key
+    }
+    uint32_t delta = now - record_clock;
+    if (delta > DELTA_MAX) {
+        delta = DELTA_MAX;
+    }
+
+    // A release straight after its press may repeat the previous tap. Both
+    // its press and its release must be within the slack of where the
+    // repeat would put them, so replay timing stays within it too.
+    if (!pressed && keycode == last_press && press_pos != NO_POS && press_pos == pair_end && keycode == pair_keycode &&
+        abs((int)press_delta - (int)pair_down) <= MACRO_RECORDER_RUN_SLACK &&
+        abs((int)(press_delta + delta) - (int)(pair_down + pair_up)) <= MACRO_RECORDER_RUN_SLACK) {
+        if (run_pos != NO_POS && (buffer.events[run_pos] & 0x3F) < MACRO_RUN_MAX - 1) {
+            buffer.events[run_pos]++;
+            buffer.length = press_pos;
+        } else {
+            run_pos                  = press_pos;
+            buffer.events[press_pos] = MACRO_TOKEN(MACRO_RUN, 0, 0);
+            buffer.length            = press_pos + 1;
+        }
+        record_clock = press_clock + pair_down + pair_up;
+        pair_end     = buffer.length;
+        press_pos    = NO_POS;
+        return;
+    }
+
+    uint8_t token[TOKEN_MAX];
+    uint8_t n = macro_encode(token, keycode, pressed, delta);
+    if (buffer.length + n > MACRO_RECORDER_SIZE) {
+        macro_record_stop();
+        return;
+    }
+
+    if (pressed) {
+        press_pos   = buffer.length;
+        press_delta = delta;
+        press_clock = record_clock;
+        last_press  = keycode;
+    } else if (keycode == last_press && press_pos != NO_POS) {
+        pair_keycode = keycode;
+        pair_down    = press_delta;
+        pair_up      = delta;
+        pair_end     = buffer.length + n;
+        run_pos      = NO_POS;
+        press_pos    = NO_POS;
+    } else {
+        press_pos = NO_POS;
+    }
+    memcpy(buffer.events + buffer.length, token, n);
+    buffer.length += n;
+    record_clock += delta;
+}
+
+/**
+ * @brief Decode the next event into next_event; false at the end
+ */
+static bool macro_decode(void) {
+    if (run_left) {
+        next_event.keycode = pair_keycode;
+        next_event.pressed = !run_release;
+        next_event.delta   = run_release ? pair_up : pair_down;
+        run_left -= run_release;
+        run_release = !run_release;
+        return true;
+    }
+    if (play_pos >= buffer.length) {
+        return false;
+    }
+
+    uint8_t  token = buffer.events[play_pos++];
+    uint8_t  kind  = MACRO_TOKEN_KIND(token);
+    uint16_t keycode;
+    if (kind == MACRO_RUN) {
+        run_left    = (token & 0x3F) + 1;
+        run_release = false;
+        return macro_decode();
+    }
+    keycode = kind == MACRO_SAME ? last_press : buffer.events[play_pos++];
+    if (kind == MACRO_FULL) {
+        keycode |= buffer.events[play_pos++] << 8;
+    }
+
+    uint32_t delta = MACRO_TOKEN_DELTA(token);
+    if (delta == MACRO_DELTA_VARINT) {
+        uint8_t shift = 0, byte;
+        do {
+            byte = buffer.events[play_pos++];
+            delta += (uint32_t)(byte & 0x7F) << shift;
+            shift += 7;
+        } while ((byte & 0x80) && play_pos < buffer.length);
+    }
+
+    // Track the last press and tap exactly as macro_record() did
+    bool pressed = MACRO_TOKEN_PRESSED(token);
+    if (pressed) {
+        press_delta = delta;
+        last_press  = keycode;
+    } else if (decoded_press && keycode == last_press) {
+        pair_keycode = keycode;
+        pair_down    = press_delta;
+        pair_up      = delta;
+    }
+    decoded_press = pressed;
+
+    next_event.keycode = keycode;
+    next_event.pressed = pressed;
+    next_event.delta   = delta;
+    return true;
+}
+
+/**
+ * @brief Press or release a recorded keycode
+ */
+static void macro_emit(uint16_t keycode, bool pressed) {
+    if ((keycode & 0xFF) == KC_NO) {
+        // A held mod-tap: its modifiers, without a key
+        uint8_t mods = QK_MODS_GET_MODS(keycode);
+        mods         = mods & 0x10 ? (mods & 0x0F) << 4 : mods;
+        if (pressed) {
+            register_mods(mods);
+        } else {
+            unregister_mods(mods);
+        }
+        send_keyboard_report();
+    } else if (pressed) {
+        register_code16(keycode);
+    } else {
+        unregister_code16(keycode);
+    }
+}
+
+static void macro_hold(uint16_t keycode, bool pressed) {
+    uint8_t i = 0;
+    while (i < held_count && held[i] != keycode) {
+        i++;
+    }
+    if (pressed && i == held_count) {
+        if (held_count == MACRO_RECORDER_HELD) {
+            macro_emit(held[0], false); // Out of room: let go of the oldest
+            memmove(held, held + 1, --held_count * sizeof(held[0]));
+        }
+        held[held_count++] = keycode;
+    } else if (!pressed && i < held_count) {
+        memmove(held + i, held + i + 1, (--held_count - i) * sizeof(held[0]));
+    }
+}
+
+static void macro_play_stop(void) {
+    while (held_count) {
+        macro_emit(held[--held_count], false);
+    }
+    mode = MODE_IDLE;
+}
+
+static void macro_play_start(uint8_t slot) {
+    eeconfig_read_user_datablock(&buffer, slot_offset(slot), sizeof(buffer));
+    if (buffer.version != MACRO_RECORDER_VERSION || buffer.length > MACRO_RECORDER_SIZE) {
+        return;
+    }
+    buffer_slot   = slot;
+    play_pos      = 0;
+    run_left      = 0;
+    last_press    = KC_NO;
+    decoded_press = false;
+    held_count    = 0;
+    play_fast     = false;
+    if (macro_decode()) {
+        mode      = MODE_PLAYING;
+        next_due  = timer_read32();
+        last_emit = next_due - 1;
+        EVLOG_INFO(EV_MACRO_PLAY, slot + 1, 0);
+    }
+}
+
+static void macro_record_start(uint8_t slot) {
+    memset(&buffer, 0, sizeof(buffer));
+    buffer.version = MACRO_RECORDER_VERSION;
+    buffer_slot    = slot;
+    record_start   = timer_read32();
+    record_clock   = 0;
+    last_press     = KC_NO;
+    press_pos      = NO_POS;
+    pair_end       = NO_POS;
+    run_pos        = NO_POS;
+    mode           = MODE_RECORDING;
+}
+
+// ==== PUBLIC FUNCTIONS ====
+
+void macro_recorder_init(void) {
+    for (uint8_t i = 0; i < MACRO_RECORDER_SLOTS; i++) {
+        uint8_t header[2];
+        eeconfig_read_user_datablock(header, slot_offset(i), sizeof(header));
+        if (header[0] != MACRO_RECORDER_VERSION || header[1] > MACRO_RECORDER_SIZE) {
+            // Fresh datablock, or an older layout: store an empty macro
+            header[0] = MACRO_RECORDER_VERSION;
+            header[1] = 0;
+            eeconfig_update_user_datablock(header, slot_offset(i), sizeof(header));
+        }
+    }
+}
+
+bool process_macro_recorder(uint16_t keycode, keyrecord_t *record) {
+    switch (keycode) {
+        case MACRO_REC_1 ... MACRO_REC_4:
+            if (record->event.pressed && keycode - MACRO_REC_1 < MACRO_RECORDER_SLOTS) {
+                if (mode == MODE_RECORDING) {
+                    macro_record_stop();
+                } else if (mode == MODE_IDLE && !is_secret_input_mode()) {
+                    macro_record_start(keycode - MACRO_REC_1);
+                }
+            }
+            return false;
+
+        case MACRO_PLAY_1 ... MACRO_PLAY_4:
+            if (record->event.pressed && keycode - MACRO_PLAY_1 < MACRO_RECORDER_SLOTS) {
+                if (mode == MODE_IDLE) {
+                    macro_play_start(keycode - MACRO_PLAY_1);
+                } else if (mode == MODE_PLAYING && buffer_slot == keycode - MACRO_PLAY_1 && !play_fast) {
+                    play_fast = true;
+                    EVLOG_INFO(EV_MACRO_PLAY, buffer_slot + 1, 1);
+                }
+            }
+            return false;
+    }
+
+    if (mode == MODE_RECORDING && is_secret_input_mode()) {
+        macro_recorder_discard(); // Secrets ran ahead of us, but releases still get here
+    } else if (mode == MODE_RECORDING) {
+        keycode = macro_normalize(keycode, record);
+        if (keycode != KC_NO) {
+            macro_record(keycode, record->event.pressed);
+        }
+    }
+    return true;
+}
+
+void macro_recorder_task(void) {
+    switch (mode) {
+        case MODE_SAVING: {
+            // Written back one chunk per scan so saving never stalls the matrix
+            uint8_t n = save_end - save_pos < SAVE_CHUNK ? save_end - save_pos : SAVE_CHUNK;
+            eeconfig_update_user_datablock((const uint8_t *)&buffer + save_pos, slot_offset(buffer_slot) + save_pos, n);
+            save_pos += n;
+            if (save_pos == save_end) {
+                mode = MODE_IDLE;
+            }
+            break;
+        }
+
+        case MODE_PLAYING: {
+            uint32_t now = timer_read32();
+            if (play_fast ? now == last_emit : (int32_t)(now - next_due) < 0) {
+                return;
+            }
+            macro_emit(next_event.keycode, next_event.pressed);
+            macro_hold(next_event.keycode, next_event.pressed);
+            last_emit = now;
+            if (!macro_decode()) {
+                macro_play_stop();
+                return;
+            }
+            // Due relative to when the last event was due, so late scans don't add up
+            next_due = (play_fast ? now : next_due) + next_event.delta * MACRO_RECORDER_TICK_MS;
+            break;
+        }
+    }
+}
+
+bool macro_recorder_recording(void) {
+    return mode == MODE_RECORDING;
+}
+
+bool macro_recorder_playing(void) {
+    return mode == MODE_PLAYING;
+}
+
+void macro_recorder_discard(void) {
+    if (mode == MODE_RECORDING) {
+        EVLOG_INFO(EV_MACRO_DROP, buffer_slot + 1, buffer.length);
+        memset(&buffer, 0, sizeof(buffer));
+        mode = MODE_IDLE;
+    }
+}
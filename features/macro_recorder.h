@@ -0,0 +1,171 @@
+/**
+ * @file macro_recorder.h
+ * @brief Record key sequences at runtime and replay them
+ *
+ * MACRO_REC_n starts recording into slot n; any MACRO_REC key stops it and
+ * saves the slot to EEPROM. MACRO_PLAY_n replays slot n with its recorded
+ * timing, and pressing it again during the replay finishes it at full
+ * speed.
+ *
+ * Keys are recorded as what they did rather than where they are: a tapped
+ * home row mod is its letter and a held one its modifier, as in
+ * process_key_history(). Layer keys and custom keycodes are not recorded,
+ * so a replay never unlocks secrets or starts another macro.
+ *
+ * Secret input is never captured. Starting PIN entry or SECRET_SELECT drops
+ * a recording in progress without saving it, and no recording starts or
+ * takes keys while either is active, so neither PIN nor tag digits can
+ * reach EEPROM as a macro.
+ *
+ * Events are stored as a byte stream, one token per event:
+ *
+ *     [kind:2][pressed:1][delta:5] [keycode: 0, 1 or 2 bytes] [varint]
+ *
+ *   - kind MACRO_SAME reuses the keycode of the last press (the release of
+ *     a tap, usually), MACRO_BASIC carries a one-byte keycode and
+ *     MACRO_FULL a two-byte one
+ *   - delta is the time since the previous event in MACRO_RECORDER_TICK_MS
+ *     ticks; 31 means a LEB128 varint with the rest follows
+ *   - kind MACRO_RUN has a 6-bit count instead: the last tap (press and
+ *     release of the same key) happens count + 1 more times, with the same
+ *     timing. A tap joins a run when its timing is within
+ *     MACRO_RECORDER_RUN_SLACK ticks of the first one
+ *
+ * A plain tap costs two to three bytes. Recording and replay share one
+ * MACRO_RECORDER_SIZE buffer; only one of them runs at a time.
+ *
+ * Usage in keymap.c:
+ *   1. Set MACRO_RECORDER_ENABLE = yes in rules.mk
+ *   2. Call macro_recorder_init() from keyboard_post_init_user()
+ *   3. Call process_macro_recorder(keycode, record) in process_record_user(),
+ *      right after the secrets handlers
+ *   4. Call macro_recorder_task() from matrix_scan_user()
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+// ==== CONFIGURATION ====
+
+/**
+ * @brief Layout version of a stored slot; bump on any change to drop stored macros
+ */
+#define MACRO_RECORDER_VERSION 1
+
+/**
+ * @brief Slots; MACRO_REC_n / MACRO_PLAY_n keycodes exist for four
+ */
+#ifndef MACRO_RECORDER_SLOTS
+#    define MACRO_RECORDER_SLOTS 4
+#endif
+
+/**
+ * @brief Bytes of events per macro; recording stops when they run out
+ */
+#ifndef MACRO_RECORDER_SIZE
+#    define MACRO_RECORDER_SIZE 126
+#endif
+
+/**
+ * @brief Resolution of recorded timing
+ */
+#ifndef MACRO_RECORDER_TICK_MS
+#    define MACRO_RECORDER_TICK_MS 8
+#endif
+
+/**
+ * @brief Timing difference, in ticks, up to which repeated taps form a run
+ */
+#ifndef MACRO_RECORDER_RUN_SLACK
+#    define MACRO_RECORDER_RUN_SLACK 3
+#endif
+
+/**
+ * @brief Keys a replay can hold down at once; more are released early
+ */
+#ifndef MACRO_RECORDER_HELD
+#    define MACRO_RECORDER_HELD 8
+#endif
+
+// ==== DATA ====
+
+/**
+ * @enum macro_kind
+ * @brief Top two bits of an event token
+ */
+enum macro_kind {
+    MACRO_SAME  = 0, /**< Keycode of the last press */
+    MACRO_BASIC = 1, /**< One keycode byte follows */
+    MACRO_FULL  = 2, /**< Two keycode bytes follow, little endian */
+    MACRO_RUN   = 3, /**< Repeat the last tap; low six bits are the count - 1 */
+};
+
+#define MACRO_TOKEN(kind, pressed, delta) ((kind) << 6 | (pressed) << 5 | (delta))
+#define MACRO_TOKEN_KIND(token)           ((token) >> 6)
+#define MACRO_TOKEN_PRESSED(token)        (((token) >> 5) & 1)
+#define MACRO_TOKEN_DELTA(token)          ((token) & 0x1F)
+#define MACRO_DELTA_VARINT                0x1F
+#define MACRO_RUN_MAX                     64
+
+/**
+ * @brief One stored macro
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t version;                    /**< MACRO_RECORDER_VERSION */
+    uint8_t length;                     /**< Bytes of events used */
+    uint8_t events[MACRO_RECORDER_SIZE]; /**< Event tokens */
+} macro_slot_t;
+
+#ifdef MACRO_RECORDER_ENABLE
+
+/**
+ * @brief Drop stored macros whose layout no longer matches
+ */
+void macro_recorder_init(void);
+
+/**
+ * @brief Handle MACRO_REC_n / MACRO_PLAY_n and record keys while recording
+ *
+ * @param keycode The keycode to process
+ * @param record The keyrecord containing event information
+ * @return false for the recorder's own keycodes, true otherwise
+ */
+bool process_macro_recorder(uint16_t keycode, keyrecord_t *record);
+
+/**
+ * @brief Replay whatever events are due
+ *
+ * Call from matrix_scan_user(). Emits at most one event per call, and at
+ * full speed at most one per millisecond, so the host sees every report.
+ */
+void macro_recorder_task(void);
+
+/**
+ * @brief Whether a macro is being recorded
+ */
+bool macro_recorder_recording(void);
+
+/**
+ * @brief Whether a macro is being replayed; its keys may be down until it ends
+ */
+bool macro_recorder_playing(void);
+
+/**
+ * @brief Drop the recording in progress, if any, without saving it
+ *
+ * Called by features/secrets_manager.c when secret input starts.
+ */
+void macro_recorder_discard(void);
+
+#else // MACRO_RECORDER_ENABLE
+
+// Disabled in rules.mk: no-op stubs so callers compile away.
+static inline void macro_recorder_init(void) {}
+static inline bool process_macro_recorder(uint16_t keycode, keyrecord_t *record) { return true; }
+static inline void macro_recorder_task(void) {}
+static inline bool macro_recorder_recording(void) { return false; }
+static inline bool macro_recorder_playing(void) { return false; }
+static inline void macro_recorder_discard(void) {}
+
+#endif // MACRO_RECORDER_ENABLE
@@ -0,0 +1,307 @@
+/**
+ * @file output_queue.c
+ * @brief Implementation of the non-blocking output queue
+ */
+
+#include "features/output_queue.h"
+#include "features/telemetry.h"
+
+/**
+ * @brief Kinds of job
+ */
+enum output_job_type {
+    JOB_PROGMEM, /**< PROGMEM string */
+    JOB_SOURCE,  /**< Characters from a source callback */
+    JOB_KEYCODE, /**< Keycode taps */
+};
+
+/**
+ * @brief One pending job
+ */
+typedef struct {
+    uint8_t  type;   /**< enum output_job_type */
+    uint16_t arg;    /**< Source argument, or the number of taps */
+    uint16_t pos;    /**< Characters typed so far */
+    uint16_t length; /**< Source length, or the keycode to tap */
+    union {
+        const char     *str;
+        output_source_t source;
+    };
+} output_job_t;
+
+#define SHIFT_BIT MOD_BIT(KC_LSFT)
+
+// ==== STATE VARIABLES ====
+
+/**
+ * @brief Ring of pending jobs, oldest at head
+ */
+static output_job_t jobs[OUTPUT_QUEUE_SIZE];
+static uint8_t      head  = 0;
+static uint8_t      count = 0;
+
+/**
+ * @brief Next character, taken from the oldest job ahead of typing it
+ *
+ * A burst has to see the next character to know whether the run ends
+ * before it. Taking it out of its job (rather than peeking twice) keeps a
+ * source's per-character work to once per character.
+ */
+static char lookahead = '\0';
+
+/**
+ * @brief Time the last report went out
+ */
+static uint16_t last_output = 0;
+
+#ifdef NKRO_ENABLE
+/**
+ * @brief Keys held down by the current burst, bit n for keycode n
+ *
+ * Characters typed by a burst are basic keycodes below KC_SLSH, so 64 bits
+ * cover them all.
+ */
+static uint64_t burst_down  = 0;
+static uint8_t  burst_held  = 0;
+static uint8_t  burst_shift = 0;
+#endif
+
+// ==== HELPER FUNCTIONS ====
+
+/**
+ * @brief Claim the slot after the newest job, or NULL if the queue is full
+ */
+static output_job_t *output_queue_add(uint8_t type) {
+    if (count == OUTPUT_QUEUE_SIZE) {
+        return NULL;
+    }
+    output_job_t *job = &jobs[(head + count) % OUTPUT_QUEUE_SIZE];
+    job->type         = type;
+    job->pos          = 0;
+    count++;
+    telemetry_set_queue_depth(count);
+    return job;
+}
+
+/**
+ * @brief Retire the oldest job
+ */
+static void output_queue_pop(void) {
+    output_job_t *job = &jobs[head];
+    if (job->type == JOB_SOURCE) {
+        job->source(job->arg, OUTPUT_SOURCE_END);
+    }
+    head = (head + 1) % OUTPUT_QUEUE_SIZE;
+    count--;
+    telemetry_set_queue_depth(count);
+}
+
+/**
+ * @brief The next character to type, or '\0' if the oldest job is a keycode
+ *        tap or nothing is left
+ *
+ * Text jobs are retired as soon as their last character is taken, so a
+ * source is wiped before that character is even typed.
+ */
+static char output_queue_peek(void) {
+    while (!lookahead && count && jobs[head].type != JOB_KEYCODE) {
+        output_job_t *job = &jobs[head];
+        char          c;
+        bool          done;
+
+        if (job->type == JOB_PROGMEM) {
+            c    = pgm_read_byte(job->str + job->pos);
+            done = !c || !pgm_read_byte(job->str + job->pos + 1);
+        } else {
+            c    = job->pos < job->length ? job->source(job->arg, job->pos) : '\0';
+            done = !c || job->pos + 1 >= job->length;
+        }
+        job->pos++;
+        lookahead = c;
+        if (done) {
+            output_queue_pop();
+        }
+    }
+    return lookahead;
+}
+
+/**
+ * @brief Tap the keycode of the oldest job, which must be a keycode job
+ */
+static void output_queue_tap(void) {
+    output_job_t *job = &jobs[head];
+    tap_code16(job->length);
+    job->pos++;
+    if (job->pos >= job->arg) {
+        output_queue_pop();
+    }
+}
+
+#ifdef NKRO_ENABLE
+/**
+ * @brief Let go of every key the burst holds, in the next report sent
+ */
+static void output_burst_release(void) {
+    for (uint8_t kc = 0; burst_down; kc++, burst_down >>= 1) {
+        if (burst_down & 1) {
+            del_key(kc);
+        }
+    }
+    del_weak_mods(burst_shift);
+    burst_held  = 0;
+    burst_shift = 0;
+}
+
+/**
+ * @brief Keycode a burst can type c with, or KC_NO if it can't
+ */
+static uint8_t output_burst_keycode(char c) {
+    if ((uint8_t)c >= 0x80 || PGM_LOADBIT(ascii_to_altgr_lut, (uint8_t)c)) {
+        return KC_NO;
+    }
+    uint8_t kc = pgm_read_byte(&ascii_to_keycode_lut[(uint8_t)c]);
+    return kc >= KC_A && kc <= KC_SLSH ? kc : KC_NO;
+}
+
+static uint8_t output_burst_shift(char c) {
+    return PGM_LOADBIT(ascii_to_shift_lut, (uint8_t)c) ? SHIFT_BIT : 0;
+}
+
+/**
+ * @brief Send one report of a burst
+ *
+ * A run holds down distinct keys typed with the same Shift state, adding
+ * exactly one key per report and keeping the keys before it down. The host
+ * sees a single new key in each report, so it can only type them in the
+ * order they were sent: the HID spec doesn't order the presses within one
+ * report, and remote desktops, VMs and KVM switches don't keep them in
+ * keycode order. Releases are what's saved: a run of n characters takes
+ * n + 1 reports, where one key at a time takes 2n or more.
+ *
+ * A change of Shift, or a run as long as OUTPUT_QUEUE_BURST_KEYS, lets go
+ * of the run in the same report that adds the next key; the host applies
+ * a report's modifiers before its keys, as it does for QMK's own shifted
+ * keycodes. A repeated key has to come up in a report of its own before
+ * it can go down again. Anything else (keycode jobs, characters needing
+ * AltGr) is typed the usual way once the run is let go.
+ *
+ * @return false if the next thing to type isn't a burst character
+ */
+static bool output_burst_task(void) {
+    char    c  = output_queue_peek();
+    uint8_t kc = c ? output_burst_keycode(c) : KC_NO;
+
+    if (burst_held && (!kc || (burst_down >> kc & 1))) {
+        output_burst_release();
+        send_keyboard_report();
+        return true;
+    }
+    if (!kc) {
+        return false;
+    }
+
+    uint8_t shift = output_burst_shift(c);
+    if (burst_held && (shift != burst_shift || burst_held == OUTPUT_QUEUE_BURST_KEYS)) {
+        output_burst_release();
+    }
+    if (!burst_held) {
+        burst_shift = shift;
+        add_weak_mods(shift);
+    }
+    add_key(kc);
+    burst_down |= (uint64_t)1 << kc;
+    burst_held++;
+    lookahead = '\0';
+    send_keyboard_report();
+    return true;
+}
+#endif // NKRO_ENABLE
+
+/**
+ * @brief Send the next report of the oldest job
+ */
+static void output_queue_step(void) {
+#ifdef NKRO_ENABLE
+    if ((keymap_config.nkro || burst_held) && output_burst_task()) {
+        return;
+    }
+#endif
+    if (output_queue_peek()) {
+        send_char(lookahead);
+        lookahead = '\0';
+    } else if (count) {
+        output_queue_tap();
+    }
+}
+
+// ==== PUBLIC FUNCTIONS ====
+
+bool output_queue_push_P(const char *str) {
+    output_job_t *job = output_queue_add(JOB_PROGMEM);
+    if (job) {
+        job->str = str;
+    }
+    return job;
+}
+
+bool output_queue_push_source(output_source_t source, uint16_t arg, uint16_t length) {
+    output_job_t *job = output_queue_add(JOB_SOURCE);
+    if (job) {
+        job->source = source;
+        job->arg    = arg;
+        job->length = length;
+    }
+    return job;
+}
+
+bool output_queue_push_keycode(uint16_t keycode) {
+    return output_queue_push_taps(keycode, 1);
+}
+
+bool output_queue_push_taps(uint16_t keycode, uint16_t count) {
+    if (!count) {
+        return true;
+    }
+    output_job_t *job = output_queue_add(JOB_KEYCODE);
+    if (job) {
+        job->length = keycode;
+        job->arg    = count;
+    }
+    return job;
+}
+
+void output_queue_clear(void) {
+    while (count) {
+        output_queue_pop();
+    }
+    lookahead = '\0';
+#ifdef NKRO_ENABLE
+    if (burst_held) {
+        output_burst_release();
+        send_keyboard_report();
+    }
+#endif
+}
+
+bool output_queue_busy(void) {
+#ifdef NKRO_ENABLE
+    if (burst_held) {
+        return true;
+    }
+#endif
+    return count || lookahead;
+}
+
+void output_queue_task(void) {
+    if (!output_queue_busy() || timer_elapsed(last_output) < OUTPUT_QUEUE_INTERVAL) {
+        return;
+    }
+    last_output = timer_read();
+
+    // Type what was queued, not what is held: Shift still down from a
+    // snippet's trigger would turn "221B" into "@@!B"
+    const uint8_t mods = get_mods();
+    clear_mods();
+    output_queue_step();
+    set_mods(mods);
+}
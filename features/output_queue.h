@@ -0,0 +1,131 @@
+/**
+ * @file output_queue.h
+ * @brief Non-blocking queue of text to type
+ *
+ * Features that type more than a keystroke or two push jobs here instead of
+ * calling send_string(), which blocks the matrix scan until the last
+ * character is out. output_queue_task() types at most one character per
+ * OUTPUT_QUEUE_INTERVAL milliseconds, so keys keep being scanned and any
+ * per-character work (decrypting a secret, say) is spread over the typing
+ * time instead of stalling the keypress that queued it.
+ *
+ * A job is one of:
+ *   - a PROGMEM string
+ *   - a source callback producing one character per call, for text that
+ *     must never sit whole in RAM
+ *   - a keycode tapped one or more times
+ *
+ * With NKRO_ENABLE and NKRO switched on (NK_ON / NK_TOGG, kept in EEPROM),
+ * text goes out in bursts instead: runs of distinct keys with the same
+ * Shift state are held down together, one key added per report so the
+ * host can't type them out of order, and let go of together. Ordinary
+ * text needs about one report per character instead of two or more.
+ * Repeated keys and Shift changes end a run, and anything that isn't a
+ * plain character (keycode jobs, AltGr) is typed one key at a time as
+ * before.
+ *
+ * Modifiers held on the keyboard are left out of the queue's reports, so
+ * text comes out as written even while Shift from a snippet's trigger is
+ * still down; the next report of a key pressed sends them again.
+ *
+ * The number of pending jobs is reported to telemetry as the queue depth.
+ *
+ * Usage:
+ *   1. Set OUTPUT_QUEUE_ENABLE = yes in rules.mk (features that need it do)
+ *   2. Call output_queue_task() from matrix_scan_user()
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+/**
+ * @brief Jobs that can be pending at once
+ */
+#ifndef OUTPUT_QUEUE_SIZE
+#    define OUTPUT_QUEUE_SIZE 8
+#endif
+
+/**
+ * @brief Milliseconds between typed characters, or between reports of a burst
+ */
+#ifndef OUTPUT_QUEUE_INTERVAL
+#    define OUTPUT_QUEUE_INTERVAL 1
+#endif
+
+/**
+ * @brief Keys a burst holds down at once; six keeps a boot protocol host,
+ *        which only takes six, typing the right text too
+ */
+#ifndef OUTPUT_QUEUE_BURST_KEYS
+#    define OUTPUT_QUEUE_BURST_KEYS 6
+#endif
+
+/**
+ * @brief Produces character pos of a source job
+ *
+ * Called once more with pos = OUTPUT_SOURCE_END when the job finishes or
+ * is dropped, so the source can wipe whatever state it kept.
+ *
+ * @param arg The argument given to output_queue_push_source()
+ * @param pos Index of the character wanted, counting up from 0
+ * @return char The character, or '\0' to end the job early
+ */
+typedef char (*output_source_t)(uint16_t arg, uint16_t pos);
+
+#define OUTPUT_SOURCE_END 0xFFFF
+
+#ifdef OUTPUT_QUEUE_ENABLE
+
+/**
+ * @brief Queue a PROGMEM string
+ *
+ * @return false if the queue is full
+ */
+bool output_queue_push_P(const char *str);
+
+/**
+ * @brief Queue length characters produced by a source callback
+ *
+ * @return false if the queue is full
+ */
+bool output_queue_push_source(output_source_t source, uint16_t arg, uint16_t length);
+
+/**
+ * @brief Queue a keycode tap
+ *
+ * @return false if the queue is full
+ */
+bool output_queue_push_keycode(uint16_t keycode);
+
+/**
+ * @brief Queue count taps of a keycode, one per interval, as a single job
+ *
+ * @return false if the queue is full
+ */
+bool output_queue_push_taps(uint16_t keycode, uint16_t count);
+
+/**
+ * @brief Drop every pending job, including the one being typed
+ */
+void output_queue_clear(void);
+
+/**
+ * @brief Whether anything is left to type, or a burst still holds keys
+ */
+bool output_queue_busy(void);
+
+/**
+ * @brief Type the next character, or send the next report of a burst, if due
+ *
+ * Call from matrix_scan_user().
+ */
+void output_queue_task(void);
+
+#else // OUTPUT_QUEUE_ENABLE
+
+static inline void output_queue_clear(void) {}
+static inline bool output_queue_busy(void) { return false; }
+static inline void output_queue_task(void) {}
+
+#endif // OUTPUT_QUEUE_ENABLE
@@ -0,0 +1,112 @@
+/**
+ * @file poly1305.c
+ * @brief Implementation of Poly1305 with 26-bit limbs
+ *
+ * The accumulator and r are held in five 26-bit limbs so every product fits
+ * a 32x32->64 multiply, which the Cortex-M3 does in one UMULL.
+ */
+
+#include "features/poly1305.h"
+#include "features/chacha20.h"
+
+#define LIMB_MASK 0x3FFFFFF
+
+static uint32_t load32(const uint8_t *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void store32(uint8_t *p, uint32_t v) {
+    p[0] = v;
+    p[1] = v >> 8;
+    p[2] = v >> 16;
+    p[3] = v >> 24;
+}
+
+void poly1305_mac(const uint8_t key[POLY1305_KEY_SIZE], const uint8_t *message, uint16_t length, uint8_t tag[POLY1305_TAG_SIZE]) {
+    // r, clamped as the RFC requires
+    const uint32_t r0 = load32(key + 0) & 0x3FFFFFF;
+    const uint32_t r1 = (load32(key + 3) >> 2) & 0x3FFFF03;
+    const uint32_t r2 = (load32(key + 6) >> 4) & 0x3FFC0FF;
+    const uint32_t r3 = (load32(key + 9) >> 6) & 0x3F03FFF;
+    const uint32_t r4 = (load32(key + 12) >> 8) & 0x00FFFFF;
+    const uint32_t s1 = r1 * 5, s2 = r2 * 5, s3 = r3 * 5, s4 = r4 * 5;
+
+    uint32_t h0 = 0, h1 = 0, h2 = 0, h3 = 0, h4 = 0;
+    uint8_t  block[16];
+
+    while (length) {
+        uint8_t  n     = length < 16 ? length : 16;
+        uint32_t hibit = 1UL << 24; // The 2^128 bit of a full block
+        for (uint8_t i = 0; i < 16; i++) {
+            block[i] = i < n ? message[i] : 0;
+        }
+        if (n < 16) {
+            block[n] = 1;
+            hibit    = 0;
+        }
+        message += n;
+        length -= n;
+
+        h0 += load32(block + 0) & LIMB_MASK;
+        h1 += (load32(block + 3) >> 2) & LIMB_MASK;
+        h2 += (load32(block + 6) >> 4) & LIMB_MASK;
+        h3 += (load32(block + 9) >> 6) & LIMB_MASK;
+        h4 += (load32(block + 12) >> 8) | hibit;
+
+        // h *= r, mod 2^130 - 5
+        uint64_t d0 = (uint64_t)h0 * r0 + (uint64_t)h1 * s4 + (uint64_t)h2 * s3 + (uint64_t)h3 * s2 + (uint64_t)h4 * s1;
+        uint64_t d1 = (uint64_t)h0 * r1 + (uint64_t)h1 * r0 + (uint64_t)h2 * s4 + (uint64_t)h3 * s3 + (uint64_t)h4 * s2;
+        uint64_t d2 = (uint64_t)h0 * r2 + (uint64_t)h1 * r1 + (uint64_t)h2 * r0 + (uint64_t)h3 * s4 + (uint64_t)h4 * s3;
+        uint64_t d3 = (uint64_t)h0 * r3 + (uint64_t)h1 * r2 + (uint64_t)h2 * r1 + (uint64_t)h3 * r0 + (uint64_t)h4 * s4;
+        uint64_t d4 = (uint64_t)h0 * r4 + (uint64_t)h1 * r3 + (uint64_t)h2 * r2 + (uint64_t)h3 * r1 + (uint64_t)h4 * r0;
+
+        uint32_t c;
+        c  = d0 >> 26, h0 = d0 & LIMB_MASK;
+        d1 += c, c = d1 >> 26, h1 = d1 & LIMB_MASK;
+        d2 += c, c = d2 >> 26, h2 = d2 & LIMB_MASK;
+        d3 += c, c = d3 >> 26, h3 = d3 & LIMB_MASK;
+        d4 += c, c = d4 >> 26, h4 = d4 & LIMB_MASK;
+        h0 += c * 5, c = h0 >> 26, h0 &= LIMB_MASK;
+        h1 += c;
+    }
+
+    // Fully carry h
+    uint32_t c;
+    c = h1 >> 26, h1 &= LIMB_MASK;
+    h2 += c, c = h2 >> 26, h2 &= LIMB_MASK;
+    h3 += c, c = h3 >> 26, h3 &= LIMB_MASK;
+    h4 += c, c = h4 >> 26, h4 &= LIMB_MASK;
+    h0 += c * 5, c = h0 >> 26, h0 &= LIMB_MASK;
+    h1 += c;
+
+    // g = h + 5 - 2^130; use it instead of h if it didn't go negative
+    uint32_t g0 = h0 + 5;
+    c           = g0 >> 26, g0 &= LIMB_MASK;
+    uint32_t g1 = h1 + c;
+    c           = g1 >> 26, g1 &= LIMB_MASK;
+    uint32_t g2 = h2 + c;
+    c           = g2 >> 26, g2 &= LIMB_MASK;
+    uint32_t g3 = h3 + c;
+    c           = g3 >> 26, g3 &= LIMB_MASK;
+    uint32_t g4 = h4 + c - (1UL << 26);
+
+    uint32_t use_g = (g4 >> 31) - 1; // All ones when g4 is non-negative
+    h0             = (h0 & ~use_g) | (g0 & use_g);
+    h1             = (h1 & ~use_g) | (g1 & use_g);
+    h2             = (h2 & ~use_g) | (g2 & use_g);
+    h3             = (h3 & ~use_g) | (g3 & use_g);
+    h4             = (h4 & ~use_g) | (g4 & use_g);
+
+    // tag = (h + s) mod 2^128
+    uint64_t f;
+    f = (uint64_t)(h0 | (h1 << 26)) + load32(key + 16);
+    store32(tag + 0, f);
+    f = (uint64_t)((h1 >> 6) | (h2 << 20)) + load32(key + 20) + (f >> 32);
+    store32(tag + 4, f);
+    f = (uint64_t)((h2 >> 12) | (h3 << 14)) + load32(key + 24) + (f >> 32);
+    store32(tag + 8, f);
+    f = (uint64_t)((h3 >> 18) | (h4 << 8)) + load32(key + 28) + (f >> 32);
+    store32(tag + 12, f);
+
+    chacha20_wipe(block, sizeof(block));
+}
@@ -0,0 +1,30 @@
+/**
+ * @file poly1305.h
+ * @brief Poly1305 one-time authenticator (RFC 8439)
+ *
+ * Together with features/chacha20.h this is enough for the RFC 8439
+ * ChaCha20-Poly1305 construction the raw HID secrets channel uses. Only a
+ * one-shot function is provided: the messages are a packet or two long.
+ *
+ * tools/secrets_companion.py holds the matching host implementation.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief Bytes in a key and in a tag
+ */
+#define POLY1305_KEY_SIZE 32
+#define POLY1305_TAG_SIZE 16
+
+/**
+ * @brief Authenticate a message
+ *
+ * @param key One-time key; never use a key for two messages
+ * @param message The message
+ * @param length Bytes in the message
+ * @param tag The 16-byte tag
+ */
+void poly1305_mac(const uint8_t key[POLY1305_KEY_SIZE], const uint8_t *message, uint16_t length, uint8_t tag[POLY1305_TAG_SIZE]);
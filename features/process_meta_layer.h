@@ -6,10 +6,15 @@
  * which allows for GUI/Meta key combinations while maintaining a clean
  * separation of layers. It also implements special meta layer shortcuts
  * like Meta+L for locking secrets.
+ *
+ * Set META_LAYER_ENABLE = no in rules.mk to replace it with no-op stubs.
  */
 
 #include QMK_KEYBOARD_H
 #include "features/secrets_manager.h"
+#include "features/event_log.h"
+
+#ifdef META_LAYER_ENABLE
 
 /**
  * @brief Initialize the meta layer functionality
@@ -49,13 +54,21 @@ bool process_meta_layer(uint16_t keycode, keyrecord_t *record) {
   if (record->event.pressed) {
     // On keypress: activate meta layer and register left GUI modifier
     layer_on(_META); register_mods(MOD_BIT(KC_LGUI));
-    dprint("▶ Meta layer on\n");
+    EVLOG_DEBUG(EV_META_LAYER, 1, 0);
   } else {
     // On key release: deregister left GUI modifier and deactivate meta layer
     unregister_mods(MOD_BIT(KC_LGUI)); layer_off(_META);
-    dprint("▶ Meta layer off\n");
+    EVLOG_DEBUG(EV_META_LAYER, 0, 0);
   }
 
   // Return false to indicate we've handled this keycode
   return false;
-}
\ No newline at end of file
+}
+
+#else // META_LAYER_ENABLE
+
+// Disabled in rules.mk: no-op stubs so callers compile away.
+static inline void meta_layer_init(void) {}
+static inline bool process_meta_layer(uint16_t keycode, keyrecord_t *record) { return true; }
+
+#endif // META_LAYER_ENABLE
@@ -6,6 +6,8 @@
  * - PIN/secret entry status using the secrets manager
  * - Current active layer
  * - Caps Lock state
+ * - Autocorrect on/off
+ * - Macro recording
  * 
  * The RGB indicators provide a quick visual reference for the current keyboard state,
  * making it easier to identify which layer is active and key system states.
@@ -14,9 +16,12 @@
 #include "quantum.h"
 #include "layers.h"
 #include "features/secrets_manager.h"
+#include "features/autocorrect.h"
+#include "features/macro_recorder.h"
+#include "features/heatmap.h"
 #include "config.h"
 
-#ifdef RGB_MATRIX_ENABLE
+#if defined(RGB_MATRIX_ENABLE) && defined(RGB_INDICATORS_ENABLE)
 /**
  * @brief Main implementation for RGB indicator functionality
  * 
@@ -26,6 +31,7 @@
  * @return bool Returns false to allow RGB matrix effects to continue processing
  */
 bool rgb_indicators_implementation(void) {
+#ifdef SECRETS_ENABLE
   // ------------- PIN status indicator on KC_P0 (idx 97) -------------
   // This visualizes the current state of PIN/secret entry from the secrets manager
   {
@@ -41,6 +47,9 @@ bool rgb_indicators_implementation(void) {
       } else if (state == 2) {
           // Green: PIN successfully entered, authentication successful
           hsv_pin = (HSV){ .h = 85,  .s = 255, .v = 255 };
+      } else if (state == 3) {
+          // Cyan: unlocked and waiting for a SECRET_SELECT tag
+          hsv_pin = (HSV){ .h = 128, .s = 255, .v = 255 };
       } else {
           // Red: Default state or PIN entry failed/locked out
           hsv_pin = (HSV){ .h = 0,   .s = 255, .v = 255 };
@@ -50,24 +59,44 @@ bool rgb_indicators_implementation(void) {
       RGB rgb_pin = hsv_to_rgb(hsv_pin);
       rgb_matrix_set_color(pin_idx, rgb_pin.r, rgb_pin.g, rgb_pin.b);
   }
+#endif // SECRETS_ENABLE
 
+#ifdef AUTOCORRECT_TRIE_ENABLE
   // ------------- Autocorrect status indicator on TAB (idx 36) -------------
-//   {
-//       const uint8_t autocorrect_idx = 36; // Key index for the TAB key
-//       HSV hsv_autocorrect;
-      
-//       if (autocorrect_is_enabled()) {
-//           // Purple: Autocorrect is enabled
-//           hsv_autocorrect = (HSV){ .h = 220, .s = 255, .v = 255 };
-//       } else {
-//           // Off when autocorrect is disabled
-//           hsv_autocorrect = (HSV){ .h = 0, .s = 0, .v = 0 };
-//       }
-      
-//       // Convert HSV to RGB and set the LED color
-//       RGB rgb_autocorrect = hsv_to_rgb(hsv_autocorrect);
-//       rgb_matrix_set_color(autocorrect_idx, rgb_autocorrect.r, rgb_autocorrect.g, rgb_autocorrect.b);
-//   }
+  {
+      const uint8_t autocorrect_idx = 36; // Key index for the TAB key
+      HSV hsv_autocorrect;
+
+      if (is_autocorrect_on()) {
+          // Purple: Autocorrect is enabled
+          hsv_autocorrect = (HSV){ .h = 220, .s = 255, .v = 255 };
+      } else {
+          // Off when autocorrect is disabled
+          hsv_autocorrect = (HSV){ .h = 0, .s = 0, .v = 0 };
+      }
+
+      // Convert HSV to RGB and set the LED color
+      RGB rgb_autocorrect = hsv_to_rgb(hsv_autocorrect);
+      rgb_matrix_set_color(autocorrect_idx, rgb_autocorrect.r, rgb_autocorrect.g, rgb_autocorrect.b);
+  }
+#endif // AUTOCORRECT_TRIE_ENABLE
+
+#ifdef MACRO_RECORDER_ENABLE
+  // ------------- Macro recording indicator on ESC (idx 0) -------------
+  {
+      static bool was_recording = false;
+      bool recording = macro_recorder_recording();
+
+      if (recording) {
+          // Red while keys are being recorded, so a forgotten recording stands out
+          rgb_matrix_set_color(0, 255, 0, 0);
+      } else if (was_recording) {
+          // The heatmap only redraws LEDs that changed: give Esc back to it
+          heatmap_redraw_led(0);
+      }
+      was_recording = recording;
+  }
+#endif // MACRO_RECORDER_ENABLE
 
   // ------------- Layer state indicators -------------
   // Get the current active layer
@@ -90,7 +119,7 @@ bool rgb_indicators_implementation(void) {
       rgb_matrix_set_color(54, rgb_caps.r, rgb_caps.g, rgb_caps.b);
   }
 
-  // 3) Function layer (layer 10) indicator on grave key (index 18)
+  // 3) Function layer (_FL) indicator on grave key (index 18)
   if (layer == _FL) {
       // White indicator for function layer on the grave key
       HSV hsv = { .h = 0, .s = 0, .v = 255 };
@@ -4,14 +4,15 @@
  * 
  * This module provides functionality to control RGB LEDs for indicating different
  * keyboard states such as active layer, caps lock, and PIN entry status.
- * Only enabled when RGB_MATRIX_ENABLE is defined.
+ * Only enabled when both RGB_MATRIX_ENABLE and RGB_INDICATORS_ENABLE (rules.mk)
+ * are set; keymap.c then skips defining rgb_matrix_indicators_user() entirely.
  */
 
 #pragma once
 
 #include "quantum.h"
 
-#ifdef RGB_MATRIX_ENABLE
+#if defined(RGB_MATRIX_ENABLE) && defined(RGB_INDICATORS_ENABLE)
 /**
  * @brief Implementation of RGB indicators functionality
  * 
@@ -3,6 +3,8 @@
 
 #include "custom_keycodes.h"
 
+#ifdef RUN_CMDS_ENABLE
+
 /**
  * @brief Array of commands to be used with QMK keybindings to quickly run commands.
  *
@@ -46,5 +48,11 @@ bool process_run_cmd(uint16_t keycode, keyrecord_t *record) {
     return true;
 }
 
+#else // RUN_CMDS_ENABLE
+
+// Disabled in rules.mk: no-op stub so the call in keymap.c compiles away.
+static inline bool process_run_cmd(uint16_t keycode, keyrecord_t *record) { return true; }
+
+#endif // RUN_CMDS_ENABLE
 
 #endif // RUN_CMDS_H
\ No newline at end of file
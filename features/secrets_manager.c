@@ -8,38 +8,510 @@
  * - Auto-locking after timeout for security
  * - Visual status indicators through RGB
  * - Secure typing of secrets directly from the keyboard
+ *
+ * The secrets live in flash only as ChaCha20 ciphertext (secrets_vault.h,
+ * built from secrets.h by tools/secrets_vault.py). Each PIN digit is folded
+ * into the key derivation as it is typed, Enter only checks the result, and
+ * each secret is decrypted one character at a
+ * time as the output queue types it, so no plaintext secret is ever held
+ * whole in RAM.
+ *
+ * Beyond the E_PIN..E_PASS4 keycodes, the vault can hold any number of
+ * tagged secrets: while unlocked, SECRET_SELECT, a tag of up to four digits
+ * and Enter types the secret with that tag.
+ *
+ * With SECRETS_HID_ENABLE, passwords and tagged secrets are sealed and sent
+ * to tools/secrets_companion.py over raw HID in one or two packets when it
+ * is listening, and typed as usual when it isn't.
  */
 
 #include QMK_KEYBOARD_H
 #include "features/secrets_manager.h"
 #include <string.h>
-#include "print.h"
+#include "features/chacha20.h"
+#include "features/output_queue.h"
+#include "features/key_history.h"
+#include "features/macro_recorder.h"
+#include "features/event_log.h"
+#include "features/telemetry.h"
+
+#ifdef SECRETS_HID_ENABLE
+#    include "raw_hid.h"
+#    include "features/hid_protocol.h"
+#    include "features/poly1305.h"
+#endif
+
+// ==== VAULT ====
+
+#if __has_include("secrets_vault.h")
+#    include "secrets_vault.h"
+#else
+#    error "secrets_vault.h is missing: run tools/secrets_vault.py (needs secrets.h)"
+#endif
+
+_Static_assert(VAULT_KEYCODE_ENTRIES == E_SECRET_END - E_SECRET_START, "secrets_vault.h needs one SECRETS_LIST entry per secret keycode, rerun tools/secrets_vault.py");
+
+/**
+ * @brief Nonce domains, matching tools/secrets_vault.py
+ */
+enum vault_nonce_domain {
+    VAULT_NONCE_DATA,  /**< Keystream for a secret */
+    VAULT_NONCE_DIGIT, /**< One PIN digit folded into the key */
+    VAULT_NONCE_KEY,   /**< Vault key and check value */
+    VAULT_NONCE_HID,   /**< Wrapping of the raw HID channel key */
+};
+
+/**
+ * @brief Key the secrets decrypt with, only valid while unlocked
+ */
+static uint32_t vault_key[CHACHA20_KEY_WORDS];
+
+/**
+ * @brief Keystream block the output queue is typing from
+ */
+static uint32_t vault_stream[CHACHA20_BLOCK_WORDS];
+static uint16_t vault_stream_entry = 0xFFFF;
+static uint16_t vault_stream_block = 0;
+
+/**
+ * @brief Wipe the cached keystream
+ */
+static void vault_stream_wipe(void) {
+    chacha20_wipe(vault_stream, sizeof(vault_stream));
+    vault_stream_entry = 0xFFFF;
+}
+
+/**
+ * @brief Output queue source: character pos of secret entry
+ *
+ * A new keystream block is computed every 64 characters, so the cost is
+ * spread over the typing instead of paid at the keypress.
+ */
+static char vault_source(uint16_t entry, uint16_t pos) {
+    if (pos == OUTPUT_SOURCE_END) {
+        vault_stream_wipe();
+        return '\0';
+    }
+    uint16_t block = pos / (CHACHA20_BLOCK_WORDS * 4);
+    if (entry != vault_stream_entry || block != vault_stream_block) {
+        const uint32_t nonce[CHACHA20_NONCE_WORDS] = {VAULT_NONCE_DATA, entry, 0};
+        chacha20_block(vault_key, block, nonce, vault_stream);
+        vault_stream_entry = entry;
+        vault_stream_block = block;
+    }
+    uint8_t cipher = pgm_read_byte(&vault_data[pgm_read_word(&vault_offsets[entry]) + pos]);
+    return cipher ^ chacha20_byte(vault_stream, pos % (CHACHA20_BLOCK_WORDS * 4));
+}
+
+/**
+ * @brief Length of secret entry
+ */
+static uint16_t vault_length(uint16_t entry) {
+    return pgm_read_word(&vault_offsets[entry + 1]) - pgm_read_word(&vault_offsets[entry]);
+}
+
+/**
+ * @brief Queue secret entry, then Enter
+ */
+static void vault_type(uint16_t entry) {
+    // One character per scan, decrypted as it goes out
+    if (output_queue_push_source(vault_source, entry, vault_length(entry))) {
+        output_queue_push_keycode(KC_ENT);
+    }
+}
+
+/**
+ * @brief Find the secret with a tag
+ *
+ * Binary search over the sorted tags in flash: O(log n) reads and no RAM,
+ * whatever the size of the vault.
+ *
+ * @return uint16_t The entry, or VAULT_ENTRIES if no secret has this tag
+ */
+static uint16_t vault_find(uint16_t tag) {
+    uint16_t low  = 0;
+    uint16_t high = VAULT_TAGS;
+    while (low < high) {
+        uint16_t mid = (low + high) / 2;
+        if (pgm_read_word(&vault_tags[mid]) < tag) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    if (low < VAULT_TAGS && pgm_read_word(&vault_tags[low]) == tag) {
+        return VAULT_KEYCODE_ENTRIES + low;
+    }
+    return VAULT_ENTRIES;
+}
+
+/**
+ * @brief Most digits a tag can have, as MAX_TAG in tools/secrets_vault.py
+ */
+#define VAULT_TAG_DIGITS 4
+
+/**
+ * @brief Tag being typed after SECRET_SELECT
+ */
+static bool     vault_selecting     = false;
+static uint16_t vault_select_tag    = 0;
+static uint8_t  vault_select_digits = 0;
 
-// ==== SECRETS DEFINITIONS ====
+/**
+ * @brief Leave tag selection
+ */
+static void vault_select_end(void) {
+    vault_selecting     = false;
+    vault_select_tag    = 0;
+    vault_select_digits = 0;
+}
+
+/**
+ * @brief Running PIN state: the salt with every digit typed so far folded in
+ *
+ * The digits themselves are never stored, so there is no plaintext PIN to
+ * compare against or to leak.
+ */
+static uint32_t pin_state[CHACHA20_KEY_WORDS];
 
-// Define the actual secret string constants
-#define X(name, val) const char * const name = val;
-SECRETS_LIST(X)
-#undef X
+/**
+ * @brief Reset the PIN state to the vault's salt
+ */
+static void vault_pin_start(void) {
+    for (uint8_t i = 0; i < CHACHA20_KEY_WORDS; i++) {
+        pin_state[i] = pgm_read_dword(&vault_salt[i]);
+    }
+}
 
-// Build the lookup array from the same list
-const char * const secret_list[] = {
-#define X(name, val) name,
-  SECRETS_LIST(X)
-#undef X
+/**
+ * @brief Fold one PIN digit into the PIN state: one ChaCha20 block
+ */
+static void vault_pin_digit(uint8_t digit) {
+    uint32_t       block[CHACHA20_BLOCK_WORDS];
+    const uint32_t nonce[CHACHA20_NONCE_WORDS] = {VAULT_NONCE_DIGIT, digit, 0};
+    chacha20_block(pin_state, 0, nonce, block);
+    memcpy(pin_state, block, sizeof(pin_state));
+    chacha20_wipe(block, sizeof(block));
+}
+
+/**
+ * @brief Derive the vault key from the PIN state and check it
+ *
+ * One ChaCha20 block and a compare that looks at every byte whatever the
+ * PIN, so Enter costs the same for any PIN, right or wrong.
+ *
+ * @return true The PIN matches the vault's check value; vault_key is set
+ * @return false Wrong PIN; vault_key is untouched
+ */
+static bool vault_unlock(void) {
+    uint32_t       block[CHACHA20_BLOCK_WORDS];
+    const uint32_t nonce[CHACHA20_NONCE_WORDS] = {VAULT_NONCE_KEY, 0, 0};
+    chacha20_block(pin_state, 0, nonce, block);
+
+    uint32_t diff = 0;
+    for (uint8_t i = 0; i < 4; i++) {
+        diff |= block[CHACHA20_KEY_WORDS + i] ^ pgm_read_dword(&vault_check[i]);
+    }
+    if (!diff) {
+        memcpy(vault_key, block, sizeof(vault_key));
+    }
+    chacha20_wipe(block, sizeof(block));
+    return !diff;
+}
+
+/**
+ * @brief Forget the PIN state
+ */
+static void vault_pin_wipe(void) {
+    chacha20_wipe(pin_state, sizeof(pin_state));
+}
+
+#ifdef SECRETS_HID_ENABLE
+// ==== RAW HID DELIVERY ====
+
+#    if !VAULT_HID_KEY
+#        error "SECRETS_HID_ENABLE needs SECRETS_HID_KEY in secrets.h (tools/secrets_companion.py --new-key), then rerun tools/secrets_vault.py"
+#    endif
+
+/**
+ * @brief Longest companion silence before secrets are typed again
+ * Can be overridden in config.h
+ */
+#    ifndef SECRETS_HID_PRESENCE_MS
+#        define SECRETS_HID_PRESENCE_MS 3000
+#    endif
+
+/**
+ * @brief How long to wait for the companion's ACK before typing instead
+ */
+#    ifndef SECRETS_HID_ACK_MS
+#        define SECRETS_HID_ACK_MS 250
+#    endif
+
+/**
+ * @brief Most packets one secret may take; longer secrets are typed
+ */
+#    ifndef SECRETS_HID_MAX_PACKETS
+#        define SECRETS_HID_MAX_PACKETS 2
+#    endif
+
+/**
+ * @brief Nonce direction byte, as in tools/secrets_companion.py
+ */
+enum secrets_hid_direction {
+    HID_DIR_DELIVER,
+    HID_DIR_ACK,
+    HID_DIR_HELLO,
 };
 
-// Calculate the secret count
-const uint8_t SECRET_COUNT = sizeof(secret_list) / sizeof(secret_list[0]);
+/**
+ * @brief Latest HELLO, checked only when a secret is about to be sent
+ *
+ * The channel key is only readable while unlocked, so HELLOs that arrive
+ * while locked can't be verified on arrival.
+ */
+static uint8_t  hid_nonce[SECRETS_HID_NONCE_SIZE];
+static uint8_t  hid_hello_tag[SECRETS_HID_TAG_SIZE];
+static uint32_t hid_hello_time = 0;
+static bool     hid_hello_seen = false;
+
+/**
+ * @brief Delivery counter, part of every nonce
+ *
+ * The high half is an epoch taken from EEPROM, the low half counts this
+ * epoch's deliveries from 1; 0 means a new epoch is due.
+ */
+static uint32_t hid_counter = 0;
+
+#define VAULT_HID_EPOCH_VERSION 1
+
+/**
+ * @brief Secret waiting for its ACK, or VAULT_ENTRIES
+ */
+static uint16_t hid_pending_entry = VAULT_ENTRIES;
+static uint32_t hid_pending_counter;
+static uint8_t  hid_pending_nonce[SECRETS_HID_NONCE_SIZE];
+static uint16_t hid_pending_timer;
+
+/**
+ * @brief Unwrap the channel key; the caller wipes it
+ */
+static void vault_hid_key_read(uint32_t key[CHACHA20_KEY_WORDS]) {
+    uint32_t       block[CHACHA20_BLOCK_WORDS];
+    const uint32_t nonce[CHACHA20_NONCE_WORDS] = {VAULT_NONCE_HID, 0, 0};
+    chacha20_block(vault_key, 0, nonce, block);
+    for (uint8_t i = 0; i < CHACHA20_KEY_WORDS; i++) {
+        key[i] = pgm_read_dword(&vault_hid_key[i]) ^ block[i];
+    }
+    chacha20_wipe(block, sizeof(block));
+}
+
+/**
+ * @brief Build a packet nonce: [direction][index][counter][companion nonce]
+ */
+static void vault_hid_nonce(uint32_t nonce[CHACHA20_NONCE_WORDS], uint8_t direction, uint8_t index, uint32_t counter, const uint8_t host[SECRETS_HID_NONCE_SIZE]) {
+    nonce[0] = direction | (index << 8) | (counter << 16);
+    nonce[1] = (counter >> 16) | (host[0] << 16) | ((uint32_t)host[1] << 24);
+    nonce[2] = host[2] | (host[3] << 8) | (host[4] << 16) | ((uint32_t)host[5] << 24);
+}
+
+/**
+ * @brief Take the next epoch from EEPROM, as the high half of a counter
+ *
+ * Taken once per boot, before the first delivery, so no boot reuses the
+ * counters of an earlier one even under a replayed HELLO's nonce. The
+ * epoch is stored high byte first: a write cut short leaves a bigger
+ * epoch, never one already used.
+ */
+static uint32_t vault_hid_epoch(void) {
+    uint8_t stored[EEPROM_SECRETS_HID_SIZE];
+    eeconfig_read_user_datablock(stored, EEPROM_SECRETS_HID_OFFSET, sizeof(stored));
+    uint16_t epoch = stored[0] == VAULT_HID_EPOCH_VERSION ? (stored[1] << 8 | stored[2]) + 1 : 1;
+
+    stored[0] = VAULT_HID_EPOCH_VERSION;
+    stored[1] = epoch >> 8;
+    stored[2] = epoch;
+    stored[3] = 0;
+    eeconfig_update_user_datablock(stored, EEPROM_SECRETS_HID_OFFSET, sizeof(stored));
+    return (uint32_t)epoch << 16;
+}
 
 /**
- * @brief Retrieve a secret by its index
+ * @brief RFC 8439 tag over associated data and ciphertext, cut to 8 bytes
+ *
+ * @param aad Associated data, at most 16 bytes
+ * @param cipher Ciphertext, at most 16 bytes
+ */
+static void vault_hid_tag(const uint32_t key[CHACHA20_KEY_WORDS], const uint32_t nonce[CHACHA20_NONCE_WORDS], const uint8_t *aad, uint8_t aad_length, const uint8_t *cipher, uint8_t cipher_length, uint8_t tag[SECRETS_HID_TAG_SIZE]) {
+    uint32_t block[CHACHA20_BLOCK_WORDS];
+    uint8_t  poly_key[POLY1305_KEY_SIZE];
+    uint8_t  message[48] = {0}; // aad, padded | cipher, padded | both lengths
+    uint8_t  full_tag[POLY1305_TAG_SIZE];
+
+    chacha20_block(key, 0, nonce, block);
+    for (uint8_t i = 0; i < POLY1305_KEY_SIZE; i++) {
+        poly_key[i] = chacha20_byte(block, i);
+    }
+    uint8_t at = 0;
+    memcpy(message + at, aad, aad_length);
+    at += (aad_length + 15) & ~15;
+    if (cipher_length) { // HELLO and ACK have no ciphertext, and pass NULL
+        memcpy(message + at, cipher, cipher_length);
+    }
+    at += (cipher_length + 15) & ~15;
+    message[at]     = aad_length;
+    message[at + 8] = cipher_length;
+    poly1305_mac(poly_key, message, at + 16, full_tag);
+    memcpy(tag, full_tag, SECRETS_HID_TAG_SIZE);
+
+    chacha20_wipe(block, sizeof(block));
+    chacha20_wipe(poly_key, sizeof(poly_key));
+    chacha20_wipe(message, sizeof(message));
+}
+
+/**
+ * @brief Compare tags in constant time
+ */
+static bool vault_hid_tag_equal(const uint8_t *a, const uint8_t *b) {
+    uint8_t diff = 0;
+    for (uint8_t i = 0; i < SECRETS_HID_TAG_SIZE; i++) {
+        diff |= a[i] ^ b[i];
+    }
+    return !diff;
+}
+
+/**
+ * @brief Seal secret entry into packets and send them to the companion
+ *
+ * Each packet decrypts at most 15 characters from the vault straight into
+ * the channel's keystream, so the plaintext is never whole in RAM here
+ * either.
  *
- * @param i The index of the secret to retrieve
- * @return const char* Pointer to the secret string, or NULL if index is invalid
+ * @return true Sent; typed later if no ACK arrives
+ * @return false No companion, or the secret is too long: type it now
+ */
+static bool vault_send_hid(uint16_t entry) {
+    uint16_t length  = vault_length(entry);
+    uint8_t  packets = length ? (length + SECRETS_HID_CHUNK - 1) / SECRETS_HID_CHUNK : 1;
+    if (!hid_hello_seen || timer_elapsed32(hid_hello_time) > SECRETS_HID_PRESENCE_MS || packets > SECRETS_HID_MAX_PACKETS || hid_pending_entry != VAULT_ENTRIES) {
+        return false;
+    }
+
+    uint32_t key[CHACHA20_KEY_WORDS];
+    uint32_t nonce[CHACHA20_NONCE_WORDS];
+    uint8_t  tag[SECRETS_HID_TAG_SIZE];
+    vault_hid_key_read(key);
+
+    // The HELLO proves the companion holds the key and chose this nonce
+    uint8_t hello[2 + SECRETS_HID_NONCE_SIZE] = {HID_CMD_SECRET, SECRETS_HID_HELLO};
+    memcpy(hello + 2, hid_nonce, SECRETS_HID_NONCE_SIZE);
+    vault_hid_nonce(nonce, HID_DIR_HELLO, 0, 0, hid_nonce);
+    vault_hid_tag(key, nonce, hello, sizeof(hello), NULL, 0, tag);
+    bool valid = vault_hid_tag_equal(tag, hid_hello_tag);
+    if (valid && !(uint16_t)hid_counter) {
+        hid_counter = vault_hid_epoch() | 1;
+    }
+
+    for (uint8_t index = 0; valid && index < packets; index++) {
+        uint32_t stream[CHACHA20_BLOCK_WORDS];
+        uint8_t  packet[HID_PACKET_SIZE] = {HID_CMD_SECRET, HID_STATUS_OK, SECRETS_HID_DELIVER, index, hid_counter, hid_counter >> 8, hid_counter >> 16, hid_counter >> 24, length};
+        uint8_t *chunk = packet + 9;
+
+        vault_hid_nonce(nonce, HID_DIR_DELIVER, index, hid_counter, hid_nonce);
+        chacha20_block(key, 1, nonce, stream);
+        for (uint8_t i = 0; i < SECRETS_HID_CHUNK; i++) {
+            uint16_t pos = index * SECRETS_HID_CHUNK + i;
+            chunk[i]     = (pos < length ? vault_source(entry, pos) : 0) ^ chacha20_byte(stream, i);
+        }
+        vault_hid_tag(key, nonce, packet, 9, chunk, SECRETS_HID_CHUNK, chunk + SECRETS_HID_CHUNK);
+        raw_hid_send(packet, sizeof(packet));
+        chacha20_wipe(stream, sizeof(stream));
+    }
+    vault_source(entry, OUTPUT_SOURCE_END);
+    chacha20_wipe(key, sizeof(key));
+
+    if (!valid) {
+        hid_hello_seen = false; // Forged or stale: ignore until the next HELLO
+        return false;
+    }
+    EVLOG_INFO(EV_SECRET_HID_SENT, packets, hid_counter);
+    hid_pending_entry   = entry;
+    hid_pending_counter = hid_counter++;
+    hid_pending_timer   = timer_read();
+    memcpy(hid_pending_nonce, hid_nonce, SECRETS_HID_NONCE_SIZE);
+    return true;
+}
+
+/**
+ * @brief Type the pending secret if its ACK is overdue
+ */
+static void vault_hid_task(void) {
+    if (hid_pending_entry != VAULT_ENTRIES && timer_elapsed(hid_pending_timer) > SECRETS_HID_ACK_MS) {
+        uint16_t entry    = hid_pending_entry;
+        hid_pending_entry = VAULT_ENTRIES;
+        EVLOG_INFO(EV_SECRET_HID_DONE, 2, hid_pending_counter);
+        vault_type(entry);
+    }
+}
+
+void secrets_raw_hid(uint8_t *data, uint8_t length) {
+    uint8_t op     = data[1];
+    uint8_t status = HID_STATUS_BAD_ARG;
+
+    if (op == SECRETS_HID_HELLO) {
+        memcpy(hid_nonce, data + 2, SECRETS_HID_NONCE_SIZE);
+        memcpy(hid_hello_tag, data + 2 + SECRETS_HID_NONCE_SIZE, SECRETS_HID_TAG_SIZE);
+        hid_hello_time = timer_read32();
+        hid_hello_seen = true;
+        status         = HID_STATUS_OK;
+    } else if (op == SECRETS_HID_ACK && hid_pending_entry != VAULT_ENTRIES) {
+        uint32_t key[CHACHA20_KEY_WORDS];
+        uint32_t nonce[CHACHA20_NONCE_WORDS];
+        uint8_t  tag[SECRETS_HID_TAG_SIZE];
+        uint32_t counter = data[2] | (data[3] << 8) | ((uint32_t)data[4] << 16) | ((uint32_t)data[5] << 24);
+
+        vault_hid_key_read(key);
+        vault_hid_nonce(nonce, HID_DIR_ACK, 0, counter, hid_pending_nonce);
+        vault_hid_tag(key, nonce, data, 6, NULL, 0, tag);
+        chacha20_wipe(key, sizeof(key));
+
+        if (counter == hid_pending_counter && vault_hid_tag_equal(tag, data + 6)) {
+            EVLOG_INFO(EV_SECRET_HID_DONE, 1, counter);
+            hid_pending_entry = VAULT_ENTRIES;
+            status            = HID_STATUS_OK;
+        }
+    }
+    memset(data + 2, 0, length - 2);
+    data[1] = status;
+    data[2] = op;
+}
+
+/**
+ * @brief Send a password or tagged secret to the companion, or type it
+ */
+static void vault_deliver(uint16_t entry) {
+    if (!vault_send_hid(entry)) {
+        vault_type(entry);
+    }
+}
+#else
+static inline void vault_hid_task(void) {}
+static inline void vault_deliver(uint16_t entry) {
+    vault_type(entry);
+}
+#endif // SECRETS_HID_ENABLE
+
+/**
+ * @brief Forget the vault key and drop anything still being typed from it
  */
-const char *get_secret(uint8_t i) {
-  return (i < SECRET_COUNT) ? secret_list[i] : NULL;
+static void vault_lock(void) {
+#ifdef SECRETS_HID_ENABLE
+    hid_pending_entry = VAULT_ENTRIES; // An ACK can't come back to a locked vault
+#endif
+    vault_select_end();
+    output_queue_clear();
+    vault_stream_wipe();
+    chacha20_wipe(vault_key, sizeof(vault_key));
 }
 
 // ==== STATE VARIABLES ====
@@ -57,6 +529,11 @@ static bool secrets_unlocked = false;
 #define LOCK_TIMEOUT_MS 300000  // Default: 5 minutes
 #endif
 
+// timer_elapsed32() is only wrap-safe for intervals under half the 32-bit range
+#if LOCK_TIMEOUT_MS >= 0x80000000UL
+#error "LOCK_TIMEOUT_MS must be below 2^31 ms"
+#endif
+
 /**
  * @brief Timestamp of the last successful unlock, used for auto-lock timeout
  */
@@ -68,17 +545,12 @@ static uint32_t unlock_timer = 0;
 static bool pin_entry_mode = false;
 
 /**
- * @brief Maximum length for the PIN input buffer
- */
-#define MAX_PIN_LENGTH 32
-
-/**
- * @brief Buffer to store PIN digits as they're entered
+ * @brief Maximum number of PIN digits, as in tools/secrets_vault.py
  */
-static char pin_buffer[MAX_PIN_LENGTH];
+#define MAX_PIN_LENGTH 31
 
 /**
- * @brief Current position in the PIN buffer
+ * @brief Number of PIN digits entered
  */
 static uint8_t pin_index = 0;
 
@@ -104,31 +576,55 @@ bool is_pin_entry_mode(void) {
     return pin_entry_mode;
 }
 
+bool is_secret_input_mode(void) {
+    return pin_entry_mode || vault_selecting;
+}
+
 // ==== COMMAND FUNCTIONS ====
 
+/**
+ * @brief Leave PIN entry mode, wiping the digits folded in so far
+ *
+ * The digits themselves never reach the key history (keymap.c runs PIN
+ * entry first), but the history is cleared anyway so the text typed before
+ * the PIN can't join up with the text after it in a snippet or typo match.
+ */
+static void pin_entry_end(void) {
+    if (pin_entry_mode) {
+        key_history_clear();
+    }
+    pin_entry_mode = false;
+    vault_pin_wipe();
+    pin_index = 0;
+}
+
 /**
  * @brief Lock the secrets system
  * 
- * This clears the unlocked state and PIN buffer, and exits PIN entry mode.
+ * This clears the unlocked state, PIN state and vault key, drops any
+ * secret still being typed, and exits PIN entry mode.
  */
 void secrets_lock(void) {
-    dprint("▶ LOCK command received – locking secrets\n");
+    EVLOG_INFO(EV_SECRETS_LOCK, 0, 0);
+    TELEMETRY_INC(secrets_locks);
     secrets_unlocked = false;
-    pin_entry_mode = false;
-    pin_index = 0;
-    pin_buffer[0] = '\0';
+    pin_entry_end();
+    vault_lock();
 }
 
 /**
  * @brief Enter PIN entry mode to unlock secrets
  * 
- * If secrets are already unlocked, this will lock them instead.
+ * If secrets are already unlocked, this will lock them instead. A macro
+ * being recorded is dropped: the releases of the PIN digits would reach it.
  */
 void enter_pin_mode(void) {
     if (!secrets_unlocked) {
-        dprint("▶ Entering PIN mode\n");
+        EVLOG_INFO(EV_PIN_MODE, 0, 0);
+        macro_recorder_discard();
         pin_entry_mode = true;
         pin_index = 0;
+        vault_pin_start();
     } else {
         secrets_lock();
     }
@@ -136,6 +632,25 @@ void enter_pin_mode(void) {
 
 // ==== PIN PROCESSING ====
 
+/**
+ * @brief Digit typed by a number row or numpad key
+ *
+ * @param keycode The QMK keycode being processed
+ * @return int8_t 0-9, or -1 if the key isn't a digit
+ */
+static int8_t keycode_to_digit(uint16_t keycode) {
+    if (keycode >= KC_KP_1 && keycode <= KC_KP_9) {
+        return (keycode - KC_KP_1) + 1;  // KP1→1, KP2→2, …
+    } else if (keycode == KC_KP_0) {
+        return 0;
+    } else if (keycode >= KC_1 && keycode <= KC_9) {
+        return (keycode - KC_1) + 1;     // '1'→1, '2'→2, …
+    } else if (keycode == KC_0) {
+        return 0;
+    }
+    return -1;
+}
+
 /**
  * @brief Process keystrokes during PIN entry mode
  *
@@ -153,60 +668,46 @@ bool process_pin_entry(uint16_t keycode, keyrecord_t *record) {
         return true;
     }
 
-    dprintf("▶ PIN mode: keycode=%d\n", keycode);
-
     // Handle digit keys (main row and numpad)
-    if ((keycode >= KC_1 && keycode <= KC_0) || 
-        (keycode >= KC_KP_1 && keycode <= KC_KP_0))
-    {
-        uint8_t val;
-        // Convert keycode to numeric value
-        if (keycode >= KC_KP_1 && keycode <= KC_KP_9) {
-            val = (keycode - KC_KP_1) + 1;  // KP1→1, KP2→2, …
-        } else if (keycode == KC_KP_0) {
-            val = 0;
+    int8_t val = keycode_to_digit(keycode);
+    if (val >= 0) {
+        // Fold the digit into the key derivation if there's room
+        if (pin_index < MAX_PIN_LENGTH) {
+            vault_pin_digit(val);
+            pin_index++;
+            EVLOG_DEBUG(EV_PIN_DIGIT, pin_index, 0); // Never log the digit itself
         } else {
-            val = (keycode - KC_1) + 1;     // '1'→1, '2'→2, …
-        }
-        
-        // Add digit to buffer if there's room
-        if (pin_index < MAX_PIN_LENGTH - 1) {
-            pin_buffer[pin_index++] = '0' + val;
-            dprintf("▶ Digit added: %c (index=%d)\n", '0'+val, pin_index-1);
-        } else {
-            dprint("▶ PIN buffer full!\n");
+            EVLOG_INFO(EV_PIN_FULL, 0, 0);
         }
         return false;  // Consume the key
     }
+
+    // Digits are excluded above so the log cannot reconstruct the PIN
+    EVLOG_DEBUG(EV_PIN_KEY, keycode, 0);
     
     // Handle Enter key to submit PIN
     if (keycode == KC_PENT || keycode == KC_ENT) {
-        // Null-terminate the PIN string
-        pin_buffer[pin_index] = '\0';
-        dprintf("▶ PIN entered: %s (length=%d)\n", pin_buffer, pin_index);
-        
-        // Validate against stored PIN
-        if (!strcmp(pin_buffer, SECRET_PIN)) {
-            dprint("▶ PIN CORRECT - Secrets unlocked!\n");
+        // Validate by finishing the vault key; no plaintext PIN is stored
+        bool correct = vault_unlock();
+        EVLOG_INFO(EV_PIN_SUBMIT, correct, 0); // The length would narrow a guess
+        if (correct) {
+            TELEMETRY_INC(secrets_unlocks);
             secrets_unlocked = true;
             // Reset unlock timer
             unlock_timer = timer_read32();
         } else {
-            dprint("▶ PIN INCORRECT - Access denied\n");
+            TELEMETRY_INC(secrets_failures);
         }
         
         // Clean up and exit PIN mode
-        dprint("▶ Exiting PIN mode\n");
-        pin_entry_mode = false;
-        pin_index = 0;
+        pin_entry_end();
         return false;  // Consume the key
     }
     
     // Handle Escape key to cancel PIN entry
     if (keycode == KC_ESC) {
-        dprint("▶ PIN entry canceled\n");
-        pin_entry_mode = false;
-        pin_index = 0;
+        EVLOG_INFO(EV_PIN_CANCEL, 0, 0);
+        pin_entry_end();
         return false;  // Consume the key
     }
 
@@ -217,8 +718,9 @@ bool process_pin_entry(uint16_t keycode, keyrecord_t *record) {
 /**
  * @brief Process keystrokes for secret-related keycodes
  *
- * Handles sending of secrets when their corresponding keys are pressed.
- * Blocks access to secrets when the system is locked.
+ * Queues the decrypting source for a secret, then Enter, when its key is
+ * pressed, or when a tag is typed after SECRET_SELECT. Blocks access to
+ * secrets when the system is locked.
  *
  * @param keycode The QMK keycode being processed
  * @param record Key event record containing press/release info
@@ -227,23 +729,65 @@ bool process_pin_entry(uint16_t keycode, keyrecord_t *record) {
  */
 bool process_secret_keycodes(uint16_t keycode, keyrecord_t *record) {
     // Block secret macros if system is locked
-    if (keycode >= E_PIN && keycode <= E_PASS4 && !secrets_unlocked) {
+    if (((keycode >= E_PIN && keycode <= E_PASS4) || keycode == SECRET_SELECT) && !secrets_unlocked) {
         return false;  // Silently consume the key
     }
 
     // Handle secret macro keycodes
     if (record->event.pressed && keycode >= E_SECRET_START && keycode < E_SECRET_END) {
-        uint8_t idx = keycode - E_SECRET_START;
-        const char *secret = get_secret(idx);
-        if (secret) {
-            // Type out the secret and press Enter
-            send_string_with_delay(secret, 1);
-            tap_code(KC_ENT);
+        if (keycode >= E_PASS1) {
+            vault_deliver(keycode - E_SECRET_START);
+        } else {
+            vault_type(keycode - E_SECRET_START);
         }
         // Consume the key
         return false;
     }
 
+    // Start typing a tag, never into a macro
+    if (keycode == SECRET_SELECT) {
+        if (record->event.pressed) {
+            vault_select_end();
+            macro_recorder_discard();
+            vault_selecting = true;
+        }
+        return false;
+    }
+
+    if (vault_selecting && record->event.pressed) {
+        int8_t digit = keycode_to_digit(keycode);
+        if (digit >= 0) {
+            if (vault_select_digits < VAULT_TAG_DIGITS) {
+                vault_select_tag = vault_select_tag * 10 + digit;
+                vault_select_digits++;
+            }
+            return false;
+        }
+        // Enter types the secret with the tag typed so far, if there is one
+        if (keycode == KC_PENT || keycode == KC_ENT) {
+            uint16_t entry = vault_select_digits ? vault_find(vault_select_tag) : VAULT_ENTRIES;
+            EVLOG_INFO(EV_VAULT_SELECT, vault_select_digits, entry < VAULT_ENTRIES);
+            if (entry < VAULT_ENTRIES) {
+                vault_deliver(entry);
+            }
+            vault_select_end();
+            return false;
+        }
+        if (keycode == KC_ESC) {
+            vault_select_end();
+            return false;
+        }
+
+        // Anything else would land in the field the secret is meant for,
+        // between the tag's digits. Modifiers and layer keys still work, so
+        // the numpad stays in reach.
+        if (IS_MODIFIER_KEYCODE(keycode) || (keycode >= QK_TO && keycode <= QK_LAYER_TAP_TOGGLE_MAX) ||
+            ((IS_QK_MOD_TAP(keycode) || IS_QK_LAYER_TAP(keycode)) && !record->tap.count)) {
+            return true;
+        }
+        return false;
+    }
+
     // Allow other keys to pass through
     return true;
 }
@@ -272,13 +816,17 @@ bool process_pin_entry_keycode(uint16_t keycode, keyrecord_t *record) {
  * This should be called regularly from matrix_scan_user()
  */
 void secrets_timer_task(void) {
-    // Check if timeout has elapsed since last unlock
-    if (secrets_unlocked && timer_elapsed(unlock_timer) > LOCK_TIMEOUT_MS) {
-        dprint("▶ Auto-lock timeout reached – locking secrets\n");
+    vault_hid_task();
+
+    // Check if timeout has elapsed since last unlock. The timeout is longer
+    // than the 16-bit timer can represent, so use the 32-bit variant.
+    if (secrets_unlocked && timer_elapsed32(unlock_timer) > LOCK_TIMEOUT_MS) {
+        EVLOG_INFO(EV_AUTO_LOCK, 0, 0);
+        TELEMETRY_INC(secrets_locks);
+        TELEMETRY_INC(secrets_auto_locks);
         secrets_unlocked = false;
-        pin_entry_mode = false;
-        pin_index = 0;
-        pin_buffer[0] = '\0';
+        pin_entry_end();
+        vault_lock();
     }
 }
 
@@ -288,8 +836,10 @@ void secrets_timer_task(void) {
  * Locks secrets when Windows lock shortcut is used
  */
 void secrets_gui_lock(void) {
-    dprint("▶ GUI+L detected – locking secrets\n");
+    EVLOG_INFO(EV_GUI_LOCK, 0, 0);
+    TELEMETRY_INC(secrets_locks);
     secrets_unlocked = false;
+    vault_lock();
 }
 
 // ==== RGB INDICATORS ====
@@ -297,11 +847,13 @@ void secrets_gui_lock(void) {
 /**
  * @brief Get the current security state for RGB indicators
  *
- * @return uint8_t 0: Locked, 1: PIN entry mode, 2: Unlocked
+ * @return uint8_t 0: Locked, 1: PIN entry mode, 2: Unlocked, 3: Typing a tag
  */
 uint8_t secrets_get_indicator_state(void) {
     if (pin_entry_mode) {
         return 1; // PIN entry mode
+    } else if (vault_selecting) {
+        return 3; // Typing a tag after SECRET_SELECT
     } else if (secrets_unlocked) {
         return 2; // Unlocked
     } else {
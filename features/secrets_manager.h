@@ -1,165 +1,225 @@
-/**
- * @file secrets_manager.h
- * @brief Secure secrets management system for QMK keyboards
- *
- * This module provides a complete secrets management system that allows:
- * - Storing and retrieving secrets securely
- * - PIN-based authentication to unlock secrets
- * - Auto-locking after timeout for security
- * - Visual status indicators through RGB
- * - Secure typing of secrets directly from the keyboard
- *
- * To use this module:
- * 1. Define SECRETS_ENABLED in config.h
- * 2. Create a secrets.h file with your sensitive data
- * 3. Call secrets_timer_task() from matrix_scan_user()
- * 4. Process keystrokes with process_pin_entry() and process_secret_keycodes()
- */
-
-#ifndef SECRETS_MANAGER_H
-#define SECRETS_MANAGER_H
-
-#if !defined(SECRETS_ENABLED) || (SECRETS_ENABLED != yes)
-    #error "SECRETS_ENABLED must be defined as 'yes' in your config.h"
-#endif
-
-#include "secrets.h"
-#include "custom_keycodes.h"
-
-// ==== SECRET DECLARATIONS ====
-
-/**
- * @brief Declare the secret constants as extern
- * These are defined in secrets_manager.c
- */
-#define X(name, val) extern const char * const name;
-SECRETS_LIST(X)
-#undef X
-
-/**
- * @brief Array of pointers to all secrets for easy access by index
- * This corresponds to keycodes E_PIN, E_PHRASE, E_PASS1, etc.
- */
-extern const char * const secret_list[];
-
-/**
- * @brief Number of secrets in the array
- */
-extern const uint8_t SECRET_COUNT;
-
-/**
- * @brief Get a secret by its index
- *
- * @param i Index of the secret to retrieve
- * @return const char* The secret string, or NULL if index is invalid
- */
-const char *get_secret(uint8_t i);
-
-// ==== STATE QUERY FUNCTIONS ====
-
-/**
- * @brief Check if secrets are currently unlocked
- *
- * @return true Secrets are unlocked and accessible
- * @return false Secrets are locked
- */
-bool is_secrets_unlocked(void);
-
-/**
- * @brief Check if PIN entry mode is active
- *
- * @return true PIN entry mode is active
- * @return false PIN entry mode is not active
- */
-bool is_pin_entry_mode(void);
-
-// ==== COMMAND FUNCTIONS ====
-
-/**
- * @brief Lock the secrets system
- * 
- * This clears the unlocked state and PIN buffer, and exits PIN entry mode.
- */
-void secrets_lock(void);
-
-/**
- * @brief Enter PIN entry mode to unlock secrets
- * 
- * If secrets are already unlocked, this will lock them instead.
- */
-void enter_pin_mode(void);
-
-/**
- * @brief Special handler for GUI+L key combination
- * 
- * Call this when Windows lock shortcut is pressed to also lock secrets
- */
-void secrets_gui_lock(void);
-
-// ==== KEYCODE PROCESSING ====
-
-/**
- * @brief Process keystrokes for PIN_ENTRY keycode activation
- *
- * This function handles activation of PIN entry mode via dedicated keycode
- *
- * @param keycode The QMK keycode being processed
- * @param record Key event record containing press/release info
- * @return true Allow QMK to process this key normally
- * @return false Key was consumed by PIN entry keycode processing
- */
-bool process_pin_entry_keycode(uint16_t keycode, keyrecord_t *record);
-
-/**
- * @brief Process keystrokes during PIN entry mode
- *
- * This function handles all PIN entry functionality:
- * - Digit entry (both number row and numpad)
- * - PIN submission (Enter)
- * - Cancellation (Escape)
- * - Authentication against stored PIN
- *
- * @param keycode The QMK keycode being processed
- * @param record Key event record containing press/release info
- * @return true Allow QMK to process this key normally
- * @return false Key was consumed by PIN processing
- */
-bool process_pin_entry(uint16_t keycode, keyrecord_t *record);
-
-/**
- * @brief Process keystrokes for secret-related keycodes
- *
- * This function:
- * - Blocks access to secret keycodes when the system is locked
- * - Handles sending secrets when their corresponding keys are pressed
- *
- * @param keycode The QMK keycode being processed
- * @param record Key event record containing press/release info
- * @return true Allow QMK to process this key normally
- * @return false Key was consumed by secrets processing
- */
-bool process_secret_keycodes(uint16_t keycode, keyrecord_t *record);
-
-// ==== TIMER AND AUTO-LOCK ====
-
-/**
- * @brief Timer task to handle auto-locking of secrets
- * 
- * Call this regularly from matrix_scan_user() to enable auto-locking
- * after the timeout period (LOCK_TIMEOUT_MS).
- */
-void secrets_timer_task(void);
-
-// ==== RGB INDICATORS ====
-
-/**
- * @brief Get the current security state for RGB indicators
- *
- * This function returns a numeric value representing the security state
- * that can be used for RGB indicators.
- *
- * @return uint8_t 0: Locked, 1: PIN entry mode, 2: Unlocked
- */
-uint8_t secrets_get_indicator_state(void);
-
-#endif // SECRETS_MANAGER_H
+/**
+ * @file secrets_manager.h
+ * @brief Secure secrets management system for QMK keyboards
+ *
+ * This module provides a complete secrets management system that allows:
+ * - Storing and retrieving secrets securely
+ * - PIN-based authentication to unlock secrets
+ * - Auto-locking after timeout for security
+ * - Visual status indicators through RGB
+ * - Secure typing of secrets directly from the keyboard
+ *
+ * To use this module:
+ * 1. Set SECRETS_ENABLE = yes in rules.mk (otherwise every function below is
+ *    an inline no-op stub)
+ * 2. Create a secrets.h file with your sensitive data and encrypt it into
+ *    secrets_vault.h with tools/secrets_vault.py (rerun after every change)
+ * 3. Call secrets_timer_task() and output_queue_task() from matrix_scan_user()
+ * 4. Process keystrokes with process_pin_entry() and process_secret_keycodes()
+ *    ahead of every other handler, so no PIN or tag digit reaches the key
+ *    history, leader or macro recorder
+ *
+ * Only the encrypted vault is compiled in; secrets.h itself never is.
+ *
+ * With SECRETS_HID_ENABLE, E_PASS1..E_PASS4 and tagged secrets go to
+ * tools/secrets_companion.py over raw HID instead of being typed, whenever
+ * the companion is running; see RAW HID DELIVERY below.
+ */
+
+#ifndef SECRETS_MANAGER_H
+#define SECRETS_MANAGER_H
+
+#include "custom_keycodes.h"
+
+// ==== RAW HID DELIVERY ====
+
+/**
+ * @enum secrets_hid_op
+ * @brief Operations on the HID_CMD_SECRET channel
+ *
+ * Every packet is sealed with ChaCha20-Poly1305 (RFC 8439) under the key
+ * SECRETS_HID_KEY from secrets.h, with the tag cut to 8 bytes. The nonce is
+ * [direction][index][counter, 4 bytes LE][companion nonce, 6 bytes] and the
+ * associated data is every packet byte before the ciphertext (or tag).
+ *
+ *   companion: [cmd][HELLO][nonce 6][tag 8]           direction 2, once a second
+ *   keyboard:  [cmd][status][DELIVER][index][counter 4][length][chunk 15][tag 8]
+ *                                                     direction 0, per packet
+ *   companion: [cmd][ACK][counter 4][tag 8]           direction 1
+ *
+ * The keyboard answers HELLO and ACK with [cmd][status][op]. A secret of
+ * up to SECRETS_HID_MAX_PACKETS * 15 characters goes out while a HELLO is
+ * less than SECRETS_HID_PRESENCE_MS old; if no ACK follows within
+ * SECRETS_HID_ACK_MS it is typed instead. A counter's high half is an
+ * epoch kept in EEPROM and bumped on each boot's first delivery, so a
+ * replayed HELLO still never gets a (counter, nonce) pair sent before,
+ * across reboots too; only clearing the EEPROM starts the epochs over.
+ */
+enum secrets_hid_op {
+    SECRETS_HID_HELLO   = 0x00, /**< Companion is listening, with a fresh nonce */
+    SECRETS_HID_DELIVER = 0x01, /**< One chunk of a secret, keyboard to companion */
+    SECRETS_HID_ACK     = 0x02, /**< Companion received the whole secret */
+};
+
+/**
+ * @brief Packet geometry, mirrored in tools/secrets_companion.py
+ */
+#define SECRETS_HID_NONCE_SIZE 6
+#define SECRETS_HID_TAG_SIZE 8
+#define SECRETS_HID_CHUNK 15
+
+#ifdef SECRETS_ENABLE
+
+// ==== STATE QUERY FUNCTIONS ====
+
+/**
+ * @brief Check if secrets are currently unlocked
+ *
+ * @return true Secrets are unlocked and accessible
+ * @return false Secrets are locked
+ */
+bool is_secrets_unlocked(void);
+
+/**
+ * @brief Check if PIN entry mode is active
+ *
+ * @return true PIN entry mode is active
+ * @return false PIN entry mode is not active
+ */
+bool is_pin_entry_mode(void);
+
+/**
+ * @brief Check if the keys being typed are secret: a PIN, or a tag after
+ *        SECRET_SELECT
+ *
+ * @return true PIN entry or tag selection is active
+ * @return false Keys typed now are ordinary input
+ */
+bool is_secret_input_mode(void);
+
+// ==== COMMAND FUNCTIONS ====
+
+/**
+ * @brief Lock the secrets system
+ * 
+ * This clears the unlocked state, PIN state and vault key, drops any
+ * secret still being typed, and exits PIN entry mode.
+ */
+void secrets_lock(void);
+
+/**
+ * @brief Enter PIN entry mode to unlock secrets
+ * 
+ * If secrets are already unlocked, this will lock them instead.
+ */
+void enter_pin_mode(void);
+
+/**
+ * @brief Special handler for GUI+L key combination
+ * 
+ * Call this when Windows lock shortcut is pressed to also lock secrets
+ */
+void secrets_gui_lock(void);
+
+// ==== KEYCODE PROCESSING ====
+
+/**
+ * @brief Process keystrokes for PIN_ENTRY keycode activation
+ *
+ * This function handles activation of PIN entry mode via dedicated keycode
+ *
+ * @param keycode The QMK keycode being processed
+ * @param record Key event record containing press/release info
+ * @return true Allow QMK to process this key normally
+ * @return false Key was consumed by PIN entry keycode processing
+ */
+bool process_pin_entry_keycode(uint16_t keycode, keyrecord_t *record);
+
+/**
+ * @brief Process keystrokes during PIN entry mode
+ *
+ * This function handles all PIN entry functionality:
+ * - Digit entry (both number row and numpad)
+ * - PIN submission (Enter)
+ * - Cancellation (Escape)
+ * - Authentication by deriving the vault key from the PIN
+ *
+ * @param keycode The QMK keycode being processed
+ * @param record Key event record containing press/release info
+ * @return true Allow QMK to process this key normally
+ * @return false Key was consumed by PIN processing
+ */
+bool process_pin_entry(uint16_t keycode, keyrecord_t *record);
+
+/**
+ * @brief Process keystrokes for secret-related keycodes
+ *
+ * This function:
+ * - Blocks access to secret keycodes when the system is locked
+ * - Handles sending secrets when their corresponding keys are pressed
+ * - Handles SECRET_SELECT: a tag typed on the number row or numpad, then
+ *   Enter, sends the tagged secret (Esc cancels). Other keys are dropped
+ *   until then, except modifiers and layer keys
+ *
+ * @param keycode The QMK keycode being processed
+ * @param record Key event record containing press/release info
+ * @return true Allow QMK to process this key normally
+ * @return false Key was consumed by secrets processing
+ */
+bool process_secret_keycodes(uint16_t keycode, keyrecord_t *record);
+
+// ==== TIMER AND AUTO-LOCK ====
+
+/**
+ * @brief Timer task to handle auto-locking of secrets
+ * 
+ * Call this regularly from matrix_scan_user() to enable auto-locking
+ * after the timeout period (LOCK_TIMEOUT_MS). With SECRETS_HID_ENABLE it
+ * also types a raw HID delivery the companion didn't acknowledge.
+ */
+void secrets_timer_task(void);
+
+// ==== RAW HID ====
+
+#ifdef SECRETS_HID_ENABLE
+/**
+ * @brief Handle a HID_CMD_SECRET request from the companion
+ *
+ * Answers in place, like the other raw HID handlers.
+ *
+ * @param data The 32-byte packet
+ * @param length Packet length
+ */
+void secrets_raw_hid(uint8_t *data, uint8_t length);
+#endif
+
+// ==== RGB INDICATORS ====
+
+/**
+ * @brief Get the current security state for RGB indicators
+ *
+ * This function returns a numeric value representing the security state
+ * that can be used for RGB indicators.
+ *
+ * @return uint8_t 0: Locked, 1: PIN entry mode, 2: Unlocked, 3: Typing a tag
+ */
+uint8_t secrets_get_indicator_state(void);
+
+#else // SECRETS_ENABLE
+
+// Disabled in rules.mk: no-op stubs so callers compile away.
+static inline bool is_secrets_unlocked(void) { return false; }
+static inline bool is_pin_entry_mode(void) { return false; }
+static inline bool is_secret_input_mode(void) { return false; }
+static inline void secrets_lock(void) {}
+static inline void enter_pin_mode(void) {}
+static inline void secrets_gui_lock(void) {}
+static inline bool process_pin_entry_keycode(uint16_t keycode, keyrecord_t *record) { return true; }
+static inline bool process_pin_entry(uint16_t keycode, keyrecord_t *record) { return true; }
+static inline bool process_secret_keycodes(uint16_t keycode, keyrecord_t *record) { return true; }
+static inline void secrets_timer_task(void) {}
+static inline uint8_t secrets_get_indicator_state(void) { return 0; }
+
+#endif // SECRETS_ENABLE
+
+#endif // SECRETS_MANAGER_H
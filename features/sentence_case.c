@@ -24,6 +24,9 @@
 
 #include <string.h>
 
+#include "custom_keycodes.h"
+#include "features/event_log.h"
+
 #if defined(NO_ACTION_ONESHOT)
 // One-shot keys must be enabled for Sentence Case. One-shot keys are enabled
 // by default, but are disabled by `#define NO_ACTION_ONESHOT` in config.h. If
@@ -38,8 +41,23 @@ ASSERT_COMMUNITY_MODULES_MIN_API_VERSION(1, 0, 0);
 #  define SENTENCE_CASE_TIMEOUT 5000
 #endif  // SENTENCE_CASE_TIMEOUT
 
-// Number of keys of state history to retain for backspacing.
-#define STATE_HISTORY_SIZE 6
+#if SENTENCE_CASE_STATE_HISTORY_SIZE < 1 || \
+    SENTENCE_CASE_STATE_HISTORY_SIZE * 3 > 64
+#error "sentence_case: SENTENCE_CASE_STATE_HISTORY_SIZE must be 1 to 21"
+#endif
+
+// States are packed 3 bits apiece, most recent state in the low bits.
+#define STATE_BITS 3
+#define STATE_MASK ((1 << STATE_BITS) - 1)
+#if SENTENCE_CASE_STATE_HISTORY_SIZE * STATE_BITS > 32
+typedef uint64_t state_history_t;
+#else
+typedef uint32_t state_history_t;
+#endif
+#define STATE_HISTORY_BITS (SENTENCE_CASE_STATE_HISTORY_SIZE * STATE_BITS)
+#define STATE_HISTORY_MASK                     \
+  ((state_history_t)~(state_history_t)0 >>     \
+   (sizeof(state_history_t) * 8 - STATE_HISTORY_BITS))
 
 // clang-format off
 /** States in matching the beginning of a sentence. */
@@ -51,35 +69,35 @@ enum {
   STATE_PRIMED,   /**< "Primed" state, in the space following an ending. */
   STATE_DISABLED, /**< Sentence Case is disabled. */
 };
-
-/** Keycodes to be used */
-enum {
-  SENTENCE_CASE_ON,
-  SENTENCE_CASE_OFF,
-  SENTENCE_CASE_TOGGLE,
-};
 // clang-format on
 
 #if SENTENCE_CASE_TIMEOUT > 0
 static uint16_t idle_timer = 0;
 #endif  // SENTENCE_CASE_TIMEOUT > 0
-#if SENTENCE_CASE_BUFFER_SIZE > 1
-static uint16_t key_buffer[SENTENCE_CASE_BUFFER_SIZE] = {0};
-#endif  // SENTENCE_CASE_BUFFER_SIZE > 1
-static uint8_t state_history[STATE_HISTORY_SIZE];
+static state_history_t state_history = 0;
 static uint16_t suppress_key = KC_NO;
 static uint8_t sentence_state = STATE_INIT;
 
+#ifdef SENTENCE_CASE_STATS
+static sentence_case_stats_t stats = {0};
+#define STATS_INC(field)                                \
+  do {                                                  \
+    if (stats.field != (__typeof__(stats.field))~0) {   \
+      ++stats.field;                                    \
+    }                                                   \
+  } while (0)
+
+const sentence_case_stats_t* sentence_case_get_stats(void) { return &stats; }
+void sentence_case_reset_stats(void) { memset(&stats, 0, sizeof(stats)); }
+#else
+#define STATS_INC(field)
+#endif  // SENTENCE_CASE_STATS
+
 // Sets the current state to `new_state`.
 static void set_sentence_state(uint8_t new_state) {
-#if !defined(NO_DEBUG) && defined(SENTENCE_CASE_DEBUG)
-  if (debug_enable && sentence_state != new_state) {
-    static const char* state_names[] = {
-        "INIT", "WORD", "ABBREV", "ENDING", "PRIMED", "DISABLED",
-    };
-    dprintf("Sentence case: %s\n", state_names[new_state]);
+  if (sentence_state != new_state) {
+    EVLOG_DEBUG(EV_SENTENCE_STATE, sentence_state, new_state);
   }
-#endif  // !NO_DEBUG && SENTENCE_CASE_DEBUG
 
   const bool primed = (new_state == STATE_PRIMED);
   if (primed != (sentence_state == STATE_PRIMED)) {
@@ -92,7 +110,7 @@ static void clear_state_history(void) {
 #if SENTENCE_CASE_TIMEOUT > 0
   idle_timer = 0;
 #endif  // SENTENCE_CASE_TIMEOUT > 0
-  memset(state_history, STATE_INIT, sizeof(state_history));
+  state_history = 0;  // All STATE_INIT.
   if (sentence_state != STATE_DISABLED) {
     set_sentence_state(STATE_INIT);
   }
@@ -101,9 +119,6 @@ static void clear_state_history(void) {
 void sentence_case_clear(void) {
   clear_state_history();
   suppress_key = KC_NO;
-#if SENTENCE_CASE_BUFFER_SIZE > 1
-  memset(key_buffer, 0, sizeof(key_buffer));
-#endif  // SENTENCE_CASE_BUFFER_SIZE > 1
 }
 
 void sentence_case_on(void) {
@@ -127,6 +142,43 @@ void sentence_case_toggle(void) {
   }
 }
 
+void sentence_case_rewrite_P(uint8_t erased, const char* text_P) {
+  if (sentence_state == STATE_DISABLED) {
+    return;
+  }
+
+  for (; erased; --erased) {  // As for Backspace below.
+    set_sentence_state(state_history & STATE_MASK);
+    state_history >>= STATE_BITS;
+  }
+  for (char c; (c = pgm_read_byte(text_P)); ++text_P) {
+    // Characters move on as their keys do in the table below, classified as
+    // sentence_case_press_user() does. A sentence start was capitalized when
+    // first typed, and nothing is capitalized here.
+    uint8_t new_state = STATE_INIT;
+    if (('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z')) {
+      new_state = (sentence_state == STATE_ABBREV ||
+                   sentence_state == STATE_ENDING) ? STATE_ABBREV : STATE_WORD;
+    } else if (c == '.' || c == '!' || c == '?') {
+      new_state = (sentence_state == STATE_WORD) ? STATE_ENDING : STATE_ABBREV;
+    } else if (c == ' ') {
+      if (sentence_state == STATE_PRIMED || sentence_state == STATE_ENDING) {
+        new_state = STATE_PRIMED;
+      }
+    } else if (c == '\'' || c == '"') {
+      new_state = sentence_state;
+    } else if (c < ' ' || c > '~') {
+      // Enter, Tab: clears, as any other key does.
+      state_history = 0;
+      set_sentence_state(STATE_INIT);
+      continue;
+    }
+    state_history =
+        ((state_history << STATE_BITS) | sentence_state) & STATE_HISTORY_MASK;
+    set_sentence_state(new_state);
+  }
+}
+
 bool is_sentence_case_on(void) { return sentence_state != STATE_DISABLED; }
 bool is_sentence_case_primed(void) { return sentence_state == STATE_PRIMED; }
 
@@ -137,14 +189,26 @@ bool is_sentence_case_primed(void) { return sentence_state == STATE_PRIMED; }
 #error "sentence_case: SENTENCE_CASE_TIMEOUT must be between 100 and 30000 ms"
 #endif
 
+#endif  // SENTENCE_CASE_TIMEOUT > 0
+
 void housekeeping_task_sentence_case(void) {
+#if SENTENCE_CASE_TIMEOUT > 0
   if (idle_timer && timer_expired(timer_read(), idle_timer)) {
+    STATS_INC(timeouts);
     clear_state_history();  // Timed out; clear all state.
   }
-}
 #endif  // SENTENCE_CASE_TIMEOUT > 0
+}
 
 bool process_record_sentence_case(uint16_t keycode, keyrecord_t* record) {
+  // The toggle keycode (custom_keycodes.h) has to work while disabled too.
+  if (keycode == SENTENCE_CASE_TOGGLE) {
+    if (record->event.pressed) {
+      sentence_case_toggle();
+    }
+    return false;
+  }
+
   // Only process while enabled, and only process press events.
   if (sentence_state == STATE_DISABLED || !record->event.pressed) {
     return true;
@@ -153,18 +217,9 @@ bool process_record_sentence_case(uint16_t keycode, keyrecord_t* record) {
 #if SENTENCE_CASE_TIMEOUT > 0
   idle_timer = (record->event.time + SENTENCE_CASE_TIMEOUT) | 1;
 #endif  // SENTENCE_CASE_TIMEOUT > 0
+  STATS_INC(keys);
 
   switch (keycode) {
-    case SENTENCE_CASE_ON:
-      sentence_case_on();
-      return false;
-    case SENTENCE_CASE_OFF:
-      sentence_case_off();
-      return false;
-    case SENTENCE_CASE_TOGGLE:
-      sentence_case_toggle();
-      return false;
-
     case KC_LCTL ... KC_RGUI:  // Ignore mod keys.
     case QK_ONE_SHOT_MOD ... QK_ONE_SHOT_MOD_MAX:  // Ignore one-shot mod.
     // Ignore MO, TO, TG, TT, OSL, TL layer switch keys.
@@ -207,16 +262,11 @@ bool process_record_sentence_case(uint16_t keycode, keyrecord_t* record) {
   }
 
   if (keycode == KC_BSPC) {
-    // Backspace key pressed. Rewind the state and key buffers.
-    set_sentence_state(state_history[STATE_HISTORY_SIZE - 1]);
-
-    memmove(state_history + 1, state_history, STATE_HISTORY_SIZE - 1);
-    state_history[0] = STATE_INIT;
-#if SENTENCE_CASE_BUFFER_SIZE > 1
-    memmove(key_buffer + 1, key_buffer,
-            (SENTENCE_CASE_BUFFER_SIZE - 1) * sizeof(uint16_t));
-    key_buffer[0] = KC_NO;
-#endif  // SENTENCE_CASE_BUFFER_SIZE > 1
+    // Backspace key pressed. Rewind the state; process_key_history() has
+    // already popped the key buffer.
+    STATS_INC(undos);
+    set_sentence_state(state_history & STATE_MASK);
+    state_history >>= STATE_BITS;  // STATE_INIT shifts in at the oldest end.
     return true;
   }
 
@@ -254,6 +304,7 @@ bool process_record_sentence_case(uint16_t keycode, keyrecord_t* record) {
           if (keycode != suppress_key) {
             suppress_key = keycode;
             set_oneshot_mods(MOD_BIT(KC_LSFT));  // Shift mod to capitalize.
+            STATS_INC(capitalizations);
             new_state = STATE_WORD;
           }
           break;
@@ -275,12 +326,9 @@ bool process_record_sentence_case(uint16_t keycode, keyrecord_t* record) {
       break;
 
     case ' ':  // Current key is a space.
-      if (sentence_state == STATE_PRIMED ||
-          (sentence_state == STATE_ENDING
-#if SENTENCE_CASE_BUFFER_SIZE > 1
-           && sentence_case_check_ending(key_buffer)
-#endif  // SENTENCE_CASE_BUFFER_SIZE > 1
-               )) {
+      // STATE_ENDING is only entered once check_ending() accepted the
+      // punctuation, so it needs no second look here.
+      if (sentence_state == STATE_PRIMED || sentence_state == STATE_ENDING) {
         new_state = STATE_PRIMED;
         suppress_key = KC_NO;
       }
@@ -291,49 +339,39 @@ bool process_record_sentence_case(uint16_t keycode, keyrecord_t* record) {
       break;
   }
 
-    // Slide key_buffer and state_history buffers one element to the left.
-    // Optimization note: Using manual loops instead of memmove() here saved
-    // ~100 bytes on AVR.
-#if SENTENCE_CASE_BUFFER_SIZE > 1
-  for (int8_t i = 0; i < SENTENCE_CASE_BUFFER_SIZE - 1; ++i) {
-    key_buffer[i] = key_buffer[i + 1];
-  }
-#endif  // SENTENCE_CASE_BUFFER_SIZE > 1
-  for (int8_t i = 0; i < STATE_HISTORY_SIZE - 1; ++i) {
-    state_history[i] = state_history[i + 1];
-  }
-
+  // Shift the state into the packed history. The current key is already in
+  // the shared key buffer.
 #if SENTENCE_CASE_BUFFER_SIZE > 1
-  key_buffer[SENTENCE_CASE_BUFFER_SIZE - 1] = keycode;
-  if (new_state == STATE_ENDING && !sentence_case_check_ending(key_buffer)) {
-#if defined SENTENCE_CASE_DEBUG
-    dprintf("Not a real ending.\n");
-#endif  // SENTENCE_CASE_DEBUG
+  if (new_state == STATE_ENDING &&
+      !sentence_case_check_ending(key_history_buffer())) {
+    EVLOG_DEBUG(EV_SENTENCE_REJECT, 0, 0);
+    STATS_INC(rejected_endings);
     new_state = STATE_INIT;
   }
 #endif  // SENTENCE_CASE_BUFFER_SIZE > 1
-  state_history[STATE_HISTORY_SIZE - 1] = sentence_state;
+  state_history =
+      ((state_history << STATE_BITS) | sentence_state) & STATE_HISTORY_MASK;
 
   set_sentence_state(new_state);
   return true;
 }
 
-bool sentence_case_just_typed_P(const uint16_t* buffer, const uint16_t* pattern,
-                                int8_t pattern_len) {
+bool sentence_case_just_typed(const uint32_t* buffer, uint64_t pattern,
+                              uint8_t pattern_len) {
 #if SENTENCE_CASE_BUFFER_SIZE > 1
-  buffer += SENTENCE_CASE_BUFFER_SIZE - pattern_len;
-  for (int8_t i = 0; i < pattern_len; ++i) {
-    if (buffer[i] != pgm_read_word(pattern + i)) {
-      return false;
-    }
-  }
-  return true;
+  uint64_t recent = buffer[0];
+#if SENTENCE_CASE_BUFFER_WORDS > 1
+  recent |= (uint64_t)buffer[1] << 32;
+#endif  // SENTENCE_CASE_BUFFER_WORDS > 1
+  const uint64_t mask =
+      (UINT64_C(1) << (pattern_len * SENTENCE_CASE_CLASS_BITS)) - 1;
+  return (recent & mask) == pattern;
 #else
   return false;
 #endif  // SENTENCE_CASE_BUFFER_SIZE > 1
 }
 
-__attribute__((weak)) bool sentence_case_check_ending(const uint16_t* buffer) {
+__attribute__((weak)) bool sentence_case_check_ending(const uint32_t* buffer) {
 #if SENTENCE_CASE_BUFFER_SIZE >= 5
   // Don't consider the abbreviations "vs." and "etc." to end the sentence.
   if (SENTENCE_CASE_JUST_TYPED(KC_SPC, KC_V, KC_S, KC_DOT) ||
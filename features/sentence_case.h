@@ -46,24 +46,95 @@
 #pragma once
 
 #include "quantum.h"
+#include "features/key_history.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-// The size of the keycode buffer for `sentence_case_check_ending()`. It must be
-// at least as large as the longest pattern checked. If less than 2, buffering
-// is disabled and the callback is not called.
+// The keycode buffer for `sentence_case_check_ending()` is the shared key
+// history (features/key_history.h), which autocorrect reads as well. Its size,
+// KEY_HISTORY_SIZE, must be at least as large as the longest pattern checked.
+// If less than 2, the callback is not called. A SENTENCE_CASE_BUFFER_SIZE set
+// in config.h can't resize it and has to match; set KEY_HISTORY_SIZE instead.
 #ifndef SENTENCE_CASE_BUFFER_SIZE
-#define SENTENCE_CASE_BUFFER_SIZE 8
+#define SENTENCE_CASE_BUFFER_SIZE KEY_HISTORY_SIZE
 #endif  // SENTENCE_CASE_BUFFER_SIZE
+#if SENTENCE_CASE_BUFFER_SIZE != KEY_HISTORY_SIZE
+#error "sentence_case: SENTENCE_CASE_BUFFER_SIZE must equal KEY_HISTORY_SIZE"
+#endif
+
+// Number of keys of state history to retain for backspacing. States are packed
+// 3 bits apiece into one word, so at most 21 steps are supported.
+#ifndef SENTENCE_CASE_STATE_HISTORY_SIZE
+#define SENTENCE_CASE_STATE_HISTORY_SIZE 6
+#endif  // SENTENCE_CASE_STATE_HISTORY_SIZE
+
+// The keycode buffer is bit-packed: each key is reduced to a 6-bit class (see
+// `SENTENCE_CASE_KEYCODE_CLASS()`) and the classes are shifted through an
+// array of 32-bit words, most recent key in the low bits of word 0.
+#define SENTENCE_CASE_CLASS_BITS KEY_HISTORY_CLASS_BITS
+#define SENTENCE_CASE_CLASS_MASK KEY_HISTORY_CLASS_MASK
+#define SENTENCE_CASE_BUFFER_WORDS KEY_HISTORY_WORDS
+
+// Longest pattern `SENTENCE_CASE_JUST_TYPED()` can compare in one 64-bit word.
+#define SENTENCE_CASE_MAX_PATTERN_LEN (64 / SENTENCE_CASE_CLASS_BITS)
+
+/** Maps a keycode to the 6-bit class stored in the keycode buffer. */
+#define SENTENCE_CASE_KEYCODE_CLASS(kc) KEY_HISTORY_CLASS(kc)
+
+/** RAM taken by the state history, in bytes; the key buffer is shared. */
+#define SENTENCE_CASE_HISTORY_BYTES \
+  (SENTENCE_CASE_STATE_HISTORY_SIZE * 3 > 32 ? 8 : 4)
+
+#ifdef SENTENCE_CASE_STATS
+/**
+ * Counters for measuring Sentence Case accuracy and cost, compiled in only when
+ * `SENTENCE_CASE_STATS` is defined. Counters saturate rather than wrap.
+ */
+typedef struct {
+  uint32_t keys;              /**< Press events examined. */
+  uint16_t capitalizations;   /**< Letters auto-shifted. */
+  uint16_t rejected_endings;  /**< Endings vetoed by check_ending(). */
+  uint16_t undos;             /**< Backspaces that rewound the state. */
+  uint16_t timeouts;          /**< Idle timeouts that cleared the state. */
+} sentence_case_stats_t;
+
+/** Gets the Sentence Case counters. */
+const sentence_case_stats_t* sentence_case_get_stats(void);
+/** Resets the Sentence Case counters to zero. */
+void sentence_case_reset_stats(void);
+#endif  // SENTENCE_CASE_STATS
 
+#ifdef SENTENCE_CASE_ENABLE
 void sentence_case_on(void); /**< Enables Sentence Case. */
 void sentence_case_off(void); /**< Disables Sentence Case. */
 void sentence_case_toggle(void); /**< Toggles Sentence Case. */
 bool is_sentence_case_on(void); /**< Gets whether currently enabled. */
 bool is_sentence_case_primed(void); /**< Whether currently primed. */
 void sentence_case_clear(void); /**< Clears Sentence Case to initial state. */
+/**
+ * Follows a rewrite of the text just typed, as autocorrect and snippets
+ * make it.
+ *
+ * Rewinds the state over the `erased` keys backspaced, then steps it over
+ * `text_P`, a PROGMEM ASCII string, without capitalizing any of it. Keeps
+ * one state per key on screen, so a later Backspace rewinds to the right
+ * one; \n and \t clear the state, as Enter and Tab do.
+ */
+void sentence_case_rewrite_P(uint8_t erased, const char* text_P);
+void housekeeping_task_sentence_case(void); /**< Runs the idle timeout. */
+#else
+// Disabled in rules.mk: no-op stubs so callers compile away.
+static inline void sentence_case_on(void) {}
+static inline void sentence_case_off(void) {}
+static inline void sentence_case_toggle(void) {}
+static inline bool is_sentence_case_on(void) { return false; }
+static inline bool is_sentence_case_primed(void) { return false; }
+static inline void sentence_case_clear(void) {}
+static inline void sentence_case_rewrite_P(uint8_t erased, const char* text_P) {}
+static inline void housekeeping_task_sentence_case(void) {}
+#endif  // SENTENCE_CASE_ENABLE
 
 /**
  * Optional callback to indicate primed state.
@@ -80,13 +151,14 @@ void sentence_case_primed(bool primed);
  * When a sentence-ending punctuation key is typed, this callback is called to
  * determine whether it is a real sentence ending, meaning the first letter of
  * the following word should be capitalized. For instance, abbreviations like
- * "vs." are usually not real sentence endings. The input argument is a buffer
- * of the last SENTENCE_CASE_BUFFER_SIZE keycodes. Returning true means it is a
- * real sentence ending; returning false means it is not.
+ * "vs." are usually not real sentence endings. The input argument is the
+ * packed buffer of the last SENTENCE_CASE_BUFFER_SIZE keycodes, to be examined
+ * with `SENTENCE_CASE_JUST_TYPED()`. Returning true means it is a real sentence
+ * ending; returning false means it is not.
  *
  * The default implementation checks for the abbreviations "vs." and "etc.":
  *
- *     bool sentence_case_check_ending(const uint16_t* buffer) {
+ *     bool sentence_case_check_ending(const uint32_t* buffer) {
  *       // Don't consider "vs." and "etc." to end the sentence.
  *       if (SENTENCE_CASE_JUST_TYPED(KC_SPC, KC_V, KC_S, KC_DOT) ||
  *           SENTENCE_CASE_JUST_TYPED(KC_SPC, KC_E, KC_T, KC_C, KC_DOT)) {
@@ -98,10 +170,11 @@ void sentence_case_primed(bool primed);
  * @note This callback is used only if `SENTENCE_CASE_BUFFER_SIZE >= 2`.
  *       Otherwise it has no effect.
  *
- * @param buffer Buffer of the last `SENTENCE_CASE_BUFFER_SIZE` keycodes.
+ * @param buffer Packed buffer of the last `SENTENCE_CASE_BUFFER_SIZE` keycode
+ *               classes, `SENTENCE_CASE_BUFFER_WORDS` words long.
  * @return whether there is a real sentence ending.
  */
-bool sentence_case_check_ending(const uint16_t* buffer);
+bool sentence_case_check_ending(const uint32_t* buffer);
 
 /**
  * Macro to be used in `sentence_case_check_ending()`.
@@ -113,16 +186,48 @@ bool sentence_case_check_ending(const uint16_t* buffer);
  * For example, `SENTENCE_CASE_JUST_TYPED(KC_SPC, KC_V, KC_S, KC_DOT)` returns
  * true if " vs." were the last four keys typed.
  *
- * @note The pattern must be no longer than `SENTENCE_CASE_BUFFER_SIZE`.
+ * The pattern is packed into a single word at compile time, so the check is
+ * one masked compare regardless of pattern length.
+ *
+ * @note The pattern must be no longer than `SENTENCE_CASE_BUFFER_SIZE` nor
+ *       `SENTENCE_CASE_MAX_PATTERN_LEN` keys.
  */
-#define SENTENCE_CASE_JUST_TYPED(...)                               \
-  ({                                                                \
-    static const uint16_t PROGMEM pattern[] = {__VA_ARGS__};        \
-    sentence_case_just_typed_P(buffer, pattern,                     \
-                               sizeof(pattern) / sizeof(uint16_t)); \
+#define SENTENCE_CASE_JUST_TYPED(...)                                    \
+  ({                                                                     \
+    _Static_assert(SENTENCE_CASE_NARGS(__VA_ARGS__) <=                   \
+                           SENTENCE_CASE_BUFFER_SIZE &&                  \
+                       SENTENCE_CASE_NARGS(__VA_ARGS__) <=               \
+                           SENTENCE_CASE_MAX_PATTERN_LEN,                \
+                   "sentence_case: pattern too long");                   \
+    sentence_case_just_typed(buffer, SENTENCE_CASE_PACK(__VA_ARGS__),    \
+                             SENTENCE_CASE_NARGS(__VA_ARGS__));          \
   })
-bool sentence_case_just_typed_P(const uint16_t* buffer, const uint16_t* pattern,
-                                int8_t pattern_len);
+bool sentence_case_just_typed(const uint32_t* buffer, uint64_t pattern,
+                              uint8_t pattern_len);
+
+// Helpers for `SENTENCE_CASE_JUST_TYPED()`: count the arguments and pack their
+// classes with the last argument in the low bits, matching the buffer layout.
+// clang-format off
+#define SENTENCE_CASE_NARGS(...) \
+  SENTENCE_CASE_NARGS_(__VA_ARGS__, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define SENTENCE_CASE_NARGS_(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, N, ...) N
+#define SENTENCE_CASE_PACK(...) \
+  SENTENCE_CASE_PACK_CAT(SENTENCE_CASE_PACK_, SENTENCE_CASE_NARGS(__VA_ARGS__))(__VA_ARGS__)
+#define SENTENCE_CASE_PACK_CAT(a, b) SENTENCE_CASE_PACK_CAT_(a, b)
+#define SENTENCE_CASE_PACK_CAT_(a, b) a##b
+#define SENTENCE_CASE_PACK_CLASS(kc, n) \
+  ((uint64_t)SENTENCE_CASE_KEYCODE_CLASS(kc) << ((n) * SENTENCE_CASE_CLASS_BITS))
+#define SENTENCE_CASE_PACK_1(a) SENTENCE_CASE_PACK_CLASS(a, 0)
+#define SENTENCE_CASE_PACK_2(a, ...) (SENTENCE_CASE_PACK_CLASS(a, 1) | SENTENCE_CASE_PACK_1(__VA_ARGS__))
+#define SENTENCE_CASE_PACK_3(a, ...) (SENTENCE_CASE_PACK_CLASS(a, 2) | SENTENCE_CASE_PACK_2(__VA_ARGS__))
+#define SENTENCE_CASE_PACK_4(a, ...) (SENTENCE_CASE_PACK_CLASS(a, 3) | SENTENCE_CASE_PACK_3(__VA_ARGS__))
+#define SENTENCE_CASE_PACK_5(a, ...) (SENTENCE_CASE_PACK_CLASS(a, 4) | SENTENCE_CASE_PACK_4(__VA_ARGS__))
+#define SENTENCE_CASE_PACK_6(a, ...) (SENTENCE_CASE_PACK_CLASS(a, 5) | SENTENCE_CASE_PACK_5(__VA_ARGS__))
+#define SENTENCE_CASE_PACK_7(a, ...) (SENTENCE_CASE_PACK_CLASS(a, 6) | SENTENCE_CASE_PACK_6(__VA_ARGS__))
+#define SENTENCE_CASE_PACK_8(a, ...) (SENTENCE_CASE_PACK_CLASS(a, 7) | SENTENCE_CASE_PACK_7(__VA_ARGS__))
+#define SENTENCE_CASE_PACK_9(a, ...) (SENTENCE_CASE_PACK_CLASS(a, 8) | SENTENCE_CASE_PACK_8(__VA_ARGS__))
+#define SENTENCE_CASE_PACK_10(a, ...) (SENTENCE_CASE_PACK_CLASS(a, 9) | SENTENCE_CASE_PACK_9(__VA_ARGS__))
+// clang-format on
 
 /**
  * Optional callback defining which keys are letter, punctuation, etc.
@@ -201,7 +306,14 @@ bool sentence_case_just_typed_P(const uint16_t* buffer, const uint16_t* pattern,
 char sentence_case_press_user(uint16_t keycode, keyrecord_t* record,
                               uint8_t mods);
 
+#ifdef SENTENCE_CASE_ENABLE
 bool process_record_sentence_case(uint16_t keycode, keyrecord_t* record);
+#else
+static inline bool process_record_sentence_case(uint16_t keycode,
+                                                keyrecord_t* record) {
+  return true;
+}
+#endif  // SENTENCE_CASE_ENABLE
 
 #ifdef __cplusplus
 }
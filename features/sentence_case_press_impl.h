@@ -9,6 +9,8 @@
  * This file is meant to be directly included in keymap.c.
  */
 
+#ifdef SENTENCE_CASE_ENABLE
+
 /**
  * @brief Processes keypresses for sentence case handling
  * 
@@ -86,4 +88,5 @@ char sentence_case_press_user(uint16_t keycode, keyrecord_t *record, uint8_t mod
     // This prevents unexpected capitalization when using keyboard shortcuts or navigation
     sentence_case_clear();
     return '\0';
-} 
\ No newline at end of file
+} 
+#endif // SENTENCE_CASE_ENABLE
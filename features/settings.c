@@ -0,0 +1,174 @@
+/**
+ * @file settings.c
+ * @brief Implementation of the persistent settings block
+ */
+
+#include "features/settings.h"
+#include "features/eeprom_layout.h"
+#include "features/sentence_case.h"
+#include "features/autocorrect.h"
+#include "features/virtual_desktop.h"
+#include "features/event_log.h"
+#include <stddef.h>
+#include <string.h>
+
+_Static_assert(sizeof(settings_t) <= EEPROM_SETTINGS_SLOT_SIZE, "settings_t outgrew its EEPROM slot, see eeprom_layout.h");
+
+/**
+ * @brief settings_init() found no valid slot
+ */
+#define NO_SLOT 0xFF
+
+// ==== STATE VARIABLES ====
+
+/**
+ * @brief The settings as last stored (or loaded), plus unsaved changes
+ */
+static settings_t settings;
+
+/**
+ * @brief Slot holding the newest stored copy, NO_SLOT if none
+ */
+static uint8_t slot = NO_SLOT;
+
+/**
+ * @brief A key event happened since the last comparison
+ */
+static bool check_pending = false;
+
+/**
+ * @brief The mirror holds changes not yet written, since write_timer
+ */
+static bool     dirty       = false;
+static uint32_t write_timer = 0;
+
+// ==== HELPER FUNCTIONS ====
+
+/**
+ * @brief Fletcher-16 folded to a byte; an all-zero or erased slot fails it
+ */
+static uint8_t settings_checksum(const settings_t *s) {
+    const uint8_t *bytes = (const uint8_t *)s;
+    uint8_t        a = 0x5A, b = 0;
+    for (uint8_t i = 0; i < offsetof(settings_t, check); i++) {
+        a += bytes[i];
+        b += a;
+    }
+    return a ^ b;
+}
+
+/**
+ * @brief Fill the fields of s from the features' current state
+ */
+static void settings_capture(settings_t *s) {
+    s->flags = (is_sentence_case_on() ? SETTINGS_SENTENCE_CASE : 0) | (is_autocorrect_on() ? SETTINGS_AUTOCORRECT : 0);
+    s->vd_current = get_current_vd();
+    s->vd_max     = get_vd_max();
+#ifdef DYNAMIC_TAPPING_TERM_ENABLE
+    s->tapping_term = g_tapping_term;
+#else
+    s->tapping_term = TAPPING_TERM;
+#endif
+}
+
+/**
+ * @brief Push the fields of s back into the features
+ */
+static void settings_apply(const settings_t *s) {
+    if (s->flags & SETTINGS_SENTENCE_CASE) {
+        sentence_case_on();
+    } else {
+        sentence_case_off();
+    }
+    if (s->flags & SETTINGS_AUTOCORRECT) {
+        autocorrect_on();
+    } else {
+        autocorrect_off();
+    }
+    set_vd_max(s->vd_max);
+    set_current_vd(s->vd_current);
+#ifdef DYNAMIC_TAPPING_TERM_ENABLE
+    if (s->tapping_term) {
+        g_tapping_term = s->tapping_term;
+    }
+#endif
+}
+
+/**
+ * @brief Write the mirror to the slot after the current one
+ */
+static void settings_write(void) {
+    slot = slot == NO_SLOT ? 0 : (slot + 1) % EEPROM_SETTINGS_SLOTS;
+    settings.sequence++;
+    settings.version = SETTINGS_VERSION;
+    settings.check   = settings_checksum(&settings);
+    eeconfig_update_user_datablock(&settings, EEPROM_SETTINGS_OFFSET + slot * EEPROM_SETTINGS_SLOT_SIZE, sizeof(settings));
+    dirty = false;
+    EVLOG_INFO(EV_SETTINGS_SAVE, slot, settings.sequence);
+}
+
+// ==== PUBLIC FUNCTIONS ====
+
+void settings_init(void) {
+    settings_t stored;
+
+    // Forget any earlier load, so a second call sees only what is stored
+    memset(&settings, 0, sizeof(settings));
+    slot          = NO_SLOT;
+    check_pending = false;
+    dirty         = false;
+    for (uint8_t i = 0; i < EEPROM_SETTINGS_SLOTS; i++) {
+        eeconfig_read_user_datablock(&stored, EEPROM_SETTINGS_OFFSET + i * EEPROM_SETTINGS_SLOT_SIZE, sizeof(stored));
+        if (stored.version != SETTINGS_VERSION || stored.check != settings_checksum(&stored)) {
+            continue;
+        }
+        // Sequence numbers wrap; consecutive slots differ by one
+        if (slot == NO_SLOT || (int8_t)(stored.sequence - settings.sequence) > 0) {
+            settings = stored;
+            slot     = i;
+        }
+    }
+
+    if (slot != NO_SLOT) {
+        settings_apply(&settings);
+    }
+    // Whatever the features refused to take (an out-of-range desktop, say)
+    // is dropped here rather than carried forward
+    settings_capture(&settings);
+    EVLOG_INFO(EV_SETTINGS_LOAD, slot, settings.sequence);
+}
+
+void settings_record_event(void) {
+    check_pending = true;
+}
+
+void settings_task(void) {
+    if (check_pending) {
+        check_pending = false;
+        settings_t current = settings;
+        settings_capture(&current);
+        if (memcmp(&current, &settings, sizeof(settings))) {
+            settings = current;
+            if (!dirty) {
+                dirty       = true;
+                write_timer = timer_read32();
+            }
+        }
+    }
+
+    if (dirty && timer_elapsed32(write_timer) >= SETTINGS_WRITE_DELAY_MS) {
+        settings_write();
+    }
+}
+
+void settings_flush(void) {
+    check_pending = true;
+    settings_task();
+    if (dirty) {
+        settings_write();
+    }
+}
+
+const settings_t *settings_get(void) {
+    return &settings;
+}
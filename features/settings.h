@@ -0,0 +1,117 @@
+/**
+ * @file settings.h
+ * @brief Runtime settings that survive a reboot
+ *
+ * The settings the keyboard can change at runtime are kept in one small
+ * versioned block in EEPROM:
+ *   - Sentence case on/off (SENTENCE_CASE_TOGGLE)
+ *   - Autocorrect on/off (AC_TOGG / AC_ON / AC_OFF)
+ *   - The current virtual desktop and the desktop count
+ *   - The dynamic tapping term (DT_UP / DT_DOWN)
+ *
+ * The features keep owning their state; this module only snapshots it. After
+ * a key event the snapshot is compared with the RAM mirror, and a change
+ * starts a SETTINGS_WRITE_DELAY_MS timer so a burst of changes (holding
+ * DT_UP, say) becomes a single write.
+ *
+ * Writes rotate through the EEPROM_SETTINGS_SLOTS slots of the settings
+ * region (eeprom_layout.h), each tagged with a sequence number and a
+ * checksum. Loading picks the newest valid slot, so a write cut short by a
+ * power loss falls back to the previous settings, and each slot sees only
+ * one write in EEPROM_SETTINGS_SLOTS.
+ *
+ * Usage in keymap.c:
+ *   1. Set SETTINGS_ENABLE = yes in rules.mk
+ *   2. Call settings_init() from keyboard_post_init_user()
+ *   3. Call settings_record_event() from process_record_user()
+ *   4. Call settings_task() from matrix_scan_user()
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+// ==== CONFIGURATION ====
+
+/**
+ * @brief Layout version of settings_t; bump on any change to drop stored settings
+ */
+#define SETTINGS_VERSION 1
+
+/**
+ * @brief Time from the first unsaved change to the write that saves it
+ */
+#ifndef SETTINGS_WRITE_DELAY_MS
+#    define SETTINGS_WRITE_DELAY_MS 5000
+#endif
+
+// ==== DATA ====
+
+/**
+ * @enum settings_flag
+ * @brief Bits of settings_t.flags
+ */
+enum settings_flag {
+    SETTINGS_SENTENCE_CASE = 1 << 0, /**< Sentence case enabled */
+    SETTINGS_AUTOCORRECT   = 1 << 1, /**< Autocorrect enabled */
+};
+
+/**
+ * @brief One stored copy of the settings
+ *
+ * check must stay last: it covers every byte before it.
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t  sequence;     /**< Write count; the newest valid slot wins */
+    uint8_t  version;      /**< SETTINGS_VERSION */
+    uint8_t  flags;        /**< enum settings_flag bits */
+    int8_t   vd_current;   /**< Current virtual desktop */
+    int8_t   vd_max;       /**< Virtual desktop count */
+    uint16_t tapping_term; /**< Dynamic tapping term, ms */
+    uint8_t  check;        /**< Fletcher checksum of the bytes above */
+} settings_t;
+
+#ifdef SETTINGS_ENABLE
+
+/**
+ * @brief Load the newest valid slot and apply it
+ *
+ * Reads the EEPROM_SETTINGS_SLOTS small slots and nothing else, so it adds
+ * little to the time before the first scan (see PROBE_SETTINGS_LOAD). With
+ * no valid slot the features keep their defaults. Calling it again starts
+ * over from what is stored.
+ */
+void settings_init(void);
+
+/**
+ * @brief Note a key event; the settings are compared on the next scan
+ */
+void settings_record_event(void);
+
+/**
+ * @brief Pick up changed settings and write them once the delay has passed
+ *
+ * Call from matrix_scan_user(). Costs a flag test on scans without a key
+ * event.
+ */
+void settings_task(void);
+
+/**
+ * @brief Write any unsaved change now, e.g. before jumping to the bootloader
+ */
+void settings_flush(void);
+
+/**
+ * @brief Get the RAM mirror of the stored settings
+ */
+const settings_t *settings_get(void);
+
+#else // SETTINGS_ENABLE
+
+// Disabled in rules.mk: no-op stubs so callers compile away.
+static inline void settings_init(void) {}
+static inline void settings_record_event(void) {}
+static inline void settings_task(void) {}
+static inline void settings_flush(void) {}
+
+#endif // SETTINGS_ENABLE
@@ -0,0 +1,134 @@
+/**
+ * @file snippets.c
+ * @brief Implementation of the text expansion engine
+ *
+ * See tools/snippet_automaton.py for the table layout.
+ */
+
+#include "features/snippets.h"
+#include "features/key_history.h"
+#include "features/output_queue.h"
+#include "features/event_log.h"
+#include "features/sentence_case.h"
+#include "snippet_expansions.h"
+#include "features/snippets_data.h"
+
+// Catch snippet_expansions.h edits that were not followed by tools/snippet_automaton.py
+#define X(trigger, text) +1
+_Static_assert(0 SNIPPET_EXPANSIONS(X) == SNIPPETS_COUNT, "snippets_data.h is stale, run tools/snippet_automaton.py");
+#undef X
+#define X(trigger, text) +(sizeof(trigger) - 1)
+_Static_assert(0 SNIPPET_EXPANSIONS(X) == SNIPPETS_TRIGGER_CHARS, "snippets_data.h is stale, run tools/snippet_automaton.py");
+#undef X
+
+_Static_assert(SNIPPETS_MAX_TRIGGER_LEN <= KEY_HISTORY_SIZE, "snippets: KEY_HISTORY_SIZE is shorter than the longest trigger");
+
+#if SNIPPETS_STATES > 0x100
+#    define read_state(p) pgm_read_word(p)
+#else
+#    define read_state(p) pgm_read_byte(p)
+#endif
+
+/**
+ * @brief Texts, and the lengths of triggers and texts, in snippet_expansions.h order
+ */
+#define X(trigger, text) text,
+static const char *const snippet_texts[SNIPPETS_COUNT] PROGMEM = {SNIPPET_EXPANSIONS(X)};
+#undef X
+#define X(trigger, text) sizeof(trigger) - 1,
+static const uint8_t snippet_trigger_lengths[SNIPPETS_COUNT] PROGMEM = {SNIPPET_EXPANSIONS(X)};
+#undef X
+#define X(trigger, text) sizeof(text) - 1,
+static const uint16_t snippet_text_lengths[SNIPPETS_COUNT] PROGMEM = {SNIPPET_EXPANSIONS(X)};
+#undef X
+
+// ==== STATE VARIABLES ====
+
+/**
+ * @brief Automaton state after the keys in the history
+ */
+static snippets_state_t state = 0;
+
+/**
+ * @brief Newest word of the key history as of the last step, to notice
+ *        changes made behind the automaton's back
+ */
+static uint32_t seen = 0;
+
+// ==== HELPER FUNCTIONS ====
+
+static inline snippets_state_t snippets_step(snippets_state_t from, uint8_t key_class) {
+    return read_state(&snippets_next[from][pgm_read_byte(&snippets_symbol[key_class])]);
+}
+
+/**
+ * @brief Rebuild the state from the newest keys of the history
+ *
+ * The state only depends on the last SNIPPETS_MAX_TRIGGER_LEN keys, so
+ * replaying those from the root gives the same state as every key since
+ * boot would.
+ */
+static void snippets_resync(void) {
+    state = 0;
+    for (uint8_t n = SNIPPETS_MAX_TRIGGER_LEN; n--;) {
+        state = snippets_step(state, key_history_class(n));
+    }
+}
+
+/**
+ * @brief Replace the trigger just completed with its text
+ */
+static void snippets_expand(uint8_t index) {
+    uint8_t     trigger = pgm_read_byte(&snippet_trigger_lengths[index]);
+    uint16_t    length  = pgm_read_word(&snippet_text_lengths[index]);
+    const char *text    = (const char *)pgm_read_ptr(&snippet_texts[index]);
+
+    EVLOG_INFO(EV_SNIPPET, index, trigger - 1);
+
+    // The key being processed is swallowed, so it's never on screen
+    output_queue_push_taps(KC_BSPC, trigger - 1);
+    output_queue_push_P(text);
+
+    // Sentence case saw the rest of the trigger: bring its states in line
+    // with the text that replaces it
+    sentence_case_rewrite_P(trigger - 1, text);
+
+    // It was recorded already, though, after the rest of the trigger. Only
+    // the end of the text can ever be matched against.
+    for (uint8_t i = 0; i < trigger; i++) {
+        key_history_pop();
+    }
+    for (uint16_t i = length > KEY_HISTORY_SIZE ? length - KEY_HISTORY_SIZE : 0; i < length; i++) {
+        uint8_t c = pgm_read_byte(text + i);
+        key_history_push(KEY_HISTORY_CLASS(pgm_read_byte(&ascii_to_keycode_lut[c])));
+    }
+    snippets_resync();
+}
+
+// ==== PUBLIC FUNCTIONS ====
+
+bool process_snippets(uint16_t keycode, keyrecord_t *record) {
+    if (!record->event.pressed) {
+        return true;
+    }
+
+    // A key pushed onto the history we last saw is one step; anything else
+    // (a pop, a clear, a rewrite) means replaying the history
+    uint32_t newest = key_history_buffer()[0];
+    if (key_history_recorded() && newest >> KEY_HISTORY_CLASS_BITS == (seen & (UINT32_MAX >> KEY_HISTORY_CLASS_BITS))) {
+        state = snippets_step(state, newest & KEY_HISTORY_CLASS_MASK);
+    } else if (newest != seen) {
+        snippets_resync();
+    }
+    seen = newest;
+
+    // Only a newly typed key completes a trigger, and an expansion waits
+    // for whatever is being typed already
+    uint8_t match = pgm_read_byte(&snippets_match[state]);
+    if (!match || !key_history_recorded() || output_queue_busy()) {
+        return true;
+    }
+    snippets_expand(match - 1);
+    seen = key_history_buffer()[0];
+    return false;
+}
@@ -0,0 +1,47 @@
+/**
+ * @file snippets.h
+ * @brief Text expansion matched against the shared key history
+ *
+ * Snippets are listed in snippet_expansions.h and their triggers compiled
+ * by tools/snippet_automaton.py into a PROGMEM Aho-Corasick automaton
+ * (features/snippets_data.h). Matching follows each key as it is added
+ * to the key history (features/key_history.h), so it never keeps a buffer
+ * of its own:
+ *   - a typed key is one table lookup, however many snippets there are
+ *   - when the history changes some other way (Backspace, an
+ *     autocorrection) the automaton replays the last few keys from it
+ *
+ * The key completing a trigger is swallowed; the rest of the trigger is
+ * backspaced and the text typed through the output queue, and the key
+ * history and sentence case's states are rewritten to end in the text, as
+ * autocorrect does.
+ *
+ * Usage in keymap.c:
+ *   1. Set SNIPPETS_ENABLE = yes in rules.mk
+ *   2. Call process_key_history() and then process_snippets(keycode, record)
+ *      in process_record_user(), ahead of autocorrect
+ *   3. Call output_queue_task() from matrix_scan_user()
+ */
+
+#pragma once
+
+#include "quantum.h"
+
+#ifdef SNIPPETS_ENABLE
+
+/**
+ * @brief Advance the automaton and expand a completed trigger
+ *
+ * @param keycode The keycode to process
+ * @param record The keyrecord containing event information
+ * @return false if the key completed a trigger and was replaced by its
+ *         text, true otherwise
+ */
+bool process_snippets(uint16_t keycode, keyrecord_t *record);
+
+#else // SNIPPETS_ENABLE
+
+// Disabled in rules.mk: no-op stubs so callers compile away.
+static inline bool process_snippets(uint16_t keycode, keyrecord_t *record) { return true; }
+
+#endif // SNIPPETS_ENABLE
@@ -0,0 +1,62 @@
+// Generated by tools/snippet_automaton.py from snippet_expansions.h - do not edit.
+// Layout is described in tools/snippet_automaton.py.
+
+#pragma once
+
+#define SNIPPETS_COUNT 7
+#define SNIPPETS_TRIGGER_CHARS 34
+#define SNIPPETS_MAX_TRIGGER_LEN 6
+#define SNIPPETS_STATES 34
+#define SNIPPETS_SYMBOLS 17
+
+typedef uint8_t snippets_state_t;
+
+static const uint8_t snippets_symbol[64] PROGMEM = {
+    0, 1, 0, 0, 2, 0, 0, 3, 4, 5, 0, 6, 7, 8, 0, 0,
+    0, 9, 10, 11, 12, 13, 14, 0, 0, 15, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    16, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+};
+
+static const snippets_state_t snippets_next[SNIPPETS_STATES][SNIPPETS_SYMBOLS] PROGMEM = {
+    /* root       */ {0, 1, 0, 0, 0, 0, 0, 2, 3, 4, 0, 5, 6, 0, 0, 0, 0},
+    /* 'a'        */ {0, 1, 7, 0, 0, 0, 0, 2, 3, 4, 0, 5, 6, 0, 0, 0, 0},
+    /* 'l'        */ {0, 1, 0, 8, 0, 0, 0, 2, 3, 4, 0, 5, 6, 0, 0, 0, 0},
+    /* 'm'        */ {0, 9, 0, 0, 0, 0, 0, 2, 3, 4, 0, 5, 6, 0, 0, 0, 0},
+    /* 'q'        */ {0, 1, 0, 0, 0, 0, 0, 2, 10, 4, 0, 5, 6, 0, 0, 0, 0},
+    /* 's'        */ {0, 1, 0, 0, 11, 12, 0, 2, 3, 4, 0, 5, 6, 0, 0, 0, 0},
+    /* 't'        */ {0, 1, 0, 0, 0, 0, 0, 2, 3, 4, 0, 5, 6, 0, 0, 13, 0},
+    /* 'ad'       */ {0, 1, 14, 0, 0, 0, 0, 2, 3, 4, 0, 5, 6, 0, 0, 0, 0},
+    /* 'lg'       */ {0, 1, 0, 0, 0, 0, 0, 2, 3, 4, 0, 5, 15, 0, 0, 0, 0},
+    /* 'ma'       */ {0, 1, 7, 0, 0, 16, 0, 2, 3, 4, 0, 5, 6, 0, 0, 0, 0},
+    /* 'qm'       */ {0, 9, 0, 0, 0, 0, 17, 2, 3, 4, 0, 5, 6, 0, 0, 0, 0},
+    /* 'sh'       */ {0, 1, 0, 0, 0, 0, 0, 2, 3, 4, 18, 5, 6, 0, 0, 0, 0},
+    /* 'si'       */ {0, 1, 0, 19, 0, 0, 0, 2, 3, 4, 0, 5, 6, 0, 0, 0, 0},
+    /* 'ty'       */ {0, 1, 0, 0, 0, 0, 0, 2, 3, 4, 0, 5, 6, 0, 20, 0, 0},
+    /* 'add'      */ {0, 1, 0, 0, 0, 0, 0, 2, 3, 4, 21, 5, 6, 0, 0, 0, 0},
+    /* 'lgt'      */ {0, 1, 0, 0, 0, 0, 0, 2, 22, 4, 0, 5, 6, 0, 0, 13, 0},
+    /* 'mai'      */ {0, 1, 0, 0, 0, 0, 0, 23, 3, 4, 0, 5, 6, 0, 0, 0, 0},
+    /* 'qmk'      */ {0, 1, 0, 0, 0, 0, 0, 2, 3, 4, 0, 5, 6, 0, 0, 0, 24},
+    /* 'shr'      */ {0, 1, 0, 0, 0, 0, 0, 2, 3, 4, 0, 5, 6, 25, 0, 0, 0},
+    /* 'sig'      */ {0, 1, 0, 0, 0, 0, 0, 2, 3, 4, 0, 5, 6, 0, 0, 0, 26},
+    /* 'tyv'      */ {0, 1, 0, 0, 0, 0, 0, 2, 27, 4, 0, 5, 6, 0, 0, 0, 0},
+    /* 'addr'     */ {0, 1, 0, 0, 0, 0, 0, 2, 3, 4, 0, 5, 6, 0, 0, 0, 28},
+    /* 'lgtm'     */ {0, 9, 0, 0, 0, 0, 0, 2, 3, 4, 0, 5, 6, 0, 0, 0, 29},
+    /* 'mail'     */ {0, 1, 0, 8, 0, 0, 0, 2, 3, 4, 0, 5, 6, 0, 0, 0, 30},
+    /* 'qmk;'     */ {0, 1, 0, 0, 0, 0, 0, 2, 3, 4, 0, 5, 6, 0, 0, 0, 0},
+    /* 'shru'     */ {0, 1, 0, 31, 0, 0, 0, 2, 3, 4, 0, 5, 6, 0, 0, 0, 0},
+    /* 'sig;'     */ {0, 1, 0, 0, 0, 0, 0, 2, 3, 4, 0, 5, 6, 0, 0, 0, 0},
+    /* 'tyvm'     */ {0, 9, 0, 0, 0, 0, 0, 2, 3, 4, 0, 5, 6, 0, 0, 0, 32},
+    /* 'addr;'    */ {0, 1, 0, 0, 0, 0, 0, 2, 3, 4, 0, 5, 6, 0, 0, 0, 0},
+    /* 'lgtm;'    */ {0, 1, 0, 0, 0, 0, 0, 2, 3, 4, 0, 5, 6, 0, 0, 0, 0},
+    /* 'mail;'    */ {0, 1, 0, 0, 0, 0, 0, 2, 3, 4, 0, 5, 6, 0, 0, 0, 0},
+    /* 'shrug'    */ {0, 1, 0, 0, 0, 0, 0, 2, 3, 4, 0, 5, 6, 0, 0, 0, 33},
+    /* 'tyvm;'    */ {0, 1, 0, 0, 0, 0, 0, 2, 3, 4, 0, 5, 6, 0, 0, 0, 0},
+    /* 'shrug;'   */ {0, 1, 0, 0, 0, 0, 0, 2, 3, 4, 0, 5, 6, 0, 0, 0, 0},
+};
+
+static const uint8_t snippets_match[SNIPPETS_STATES] PROGMEM = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 7, 0, 3, 0, 1, 5, 2, 0,
+    4, 6,
+};
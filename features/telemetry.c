@@ -0,0 +1,116 @@
+/**
+ * @file telemetry.c
+ * @brief Implementation of the raw HID telemetry counters
+ *
+ * The hot paths only increment counters; rates are rolled once a second from
+ * the scan task, and everything derived (handler timings, sentence case
+ * counts) is copied into the block only when the host asks for page 0.
+ */
+
+#include "features/telemetry.h"
+#include "features/hid_protocol.h"
+#include "features/sentence_case.h"
+#include <string.h>
+
+// ==== STATE VARIABLES ====
+
+/**
+ * @brief The live counters block
+ */
+telemetry_block_t telemetry = {
+    .version = TELEMETRY_VERSION,
+#ifdef CYCLE_PROFILE_ENABLE
+    .probe_count = PROBE_COUNT,
+#endif
+};
+
+/**
+ * @brief Start of the current one-second rate window
+ */
+static uint32_t window_start = 0;
+
+/**
+ * @brief Scans and events counted in the current window
+ */
+static uint16_t window_scans  = 0;
+static uint16_t window_events = 0;
+
+/**
+ * @brief Number of HID pages needed for the block
+ */
+#define TELEMETRY_PAGE_SIZE  (HID_PAYLOAD_SIZE - 2)
+#define TELEMETRY_PAGE_COUNT ((sizeof(telemetry_block_t) + TELEMETRY_PAGE_SIZE - 1) / TELEMETRY_PAGE_SIZE)
+
+// ==== HELPER FUNCTIONS ====
+
+/**
+ * @brief Copy the values owned by other modules into the block
+ */
+static void telemetry_snapshot(void) {
+    telemetry.uptime_ms = timer_read32();
+
+    for (uint8_t i = 0; i < PROBE_COUNT; i++) {
+        const cycle_stat_t *stat = cycle_profile_get(i);
+        if (stat && stat->count) {
+            telemetry.handler_avg[i] = (uint32_t)(stat->total / stat->count);
+            telemetry.handler_max[i] = stat->max;
+        }
+    }
+
+#if defined(SENTENCE_CASE_ENABLE) && defined(SENTENCE_CASE_STATS)
+    telemetry.sentence_caps = sentence_case_get_stats()->capitalizations;
+#endif
+}
+
+// ==== PUBLIC FUNCTIONS ====
+
+void telemetry_scan_task(void) {
+    telemetry.scans++;
+    window_scans++;
+
+    if (timer_elapsed32(window_start) >= 1000) {
+        telemetry.scan_rate  = window_scans;
+        telemetry.event_rate = window_events;
+        window_scans         = 0;
+        window_events        = 0;
+        window_start         = timer_read32();
+    }
+}
+
+void telemetry_record_event(void) {
+    telemetry.events++;
+    window_events++;
+}
+
+void telemetry_set_queue_depth(uint16_t depth) {
+    telemetry.queue_depth = depth;
+    if (depth > telemetry.queue_peak) {
+        telemetry.queue_peak = depth;
+    }
+}
+
+void telemetry_raw_hid(uint8_t *data, uint8_t length) {
+    uint8_t page = data[1];
+
+    if (page >= TELEMETRY_PAGE_COUNT) {
+        data[1] = HID_STATUS_BAD_ARG;
+        return;
+    }
+
+    // Take one consistent snapshot per read, at the first page
+    if (page == 0) {
+        telemetry_snapshot();
+    }
+
+    uint16_t offset = page * TELEMETRY_PAGE_SIZE;
+    uint16_t n      = sizeof(telemetry_block_t) - offset;
+    if (n > TELEMETRY_PAGE_SIZE) {
+        n = TELEMETRY_PAGE_SIZE;
+    }
+
+    memset(data + 2, 0, length - 2);
+    data[1] = HID_STATUS_OK;
+    data[2] = page;
+    data[3] = TELEMETRY_PAGE_COUNT;
+    memcpy(data + 4, (const uint8_t *)&telemetry + offset, n);
+}
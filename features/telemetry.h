@@ -0,0 +1,118 @@
+/**
+ * @file telemetry.h
+ * @brief Runtime counters readable over raw HID
+ *
+ * This module keeps a fixed block of counters describing how the keyboard is
+ * performing in everyday use: matrix scan rate, key events per second, time
+ * spent in each feature handler, output queue depth, RGB frame cost, secrets
+ * lock/unlock counts and sentence case capitalisations. tools/telemetry.py
+ * polls the block and prints it.
+ *
+ * Usage in keymap.c:
+ *   1. Set TELEMETRY_ENABLE = yes in rules.mk (this also enables RAW_ENABLE)
+ *   2. Call telemetry_scan_task() from matrix_scan_user()
+ *   3. Call telemetry_record_event() from process_record_user()
+ *   4. Route HID_CMD_TELEMETRY packets to telemetry_raw_hid()
+ *
+ * Other modules bump counters with TELEMETRY_INC(field), which compiles to
+ * nothing when telemetry is disabled.
+ *
+ * Handler timings, the RGB frame cost among them (the rgb_indicators and
+ * heatmap probes), are taken from cycle_profile. Without
+ * CYCLE_PROFILE_ENABLE nothing measures them: probe_count is then 0 and
+ * handler_avg/handler_max are all zero, which tools/telemetry.py reports
+ * instead of printing a table of zeros. The arrays keep their size either
+ * way, so the layout does not depend on the build.
+ */
+
+#pragma once
+
+#include "quantum.h"
+#include "features/cycle_profile.h"
+
+/**
+ * @brief Layout version of telemetry_block_t; bump on any change
+ */
+#define TELEMETRY_VERSION 1
+
+/**
+ * @brief The counters block, sent verbatim (little-endian) to the host
+ */
+typedef struct __attribute__((packed)) {
+    uint8_t  version;                     /**< TELEMETRY_VERSION */
+    uint8_t  probe_count;                 /**< PROBE_COUNT, or 0 without CYCLE_PROFILE_ENABLE */
+    uint32_t uptime_ms;                   /**< timer_read32() at snapshot */
+    uint16_t scan_rate;                   /**< Matrix scans in the last full second */
+    uint16_t event_rate;                  /**< Key events in the last full second */
+    uint32_t scans;                       /**< Matrix scans since boot */
+    uint32_t events;                      /**< Key events since boot */
+    uint16_t queue_depth;                 /**< Pending entries in the output queue */
+    uint16_t queue_peak;                  /**< Deepest the output queue has been */
+    uint16_t secrets_unlocks;             /**< Successful PIN entries */
+    uint16_t secrets_failures;            /**< Rejected PIN entries */
+    uint16_t secrets_locks;               /**< Locks by command, timeout or GUI+L */
+    uint16_t secrets_auto_locks;          /**< Of those, locks by timeout */
+    uint16_t sentence_caps;               /**< Letters auto-capitalised */
+    uint32_t handler_avg[PROBE_COUNT];    /**< Average cycles per cycle_probe_t */
+    uint32_t handler_max[PROBE_COUNT];    /**< Worst cycles per cycle_probe_t */
+} telemetry_block_t;
+
+#ifdef TELEMETRY_ENABLE
+
+/**
+ * @brief The live counters block
+ *
+ * Exposed so TELEMETRY_INC() is a single increment at the call site.
+ */
+extern telemetry_block_t telemetry;
+
+/**
+ * @brief Increment a 16-bit counter in the block, saturating
+ */
+#    define TELEMETRY_INC(field)                    \
+        do {                                        \
+            if (telemetry.field != UINT16_MAX) {    \
+                telemetry.field++;                  \
+            }                                       \
+        } while (0)
+
+/**
+ * @brief Count one matrix scan and roll the per-second rates
+ *
+ * Call from matrix_scan_user().
+ */
+void telemetry_scan_task(void);
+
+/**
+ * @brief Count one key event
+ *
+ * Call from process_record_user().
+ */
+void telemetry_record_event(void);
+
+/**
+ * @brief Report the current output queue depth
+ *
+ * @param depth Entries waiting to be sent
+ */
+void telemetry_set_queue_depth(uint16_t depth);
+
+/**
+ * @brief Handle a HID_CMD_TELEMETRY request in place
+ *
+ * Request [cmd][page]; response [cmd][status][page][page_count][bytes...].
+ *
+ * @param data The raw HID packet, overwritten with the response
+ * @param length Packet length (HID_PACKET_SIZE)
+ */
+void telemetry_raw_hid(uint8_t *data, uint8_t length);
+
+#else // TELEMETRY_ENABLE
+
+#    define TELEMETRY_INC(field) ((void)0)
+
+static inline void telemetry_scan_task(void) {}
+static inline void telemetry_record_event(void) {}
+static inline void telemetry_set_queue_depth(uint16_t depth) {}
+
+#endif // TELEMETRY_ENABLE
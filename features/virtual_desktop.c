@@ -1,6 +1,6 @@
 #include "virtual_desktop.h"
 #include "custom_keycodes.h"
-#include "print.h"
+#include "features/event_log.h"
 #include "wait.h"
 
 /**
@@ -63,6 +63,26 @@ void set_vd_max(int8_t max) {
     }
 }
 
+/**
+ * @brief Get the maximum number of virtual desktops
+ * 
+ * Implementation of get_vd_max() defined in the header.
+ */
+int8_t get_vd_max(void) {
+    return vd_max;
+}
+
+/**
+ * @brief Set the current virtual desktop tracking without switching
+ * 
+ * Implementation of set_current_vd() defined in the header.
+ */
+void set_current_vd(int8_t vd) {
+    if (vd >= 1 && vd <= vd_max) {
+        current_vd = vd;
+    }
+}
+
 /**
  * @brief Switch to the specified virtual desktop
  * 
@@ -76,44 +96,32 @@ void move_vd(int8_t vd) {
   // Validate the target desktop
   if (vd < 1 || vd > vd_max || vd == current_vd) return;
 
-  dprintf("▶ Switching to VD %d\n", vd);
+  EVLOG_INFO(EV_VD_SWITCH, vd, current_vd);
 
   // Calculate how many desktops to move left or right
   int8_t diff = vd - current_vd;
-
-  // Switch based on direction
-  if (diff < 0) {
-    // Need to move left (lower desktop number)
-    register_code(KC_LCTL);
-    register_code(KC_LGUI);
-    
-    // Send the left arrow key the required number of times
-    for (int8_t i = 0; i < -diff; i++) {
-      tap_code(KC_LEFT);
-      // Uncomment to add delay between keypresses if needed
-      // wait_ms(50);
-    }
-    
-    // Release modifiers
-    unregister_code(KC_LGUI);
-    unregister_code(KC_LCTL);
-  } else if (diff > 0) {
-    // Need to move right (higher desktop number)
-    register_code(KC_LCTL);
-    register_code(KC_LGUI);
-    
-    // Send the right arrow key the required number of times
-    for (int8_t i = 0; i < diff; i++) {
-      tap_code(KC_RGHT);
-      // Uncomment to add delay between keypresses if needed
-      // wait_ms(50);
-    }
-    
-    // Release modifiers
-    unregister_code(KC_LGUI);
-    unregister_code(KC_LCTL);
+  uint8_t steps = (diff < 0) ? -diff : diff;
+  uint8_t arrow = (diff < 0) ? KC_LEFT : KC_RGHT;
+
+  // Hold exactly Ctrl+GUI for the arrows. Setting the mods outright (rather
+  // than registering on top) keeps a held Shift or a pending weak mod out of
+  // the sequence, and leaves the Meta layer's own GUI untouched afterwards.
+  const uint8_t saved_mods = get_mods();
+  clear_weak_mods();
+  set_mods(MOD_BIT(KC_LCTL) | MOD_BIT(KC_LGUI));
+  send_keyboard_report();
+
+  // Send the arrow key the required number of times
+  for (uint8_t i = 0; i < steps; i++) {
+    tap_code(arrow);
+    // Uncomment to add delay between keypresses if needed
+    // wait_ms(50);
   }
 
+  // Restore whatever the user is physically holding
+  set_mods(saved_mods);
+  send_keyboard_report();
+
   // Update the tracking variable
   current_vd = vd;
 }
@@ -139,22 +147,22 @@ void move_window_to_vd(int8_t vd) {
   // Validate the target desktop
   if (vd < 1 || vd > vd_max || vd == current_vd) return;
 
-  dprintf("▶ Moving window to VD %d\n", vd);
+  EVLOG_INFO(EV_VD_MOVE_WINDOW, vd, current_vd);
+
+  // Release every modifier for the duration of the macro. The Shift that
+  // selected this action may be either side (HOME_E is right Shift) and would
+  // turn Win+Tab into Win+Shift+Tab.
+  const uint8_t saved_mods = get_mods();
+  clear_mods();
+  clear_weak_mods();
+  send_keyboard_report();
 
   // Step 1: Open Task View (Win+Tab)
-  // First ensure Shift is not pressed (can interfere with Win+Tab)
-  unregister_code(KC_LSFT);
-  // Send Win+Tab
   tap_code16(LGUI(KC_TAB));
   // Wait for Task View to open
   wait_ms(400);
 
   // Step 2: Open window context menu (App key)
-  // Make sure modifiers are released
-  unregister_code(KC_LSFT);
-  unregister_code(KC_TAB);
-  unregister_code(KC_LGUI);
-  // Send App/Menu key
   tap_code(KC_APP);
   wait_ms(100);
 
@@ -187,6 +195,12 @@ void move_window_to_vd(int8_t vd) {
 
   // Step 6: Switch to the target desktop
   move_vd(vd);
+
+  // Put the held modifiers back for QMK's bookkeeping only, minus GUI.
+  // Re-announcing them would make a later lone GUI release open the Start
+  // menu, and so would a GUI kept here: letting go of Shift before Meta
+  // would send GUI on its own. Meta has to be pressed again to chord GUI.
+  set_mods(saved_mods & ~MOD_MASK_GUI);
 }
 
 /**
@@ -208,11 +222,10 @@ bool process_virtual_desktop(uint16_t keycode, keyrecord_t *record) {
     if (record->event.pressed && keycode >= VD_START && keycode < VD_END) {
         // Calculate the desktop number from the keycode
         target_vd = keycode - VD_START;
-        dprintf("▶ VD %d key pressed\n", target_vd);
+        EVLOG_DEBUG(EV_VD_KEY, target_vd, current_vd);
 
         // Skip if we're already on this desktop
         if (target_vd == current_vd) {
-            dprint("▶ Already here – no action\n");
             return false;
         }
 
@@ -18,8 +18,13 @@
  *   3. Define virtual desktop keycodes (VD_1, VD_2, etc.) in your keymap
  * 
  * Hold SHIFT when pressing a VD key to move the active window to that desktop.
+ *
+ * Set VIRTUAL_DESKTOP_ENABLE = no in rules.mk to replace everything below with
+ * inline no-op stubs.
  */
 
+#ifdef VIRTUAL_DESKTOP_ENABLE
+
 /**
  * @brief Process virtual desktop keycodes
  * 
@@ -82,4 +87,34 @@ int8_t get_current_vd(void);
  * 
  * @param max The maximum number of virtual desktops (default is 9)
  */
-void set_vd_max(int8_t max); 
\ No newline at end of file
+void set_vd_max(int8_t max);
+
+/**
+ * @brief Get the maximum number of virtual desktops
+ * 
+ * @return int8_t The value last set with set_vd_max() (default is 9)
+ */
+int8_t get_vd_max(void);
+
+/**
+ * @brief Tell the module which virtual desktop is current, without switching
+ * 
+ * Used to restore the tracking after a reboot. Ignored if out of range.
+ * 
+ * @param vd The current virtual desktop (1-based index)
+ */
+void set_current_vd(int8_t vd);
+
+#else // VIRTUAL_DESKTOP_ENABLE
+
+// Disabled in rules.mk: no-op stubs so callers compile away.
+static inline bool process_virtual_desktop(uint16_t keycode, keyrecord_t *record) { return true; }
+static inline void move_vd(int8_t vd) {}
+static inline void move_window_to_vd(int8_t vd) {}
+static inline int8_t get_current_vd(void) { return 1; }
+static inline void set_vd_max(int8_t max) {}
+static inline int8_t get_vd_max(void) { return 9; }
+static inline void set_current_vd(int8_t vd) {}
+
+#endif // VIRTUAL_DESKTOP_ENABLE
+ 
\ No newline at end of file
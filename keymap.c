@@ -14,6 +14,25 @@
 #include "features/virtual_desktop.h"
 #include "features/rgb_indicators.h"
 #include "features/process_meta_layer.h"
+#include "features/cycle_profile.h"
+#include "features/event_log.h"
+#include "features/telemetry.h"
+#include "features/key_stats.h"
+#include "features/heatmap.h"
+#include "features/leader.h"
+#include "features/key_history.h"
+#include "features/autocorrect.h"
+#include "features/snippets.h"
+#include "features/esc_dance.h"
+#include "features/output_queue.h"
+#include "features/hid_protocol.h"
+#include "features/settings.h"
+#include "features/keymap_overrides.h"
+#include "features/macro_recorder.h"
+
+#ifdef RAW_ENABLE
+#include "raw_hid.h"
+#endif
 
 /* The following files are meant to be included directly in keymap.c 
 *  We do this to trick the compiler into treating them as if they were defined in this file, as the
@@ -22,26 +41,99 @@
 #include "features/sentence_case_press_impl.h" // Include the sentence case press implementation
 
 void matrix_scan_user(void) {
-    secrets_timer_task();
+    CYCLE_PROFILE_VOID(PROBE_MATRIX_SCAN, secrets_timer_task());
+    telemetry_scan_task();
+    key_stats_task();
+    leader_task();
+    esc_dance_task();
+    output_queue_task();
+    settings_task();
+    keymap_overrides_task();
+    macro_recorder_task();
 }
 
-bool process_record_user(uint16_t keycode, keyrecord_t *record) {
-  // Process the keycodes in the order of priority
-  return process_record_sentence_case(keycode, record) &&
+// Sentence case isn't registered as a community module, so its idle
+// timeout has to be run from here
+void housekeeping_task_user(void) {
+    housekeeping_task_sentence_case();
+}
+
+// Process the keycodes in the order of priority. Handlers of features
+// disabled in rules.mk are inline stubs returning true, so they vanish here.
+// CYCLE_PROFILE() is a plain pass-through unless CYCLE_PROFILE_ENABLE is set.
+// The secrets go first: PIN digits and SECRET_SELECT tags are consumed
+// before anything that keeps or matches on typed keys can see them.
+static bool process_record_features(uint16_t keycode, keyrecord_t *record) {
+  return CYCLE_PROFILE(PROBE_SECRETS, process_pin_entry(keycode, record) &&
+                                      process_pin_entry_keycode(keycode, record) &&
+                                      process_secret_keycodes(keycode, record)) &&
+         process_macro_recorder(keycode, record) &&
+         process_esc_dance(keycode, record) &&
+         process_leader(keycode, record) &&
+         process_key_history(keycode, record) &&
+         CYCLE_PROFILE(PROBE_SNIPPETS, process_snippets(keycode, record)) &&
+         CYCLE_PROFILE(PROBE_AUTOCORRECT, process_autocorrect(keycode, record)) &&
+         CYCLE_PROFILE(PROBE_SENTENCE_CASE, process_record_sentence_case(keycode, record)) &&
          process_run_cmd(keycode, record) &&
          process_meta_layer(keycode, record) &&
-         process_virtual_desktop(keycode, record) &&
-         process_pin_entry(keycode, record) &&
-         process_pin_entry_keycode(keycode, record) &&
-         process_secret_keycodes(keycode, record);
+         CYCLE_PROFILE(PROBE_VIRTUAL_DESKTOP, process_virtual_desktop(keycode, record));
+}
 
-    return true; // otherwise, let QMK send the key normally
+bool process_record_user(uint16_t keycode, keyrecord_t *record) {
+  telemetry_record_event();
+  settings_record_event();
+  key_stats_record(keycode, record);
+  heatmap_record(record);
+  return CYCLE_PROFILE_EVENT(PROBE_PROCESS_RECORD, keycode, record,
+                             process_record_features(keycode, record));
 }
 
-#ifdef RGB_MATRIX_ENABLE
+#if defined(RGB_MATRIX_ENABLE) && defined(RGB_INDICATORS_ENABLE)
 // Main RGB function that QMK will look for - calls our implementation
 bool rgb_matrix_indicators_user(void) {
-    return rgb_indicators_implementation();
+    return CYCLE_PROFILE(PROBE_RGB_INDICATORS, rgb_indicators_implementation());
+}
+#endif
+
+#ifdef RAW_ENABLE
+// Raw HID requests from the tools/ host scripts; see features/hid_protocol.h
+void raw_hid_receive(uint8_t *data, uint8_t length) {
+    switch (data[0]) {
+#ifdef TELEMETRY_ENABLE
+        case HID_CMD_TELEMETRY:
+            telemetry_raw_hid(data, length);
+            break;
+#endif
+#ifdef EVENT_LOG_ENABLE
+        case HID_CMD_EVENT_LOG:
+            event_log_raw_hid(data, length);
+            break;
+#endif
+#ifdef KEY_STATS_ENABLE
+        case HID_CMD_KEY_STATS:
+            key_stats_raw_hid(data, length);
+            break;
+#endif
+#ifdef SECRETS_HID_ENABLE
+        case HID_CMD_SECRET:
+            secrets_raw_hid(data, length);
+            break;
+#endif
+#ifdef KEYMAP_OVERRIDES_ENABLE
+        case HID_CMD_KEYMAP:
+            keymap_overrides_raw_hid(data, length);
+            break;
+#endif
+#ifdef CYCLE_PROFILE_ENABLE
+        case HID_CMD_CYCLE_TRACE:
+            cycle_profile_raw_hid(data, length);
+            break;
+#endif
+        default:
+            data[1] = HID_STATUS_UNSUPPORTED;
+            break;
+    }
+    raw_hid_send(data, length);
 }
 #endif
 
@@ -49,6 +141,17 @@ void keyboard_post_init_user(void) {
     debug_enable   = false;   // master debug switch
     debug_matrix   = false;  // raw switch-matrix events
     debug_keyboard = false;   // uncomment if you want keycode-by-keycode logs
+
+    cycle_profile_init();
+    key_stats_init();
+    keymap_overrides_init();
+    macro_recorder_init();
+    CYCLE_PROFILE_VOID(PROBE_SETTINGS_LOAD, settings_init());
+}
+
+bool shutdown_user(bool jump_to_bootloader) {
+    settings_flush(); // QK_BOOT shouldn't lose a change still waiting for its write
+    return true;
 }
 
 
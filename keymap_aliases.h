@@ -0,0 +1,34 @@
+/**
+ * @file keymap_aliases.h
+ * @brief Keycode aliases used by the layers in keymap.json
+ *
+ * keymaps.h is generated by tools/keymap_gen.py; anything the layers refer
+ * to that isn't a plain keycode or a custom keycode is defined here.
+ */
+
+#pragma once
+
+// Left-hand home row mod keys
+#define HOME_A LGUI_T(KC_A)
+#define HOME_R LALT_T(KC_R)
+#define HOME_S LSFT_T(KC_S)
+#define HOME_T LCTL_T(KC_T)
+#define HOME_D LT(_NAV, KC_D)
+
+// Right-hand home row mod keys
+#define HOME_H LT(_NAV, KC_H)
+#define HOME_N RCTL_T(KC_N)
+#define HOME_E RSFT_T(KC_E)
+#define HOME_I RALT_T(KC_I)
+#define HOME_O RGUI_T(KC_O)
+
+// Alt+F4 keycode for killing applications
+#define KC_KILL LALT(KC_F4)
+
+// Esc tap dance (features/esc_dance.h): tap Esc, double tap locks secrets,
+// hold for _FL. Plain Esc when the feature is switched off in rules.mk
+#ifdef ESC_DANCE_ENABLE
+#define ESC_TD TD(TD_ESC)
+#else
+#define ESC_TD KC_ESC
+#endif
@@ -1,27 +1,47 @@
+// Generated by tools/keymap_gen.py from keymap.json - do not edit.
+
 /**
  * @file layers.h
- * @brief Layer definitions for keyboard firmware
- * 
- * This file defines the various keyboard layers used in the firmware.
- * Layers allow different key mappings to be activated, giving more
- * functionality with fewer physical keys.
+ * @brief Layer numbers, and the per-layer key masks from keymaps.h
+ *
+ * Layers are numbered densely in keymap.json order; a later layer takes
+ * priority over an earlier one.
  */
 
 #pragma once
 
+#include <stdint.h>
+
 /**
  * @enum custom_layers
  * @brief Enumeration of all keyboard layers
- * 
- * The underscores don't mean anything - you can have a layer called STUFF or any other name.
- * Each layer gets a name for readability, which is then used in the keymap matrix.
  */
 enum custom_layers {
     _BL = 0,    /**< Base Layer - Default layer (Colemak layout) */
     _QW = 1,    /**< QWERTY Layer - Standard QWERTY layout if needed */
     _RG = 2,    /**< RGB Layer - Controls for RGB lighting */
     _NM = 3,    /**< No Mod Layer - Similar to base but without modifiers */
-    _NAV= 4,    /**< Navigation Layer - Arrow keys and text navigation */
-    _FL = 10,   /**< Function Layer - F-keys, media controls, and special functions */
-    _META = 11, /**< Meta Layer - Virtual desktop switching and application launching */
-};
\ No newline at end of file
+    _NAV = 4,   /**< Navigation Layer - Arrow keys and text navigation */
+    _FL = 5,    /**< Function Layer - F-keys, media controls, and special functions */
+    _META = 6,  /**< Meta Layer - Virtual desktop switching and application launching */
+};
+
+/**
+ * @brief Number of layers in keymaps[]
+ */
+#define LAYER_COUNT 7
+
+/**
+ * @brief Keys in LAYOUT(), and bytes in one layer's mask
+ */
+#define KEYMAP_LAYOUT_KEYS 99
+#define KEYMAP_MASK_BYTES 13
+
+/**
+ * @brief Per-layer masks, bit i for the i-th LAYOUT() key (LED i)
+ *
+ * keymap_trans_mask marks KC_TRNS keys, keymap_led_mask keys bound to
+ * something on that layer. See tools/keymap_gen.py.
+ */
+extern const uint8_t keymap_trans_mask[LAYER_COUNT][KEYMAP_MASK_BYTES];
+extern const uint8_t keymap_led_mask[LAYER_COUNT][KEYMAP_MASK_BYTES];
@@ -0,0 +1,39 @@
+/**
+ * @file leader_sequences.h
+ * @brief Leader key sequences
+ *
+ * Each entry maps the keys typed after QK_LEAD to a keycode. The keycode is
+ * replayed through process_record_user(), so any custom keycode works (run
+ * commands, virtual desktops, secrets, ...) as well as plain keycodes.
+ *
+ * Sequences may use a-z, 0-9 and . , / ; - (matched by what the key types,
+ * so they follow the active layout). A sequence that is a prefix of another
+ * fires after LEADER_TIMEOUT; all others fire on their last key.
+ *
+ * After editing, regenerate the trie the firmware actually uses:
+ *   tools/leader_trie.py
+ */
+
+#pragma once
+
+#define LEADER_SEQUENCES(_) \
+    _("t",   RUN_WT)        \
+    _("e",   RUN_FILES)     \
+    _("b",   RUN_BROWSER)   \
+    _("n",   RUN_NOTEPAD)   \
+    _("d1",  VD_1)          \
+    _("d2",  VD_2)          \
+    _("d3",  VD_3)          \
+    _("d4",  VD_4)          \
+    _("d5",  VD_5)          \
+    _("d6",  VD_6)          \
+    _("d7",  VD_7)          \
+    _("d8",  VD_8)          \
+    _("d9",  VD_9)          \
+    _("p",   PIN_ENTRY)     \
+    _("pp",  E_PHRASE)      \
+    _("p1",  E_PASS1)       \
+    _("p2",  E_PASS2)       \
+    _("p3",  E_PASS3)       \
+    _("p4",  E_PASS4)       \
+    _("ps",  SECRET_SELECT)
@@ -3,11 +3,148 @@
 ############################
 
 # === CUSTOM FEATURES AND SOURCE FILES ===
-# Add custom C files to be compiled
-SRC += features/sentence_case.c      # Sentence case implementation
-SRC += features/secrets_manager.c    # Secure storage for sensitive data
-SRC += features/virtual_desktop.c    # Virtual desktop switching functionality
-SRC += features/rgb_indicators.c     # RGB lighting status indicators
+# Each feature can be switched off here (or with `qmk compile -e FOO_ENABLE=no`).
+# A disabled feature's sources are not built and its header swaps in inline
+# no-op stubs, so the calls in keymap.c compile away entirely.
+
+# SENTENCE_CASE_ENABLE: Automatically capitalize first letter of sentences
+SENTENCE_CASE_ENABLE = yes
+
+# SECRETS_ENABLE: PIN-protected password/phrase macros (needs secrets.h, encrypted with tools/secrets_vault.py)
+SECRETS_ENABLE = yes
+
+# SECRETS_HID_ENABLE: Send passwords to tools/secrets_companion.py over raw HID when it's running (needs SECRETS_HID_KEY)
+SECRETS_HID_ENABLE = no
+
+# VIRTUAL_DESKTOP_ENABLE: Windows virtual desktop switching (VD_1..VD_9)
+VIRTUAL_DESKTOP_ENABLE = yes
+
+# RUN_CMDS_ENABLE: Application launcher keycodes via the Run dialog (RUN_*)
+RUN_CMDS_ENABLE = yes
+
+# META_LAYER_ENABLE: META_LAYER key holding GUI over the _META layer
+META_LAYER_ENABLE = yes
+
+# RGB_INDICATORS_ENABLE: Layer/Caps/PIN status LEDs (needs RGB_MATRIX_ENABLE)
+RGB_INDICATORS_ENABLE = yes
+
+# AUTOCORRECT_TRIE_ENABLE: Autocorrect typos from autocorrect_dictionary.txt (regenerate with tools/autocorrect_trie.py)
+AUTOCORRECT_TRIE_ENABLE = yes
+
+# SNIPPETS_ENABLE: Expand the triggers in snippet_expansions.h as they're typed (regenerate with tools/snippet_automaton.py)
+SNIPPETS_ENABLE = yes
+
+ifeq ($(strip $(SENTENCE_CASE_ENABLE)), yes)
+    KEY_HISTORY_ENABLE = yes
+    SRC += features/sentence_case.c      # Sentence case implementation
+    OPT_DEFS += -DSENTENCE_CASE_ENABLE
+endif
+
+ifeq ($(strip $(AUTOCORRECT_TRIE_ENABLE)), yes)
+    KEY_HISTORY_ENABLE = yes
+    SRC += features/autocorrect.c        # Trie-based autocorrect
+    OPT_DEFS += -DAUTOCORRECT_TRIE_ENABLE
+endif
+
+ifeq ($(strip $(SNIPPETS_ENABLE)), yes)
+    KEY_HISTORY_ENABLE = yes
+    OUTPUT_QUEUE_ENABLE = yes
+    SRC += features/snippets.c           # Aho-Corasick text expansion
+    OPT_DEFS += -DSNIPPETS_ENABLE
+endif
+
+# One typed-key history shared by sentence case, autocorrect and snippets
+ifeq ($(strip $(KEY_HISTORY_ENABLE)), yes)
+    SRC += features/key_history.c        # Shared key history
+    OPT_DEFS += -DKEY_HISTORY_ENABLE
+endif
+
+ifeq ($(strip $(SECRETS_ENABLE)), yes)
+    OUTPUT_QUEUE_ENABLE = yes
+    SRC += features/secrets_manager.c    # Secure storage for sensitive data
+    SRC += features/chacha20.c           # Vault cipher
+    OPT_DEFS += -DSECRETS_ENABLE
+endif
+
+ifeq ($(strip $(SECRETS_ENABLE))$(strip $(SECRETS_HID_ENABLE)), yesyes)
+    RAW_ENABLE = yes
+    SRC += features/poly1305.c           # Raw HID channel authenticator
+    OPT_DEFS += -DSECRETS_HID_ENABLE
+endif
+
+# Non-blocking typing for features that send more than a key or two
+ifeq ($(strip $(OUTPUT_QUEUE_ENABLE)), yes)
+    SRC += features/output_queue.c       # Output queue
+    OPT_DEFS += -DOUTPUT_QUEUE_ENABLE
+endif
+
+ifeq ($(strip $(VIRTUAL_DESKTOP_ENABLE)), yes)
+    SRC += features/virtual_desktop.c    # Virtual desktop switching functionality
+    OPT_DEFS += -DVIRTUAL_DESKTOP_ENABLE
+endif
+
+ifeq ($(strip $(RUN_CMDS_ENABLE)), yes)
+    OPT_DEFS += -DRUN_CMDS_ENABLE           # header-only, see features/run_cmds.h
+endif
+
+ifeq ($(strip $(META_LAYER_ENABLE)), yes)
+    OPT_DEFS += -DMETA_LAYER_ENABLE         # header-only, see features/process_meta_layer.h
+endif
+
+ifeq ($(strip $(RGB_INDICATORS_ENABLE)), yes)
+    SRC += features/rgb_indicators.c     # RGB lighting status indicators
+    OPT_DEFS += -DRGB_INDICATORS_ENABLE
+endif
+
+# KEY_STATS_ENABLE: Per-key, per-layer, home row bigram and WPM statistics in EEPROM (see tools/key_stats.py)
+KEY_STATS_ENABLE = yes
+
+ifeq ($(strip $(KEY_STATS_ENABLE)), yes)
+    RAW_ENABLE = yes
+    SRC += features/key_stats.c          # Keystroke statistics engine
+    OPT_DEFS += -DKEY_STATS_ENABLE
+endif
+
+# KEYMAP_OVERRIDES_ENABLE: Rebind keys at runtime over raw HID, kept in EEPROM (see tools/keymap_overrides.py)
+KEYMAP_OVERRIDES_ENABLE = yes
+
+ifeq ($(strip $(KEYMAP_OVERRIDES_ENABLE)), yes)
+    RAW_ENABLE = yes
+    SRC += features/keymap_overrides.c   # Runtime key binding overrides
+    OPT_DEFS += -DKEYMAP_OVERRIDES_ENABLE
+endif
+
+# MACRO_RECORDER_ENABLE: Record key sequences with MACRO_REC_n and replay them with MACRO_PLAY_n, kept in EEPROM
+MACRO_RECORDER_ENABLE = yes
+
+ifeq ($(strip $(MACRO_RECORDER_ENABLE)), yes)
+    SRC += features/macro_recorder.c     # Runtime macro recorder
+    OPT_DEFS += -DMACRO_RECORDER_ENABLE
+endif
+
+# SETTINGS_ENABLE: Keep sentence case, autocorrect, virtual desktop and tapping term settings across reboots
+SETTINGS_ENABLE = yes
+
+ifeq ($(strip $(SETTINGS_ENABLE)), yes)
+    SRC += features/settings.c           # Persistent settings block
+    OPT_DEFS += -DSETTINGS_ENABLE
+endif
+
+# LEADER_TRIE_ENABLE: QK_LEAD sequences from leader_sequences.h (regenerate with tools/leader_trie.py)
+LEADER_TRIE_ENABLE = yes
+
+ifeq ($(strip $(LEADER_TRIE_ENABLE)), yes)
+    SRC += features/leader.c             # Trie-based leader engine
+    OPT_DEFS += -DLEADER_TRIE_ENABLE
+endif
+
+# ESC_DANCE_ENABLE: Esc tap dance - tap Esc, double tap lock secrets, hold _FL (ESC_TD in keymaps.h)
+ESC_DANCE_ENABLE = yes
+
+ifeq ($(strip $(ESC_DANCE_ENABLE)), yes)
+    SRC += features/esc_dance.c          # Eager Esc tap dance
+    OPT_DEFS += -DESC_DANCE_ENABLE
+endif
 
 # === CORE QMK FEATURES ===
 # CAPS_WORD_ENABLE: Type words in all caps by tapping shift+shift
@@ -16,32 +153,42 @@ SRC += features/rgb_indicators.c     # RGB lighting status indicators
 CAPS_WORD_ENABLE = yes
 #define BOTH_SHIFTS_TURNS_ON_CAPS_WORD # Enable this to make both shift keys activate caps word
 
-# SENTENCE_CASE_ENABLE: Automatically capitalize first letter of sentences
-SENTENCE_CASE_ENABLE = yes
-
 # DYNAMIC_TAPPING_TERM_ENABLE: Adjust tapping term at runtime with DT_PRNT, DT_UP, and DT_DOWN (see keymaps.c for usage)
 DYNAMIC_TAPPING_TERM_ENABLE = yes
 
 # DEFERRED_EXEC_ENABLE: Allow functions to be executed after a delay
 DEFERRED_EXEC_ENABLE = yes
 
-# AUTOCORRECT_ENABLE = yes
+# NKRO_ENABLE: N-key rollover, switched on with NK_ON / NK_TOGG. While on, the output
+# queue types text in bursts of held keys (features/output_queue.h)
+NKRO_ENABLE = yes
 
-# TAP_DANCE_ENABLE: Configure keys to have different behavior depending on taps
-# I was was using this for some custom keys at one point, but I don't think I need it anymore
-# If you want to add tap dance functionality, you can enable this
-# and define your tap dance keycodes in custom_keycodes.h and keymaps.c
+# AUTOCORRECT_ENABLE: QMK's own autocorrect. Keep it off: AC_TOGG is handled by
+# the trie engine above (AUTOCORRECT_TRIE_ENABLE), which shares sentence case's key history
+AUTOCORRECT_ENABLE = no
 
-# TAP_DANCE_ENABLE = yes
+# TAP_DANCE_ENABLE: QMK's own tap dance. Keep it off: TD(TD_ESC) is handled by
+# the eager engine above (ESC_DANCE_ENABLE), which doesn't wait out TAPPING_TERM
+# on every Esc. Tap dance keycodes live in custom_keycodes.h
+TAP_DANCE_ENABLE = no
 
-# LEADER_ENABLE: Allows for key sequences like Vim leader commands
-# Might revisit this in the future, but for now I don't use it
+# LEADER_ENABLE: QMK's own leader key. Keep it off: QK_LEAD is handled by
+# the trie engine above (LEADER_TRIE_ENABLE) instead
 LEADER_ENABLE = no
 
 # === RGB LIGHTING ===
 # RGB_MATRIX_ENABLE: Control per-key RGB LEDs
 RGB_MATRIX_ENABLE = yes
 
+# HEATMAP_ENABLE: Typing heatmap RGB effect with decaying per-key heat (select with RGB_MOD on _RG)
+HEATMAP_ENABLE = yes
+
+ifeq ($(strip $(RGB_MATRIX_ENABLE))$(strip $(HEATMAP_ENABLE)), yesyes)
+    RGB_MATRIX_CUSTOM_USER = yes         # Registers the effects in rgb_matrix_user.inc
+    SRC += features/heatmap.c            # Heatmap effect
+    OPT_DEFS += -DHEATMAP_ENABLE
+endif
+
 # === DEBUGGING AND UTILITY ===
 # CONSOLE_ENABLE: Debug console for QMK
 CONSOLE_ENABLE = no
@@ -49,3 +196,30 @@ CONSOLE_ENABLE = no
 # COMMAND_ENABLE: Enable command processing
 COMMAND_ENABLE = no
 
+# EVENT_LOG_ENABLE: Binary event log ring replacing dprintf on hot paths (see tools/event_log_decode.py)
+EVENT_LOG_ENABLE = no
+
+ifeq ($(strip $(EVENT_LOG_ENABLE)), yes)
+    SRC += features/event_log.c          # Event log ring storage
+    OPT_DEFS += -DEVENT_LOG_ENABLE
+endif
+
+# TELEMETRY_ENABLE: Scan rate and feature counters readable over raw HID (see tools/telemetry.py)
+TELEMETRY_ENABLE = yes
+
+ifeq ($(strip $(TELEMETRY_ENABLE)), yes)
+    RAW_ENABLE = yes
+    SRC += features/telemetry.c          # Raw HID counters block
+    OPT_DEFS += -DTELEMETRY_ENABLE
+    OPT_DEFS += -DSENTENCE_CASE_STATS    # Source of the capitalisation count
+endif
+
+# CYCLE_PROFILE_ENABLE: Count CPU cycles spent in the feature hot paths (DWT, Cortex-M3+)
+CYCLE_PROFILE_ENABLE = no
+
+ifeq ($(strip $(CYCLE_PROFILE_ENABLE)), yes)
+    RAW_ENABLE = yes                     # Slowest events read by tools/cycle_trace.py
+    SRC += features/cycle_profile.c      # DWT cycle counters
+    OPT_DEFS += -DCYCLE_PROFILE_ENABLE
+endif
+
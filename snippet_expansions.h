@@ -0,0 +1,28 @@
+/**
+ * @file snippet_expansions.h
+ * @brief Text snippets expanded as their trigger is typed
+ *
+ * Each entry maps a trigger to the text that replaces it. As soon as the
+ * trigger's last key is pressed, the rest of the trigger is backspaced and
+ * the text typed in its place; the last key itself is never typed.
+ *
+ * Triggers may use a-z, 0-9, space and - = [ ] \ ; ' ` , . / and are
+ * matched by key, so Shift makes no difference ("addr;" also fires on
+ * "ADDR:"). No trigger may contain another, and ending them in a key that
+ * rarely follows a letter (like ;) keeps them out of normal words. Texts
+ * are plain ASCII; \n types Enter and \t Tab.
+ *
+ * After editing, regenerate the automaton the firmware actually uses:
+ *   tools/snippet_automaton.py
+ */
+
+#pragma once
+
+#define SNIPPET_EXPANSIONS(_)                                   \
+    _("addr;",  "221B Baker Street, London NW1 6XE")            \
+    _("mail;",  "me@example.com")                               \
+    _("sig;",   "Best regards,\nLordHerdier")                   \
+    _("tyvm;",  "Thank you very much!")                         \
+    _("lgtm;",  "Looks good to me, thanks!")                    \
+    _("shrug;", "\\_(o.o)_/")                                   \
+    _("qmk;",   "qmk compile -kb gmmk2/p96/ansi -km lordherdier")
@@ -0,0 +1,123 @@
+/**
+ * @file bench_macro_recorder.c
+ * @brief Bytes per recorded event on typed corpora
+ *
+ * Replays the keystroke traces tools/corpus_trace.py makes from the
+ * test/corpus/ texts through the whole keymap in virtual time, recording
+ * them into macro slot 1 back to back: each time a macro fills up and is
+ * saved, the next one starts. The bytes of the saved slots over the events
+ * they hold is what the token format costs on real typing, pauses and
+ * typos included; a plain (keycode, pressed, ms) record would take four.
+ *
+ *     make -C test bench CONFIG="-DMACRO_RECORDER_TICK_MS=16"
+ */
+
+#include "sim.h"
+#include "custom_keycodes.h"
+#include "features/eeprom_layout.h"
+#include "features/macro_recorder.h"
+
+static uint32_t events, macro_events, macro_bytes, macros, runs;
+
+/**
+ * @brief process_record_user(), counting the events that went into a macro
+ */
+static bool counted_process_record(uint16_t keycode, keyrecord_t *record) {
+    bool recording = macro_recorder_recording();
+    bool go_on     = process_record_user(keycode, record);
+    if (recording && macro_recorder_recording() && keycode != MACRO_REC_1) {
+        events++;
+    }
+    return go_on;
+}
+
+/**
+ * @brief Wait for the full macro to be saved and count it, then start the next
+ */
+static void next_macro(void) {
+    const macro_slot_t *slot = (const macro_slot_t *)(sim_eeprom + EEPROM_MACROS_OFFSET);
+
+    sim_idle(10);
+    if (events) {
+        macros++;
+        macro_events += events;
+        macro_bytes += slot->length;
+        for (uint8_t i = 0; i < slot->length; i++) {
+            runs += MACRO_TOKEN_KIND(slot->events[i]) == MACRO_RUN;
+        }
+    }
+    events = 0;
+    sim_tap(MACRO_REC_1);
+}
+
+/**
+ * @brief Record one trace file; false if it can't be read
+ */
+static bool record(const char *path) {
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        perror(path);
+        return false;
+    }
+
+    char          line[1024];
+    unsigned long line_number = 0;
+    uint32_t      start       = sim_now();
+
+    macros = macro_events = macro_bytes = runs = events = 0;
+    next_macro();
+    while (fgets(line, sizeof(line), file)) {
+        unsigned long ms;
+        char          action[8];
+        unsigned int  keycode;
+
+        line_number++;
+        if (line[0] == '#' || line[0] == '=' || line[0] == '\n') {
+            continue;
+        }
+        if (sscanf(line, "%lu %7s %x", &ms, action, &keycode) != 3 ||
+            (strcmp(action, "down") && strcmp(action, "up"))) {
+            fprintf(stderr, "%s:%lu: bad line\n", path, line_number);
+            fclose(file);
+            return false;
+        }
+        while (sim_now() - start < ms) {
+            sim_scan();
+            if (!macro_recorder_recording()) {
+                next_macro();
+            }
+        }
+        if (!strcmp(action, "down")) {
+            sim_press((uint16_t)keycode);
+        } else {
+            sim_release((uint16_t)keycode);
+        }
+    }
+    fclose(file);
+
+    // Only full slots are counted; the one being filled at the end is dropped
+    if (macro_recorder_recording()) {
+        events = 0;
+        sim_tap(MACRO_REC_1);
+        sim_idle(10);
+    }
+    sim_drain(60000);
+
+    printf("  %s: %lu macros of %u bytes, %lu events, %.2f bytes per event, %lu runs\n", path,
+           (unsigned long)macros, MACRO_RECORDER_SIZE, (unsigned long)macro_events,
+           macro_events ? (double)macro_bytes / macro_events : 0.0, (unsigned long)runs);
+    return true;
+}
+
+int main(int argc, char **argv) {
+    sim_boot(0);
+    sim_process_record = counted_process_record;
+
+    printf("macro recorder: EEPROM bytes per recorded event, %u ms ticks\n", MACRO_RECORDER_TICK_MS);
+    for (int i = 1; i < argc; i++) {
+        if (!record(argv[i])) {
+            return 1;
+        }
+    }
+    return 0;
+}
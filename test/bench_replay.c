@@ -0,0 +1,142 @@
+/**
+ * @file bench_replay.c
+ * @brief Replays keystroke traces through the whole keymap and times each event
+ *
+ * Reads traces in the format of tools/corpus_trace.py, including the state
+ * lines tools/cycle_trace.py writes before each of the keyboard's slowest
+ * events:
+ *
+ *     <ms> state 0x<mods> <layer>    set the real mods and the highest layer
+ *
+ * Every event goes through process_record_user() in virtual time, as on
+ * the keyboard, and the slowest ones are listed with the trace line that
+ * caused them, so a slow path the keyboard measured can be reproduced here
+ * and taken apart with a debugger or a profiler. Host ns aren't MCU cycles,
+ * but the same code path is slow on both.
+ *
+ *     test/build/bench/bench_replay worst.trace
+ */
+
+#include "sim.h"
+#include "features/key_history.h"
+#include <stdlib.h>
+#include <time.h>
+
+#define SLOWEST 5 // Events listed per trace
+
+typedef struct {
+    uint64_t ns;
+    uint32_t line;
+    uint16_t keycode;
+    bool     pressed;
+} slow_event_t;
+
+static slow_event_t slowest[SLOWEST];
+static uint32_t     events, line_number;
+static uint64_t     total_ns;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief process_record_user(), timed, keeping the slowest events sorted
+ */
+static bool timed_process_record(uint16_t keycode, keyrecord_t *record) {
+    uint64_t start = now_ns();
+    bool     go_on = process_record_user(keycode, record);
+    uint64_t ns    = now_ns() - start;
+
+    events++;
+    total_ns += ns;
+    int i = SLOWEST - 1;
+    if (ns > slowest[i].ns) {
+        for (; i > 0 && slowest[i - 1].ns < ns; i--) {
+            slowest[i] = slowest[i - 1];
+        }
+        slowest[i] = (slow_event_t){.ns = ns, .line = line_number, .keycode = keycode, .pressed = record->event.pressed};
+    }
+    return go_on;
+}
+
+/**
+ * @brief Replay one trace file; false if it can't be read
+ */
+static bool replay(const char *path) {
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        perror(path);
+        return false;
+    }
+
+    char     line[1024];
+    uint32_t start = sim_now();
+
+    memset(slowest, 0, sizeof(slowest));
+    events = total_ns = line_number = 0;
+    while (fgets(line, sizeof(line), file)) {
+        unsigned long ms;
+        char          action[8];
+        unsigned int  value, layer;
+
+        line_number++;
+        if (line[0] == '#' || line[0] == '=' || line[0] == '\n') {
+            continue;
+        }
+        if (sscanf(line, "%lu %7s %x", &ms, action, &value) != 3) {
+            fprintf(stderr, "%s:%lu: bad line\n", path, (unsigned long)line_number);
+            fclose(file);
+            return false;
+        }
+        while (sim_now() - start < ms) {
+            sim_scan();
+        }
+        if (!strcmp(action, "down")) {
+            sim_press((uint16_t)value);
+        } else if (!strcmp(action, "up")) {
+            sim_release((uint16_t)value);
+        } else if (!strcmp(action, "state") && sscanf(line, "%*u %*s %*x %u", &layer) == 1) {
+            clear_weak_mods();
+            clear_oneshot_mods();
+            set_mods((uint8_t)value);
+            layer_move((uint8_t)layer);
+        } else {
+            fprintf(stderr, "%s:%lu: bad line\n", path, (unsigned long)line_number);
+            fclose(file);
+            return false;
+        }
+    }
+    fclose(file);
+
+    // Leave the next trace a keyboard at rest
+    sim_drain(60000);
+    clear_mods();
+    layer_clear();
+
+    printf("  %s: %lu events, %.0f ns average\n", path, (unsigned long)events,
+           events ? (double)total_ns / events : 0.0);
+    for (int i = 0; i < SLOWEST && slowest[i].ns; i++) {
+        printf("    line %-6lu 0x%04X %-4s %6lu ns\n", (unsigned long)slowest[i].line, slowest[i].keycode,
+               slowest[i].pressed ? "down" : "up", (unsigned long)slowest[i].ns);
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    sim_boot(0);
+    // First calls pay for cold caches and page faults the keyboard never sees
+    sim_type("Warm up.\n");
+    sim_drain(60000);
+    key_history_clear();
+    sim_process_record = timed_process_record;
+
+    printf("replay: process_record_user() per event, slowest first\n");
+    for (int i = 1; i < argc; i++) {
+        if (!replay(argv[i])) {
+            return 1;
+        }
+    }
+    return 0;
+}
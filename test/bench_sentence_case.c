@@ -0,0 +1,237 @@
+/**
+ * @file bench_sentence_case.c
+ * @brief Sentence case accuracy and cost on typed corpora
+ *
+ * Replays the keystroke traces tools/corpus_trace.py makes from
+ * the test/corpus/ texts in virtual time, through the key history and sentence
+ * case only, so pauses in the trace let the idle timeout fire as it would
+ * on the keyboard. Each line the host reads back is compared with the
+ * corpus line:
+ *   - a false capital is a letter sentence case shifted that should have
+ *     stayed lower case (an abbreviation taken for a sentence end)
+ *   - a missed capital is a sentence start it left lower case (after a
+ *     timeout, a typo or an ending it didn't recognise)
+ *
+ * Also prints ns per event, the SENTENCE_CASE_STATS counters and the RAM
+ * the two features take. To compare configurations, rebuild with another
+ * buffer size or timeout, e.g.
+ *
+ *     make -C test bench CONFIG="-DKEY_HISTORY_SIZE=16 -DSENTENCE_CASE_TIMEOUT=2000"
+ */
+
+#include "sim.h"
+#include "features/key_history.h"
+#include "features/sentence_case.h"
+#include <ctype.h>
+#include <libgen.h>
+#include <stdlib.h>
+#include <time.h>
+
+#ifndef SENTENCE_CASE_TIMEOUT
+#    define SENTENCE_CASE_TIMEOUT 5000 // The default in sentence_case.c
+#endif
+
+#define EXAMPLES 4 // Mistakes of each kind printed per trace
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t events, event_ns, event_max_ns, timer_ns;
+
+/**
+ * @brief The slice of process_record_features() sentence case depends on,
+ *        with sentence case timed
+ */
+static bool sentence_case_only(uint16_t keycode, keyrecord_t *record) {
+    if (!process_key_history(keycode, record)) {
+        return false;
+    }
+    uint64_t start = now_ns();
+    bool     go_on = process_record_sentence_case(keycode, record);
+    uint64_t ns    = now_ns() - start;
+    ns             = ns > timer_ns ? ns - timer_ns : 0;
+    event_ns += ns;
+    event_max_ns = ns > event_max_ns ? ns : event_max_ns;
+    events++;
+    return go_on;
+}
+
+/**
+ * @brief What a pair of now_ns() calls costs on their own
+ */
+static uint64_t timer_overhead(void) {
+    uint64_t best = UINT64_MAX;
+    for (int i = 0; i < 10000; i++) {
+        uint64_t start = now_ns();
+        uint64_t ns    = now_ns() - start;
+        best           = ns < best ? ns : best;
+    }
+    return best;
+}
+
+typedef struct {
+    uint32_t lines, letters, capitals, false_caps, missed_caps, garbled;
+} accuracy_t;
+
+/**
+ * @brief Print a mistake with the line around it, the letter in brackets
+ */
+static void example(const char *kind, const char *typed, size_t at) {
+    size_t from = at > 24 ? at - 24 : 0;
+    printf("    %-6s \"%.*s[%c]%.24s\"\n", kind, (int)(at - from), typed + from, typed[at], typed + at + 1);
+}
+
+/**
+ * @brief Compare what the host read for one corpus line with the line
+ */
+static void check_line(const char *truth, accuracy_t *acc) {
+    const char *typed = sim_typed();
+    size_t      len   = strlen(truth);
+
+    acc->lines++;
+    if (strlen(typed) != len + 1 || strncasecmp(typed, truth, len) || typed[len] != '\n') {
+        if (acc->garbled++ < EXAMPLES) {
+            printf("    garbled \"%s\"\n", typed);
+        }
+        return;
+    }
+    for (size_t i = 0; i < len; i++) {
+        if (!isalpha((unsigned char)truth[i])) {
+            continue;
+        }
+        acc->letters++;
+        acc->capitals += isupper((unsigned char)truth[i]) != 0;
+        if (typed[i] == truth[i]) {
+            continue;
+        }
+        if (isupper((unsigned char)typed[i])) {
+            if (acc->false_caps++ < EXAMPLES) {
+                example("false", typed, i);
+            }
+        } else if (acc->missed_caps++ < EXAMPLES) {
+            example("missed", typed, i);
+        }
+    }
+}
+
+/**
+ * @brief Replay one trace file; false if it can't be read
+ */
+static bool replay(const char *path, accuracy_t *acc) {
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        perror(path);
+        return false;
+    }
+    printf("  %s\n", path);
+
+    static char truth[1024];
+    char        line[1024];
+    bool        have_truth = false;
+    uint32_t    start      = sim_now();
+
+    key_history_clear();
+    sentence_case_clear();
+    while (fgets(line, sizeof(line), file)) {
+        unsigned long ms;
+        char          action[8];
+        unsigned int  keycode;
+
+        line[strcspn(line, "\n")] = '\0';
+        if (line[0] == '#' || !line[0]) {
+            continue;
+        }
+        if (line[0] == '=') {
+            if (have_truth) {
+                check_line(truth, acc);
+            }
+            snprintf(truth, sizeof(truth), "%s", line + (line[1] == ' ' ? 2 : 1));
+            have_truth = true;
+            sim_reports_clear();
+            continue;
+        }
+        if (sscanf(line, "%lu %7s %x", &ms, action, &keycode) != 3) {
+            fprintf(stderr, "%s: bad line \"%s\"\n", path, line);
+            fclose(file);
+            return false;
+        }
+        while (sim_now() - start < ms) {
+            sim_scan();
+        }
+        if (!strcmp(action, "down")) {
+            sim_press((uint16_t)keycode);
+        } else if (!strcmp(action, "up")) {
+            sim_release((uint16_t)keycode);
+        } else {
+            fprintf(stderr, "%s: not a key event \"%s\"\n", path, line);
+            fclose(file);
+            return false;
+        }
+    }
+    if (have_truth) {
+        check_line(truth, acc);
+    }
+    fclose(file);
+    return true;
+}
+
+/**
+ * @brief RAM (.data and .bss) an object file of this build takes
+ */
+static unsigned long ram_bytes(const char *self, const char *object) {
+    char  command[512];
+    char *dir = strdup(self);
+    snprintf(command, sizeof(command), "nm -S --defined-only %s/%s 2>/dev/null", dirname(dir), object);
+    free(dir);
+
+    FILE         *nm    = popen(command, "r");
+    unsigned long total = 0;
+    char          line[256];
+    while (nm && fgets(line, sizeof(line), nm)) {
+        unsigned long address, size;
+        char          type;
+        if (sscanf(line, "%lx %lx %c", &address, &size, &type) == 3 && strchr("bBdD", type)) {
+            total += size;
+        }
+    }
+    if (nm) {
+        pclose(nm);
+    }
+    return total;
+}
+
+int main(int argc, char **argv) {
+    accuracy_t acc = {0};
+
+    sim_boot(0);
+    sim_process_record = sentence_case_only;
+    timer_ns           = timer_overhead();
+
+    printf("sentence case: KEY_HISTORY_SIZE %d, SENTENCE_CASE_STATE_HISTORY_SIZE %d, timeout %d ms\n",
+           KEY_HISTORY_SIZE, SENTENCE_CASE_STATE_HISTORY_SIZE, SENTENCE_CASE_TIMEOUT);
+    if (argc < 2) {
+        printf("  no traces; make -C test bench makes them from test/corpus/\n");
+        return 0;
+    }
+    for (int i = 1; i < argc; i++) {
+        if (!replay(argv[i], &acc)) {
+            return 1;
+        }
+    }
+
+    const sentence_case_stats_t *stats = sentence_case_get_stats();
+    printf("  %lu lines, %lu letters, %lu capitals: %lu false, %lu missed, %lu lines garbled\n",
+           (unsigned long)acc.lines, (unsigned long)acc.letters, (unsigned long)acc.capitals,
+           (unsigned long)acc.false_caps, (unsigned long)acc.missed_caps, (unsigned long)acc.garbled);
+    printf("  counters: %lu capitalised, %u endings rejected, %u undos, %u timeouts\n",
+           (unsigned long)stats->capitalizations, stats->rejected_endings, stats->undos, stats->timeouts);
+    printf("  %.1f ns per event (max %lu), over %lu events\n", events ? (double)event_ns / events : 0.0,
+           (unsigned long)event_max_ns, (unsigned long)events);
+    printf("  RAM: sentence case %lu B (history %d B), key history %lu B\n",
+           ram_bytes(argv[0], "features/sentence_case.o"), (int)SENTENCE_CASE_HISTORY_BYTES,
+           ram_bytes(argv[0], "features/key_history.o"));
+    return 0;
+}
@@ -0,0 +1,166 @@
+/**
+ * @file fuzz_events.c
+ * @brief libFuzzer target: arbitrary key event sequences through the keymap
+ *
+ * Each input is read as a list of operations on the simulated keyboard of
+ * test/sim.h: press or release a keycode from keymaps.h, tap one, let time
+ * pass, or send a raw HID packet. Feature state carries over from one input
+ * to the next, as it would on a keyboard that is never unplugged. Besides
+ * what the sanitizers catch, every input has to end with nothing stuck:
+ * once all keys are up, the output queue has drained and no macro is
+ * playing, the last report holds no key and no modifier.
+ *
+ *     make -C test fuzz FUZZ_TIME=600      libFuzzer, needs clang
+ *     make -C test fuzz-replay FUZZ_ARGS="crash-..."
+ *                                          rerun inputs in the gcc build
+ */
+
+#include "sim.h"
+#include "features/hid_protocol.h"
+#include "features/macro_recorder.h"
+#include <stdlib.h>
+
+#define MAX_DOWN 8 // Keys down at once, well under the sim's limit
+
+static uint16_t down[MAX_DOWN];
+static uint8_t  down_count;
+
+/**
+ * @brief The keycode at a flat index into keymaps[][][]
+ */
+static uint16_t keycode_at_index(uint16_t index) {
+    uint16_t positions = MATRIX_ROWS * MATRIX_COLS;
+    index %= keymap_layer_count() * positions;
+    return keycode_at_keymap_location_raw(index / positions, index % positions / MATRIX_COLS, index % MATRIX_COLS);
+}
+
+static int8_t find_down(uint16_t keycode) {
+    for (uint8_t i = 0; i < down_count; i++) {
+        if (down[i] == keycode) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static void release(uint8_t i) {
+    uint16_t keycode = down[i];
+    down[i]          = down[--down_count];
+    sim_release(keycode);
+}
+
+/**
+ * @brief Hand back whatever the keyboard sent over raw HID
+ */
+static void drain_raw_hid(void) {
+    uint8_t packet[HID_PACKET_SIZE];
+    while (sim_raw_hid_pop(packet)) {
+    }
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    static bool booted = false;
+    if (!booted) {
+        sim_boot(0);
+        booted = true;
+    }
+    sim_reports_clear();
+
+    while (size >= 3) {
+        uint8_t  op  = data[0];
+        uint16_t arg = data[1] | data[2] << 8;
+        data += 3;
+        size -= 3;
+
+        switch (op % 5) {
+            case 0: { // Press
+                uint16_t keycode = keycode_at_index(arg);
+                if (keycode != KC_NO && keycode != KC_TRNS && down_count < MAX_DOWN && find_down(keycode) < 0) {
+                    down[down_count++] = keycode;
+                    sim_press(keycode);
+                }
+                break;
+            }
+            case 1: // Release
+                if (down_count) {
+                    release(arg % down_count);
+                }
+                break;
+            case 2: { // Tap
+                uint16_t keycode = keycode_at_index(arg);
+                if (keycode != KC_NO && keycode != KC_TRNS && find_down(keycode) < 0) {
+                    sim_tap(keycode);
+                }
+                break;
+            }
+            case 3: // Wait, up to about a minute
+                sim_idle(arg % 256 << (op >> 5));
+                break;
+            case 4: { // Raw HID packet from the next bytes
+                uint8_t packet[HID_PACKET_SIZE] = {0};
+                size_t  n                       = size < sizeof(packet) - 1 ? size : sizeof(packet) - 1;
+                packet[0]                       = arg % 8;
+                memcpy(packet + 1, data, n);
+                data += n;
+                size -= n;
+                sim_raw_hid(packet);
+                break;
+            }
+        }
+        sim_scan();
+        drain_raw_hid();
+        if (sim_report_count() > 8192) {
+            sim_reports_clear();
+        }
+    }
+
+    // Nothing stays down once every key is up and everything has been typed
+    while (down_count) {
+        release(down_count - 1);
+        sim_scan();
+    }
+    sim_idle(1000);
+    sim_drain(600000);
+    for (uint8_t s = 0; s < 60 && macro_recorder_playing(); s++) {
+        sim_idle(1000);
+    }
+    drain_raw_hid();
+
+    // A replay with long recorded pauses may still be holding its keys
+    if (sim_report_count() && !macro_recorder_playing()) {
+        const sim_report_t *last = sim_report(sim_report_count() - 1);
+        for (uint8_t i = 0; i < sizeof(last->keys); i++) {
+            if (last->keys[i]) {
+                fprintf(stderr, "fuzz: keycodes 0x%02X.. still down\n", i * 8);
+                abort();
+            }
+        }
+        if (last->mods) {
+            fprintf(stderr, "fuzz: mods 0x%02X still down\n", last->mods);
+            abort();
+        }
+    }
+    return 0;
+}
+
+#ifdef FUZZ_REPLAY
+
+/**
+ * @brief Run each file named on the command line as one input
+ */
+int main(int argc, char **argv) {
+    for (int i = 1; i < argc; i++) {
+        static uint8_t data[1 << 16];
+        FILE          *file = fopen(argv[i], "rb");
+        if (!file) {
+            perror(argv[i]);
+            return 1;
+        }
+        size_t size = fread(data, 1, sizeof(data), file);
+        fclose(file);
+        LLVMFuzzerTestOneInput(data, size);
+    }
+    return 0;
+}
+
+#endif // FUZZ_REPLAY
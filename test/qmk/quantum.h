@@ -0,0 +1,435 @@
+/**
+ * @file quantum.h
+ * @brief Stand-in for QMK's quantum.h in the host test harness
+ *
+ * Declares the subset of the QMK API the keymap and features/ use, with
+ * QMK's own keycode values, so the firmware sources compile unchanged on
+ * the host. test/sim.c implements it against a virtual clock and records
+ * every keyboard report sent.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// ==== PROGMEM ====
+
+#define PROGMEM
+#define pgm_read_byte(p) (*(const uint8_t *)(p))
+#define pgm_read_word(p) (*(const uint16_t *)(p))
+#define pgm_read_dword(p) (*(const uint32_t *)(p))
+#define pgm_read_ptr(p) (*(void *const *)(p))
+#define PGM_LOADBIT(mem, pos) ((pgm_read_byte(&((mem)[(pos) / 8])) >> ((pos) % 8)) & 0x01)
+
+// ==== BASIC KEYCODES ====
+
+enum qk_keycode_defines {
+    KC_NO = 0x00, KC_TRANSPARENT = 0x01,
+    KC_A = 0x04, KC_B, KC_C, KC_D, KC_E, KC_F, KC_G, KC_H, KC_I, KC_J, KC_K, KC_L, KC_M,
+    KC_N, KC_O, KC_P, KC_Q, KC_R, KC_S, KC_T, KC_U, KC_V, KC_W, KC_X, KC_Y, KC_Z,
+    KC_1, KC_2, KC_3, KC_4, KC_5, KC_6, KC_7, KC_8, KC_9, KC_0,
+    KC_ENTER, KC_ESCAPE, KC_BACKSPACE, KC_TAB, KC_SPACE, KC_MINUS, KC_EQUAL,
+    KC_LEFT_BRACKET, KC_RIGHT_BRACKET, KC_BACKSLASH, KC_NONUS_HASH, KC_SEMICOLON,
+    KC_QUOTE, KC_GRAVE, KC_COMMA, KC_DOT, KC_SLASH, KC_CAPS_LOCK,
+    KC_F1, KC_F2, KC_F3, KC_F4, KC_F5, KC_F6, KC_F7, KC_F8, KC_F9, KC_F10, KC_F11, KC_F12,
+    KC_PRINT_SCREEN, KC_SCROLL_LOCK, KC_PAUSE, KC_INSERT, KC_HOME, KC_PAGE_UP, KC_DELETE,
+    KC_END, KC_PAGE_DOWN, KC_RIGHT, KC_LEFT, KC_DOWN, KC_UP, KC_NUM_LOCK,
+    KC_KP_SLASH, KC_KP_ASTERISK, KC_KP_MINUS, KC_KP_PLUS, KC_KP_ENTER,
+    KC_KP_1, KC_KP_2, KC_KP_3, KC_KP_4, KC_KP_5, KC_KP_6, KC_KP_7, KC_KP_8, KC_KP_9, KC_KP_0,
+    KC_KP_DOT, KC_NONUS_BACKSLASH, KC_APPLICATION,
+    KC_LOCKING_CAPS_LOCK = 0x82,
+    KC_AUDIO_MUTE = 0xA8, KC_AUDIO_VOL_UP, KC_AUDIO_VOL_DOWN, KC_MEDIA_NEXT_TRACK,
+    KC_MEDIA_PREV_TRACK, KC_MEDIA_STOP, KC_MEDIA_PLAY_PAUSE, KC_MEDIA_SELECT, KC_MEDIA_EJECT,
+    KC_MAIL, KC_CALCULATOR, KC_MY_COMPUTER, KC_WWW_SEARCH, KC_WWW_HOME,
+    KC_MEDIA_FAST_FORWARD = 0xBB, KC_MEDIA_REWIND,
+    KC_EXSEL = 0xA4,
+    KC_LEFT_CTRL = 0xE0, KC_LEFT_SHIFT, KC_LEFT_ALT, KC_LEFT_GUI,
+    KC_RIGHT_CTRL, KC_RIGHT_SHIFT, KC_RIGHT_ALT, KC_RIGHT_GUI,
+};
+
+#define KC_TRNS KC_TRANSPARENT
+#define _______ KC_TRANSPARENT
+#define XXXXXXX KC_NO
+#define KC_ENT KC_ENTER
+#define KC_ESC KC_ESCAPE
+#define KC_BSPC KC_BACKSPACE
+#define KC_SPC KC_SPACE
+#define KC_MINS KC_MINUS
+#define KC_EQL KC_EQUAL
+#define KC_LBRC KC_LEFT_BRACKET
+#define KC_RBRC KC_RIGHT_BRACKET
+#define KC_BSLS KC_BACKSLASH
+#define KC_NUHS KC_NONUS_HASH
+#define KC_SCLN KC_SEMICOLON
+#define KC_QUOT KC_QUOTE
+#define KC_GRV KC_GRAVE
+#define KC_COMM KC_COMMA
+#define KC_SLSH KC_SLASH
+#define KC_CAPS KC_CAPS_LOCK
+#define KC_PSCR KC_PRINT_SCREEN
+#define KC_INS KC_INSERT
+#define KC_PGUP KC_PAGE_UP
+#define KC_DEL KC_DELETE
+#define KC_PGDN KC_PAGE_DOWN
+#define KC_RGHT KC_RIGHT
+#define KC_NUM KC_NUM_LOCK
+#define KC_PSLS KC_KP_SLASH
+#define KC_PAST KC_KP_ASTERISK
+#define KC_PMNS KC_KP_MINUS
+#define KC_PPLS KC_KP_PLUS
+#define KC_PENT KC_KP_ENTER
+#define KC_P1 KC_KP_1
+#define KC_P2 KC_KP_2
+#define KC_P3 KC_KP_3
+#define KC_P4 KC_KP_4
+#define KC_P5 KC_KP_5
+#define KC_P6 KC_KP_6
+#define KC_P7 KC_KP_7
+#define KC_P8 KC_KP_8
+#define KC_P9 KC_KP_9
+#define KC_P0 KC_KP_0
+#define KC_PDOT KC_KP_DOT
+#define KC_APP KC_APPLICATION
+#define KC_LCAP KC_LOCKING_CAPS_LOCK
+#define KC_MUTE KC_AUDIO_MUTE
+#define KC_VOLU KC_AUDIO_VOL_UP
+#define KC_VOLD KC_AUDIO_VOL_DOWN
+#define KC_MPRV KC_MEDIA_PREV_TRACK
+#define KC_MSTP KC_MEDIA_STOP
+#define KC_MPLY KC_MEDIA_PLAY_PAUSE
+#define KC_MSEL KC_MEDIA_SELECT
+#define KC_CALC KC_CALCULATOR
+#define KC_MYCM KC_MY_COMPUTER
+#define KC_WHOM KC_WWW_HOME
+#define KC_MRWD KC_MEDIA_REWIND
+#define KC_LCTL KC_LEFT_CTRL
+#define KC_LSFT KC_LEFT_SHIFT
+#define KC_LALT KC_LEFT_ALT
+#define KC_LGUI KC_LEFT_GUI
+#define KC_RCTL KC_RIGHT_CTRL
+#define KC_RSFT KC_RIGHT_SHIFT
+#define KC_RALT KC_RIGHT_ALT
+#define KC_RGUI KC_RIGHT_GUI
+#define KC_RWIN KC_RIGHT_GUI
+
+#define IS_BASIC_KEYCODE(code) ((code) >= KC_A && (code) <= KC_EXSEL)
+#define IS_MODIFIER_KEYCODE(code) ((code) >= KC_LEFT_CTRL && (code) <= KC_RIGHT_GUI)
+#define MOD_BIT(code) (1 << ((code) & 0x07))
+#define MOD_MASK_CTRL (MOD_BIT(KC_LCTL) | MOD_BIT(KC_RCTL))
+#define MOD_MASK_SHIFT (MOD_BIT(KC_LSFT) | MOD_BIT(KC_RSFT))
+#define MOD_MASK_ALT (MOD_BIT(KC_LALT) | MOD_BIT(KC_RALT))
+#define MOD_MASK_GUI (MOD_BIT(KC_LGUI) | MOD_BIT(KC_RGUI))
+
+// ==== QUANTUM KEYCODES ====
+
+#define QK_BASIC 0x0000
+#define QK_BASIC_MAX 0x00FF
+#define QK_MODS 0x0100
+#define QK_MODS_MAX 0x1FFF
+#define QK_LCTL 0x0100
+#define QK_LSFT 0x0200
+#define QK_LALT 0x0400
+#define QK_LGUI 0x0800
+#define QK_RMODS_MIN 0x1000
+#define QK_MOD_TAP 0x2000
+#define QK_MOD_TAP_MAX 0x3FFF
+#define QK_LAYER_TAP 0x4000
+#define QK_LAYER_TAP_MAX 0x4FFF
+#define QK_TO 0x5200
+#define QK_TO_MAX 0x521F
+#define QK_MOMENTARY 0x5220
+#define QK_MOMENTARY_MAX 0x523F
+#define QK_DEF_LAYER 0x5240
+#define QK_DEF_LAYER_MAX 0x525F
+#define QK_TOGGLE_LAYER 0x5260
+#define QK_TOGGLE_LAYER_MAX 0x527F
+#define QK_ONE_SHOT_LAYER 0x5280
+#define QK_ONE_SHOT_LAYER_MAX 0x529F
+#define QK_ONE_SHOT_MOD 0x52A0
+#define QK_ONE_SHOT_MOD_MAX 0x52BF
+#define QK_LAYER_TAP_TOGGLE 0x52C0
+#define QK_LAYER_TAP_TOGGLE_MAX 0x52DF
+#define QK_SWAP_HANDS 0x5600
+#define QK_SWAP_HANDS_MAX 0x56FF
+#define QK_TAP_DANCE 0x5700
+#define QK_TAP_DANCE_MAX 0x57FF
+#define QK_UNICODE_MODE_WINDOWS 0x7784
+#define QK_UNDERGLOW_TOGGLE 0x7820
+#define QK_BOOT 0x7C00
+#define QK_LEADER 0x7C58
+#define QK_DYNAMIC_TAPPING_TERM_PRINT 0x7C70
+#define QK_DYNAMIC_TAPPING_TERM_UP 0x7C71
+#define QK_DYNAMIC_TAPPING_TERM_DOWN 0x7C72
+#define QK_AUTOCORRECT_ON 0x7C74
+#define QK_AUTOCORRECT_OFF 0x7C75
+#define QK_AUTOCORRECT_TOGGLE 0x7C76
+#define QK_TRI_LAYER_LOWER 0x7C77
+#define QK_TRI_LAYER_UPPER 0x7C78
+#define QK_COMMUNITY_MODULE 0x7E00
+#define QK_USER 0x7E40
+#define SAFE_RANGE QK_USER
+
+// Keycodes of the getreuer/select_word community module (keymap.json)
+#define SELECT_WORD (QK_COMMUNITY_MODULE + 0)
+#define SELECT_WORD_BACK (QK_COMMUNITY_MODULE + 1)
+#define SELECT_LINE (QK_COMMUNITY_MODULE + 2)
+
+#define QK_LEAD QK_LEADER
+#define UC_WIN QK_UNICODE_MODE_WINDOWS
+#define DT_PRNT QK_DYNAMIC_TAPPING_TERM_PRINT
+#define DT_UP QK_DYNAMIC_TAPPING_TERM_UP
+#define DT_DOWN QK_DYNAMIC_TAPPING_TERM_DOWN
+#define AC_ON QK_AUTOCORRECT_ON
+#define AC_OFF QK_AUTOCORRECT_OFF
+#define AC_TOGG QK_AUTOCORRECT_TOGGLE
+
+// RGB keycodes only need to be distinct here
+#define RGB_TOG (QK_UNDERGLOW_TOGGLE + 0)
+#define RGB_MOD (QK_UNDERGLOW_TOGGLE + 1)
+#define RGB_RMOD (QK_UNDERGLOW_TOGGLE + 2)
+#define RGB_HUI (QK_UNDERGLOW_TOGGLE + 3)
+#define RGB_HUD (QK_UNDERGLOW_TOGGLE + 4)
+#define RGB_SAI (QK_UNDERGLOW_TOGGLE + 5)
+#define RGB_SAD (QK_UNDERGLOW_TOGGLE + 6)
+#define RGB_VAI (QK_UNDERGLOW_TOGGLE + 7)
+#define RGB_VAD (QK_UNDERGLOW_TOGGLE + 8)
+#define RGB_SPI (QK_UNDERGLOW_TOGGLE + 9)
+#define RGB_SPD (QK_UNDERGLOW_TOGGLE + 10)
+#define RGB_M_P (QK_UNDERGLOW_TOGGLE + 11)
+#define RGB_M_B (QK_UNDERGLOW_TOGGLE + 12)
+#define RGB_M_SW (QK_UNDERGLOW_TOGGLE + 14)
+#define RGB_M_SN (QK_UNDERGLOW_TOGGLE + 15)
+
+#define MOD_LCTL 0x01
+#define MOD_LSFT 0x02
+#define MOD_LALT 0x04
+#define MOD_LGUI 0x08
+#define MOD_RCTL 0x11
+#define MOD_RSFT 0x12
+#define MOD_RALT 0x14
+#define MOD_RGUI 0x18
+
+#define LCTL(kc) (QK_LCTL | (kc))
+#define LSFT(kc) (QK_LSFT | (kc))
+#define LALT(kc) (QK_LALT | (kc))
+#define LGUI(kc) (QK_LGUI | (kc))
+#define C(kc) LCTL(kc)
+#define S(kc) LSFT(kc)
+#define A(kc) LALT(kc)
+#define G(kc) LGUI(kc)
+
+#define MT(mod, kc) (QK_MOD_TAP | (((mod) & 0x1F) << 8) | ((kc) & 0xFF))
+#define LCTL_T(kc) MT(MOD_LCTL, kc)
+#define LSFT_T(kc) MT(MOD_LSFT, kc)
+#define LALT_T(kc) MT(MOD_LALT, kc)
+#define LGUI_T(kc) MT(MOD_LGUI, kc)
+#define RCTL_T(kc) MT(MOD_RCTL, kc)
+#define RSFT_T(kc) MT(MOD_RSFT, kc)
+#define RALT_T(kc) MT(MOD_RALT, kc)
+#define RGUI_T(kc) MT(MOD_RGUI, kc)
+#define LT(layer, kc) (QK_LAYER_TAP | (((layer) & 0xF) << 8) | ((kc) & 0xFF))
+#define TO(layer) (QK_TO | ((layer) & 0x1F))
+#define MO(layer) (QK_MOMENTARY | ((layer) & 0x1F))
+#define TG(layer) (QK_TOGGLE_LAYER | ((layer) & 0x1F))
+#define TD(index) (QK_TAP_DANCE | ((index) & 0xFF))
+
+#define IS_QK_MODS(code) ((code) >= QK_MODS && (code) <= QK_MODS_MAX)
+#define IS_QK_MOD_TAP(code) ((code) >= QK_MOD_TAP && (code) <= QK_MOD_TAP_MAX)
+#define IS_QK_LAYER_TAP(code) ((code) >= QK_LAYER_TAP && (code) <= QK_LAYER_TAP_MAX)
+#define IS_QK_MOMENTARY(code) ((code) >= QK_MOMENTARY && (code) <= QK_MOMENTARY_MAX)
+#define QK_MODS_GET_MODS(kc) (((kc) >> 8) & 0x1F)
+#define QK_MODS_GET_BASIC_KEYCODE(kc) ((kc) & 0xFF)
+#define QK_MOD_TAP_GET_MODS(kc) (((kc) >> 8) & 0x1F)
+#define QK_MOD_TAP_GET_TAP_KEYCODE(kc) ((kc) & 0xFF)
+#define QK_LAYER_TAP_GET_LAYER(kc) (((kc) >> 8) & 0xF)
+#define QK_LAYER_TAP_GET_TAP_KEYCODE(kc) ((kc) & 0xFF)
+#define QK_MOMENTARY_GET_LAYER(kc) ((kc) & 0x1F)
+#define QK_SWAP_HANDS_GET_TAP_KEYCODE(kc) ((kc) & 0xFF)
+
+// Shifted symbols
+#define KC_EXLM LSFT(KC_1)
+#define KC_AT LSFT(KC_2)
+#define KC_HASH LSFT(KC_3)
+#define KC_RPRN LSFT(KC_0)
+#define KC_UNDS LSFT(KC_MINS)
+#define KC_COLN LSFT(KC_SCLN)
+#define KC_QUES LSFT(KC_SLSH)
+
+// ==== SEND_STRING ====
+
+#define SS_QMK_PREFIX 1
+#define SS_TAP_CODE 1
+#define SS_DOWN_CODE 2
+#define SS_UP_CODE 3
+#define SS_DELAY_CODE 4
+#define SS_DOWN(kc) "\1\2" kc
+#define SS_UP(kc) "\1\3" kc
+#define X_LGUI "\xe3"
+#define SS_LGUI(string) SS_DOWN(X_LGUI) string SS_UP(X_LGUI)
+#define SEND_STRING(string) send_string(string)
+
+extern const uint8_t ascii_to_keycode_lut[128];
+extern const uint8_t ascii_to_shift_lut[16];
+extern const uint8_t ascii_to_altgr_lut[16];
+
+void send_string(const char *string);
+void send_string_P(const char *string);
+void send_string_with_delay(const char *string, uint8_t interval);
+void send_char(char ascii_code);
+
+// ==== KEY EVENTS ====
+
+typedef struct {
+    uint8_t col;
+    uint8_t row;
+} keypos_t;
+
+typedef struct {
+    keypos_t key;
+    uint16_t time;
+    uint8_t  type;
+    bool     pressed;
+} keyevent_t;
+
+typedef struct {
+    bool    interrupted : 1;
+    bool    reserved2 : 1;
+    bool    reserved1 : 1;
+    bool    reserved0 : 1;
+    uint8_t count : 4;
+} tap_t;
+
+typedef struct {
+    keyevent_t event;
+    tap_t      tap;
+    uint16_t   keycode;
+} keyrecord_t;
+
+#define KEYLOC_COMBO 254
+#define MAKE_KEYEVENT(row_num, col_num, press) ((keyevent_t){.key = ((keypos_t){.row = (row_num), .col = (col_num)}), .pressed = (press), .time = timer_read() | 1})
+
+bool process_record_user(uint16_t keycode, keyrecord_t *record);
+
+// ==== KEYMAP ====
+
+// The test keymap packs LAYOUT() row-major, so key i of LAYOUT() sits at
+// [i / MATRIX_COLS][i % MATRIX_COLS], matching its LED index
+#define MATRIX_ROWS 6
+#define MATRIX_COLS 18
+#define LAYOUT(...) {__VA_ARGS__}
+
+extern const uint16_t keymaps[][MATRIX_ROWS][MATRIX_COLS];
+uint8_t  keymap_layer_count(void);
+uint16_t keycode_at_keymap_location_raw(uint8_t layer_num, uint8_t row, uint8_t column);
+uint16_t keycode_at_keymap_location(uint8_t layer_num, uint8_t row, uint8_t column);
+
+// ==== LAYERS ====
+
+typedef uint32_t layer_state_t;
+extern layer_state_t layer_state;
+extern layer_state_t default_layer_state;
+
+void    layer_on(uint8_t layer);
+void    layer_off(uint8_t layer);
+void    layer_move(uint8_t layer);
+void    layer_clear(void);
+bool    layer_state_is(uint8_t layer);
+uint8_t get_highest_layer(layer_state_t state);
+
+// ==== MODIFIERS AND REPORTS ====
+
+uint8_t get_mods(void);
+void    set_mods(uint8_t mods);
+void    add_mods(uint8_t mods);
+void    del_mods(uint8_t mods);
+void    clear_mods(void);
+void    register_mods(uint8_t mods);
+void    unregister_mods(uint8_t mods);
+uint8_t get_weak_mods(void);
+void    add_weak_mods(uint8_t mods);
+void    del_weak_mods(uint8_t mods);
+void    clear_weak_mods(void);
+uint8_t get_oneshot_mods(void);
+void    set_oneshot_mods(uint8_t mods);
+void    del_oneshot_mods(uint8_t mods);
+void    clear_oneshot_mods(void);
+
+void add_key(uint8_t key);
+void del_key(uint8_t key);
+void clear_keys(void);
+void send_keyboard_report(void);
+
+void register_code(uint8_t code);
+void unregister_code(uint8_t code);
+void tap_code(uint8_t code);
+void tap_code_delay(uint8_t code, uint16_t delay);
+void register_code16(uint16_t code);
+void unregister_code16(uint16_t code);
+void tap_code16(uint16_t code);
+
+#ifndef TAP_CODE_DELAY
+#    define TAP_CODE_DELAY 0
+#endif
+
+typedef struct {
+    bool nkro;
+} keymap_config_t;
+extern keymap_config_t keymap_config;
+
+typedef union {
+    uint8_t raw;
+    struct {
+        bool num_lock : 1;
+        bool caps_lock : 1;
+        bool scroll_lock : 1;
+        bool compose : 1;
+        bool kana : 1;
+        uint8_t reserved : 3;
+    };
+} led_t;
+led_t host_keyboard_led_state(void);
+
+// ==== TIMER ====
+
+uint16_t timer_read(void);
+uint32_t timer_read32(void);
+uint16_t timer_elapsed(uint16_t last);
+uint32_t timer_elapsed32(uint32_t last);
+#define TIMER_DIFF_16(a, b) ((uint16_t)((a) - (b)))
+#define timer_expired(current, future) ((uint16_t)((current) - (future)) < 0x8000)
+#define timer_expired32(current, future) ((uint32_t)((current) - (future)) < 0x80000000UL)
+
+void wait_ms(uint32_t ms);
+
+// ==== TAPPING TERM ====
+
+#ifndef TAPPING_TERM
+#    define TAPPING_TERM 200
+#endif
+extern uint16_t g_tapping_term;
+#define GET_TAPPING_TERM(keycode, record) g_tapping_term
+
+// ==== EEPROM ====
+
+void eeconfig_read_user_datablock(void *data, uint32_t offset, uint32_t length);
+void eeconfig_update_user_datablock(const void *data, uint32_t offset, uint32_t length);
+
+// ==== DEBUG ====
+
+extern bool debug_enable;
+extern bool debug_matrix;
+extern bool debug_keyboard;
+#define dprintf(...) ((void)0)
+#define dprint(s) ((void)0)
+#define uprintf(...) ((void)0)
+
+#define ASSERT_COMMUNITY_MODULES_MIN_API_VERSION(major, minor, patch)
+
+// ==== RGB MATRIX ====
+
+#ifdef RGB_MATRIX_ENABLE
+#    include "rgb_matrix.h"
+#endif
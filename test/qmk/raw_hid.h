@@ -0,0 +1,5 @@
+#pragma once
+#include "quantum.h"
+
+void raw_hid_receive(uint8_t *data, uint8_t length);
+void raw_hid_send(uint8_t *data, uint8_t length);
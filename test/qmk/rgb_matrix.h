@@ -0,0 +1,83 @@
+/**
+ * @file rgb_matrix.h
+ * @brief Stand-in for QMK's rgb_matrix.h in the host test harness
+ *
+ * Only what the effects in features/ use. The sim has no LEDs, so nothing
+ * here is implemented by test/sim.c: a test that switches RGB_MATRIX_ENABLE
+ * on defines the functions and globals itself, counting what an effect
+ * draws. The test keymap has one LED per matrix position, numbered as the
+ * positions are.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define RGB_MATRIX_LED_COUNT (MATRIX_ROWS * MATRIX_COLS)
+#ifndef RGB_MATRIX_LED_PROCESS_LIMIT
+#    define RGB_MATRIX_LED_PROCESS_LIMIT ((RGB_MATRIX_LED_COUNT + 4) / 5)
+#endif
+
+#define NO_LED 255
+#define LED_FLAG_ALL 0xFF
+#define LED_FLAG_KEYLIGHT 0x04
+#define HAS_ANY_FLAGS(bits, flags) (((bits) & (flags)) != 0x00)
+
+typedef struct {
+    uint8_t h;
+    uint8_t s;
+    uint8_t v;
+} HSV;
+
+typedef struct {
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+} RGB;
+
+typedef struct {
+    uint8_t matrix_co[MATRIX_ROWS][MATRIX_COLS];
+    uint8_t flags[RGB_MATRIX_LED_COUNT];
+} led_config_t;
+extern led_config_t g_led_config;
+
+typedef struct {
+    HSV     hsv;
+    uint8_t speed;
+} rgb_config_t;
+extern rgb_config_t rgb_matrix_config;
+
+typedef struct {
+    uint8_t iter;
+    uint8_t flags;
+    bool    init;
+} effect_params_t;
+
+// Custom effects are numbered after QMK's own; only the heatmap exists here
+enum rgb_matrix_effects {
+    RGB_MATRIX_NONE = 0,
+    RGB_MATRIX_SOLID_COLOR,
+    RGB_MATRIX_CUSTOM_HEATMAP,
+};
+
+#define RGB_MATRIX_USE_LIMITS(min, max)                            \
+    uint8_t min = RGB_MATRIX_LED_PROCESS_LIMIT * params->iter;     \
+    uint8_t max = min + RGB_MATRIX_LED_PROCESS_LIMIT;              \
+    if (max > RGB_MATRIX_LED_COUNT) max = RGB_MATRIX_LED_COUNT;
+
+#define RGB_MATRIX_TEST_LED_FLAGS() \
+    if (!HAS_ANY_FLAGS(g_led_config.flags[i], params->flags)) continue
+
+static inline bool rgb_matrix_check_finished_leds(uint8_t led_idx) {
+    return led_idx < RGB_MATRIX_LED_COUNT;
+}
+
+static inline uint8_t scale8(uint8_t i, uint8_t scale) {
+    return ((uint16_t)i * (1 + (uint16_t)scale)) >> 8;
+}
+
+RGB     hsv_to_rgb(HSV hsv);
+void    rgb_matrix_set_color(int index, uint8_t red, uint8_t green, uint8_t blue);
+bool    rgb_matrix_is_enabled(void);
+uint8_t rgb_matrix_get_mode(void);
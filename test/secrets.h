@@ -0,0 +1,18 @@
+// Test fixture for the host harness: the vault in test/build/secrets_vault.h
+// is made from this file by test/Makefile. Never put real secrets here.
+
+#pragma once
+
+#define SECRETS_LIST(_) \
+    _(SECRET_PIN,     "2468") \
+    _(SECRET_PHRASE,  "correct horse battery staple") \
+    _(SECRET_PASS_1,  "Tr0ub4dor&3") \
+    _(SECRET_PASS_2,  "hunter2") \
+    _(SECRET_PASS_3,  "p@ss w0rd!") \
+    _(SECRET_PASS_4,  "zZ9") 
+
+#define SECRETS_TAGGED(_) \
+    _(7,    "tagged seven") \
+    _(42,   "tagged forty-two")
+
+#define SECRETS_HID_KEY "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"
@@ -0,0 +1,631 @@
+/**
+ * @file sim.c
+ * @brief The stand-in QMK API of test/qmk/ on a virtual clock
+ *
+ * Mirrors what QMK itself does where the features depend on it: reports
+ * are only sent when they change, register_code16() holds its modifiers as
+ * weak mods, send_char() wraps the key in Shift and SEND_STRING() codes
+ * are parsed the way send_string() does.
+ */
+
+#include "sim.h"
+#include "layers.h"
+#include "raw_hid.h"
+#include "features/output_queue.h"
+#include <stdlib.h>
+
+// ==== US LAYOUT ====
+
+/**
+ * @brief QMK's keymap_us send_string tables
+ */
+const uint8_t ascii_to_keycode_lut[128] = {
+    0, 0, 0, 0, 0, 0, 0, 0, KC_BSPC, KC_TAB, KC_ENT, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, KC_ESC, 0, 0, 0, 0,
+    KC_SPC, KC_1, KC_QUOT, KC_3, KC_4, KC_5, KC_7, KC_QUOT,
+    KC_9, KC_0, KC_8, KC_EQL, KC_COMM, KC_MINS, KC_DOT, KC_SLSH,
+    KC_0, KC_1, KC_2, KC_3, KC_4, KC_5, KC_6, KC_7,
+    KC_8, KC_9, KC_SCLN, KC_SCLN, KC_COMM, KC_EQL, KC_DOT, KC_SLSH,
+    KC_2, KC_A, KC_B, KC_C, KC_D, KC_E, KC_F, KC_G,
+    KC_H, KC_I, KC_J, KC_K, KC_L, KC_M, KC_N, KC_O,
+    KC_P, KC_Q, KC_R, KC_S, KC_T, KC_U, KC_V, KC_W,
+    KC_X, KC_Y, KC_Z, KC_LBRC, KC_BSLS, KC_RBRC, KC_6, KC_MINS,
+    KC_GRV, KC_A, KC_B, KC_C, KC_D, KC_E, KC_F, KC_G,
+    KC_H, KC_I, KC_J, KC_K, KC_L, KC_M, KC_N, KC_O,
+    KC_P, KC_Q, KC_R, KC_S, KC_T, KC_U, KC_V, KC_W,
+    KC_X, KC_Y, KC_Z, KC_LBRC, KC_BSLS, KC_RBRC, KC_GRV, KC_DEL,
+};
+const uint8_t ascii_to_shift_lut[16] = {0, 0, 0, 0, 0x7E, 0x0F, 0x00, 0xD4, 0xFF, 0xFF, 0xFF, 0xC7, 0x00, 0x00, 0x00, 0x78};
+const uint8_t ascii_to_altgr_lut[16] = {0};
+
+/**
+ * @brief Keycode -> characters without and with Shift, for decoding
+ */
+static char layout[0x39][2];
+
+static void layout_init(void) {
+    for (uint8_t c = ' '; c < 0x7F; c++) {
+        layout[ascii_to_keycode_lut[c]][PGM_LOADBIT(ascii_to_shift_lut, c)] = (char)c;
+    }
+    layout[KC_ENT][0] = layout[KC_ENT][1] = '\n';
+    layout[KC_TAB][0] = layout[KC_TAB][1] = '\t';
+    layout[KC_SPC][1] = ' ';
+}
+
+// ==== SIMULATED HARDWARE ====
+
+#define MAX_REPORTS 16384
+#define MAX_RAW_HID 64
+#define MAX_HELD 16
+
+static uint32_t clock_ms;
+static uint32_t waited_ms;
+static uint8_t  real_mods, weak_mods, oneshot_mods;
+static uint8_t  keys[32];
+static led_t    leds;
+
+static sim_report_t reports[MAX_REPORTS];
+static uint16_t     report_count;
+static sim_report_t last_sent;
+
+static uint8_t  raw_queue[MAX_RAW_HID][32];
+static uint8_t  raw_head, raw_count;
+static uint8_t *raw_answer;
+
+/**
+ * @brief Keys down and where they were found, so a release matches its press
+ */
+static struct {
+    uint16_t keycode;
+    keypos_t pos;
+} held[MAX_HELD];
+
+bool (*sim_process_record)(uint16_t keycode, keyrecord_t *record) = process_record_user;
+
+uint8_t  sim_eeprom[4096];
+uint32_t sim_eeprom_writes;
+uint32_t sim_eeprom_reads;
+
+layer_state_t   layer_state;
+layer_state_t   default_layer_state;
+keymap_config_t keymap_config;
+uint16_t        g_tapping_term = TAPPING_TERM;
+bool            debug_enable, debug_matrix, debug_keyboard;
+
+// ==== TIMER ====
+
+uint16_t timer_read(void) {
+    return (uint16_t)clock_ms;
+}
+
+uint32_t timer_read32(void) {
+    return clock_ms;
+}
+
+uint16_t timer_elapsed(uint16_t last) {
+    return TIMER_DIFF_16(timer_read(), last);
+}
+
+uint32_t timer_elapsed32(uint32_t last) {
+    return clock_ms - last;
+}
+
+void wait_ms(uint32_t ms) {
+    clock_ms += ms;
+    waited_ms += ms;
+}
+
+// ==== REPORTS ====
+
+void send_keyboard_report(void) {
+    sim_report_t report = {.time = clock_ms, .mods = real_mods | weak_mods | oneshot_mods};
+    memcpy(report.keys, keys, sizeof(keys));
+
+    // QMK drops a report identical to the last one
+    if (report.mods == last_sent.mods && !memcmp(report.keys, last_sent.keys, sizeof(keys))) {
+        return;
+    }
+    last_sent = report;
+    if (report_count == MAX_REPORTS) {
+        fprintf(stderr, "sim: more than %d reports\n", MAX_REPORTS);
+        abort();
+    }
+    reports[report_count++] = report;
+}
+
+void add_key(uint8_t key) {
+    keys[key / 8] |= 1 << (key % 8);
+}
+
+void del_key(uint8_t key) {
+    keys[key / 8] &= ~(1 << (key % 8));
+}
+
+void clear_keys(void) {
+    memset(keys, 0, sizeof(keys));
+}
+
+// ==== MODIFIERS ====
+
+uint8_t get_mods(void) { return real_mods; }
+void    set_mods(uint8_t mods) { real_mods = mods; }
+void    add_mods(uint8_t mods) { real_mods |= mods; }
+void    del_mods(uint8_t mods) { real_mods &= ~mods; }
+void    clear_mods(void) { real_mods = 0; }
+uint8_t get_weak_mods(void) { return weak_mods; }
+void    add_weak_mods(uint8_t mods) { weak_mods |= mods; }
+void    del_weak_mods(uint8_t mods) { weak_mods &= ~mods; }
+void    clear_weak_mods(void) { weak_mods = 0; }
+uint8_t get_oneshot_mods(void) { return oneshot_mods; }
+void    set_oneshot_mods(uint8_t mods) { oneshot_mods = mods; }
+void    del_oneshot_mods(uint8_t mods) { oneshot_mods &= ~mods; }
+void    clear_oneshot_mods(void) { oneshot_mods = 0; }
+
+void register_mods(uint8_t mods) {
+    if (mods) {
+        add_mods(mods);
+        send_keyboard_report();
+    }
+}
+
+void unregister_mods(uint8_t mods) {
+    if (mods) {
+        del_mods(mods);
+        send_keyboard_report();
+    }
+}
+
+/**
+ * @brief The 8-bit modifier mask of a QK_MODS keycode's 5-bit mod field
+ */
+static uint8_t mods_of(uint16_t code) {
+    uint8_t mods = QK_MODS_GET_MODS(code);
+    return (mods & 0x10) ? (uint8_t)((mods & 0x0F) << 4) : mods;
+}
+
+// ==== KEY CODES ====
+
+void register_code(uint8_t code) {
+    if (IS_MODIFIER_KEYCODE(code)) {
+        add_mods(MOD_BIT(code));
+    } else if (code) {
+        add_key(code);
+    }
+    send_keyboard_report();
+}
+
+void unregister_code(uint8_t code) {
+    if (IS_MODIFIER_KEYCODE(code)) {
+        del_mods(MOD_BIT(code));
+    } else if (code) {
+        del_key(code);
+    }
+    send_keyboard_report();
+}
+
+void tap_code_delay(uint8_t code, uint16_t delay) {
+    register_code(code);
+    wait_ms(delay);
+    unregister_code(code);
+}
+
+void tap_code(uint8_t code) {
+    tap_code_delay(code, code == KC_CAPS ? 80 : TAP_CODE_DELAY);
+}
+
+void register_code16(uint16_t code) {
+    uint8_t basic = QK_MODS_GET_BASIC_KEYCODE(code);
+    if (IS_MODIFIER_KEYCODE(basic) || basic == KC_NO) {
+        register_mods(mods_of(code));
+    } else if (mods_of(code)) {
+        add_weak_mods(mods_of(code));
+        send_keyboard_report();
+    }
+    register_code(basic);
+}
+
+void unregister_code16(uint16_t code) {
+    uint8_t basic = QK_MODS_GET_BASIC_KEYCODE(code);
+    unregister_code(basic);
+    if (IS_MODIFIER_KEYCODE(basic) || basic == KC_NO) {
+        unregister_mods(mods_of(code));
+    } else if (mods_of(code)) {
+        del_weak_mods(mods_of(code));
+        send_keyboard_report();
+    }
+}
+
+void tap_code16(uint16_t code) {
+    register_code16(code);
+    wait_ms(TAP_CODE_DELAY);
+    unregister_code16(code);
+}
+
+// ==== SEND_STRING ====
+
+void send_char(char ascii_code) {
+    uint8_t keycode = ascii_to_keycode_lut[(uint8_t)ascii_code];
+    bool    shifted = PGM_LOADBIT(ascii_to_shift_lut, (uint8_t)ascii_code);
+
+    if (shifted) {
+        register_code(KC_LSFT);
+    }
+    tap_code(keycode);
+    if (shifted) {
+        unregister_code(KC_LSFT);
+    }
+}
+
+void send_string_with_delay(const char *string, uint8_t interval) {
+    while (*string) {
+        char c = *string++;
+        if (c == SS_QMK_PREFIX) {
+            char code = *string++;
+            if (code == SS_TAP_CODE) {
+                tap_code((uint8_t)*string++);
+            } else if (code == SS_DOWN_CODE) {
+                register_code((uint8_t)*string++);
+            } else if (code == SS_UP_CODE) {
+                unregister_code((uint8_t)*string++);
+            } else if (code == SS_DELAY_CODE) {
+                uint32_t ms = 0;
+                while (*string >= '0' && *string <= '9') {
+                    ms = ms * 10 + (uint32_t)(*string++ - '0');
+                }
+                if (*string == '|') {
+                    string++;
+                }
+                wait_ms(ms);
+            }
+        } else {
+            send_char(c);
+        }
+        wait_ms(interval);
+    }
+}
+
+void send_string(const char *string) {
+    send_string_with_delay(string, TAP_CODE_DELAY);
+}
+
+void send_string_P(const char *string) {
+    send_string(string);
+}
+
+// ==== LAYERS AND KEYMAP ====
+
+void layer_on(uint8_t layer) {
+    layer_state |= (layer_state_t)1 << layer;
+}
+
+void layer_off(uint8_t layer) {
+    layer_state &= ~((layer_state_t)1 << layer);
+}
+
+void layer_move(uint8_t layer) {
+    layer_state = (layer_state_t)1 << layer;
+}
+
+void layer_clear(void) {
+    layer_state = 0;
+}
+
+bool layer_state_is(uint8_t layer) {
+    return layer_state ? (layer_state >> layer) & 1 : layer == 0;
+}
+
+uint8_t get_highest_layer(layer_state_t state) {
+    uint8_t layer = 0;
+    while (state >>= 1) {
+        layer++;
+    }
+    return layer;
+}
+
+uint8_t keymap_layer_count(void) {
+    return LAYER_COUNT;
+}
+
+uint16_t keycode_at_keymap_location_raw(uint8_t layer_num, uint8_t row, uint8_t column) {
+    return keymaps[layer_num][row][column];
+}
+
+__attribute__((weak)) uint16_t keycode_at_keymap_location(uint8_t layer_num, uint8_t row, uint8_t column) {
+    return keycode_at_keymap_location_raw(layer_num, row, column);
+}
+
+/**
+ * @brief Where keycode is in the active layers, highest first
+ */
+static keypos_t find_key(uint16_t keycode) {
+    layer_state_t active = layer_state | default_layer_state | 1;
+    for (int8_t layer = LAYER_COUNT - 1; layer >= 0; layer--) {
+        if (!((active >> layer) & 1)) {
+            continue;
+        }
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                if (keycode_at_keymap_location(layer, row, col) == keycode) {
+                    return (keypos_t){.col = col, .row = row};
+                }
+            }
+        }
+    }
+    return (keypos_t){.col = KEYLOC_COMBO, .row = KEYLOC_COMBO};
+}
+
+// ==== HOST STATE, EEPROM AND RAW HID ====
+
+led_t host_keyboard_led_state(void) {
+    return leds;
+}
+
+void eeconfig_read_user_datablock(void *data, uint32_t offset, uint32_t length) {
+    memcpy(data, sim_eeprom + offset, length);
+    sim_eeprom_reads += length;
+}
+
+void eeconfig_update_user_datablock(const void *data, uint32_t offset, uint32_t length) {
+    memcpy(sim_eeprom + offset, data, length);
+    sim_eeprom_writes++;
+}
+
+void raw_hid_send(uint8_t *data, uint8_t length) {
+    if (data == raw_answer) {
+        return; // Answered in place; sim_raw_hid() hands it back
+    }
+    if (raw_count == MAX_RAW_HID) {
+        fprintf(stderr, "sim: raw HID queue full\n");
+        abort();
+    }
+    memcpy(raw_queue[(raw_head + raw_count++) % MAX_RAW_HID], data, length < 32 ? length : 32);
+}
+
+void sim_raw_hid(uint8_t *packet) {
+    uint8_t data[32];
+    memcpy(data, packet, sizeof(data));
+    raw_answer = data;
+    raw_hid_receive(data, sizeof(data));
+    raw_answer = NULL;
+    memcpy(packet, data, sizeof(data));
+}
+
+bool sim_raw_hid_pop(uint8_t *packet) {
+    if (!raw_count) {
+        return false;
+    }
+    memcpy(packet, raw_queue[raw_head], 32);
+    raw_head = (raw_head + 1) % MAX_RAW_HID;
+    raw_count--;
+    return true;
+}
+
+// ==== CLOCK AND MAIN LOOP ====
+
+__attribute__((weak)) void housekeeping_task_user(void) {}
+void keyboard_post_init_user(void);
+void matrix_scan_user(void);
+
+void sim_boot(uint32_t start_ms) {
+    layout_init();
+    clock_ms     = start_ms;
+    waited_ms    = 0;
+    real_mods    = 0;
+    weak_mods    = 0;
+    oneshot_mods = 0;
+    leds.raw     = 0;
+    clear_keys();
+    memset(&last_sent, 0, sizeof(last_sent));
+    memset(held, 0, sizeof(held));
+    report_count        = 0;
+    raw_head            = 0;
+    raw_count           = 0;
+    sim_eeprom_writes   = 0;
+    sim_eeprom_reads    = 0;
+    layer_state         = 0;
+    default_layer_state = 1;
+#ifdef FORCE_NKRO
+    keymap_config.nkro = true;
+#endif
+    keyboard_post_init_user();
+}
+
+uint32_t sim_now(void) {
+    return clock_ms;
+}
+
+void sim_advance(uint32_t ms) {
+    clock_ms += ms;
+}
+
+void sim_scan(void) {
+    clock_ms++;
+    housekeeping_task_user();
+    matrix_scan_user();
+}
+
+void sim_idle(uint32_t ms) {
+    while (ms--) {
+        sim_scan();
+    }
+}
+
+uint32_t sim_drain(uint32_t max_ms) {
+    uint32_t start = clock_ms;
+    while (output_queue_busy() && clock_ms - start < max_ms) {
+        sim_scan();
+    }
+    return clock_ms - start;
+}
+
+uint32_t sim_waited(void) {
+    return waited_ms;
+}
+
+// ==== KEYS ====
+
+/**
+ * @brief What QMK does with a key process_record_user() let through
+ */
+static void default_action(uint16_t keycode, keyrecord_t *record) {
+    bool pressed = record->event.pressed;
+
+    if (keycode <= 0xFF) {
+        pressed ? register_code((uint8_t)keycode) : unregister_code((uint8_t)keycode);
+        // One-shot mods go out with the next key press, then let go
+        if (pressed && !IS_MODIFIER_KEYCODE(keycode)) {
+            clear_oneshot_mods();
+        }
+    } else if (IS_QK_MODS(keycode)) {
+        pressed ? register_code16(keycode) : unregister_code16(keycode);
+    } else if (IS_QK_MOD_TAP(keycode) || IS_QK_LAYER_TAP(keycode)) {
+        // Always tapped here, so just the tap keycode, one-shot mods and all
+        default_action(IS_QK_MOD_TAP(keycode) ? QK_MOD_TAP_GET_TAP_KEYCODE(keycode)
+                                              : QK_LAYER_TAP_GET_TAP_KEYCODE(keycode),
+                       record);
+    } else if (IS_QK_MOMENTARY(keycode)) {
+        pressed ? layer_on(QK_MOMENTARY_GET_LAYER(keycode)) : layer_off(QK_MOMENTARY_GET_LAYER(keycode));
+    } else if (pressed && keycode >= QK_TO && keycode < QK_MOMENTARY) {
+        layer_move(keycode & 0x1F);
+    } else if (pressed && keycode >= QK_TOGGLE_LAYER && keycode < QK_ONE_SHOT_LAYER) {
+        layer_state ^= (layer_state_t)1 << (keycode & 0x1F);
+    } else if (pressed && keycode == DT_UP) {
+        g_tapping_term += 5;
+    } else if (pressed && keycode == DT_DOWN) {
+        g_tapping_term -= 5;
+    }
+}
+
+static void sim_event(uint16_t keycode, bool pressed) {
+    keypos_t pos = {.col = KEYLOC_COMBO, .row = KEYLOC_COMBO};
+    uint8_t  i;
+
+    for (i = 0; i < MAX_HELD && held[i].keycode != (pressed ? KC_NO : keycode); i++) {
+    }
+    if (i == MAX_HELD) {
+        fprintf(stderr, "sim: %s 0x%04X: %s\n", pressed ? "press" : "release", keycode,
+                pressed ? "too many keys down" : "not down");
+        abort();
+    }
+    if (pressed) {
+        pos             = find_key(keycode);
+        held[i].keycode = keycode;
+        held[i].pos     = pos;
+    } else {
+        pos             = held[i].pos;
+        held[i].keycode = KC_NO;
+    }
+
+    keyrecord_t record = {
+        .event   = MAKE_KEYEVENT(pos.row, pos.col, pressed),
+        .tap     = {.count = (IS_QK_MOD_TAP(keycode) || IS_QK_LAYER_TAP(keycode)) ? 1 : 0},
+        .keycode = keycode,
+    };
+    if (sim_process_record(keycode, &record)) {
+        default_action(keycode, &record);
+    }
+}
+
+void sim_press(uint16_t keycode) {
+    sim_event(keycode, true);
+}
+
+void sim_release(uint16_t keycode) {
+    sim_event(keycode, false);
+}
+
+void sim_tap(uint16_t keycode) {
+    sim_press(keycode);
+    sim_scan();
+    sim_release(keycode);
+    sim_scan();
+}
+
+void sim_type(const char *text) {
+    for (; *text; text++) {
+        uint8_t kc      = ascii_to_keycode_lut[(uint8_t)*text & 0x7F];
+        bool    shifted = PGM_LOADBIT(ascii_to_shift_lut, (uint8_t)*text & 0x7F);
+        if (shifted) {
+            sim_press(KC_LSFT);
+            sim_scan();
+        }
+        sim_tap(kc);
+        if (shifted) {
+            sim_release(KC_LSFT);
+            sim_scan();
+        }
+    }
+}
+
+void sim_set_caps_lock(bool on) {
+    leds.caps_lock = on;
+}
+
+// ==== REPORT LOG ====
+
+uint16_t sim_report_count(void) {
+    return report_count;
+}
+
+const sim_report_t *sim_report(uint16_t n) {
+    return (n < report_count) ? &reports[n] : NULL;
+}
+
+void sim_reports_clear(void) {
+    report_count = 0;
+}
+
+static bool key_down(const uint8_t *bits, uint8_t kc) {
+    return (bits[kc / 8] >> (kc % 8)) & 1;
+}
+
+const char *sim_typed(void) {
+    static char     text[4 * MAX_REPORTS];
+    static uint16_t starts[MAX_REPORTS]; // Where each typed item begins, for Backspace
+    uint16_t        items = 0;
+    size_t          len   = 0;
+    uint8_t         down[32] = {0};
+
+    for (uint16_t n = 0; n < report_count; n++) {
+        const sim_report_t *r = &reports[n];
+        for (uint16_t kc = 0; kc < 256; kc++) {
+            if (!key_down(r->keys, (uint8_t)kc) || key_down(down, (uint8_t)kc)) {
+                continue;
+            }
+            if (kc == KC_BSPC && !(r->mods & ~MOD_MASK_SHIFT)) {
+                if (items) {
+                    len = starts[--items];
+                }
+                continue;
+            }
+            if (len + 16 > sizeof(text) || items == MAX_REPORTS) {
+                break;
+            }
+            starts[items++] = (uint16_t)len;
+            if (r->mods & ~MOD_MASK_SHIFT) {
+                len += (size_t)sprintf(text + len, "<%02x+0x%02x>", r->mods, kc);
+            } else if (kc < 0x39 && layout[kc][0]) {
+                text[len++] = layout[kc][(r->mods & MOD_MASK_SHIFT) ? 1 : 0];
+            } else {
+                len += (size_t)sprintf(text + len, "<0x%02x>", kc);
+            }
+        }
+        memcpy(down, r->keys, sizeof(down));
+    }
+    text[len] = '\0';
+    return text;
+}
+
+void sim_print_reports(FILE *out, uint16_t from) {
+    for (uint16_t n = from; n < report_count; n++) {
+        fprintf(out, "+%u %02x", (unsigned)(n > from ? reports[n].time - reports[n - 1].time : 0), reports[n].mods);
+        for (uint16_t kc = 0; kc < 256; kc++) {
+            if (key_down(reports[n].keys, (uint8_t)kc)) {
+                fprintf(out, " %02x", kc);
+            }
+        }
+        fputc('\n', out);
+    }
+    fprintf(out, "= %u reports, %u ms\n", (unsigned)(report_count - from),
+            (unsigned)(report_count > from ? reports[report_count - 1].time - reports[from].time : 0));
+}
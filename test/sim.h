@@ -0,0 +1,178 @@
+/**
+ * @file sim.h
+ * @brief Host simulation of the keyboard for the tests in test/
+ *
+ * Links keymap.c and features/ against the stand-in QMK API in test/qmk/
+ * and drives them the way the firmware's main loop does, on a virtual
+ * clock:
+ *   - time only moves when a test says so; wait_ms() moves it instantly,
+ *     so an hour-long timeout takes microseconds and the clock can start
+ *     right before a 16 or 32-bit timer wrap
+ *   - every keyboard report sent is recorded with its time, and can be
+ *     decoded back into the text a US-layout host would see
+ *   - EEPROM and raw HID are plain buffers the tests can inspect
+ *
+ * Keys are pressed by keycode: process_record_user() gets the event first
+ * and, if it returns true, the key does what QMK would do with it (basic
+ * keys and modifiers are registered, MO() switches layers, mod-taps and
+ * layer-taps act as their tap keycode). The event's matrix position is the
+ * keycode's first position in the active layers, or KEYLOC_COMBO.
+ */
+
+#pragma once
+
+#include <stdio.h> // Before quantum.h, whose dprintf() stub would clash
+#include "quantum.h"
+
+/**
+ * @brief One keyboard report as the host received it
+ */
+typedef struct {
+    uint32_t time;     /**< Virtual time it was sent, in ms */
+    uint8_t  mods;     /**< Modifier byte (real and weak mods) */
+    uint8_t  keys[32]; /**< Keys down, bit n of byte n/8 for keycode n */
+} sim_report_t;
+
+// ==== CLOCK AND MAIN LOOP ====
+
+/**
+ * @brief Power up: reset all simulated hardware, start the clock at
+ *        start_ms and run keyboard_post_init_user()
+ *
+ * Feature state inside features/ isn't reset; one test program is one
+ * boot.
+ */
+void sim_boot(uint32_t start_ms);
+
+/**
+ * @brief The virtual clock, in ms (timer_read32())
+ */
+uint32_t sim_now(void);
+
+/**
+ * @brief Let time pass without scanning, like a blocking wait
+ */
+void sim_advance(uint32_t ms);
+
+/**
+ * @brief One pass of the main loop: 1 ms, housekeeping_task_user() and
+ *        matrix_scan_user()
+ */
+void sim_scan(void);
+
+/**
+ * @brief Scan for ms milliseconds
+ */
+void sim_idle(uint32_t ms);
+
+/**
+ * @brief Scan until the output queue has nothing left to type, at most
+ *        max_ms milliseconds
+ *
+ * @return Milliseconds it took
+ */
+uint32_t sim_drain(uint32_t max_ms);
+
+/**
+ * @brief Total time spent in wait_ms() since boot
+ */
+uint32_t sim_waited(void);
+
+// ==== KEYS ====
+
+/**
+ * @brief What sim_press() and sim_release() run before the key's default
+ *        action: process_record_user() unless a test swaps in its own
+ */
+extern bool (*sim_process_record)(uint16_t keycode, keyrecord_t *record);
+
+/**
+ * @brief Press a key; sim_process_record sees it first
+ */
+void sim_press(uint16_t keycode);
+
+/**
+ * @brief Release a key
+ */
+void sim_release(uint16_t keycode);
+
+/**
+ * @brief Press, scan, release, scan
+ */
+void sim_tap(uint16_t keycode);
+
+/**
+ * @brief Tap the keys for ASCII text, holding Left Shift around shifted
+ *        characters
+ */
+void sim_type(const char *text);
+
+/**
+ * @brief Set the host's Caps Lock LED state
+ */
+void sim_set_caps_lock(bool on);
+
+// ==== REPORTS ====
+
+/**
+ * @brief Number of reports sent since boot or the last sim_reports_clear()
+ */
+uint16_t sim_report_count(void);
+
+/**
+ * @brief Report n, oldest first
+ */
+const sim_report_t *sim_report(uint16_t n);
+
+/**
+ * @brief Forget the reports sent so far
+ */
+void sim_reports_clear(void);
+
+/**
+ * @brief The text a US-layout host reads from the reports so far
+ *
+ * Keys new in a report are pressed in ascending keycode order with the
+ * report's modifiers, as by tools/report_decode.py. Backspace deletes a
+ * character, and keys with Ctrl, Alt or GUI held come out as <mods+kc>.
+ */
+const char *sim_typed(void);
+
+/**
+ * @brief Write the reports since report from as golden file lines
+ *
+ * One line per report, "+<ms since the previous report> <mods> <keys...>"
+ * in hex, then "= <reports> reports, <ms from first to last> ms".
+ */
+void sim_print_reports(FILE *out, uint16_t from);
+
+// ==== EEPROM AND RAW HID ====
+
+/**
+ * @brief The simulated EEPROM user datablock
+ */
+extern uint8_t sim_eeprom[4096];
+
+/**
+ * @brief Number of eeconfig_update_user_datablock() calls since boot
+ */
+extern uint32_t sim_eeprom_writes;
+
+/**
+ * @brief Number of bytes eeconfig_read_user_datablock() read since boot
+ */
+extern uint32_t sim_eeprom_reads;
+
+/**
+ * @brief Send a packet from the host: raw_hid_receive() on a copy
+ *
+ * @param packet 32 bytes, overwritten with the keyboard's answer
+ */
+void sim_raw_hid(uint8_t *packet);
+
+/**
+ * @brief Take the oldest packet the keyboard sent on its own
+ *
+ * @return false if there is none
+ */
+bool sim_raw_hid_pop(uint8_t *packet);
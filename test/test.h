@@ -0,0 +1,48 @@
+/**
+ * @file test.h
+ * @brief Minimal checks for the host tests
+ *
+ * A failed CHECK() prints where and why and carries on, so one run shows
+ * every failure; test_done() turns the count into the exit status.
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <string.h>
+
+static int test_failures = 0;
+
+#define CHECK(cond)                                                        \
+    do {                                                                   \
+        if (!(cond)) {                                                     \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            test_failures++;                                               \
+        }                                                                  \
+    } while (0)
+
+#define CHECK_EQ(actual, expected)                                         \
+    do {                                                                   \
+        long long a_ = (long long)(actual), e_ = (long long)(expected);    \
+        if (a_ != e_) {                                                    \
+            fprintf(stderr, "%s:%d: %s is %lld, expected %lld\n", __FILE__, __LINE__, #actual, a_, e_); \
+            test_failures++;                                               \
+        }                                                                  \
+    } while (0)
+
+#define CHECK_STR(actual, expected)                                        \
+    do {                                                                   \
+        const char *a_ = (actual), *e_ = (expected);                       \
+        if (strcmp(a_, e_)) {                                              \
+            fprintf(stderr, "%s:%d: %s is \"%s\", expected \"%s\"\n", __FILE__, __LINE__, #actual, a_, e_); \
+            test_failures++;                                               \
+        }                                                                  \
+    } while (0)
+
+/**
+ * @brief Print the result line and return main()'s exit status
+ */
+static inline int test_done(const char *name) {
+    printf("%s: %s\n", name, test_failures ? "FAILED" : "ok");
+    return test_failures ? 1 : 0;
+}
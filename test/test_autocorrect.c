@@ -0,0 +1,44 @@
+/**
+ * @file test_autocorrect.c
+ * @brief Sentence case stays in step with the text autocorrect rewrites
+ *
+ * A correction can type more letters than the typo had on screen, and the
+ * typo's last letter never reaches sentence case. Its state history still
+ * has to hold one state per key on screen, or Backspace rewinds it to the
+ * wrong one.
+ */
+
+#include "sim.h"
+#include "test.h"
+
+static void test_backspace_over_correction(void) {
+    // "tehy" is caught at the y, which is swallowed: "eh" goes, "hey" comes
+    sim_reports_clear();
+    sim_type("done. tehy");
+    sim_drain(10000);
+    CHECK_STR(sim_typed(), "done. They");
+
+    // Back to just after "done. ", where the next letter starts a sentence
+    sim_type("\b\b\b\bx");
+    sim_drain(10000);
+    CHECK_STR(sim_typed(), "done. X");
+    sim_type("\n");
+}
+
+static void test_backspace_over_boundary_correction(void) {
+    // ":teh:" is caught at the space, which is typed after the correction
+    sim_reports_clear();
+    sim_type("ok. teh \b\b\b\bx");
+    sim_drain(10000);
+    CHECK_STR(sim_typed(), "ok. X");
+    sim_type("\n");
+}
+
+int main(void) {
+    sim_boot(0);
+
+    test_backspace_over_correction();
+    test_backspace_over_boundary_correction();
+
+    return test_done("autocorrect");
+}
@@ -0,0 +1,109 @@
+/**
+ * @file test_crypto.c
+ * @brief ChaCha20 and Poly1305 against the RFC 8439 test vectors
+ *
+ * The vault and the raw HID channel only ever check the firmware against
+ * tools/secrets_vault.py and tools/secrets_companion.py, so a mistake both
+ * sides made the same way would go unnoticed. The RFC's own vectors catch
+ * that: the block function of section 2.3.2, encryption, block by block
+ * from counter 1, of section 2.4.2, and the Poly1305 tag of section 2.5.2.
+ */
+
+#include "test.h"
+#include "features/chacha20.h"
+#include "features/poly1305.h"
+#include <stdint.h>
+
+/**
+ * @brief Words of the little endian bytes b[0..4n)
+ */
+static void le_words(const uint8_t *b, uint32_t *words, uint8_t n) {
+    for (uint8_t i = 0; i < n; i++) {
+        words[i] = b[4 * i] | b[4 * i + 1] << 8 | b[4 * i + 2] << 16 | (uint32_t)b[4 * i + 3] << 24;
+    }
+}
+
+/**
+ * @brief The key both sections use: bytes 00 01 02 ... 1f
+ */
+static void rfc_key(uint32_t key[CHACHA20_KEY_WORDS]) {
+    uint8_t bytes[4 * CHACHA20_KEY_WORDS];
+    for (uint8_t i = 0; i < sizeof(bytes); i++) {
+        bytes[i] = i;
+    }
+    le_words(bytes, key, CHACHA20_KEY_WORDS);
+}
+
+static void test_block(void) {
+    static const uint8_t  nonce_bytes[12] = {0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x4a, 0x00, 0x00, 0x00, 0x00};
+    static const uint32_t expected[CHACHA20_BLOCK_WORDS] = {
+        0xe4e7f110, 0x15593bd1, 0x1fdd0f50, 0xc47120a3, 0xc7f4d1c7, 0x0368c033, 0x9aaa2204, 0x4e6cd4c3,
+        0x466482d2, 0x09aa9f07, 0x05d7c214, 0xa2028bd9, 0xd19c12b5, 0xb94e16de, 0xe883d0cb, 0x4e3c50a2,
+    };
+    uint32_t key[CHACHA20_KEY_WORDS], nonce[CHACHA20_NONCE_WORDS], block[CHACHA20_BLOCK_WORDS];
+
+    rfc_key(key);
+    le_words(nonce_bytes, nonce, CHACHA20_NONCE_WORDS);
+    chacha20_block(key, 1, nonce, block);
+    for (uint8_t i = 0; i < CHACHA20_BLOCK_WORDS; i++) {
+        CHECK_EQ(block[i], expected[i]);
+    }
+
+    // The serialized block starts 10 f1 e7 e4 d1 3b 59 15
+    CHECK_EQ(chacha20_byte(block, 0), 0x10);
+    CHECK_EQ(chacha20_byte(block, 3), 0xe4);
+    CHECK_EQ(chacha20_byte(block, 7), 0x15);
+    CHECK_EQ(chacha20_byte(block, 63), 0x4e);
+}
+
+static void test_encryption(void) {
+    static const char     plaintext[]     = "Ladies and Gentlemen of the class of '99: If I could offer you only one "
+                                            "tip for the future, sunscreen would be it.";
+    static const uint8_t  nonce_bytes[12] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x4a, 0x00, 0x00, 0x00, 0x00};
+    static const uint8_t  expected[]      = {
+        0x6e, 0x2e, 0x35, 0x9a, 0x25, 0x68, 0xf9, 0x80, 0x41, 0xba, 0x07, 0x28, 0xdd, 0x0d, 0x69, 0x81,
+        0xe9, 0x7e, 0x7a, 0xec, 0x1d, 0x43, 0x60, 0xc2, 0x0a, 0x27, 0xaf, 0xcc, 0xfd, 0x9f, 0xae, 0x0b,
+        0xf9, 0x1b, 0x65, 0xc5, 0x52, 0x47, 0x33, 0xab, 0x8f, 0x59, 0x3d, 0xab, 0xcd, 0x62, 0xb3, 0x57,
+        0x16, 0x39, 0xd6, 0x24, 0xe6, 0x51, 0x52, 0xab, 0x8f, 0x53, 0x0c, 0x35, 0x9f, 0x08, 0x61, 0xd8,
+        0x07, 0xca, 0x0d, 0xbf, 0x50, 0x0d, 0x6a, 0x61, 0x56, 0xa3, 0x8e, 0x08, 0x8a, 0x22, 0xb6, 0x5e,
+        0x52, 0xbc, 0x51, 0x4d, 0x16, 0xcc, 0xf8, 0x06, 0x81, 0x8c, 0xe9, 0x1a, 0xb7, 0x79, 0x37, 0x36,
+        0x5a, 0xf9, 0x0b, 0xbf, 0x74, 0xa3, 0x5b, 0xe6, 0xb4, 0x0b, 0x8e, 0xed, 0xf2, 0x78, 0x5e, 0x42,
+        0x87, 0x4d,
+    };
+    uint32_t key[CHACHA20_KEY_WORDS], nonce[CHACHA20_NONCE_WORDS], block[CHACHA20_BLOCK_WORDS];
+
+    CHECK_EQ(sizeof(plaintext) - 1, sizeof(expected));
+    rfc_key(key);
+    le_words(nonce_bytes, nonce, CHACHA20_NONCE_WORDS);
+    for (uint8_t i = 0; i < sizeof(expected); i++) {
+        if (i % 64 == 0) {
+            chacha20_block(key, 1 + i / 64, nonce, block);
+        }
+        CHECK_EQ((uint8_t)plaintext[i] ^ chacha20_byte(block, i % 64), expected[i]);
+    }
+}
+
+static void test_mac(void) {
+    static const uint8_t key[POLY1305_KEY_SIZE] = {
+        0x85, 0xd6, 0xbe, 0x78, 0x57, 0x55, 0x6d, 0x33, 0x7f, 0x44, 0x52, 0xfe, 0x42, 0xd5, 0x06, 0xa8,
+        0x01, 0x03, 0x80, 0x8a, 0xfb, 0x0d, 0xb2, 0xfd, 0x4a, 0xbf, 0xf6, 0xaf, 0x41, 0x49, 0xf5, 0x1b,
+    };
+    static const char    message[]                   = "Cryptographic Forum Research Group";
+    static const uint8_t expected[POLY1305_TAG_SIZE] = {
+        0xa8, 0x06, 0x1d, 0xc1, 0x30, 0x51, 0x36, 0xc6, 0xc2, 0x2b, 0x8b, 0xaf, 0x0c, 0x01, 0x27, 0xa9,
+    };
+    uint8_t tag[POLY1305_TAG_SIZE];
+
+    poly1305_mac(key, (const uint8_t *)message, sizeof(message) - 1, tag);
+    for (uint8_t i = 0; i < POLY1305_TAG_SIZE; i++) {
+        CHECK_EQ(tag[i], expected[i]);
+    }
+}
+
+int main(void) {
+    test_block();
+    test_encryption();
+    test_mac();
+
+    return test_done("crypto");
+}
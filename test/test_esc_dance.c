@@ -0,0 +1,141 @@
+/**
+ * @file test_esc_dance.c
+ * @brief Esc tap dance latency, against what stock tap dance would take
+ *
+ * Stock QMK tap dance decides when TAPPING_TERM has passed since the last
+ * press of the dance key, or when another key is pressed, whichever comes
+ * first, whatever the outcome. Each scenario below is run through the keymap
+ * on the virtual clock and the time from the first press to its outcome
+ * (Esc reaching the host, the secrets locking, _FL turning on) is checked
+ * against that model: never later, and sooner where features/esc_dance.h
+ * says it is.
+ */
+
+#include "sim.h"
+#include "test.h"
+#include "custom_keycodes.h"
+#include "keymap_aliases.h"
+#include "layers.h"
+#include "features/secrets_manager.h"
+
+#define NEVER UINT32_MAX
+
+/**
+ * @brief One key event of a scenario, at ms after its start
+ */
+typedef struct {
+    uint16_t at;
+    uint16_t keycode;
+    bool     pressed;
+} step_t;
+
+static bool esc_sent(void) {
+    for (uint16_t n = 0; n < sim_report_count(); n++) {
+        if (sim_report(n)->keys[KC_ESC / 8] & (1 << (KC_ESC % 8))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool secrets_locked(void) {
+    return !is_secrets_unlocked();
+}
+
+static bool on_fl(void) {
+    return layer_state_is(_FL);
+}
+
+/**
+ * @brief Stock tap dance: TAPPING_TERM after the last dance press, or the
+ *        next other press, whichever comes first
+ */
+static uint32_t stock_ms(const step_t *steps, uint8_t count) {
+    uint32_t decided = NEVER;
+    for (uint8_t i = 0; i < count; i++) {
+        if (!steps[i].pressed) {
+            continue;
+        }
+        if (steps[i].keycode == ESC_TD) {
+            decided = steps[i].at + TAPPING_TERM;
+        } else if (steps[i].at < decided) {
+            return steps[i].at;
+        }
+    }
+    return decided;
+}
+
+/**
+ * @brief Run the steps, scanning every ms, until done() or 1 s after the
+ *        last step
+ *
+ * @return ms from the first step until done() was first true, or NEVER
+ */
+static uint32_t eager_ms(const step_t *steps, uint8_t count, bool (*done)(void)) {
+    uint32_t start = sim_now();
+    uint32_t until = steps[count - 1].at + 1000;
+    uint8_t  next  = 0;
+    uint32_t found = NEVER;
+
+    sim_reports_clear();
+    for (uint32_t t = 0; t <= until; t++) {
+        while (next < count && steps[next].at == t) {
+            steps[next].pressed ? sim_press(steps[next].keycode) : sim_release(steps[next].keycode);
+            next++;
+        }
+        if (found == NEVER && done()) {
+            found = sim_now() - start;
+        }
+        sim_scan();
+    }
+    return found;
+}
+
+/**
+ * @brief Run one scenario, print both latencies and check them
+ */
+static void scenario(const char *name, const step_t *steps, uint8_t count, bool (*done)(void), uint32_t expected) {
+    uint32_t eager = eager_ms(steps, count, done);
+    uint32_t stock = stock_ms(steps, count);
+    printf("  %-30s %5lu ms  stock %5lu ms\n", name, (unsigned long)eager, (unsigned long)stock);
+    CHECK_EQ(eager, expected);
+    CHECK(eager <= stock);
+}
+
+static void unlock(void) {
+    sim_tap(PIN_ENTRY);
+    sim_type("2468\n");
+    CHECK(is_secrets_unlocked());
+}
+
+int main(void) {
+    sim_boot(0);
+    printf("esc dance: first press to outcome, TAPPING_TERM %d ms\n", TAPPING_TERM);
+
+    // Locked, a double tap can't do anything: Esc at the release
+    secrets_lock();
+    const step_t tap[] = {{0, ESC_TD, true}, {40, ESC_TD, false}};
+    scenario("tap, secrets locked", tap, 2, esc_sent, 40);
+
+    // Unlocked, a second tap might follow: the same wait as stock
+    unlock();
+    scenario("tap, unlocked", tap, 2, esc_sent, TAPPING_TERM);
+
+    const step_t tap_type[] = {{0, ESC_TD, true}, {40, ESC_TD, false}, {90, KC_A, true}, {130, KC_A, false}};
+    scenario("tap, unlocked, then typing", tap_type, 4, esc_sent, 90);
+
+    // The second press decides, stock waits for a third
+    const step_t double_tap[] = {{0, ESC_TD, true}, {40, ESC_TD, false}, {100, ESC_TD, true}, {140, ESC_TD, false}};
+    scenario("double tap, unlocked", double_tap, 4, secrets_locked, 100);
+    CHECK(!esc_sent());
+
+    // _FL from the press, stock holds keys back until it decides
+    const step_t hold[] = {{0, ESC_TD, true}, {400, ESC_TD, false}};
+    scenario("hold", hold, 2, on_fl, 0);
+    const step_t hold_key[] = {{0, ESC_TD, true}, {60, KC_F1, true}, {80, KC_F1, false}, {120, ESC_TD, false}};
+    scenario("hold, key on _FL", hold_key, 4, on_fl, 0);
+    CHECK(!on_fl());
+    CHECK(!esc_sent());
+
+    return test_done("esc dance");
+}
@@ -0,0 +1,178 @@
+/**
+ * @file test_golden.c
+ * @brief The exact reports each macro sends, against the files in golden/
+ *
+ * Every capture is compared with its golden file, report by report, so a
+ * stray modifier, a reordered key or a changed delay fails the test. The
+ * last line of each file is the macro's report count and duration. After
+ * an intended change, `make -C test golden` rewrites the files; review the
+ * diff before committing them.
+ */
+
+#include "sim.h"
+#include "test.h"
+#include "custom_keycodes.h"
+#include "features/secrets_manager.h"
+#include "features/virtual_desktop.h"
+#include <stdlib.h>
+
+static bool update_golden = false;
+
+/**
+ * @brief Run a macro, check the text a host reads from it, and check its
+ *        reports against golden/<name>.txt
+ */
+static void capture(const char *name, const char *what, void (*macro)(void), const char *typed) {
+    sim_reports_clear();
+    macro();
+    sim_drain(60000);
+    CHECK_STR(sim_typed(), typed);
+
+    char  *actual = NULL;
+    size_t length = 0;
+    FILE  *out    = open_memstream(&actual, &length);
+    fprintf(out, "# %s\n", what);
+    sim_print_reports(out, 0);
+    fclose(out);
+
+    char path[128], failed[128];
+    snprintf(path, sizeof(path), "golden/%s.txt", name);
+    snprintf(failed, sizeof(failed), "build/%s.actual.txt", name);
+    printf("  %-24s %s", name, strrchr(actual, '=') + 2);
+
+    if (update_golden) {
+        FILE *file = fopen(path, "w");
+        CHECK(file != NULL);
+        if (file) {
+            fputs(actual, file);
+            fclose(file);
+        }
+        free(actual);
+        return;
+    }
+
+    static char expected[65536];
+    FILE       *file = fopen(path, "r");
+    size_t      read = file ? fread(expected, 1, sizeof(expected) - 1, file) : 0;
+    expected[read]   = '\0';
+    if (file) {
+        fclose(file);
+    }
+    if (strcmp(actual, expected)) {
+        FILE *dump = fopen(failed, "w");
+        if (dump) {
+            fputs(actual, dump);
+            fclose(dump);
+        }
+        fprintf(stderr, "%s: reports differ, see diff test/%s test/%s\n", name, path, failed);
+        test_failures++;
+    }
+    free(actual);
+}
+
+// ==== VIRTUAL DESKTOPS ====
+
+static void vd_switch_3(void) {
+    sim_press(META_LAYER);
+    sim_tap(VD_3);
+    sim_release(META_LAYER);
+}
+
+static void vd_switch_1(void) {
+    sim_press(META_LAYER);
+    sim_tap(VD_1);
+    sim_release(META_LAYER);
+}
+
+static void vd_move_lshift_2(void) {
+    sim_press(META_LAYER);
+    sim_press(KC_LSFT);
+    sim_tap(VD_2);
+    sim_release(KC_LSFT);
+    sim_release(META_LAYER);
+}
+
+static void vd_move_rshift_4(void) {
+    // Right Shift, as HOME_E holds it
+    sim_press(META_LAYER);
+    sim_press(KC_RSFT);
+    sim_tap(VD_4);
+    sim_release(KC_RSFT);
+    sim_release(META_LAYER);
+}
+
+static void vd_move_window_1(void) {
+    move_window_to_vd(1);
+}
+
+// ==== RUN DIALOG ====
+
+static void run_wt(void) {
+    sim_tap(RUN_WT);
+}
+
+static void run_notepad(void) {
+    sim_tap(RUN_NOTEPAD);
+}
+
+// ==== SECRETS ====
+
+static void secret_unlock(void) {
+    sim_tap(PIN_ENTRY);
+    sim_type("2468\n");
+}
+
+static void secret_pin(void) {
+    sim_tap(E_PIN);
+}
+
+static void secret_pass_1(void) {
+    sim_tap(E_PASS1);
+}
+
+static void secret_pass_3(void) {
+    sim_tap(E_PASS3);
+}
+
+static void secret_select_7(void) {
+    sim_tap(SECRET_SELECT);
+    sim_type("7\n");
+}
+
+static void secret_locked(void) {
+    secrets_lock();
+    sim_tap(E_PASS1);
+}
+
+int main(int argc, char **argv) {
+    update_golden = argc > 1 && !strcmp(argv[1], "--update-golden");
+    sim_boot(0);
+    keymap_config.nkro = true; // Switched on, so the secrets go out in bursts
+
+    printf("golden: reports and time per macro\n");
+    capture("vd_switch_3", "Meta + VD_3 from desktop 1: Ctrl+GUI+Right twice", vd_switch_3, "<09+0x4f><09+0x4f>");
+    CHECK_EQ(get_current_vd(), 3);
+    capture("vd_move_lshift_2", "Meta + Left Shift + VD_2: move the window from 3 to 2", vd_move_lshift_2,
+            "<08+0x2b><0x65><0x51><0x51><0x4f><0x51>\n<0x29><09+0x50>");
+    CHECK_EQ(get_current_vd(), 2);
+    capture("vd_move_rshift_4", "Meta + Right Shift + VD_4: move the window from 2 to 4", vd_move_rshift_4,
+            "<08+0x2b><0x65><0x51><0x51><0x4f><0x51><0x51>\n<0x29><09+0x4f><09+0x4f>");
+    CHECK_EQ(get_current_vd(), 4);
+    capture("vd_move_window_1", "move_window_to_vd(1) with nothing held, from 4", vd_move_window_1,
+            "<08+0x2b><0x65><0x51><0x51><0x4f>\n<0x29><09+0x50><09+0x50><09+0x50>");
+    capture("vd_switch_1", "Meta + VD_1 while on desktop 1: GUI alone, already there", vd_switch_1, "");
+    CHECK_EQ(get_current_vd(), 1);
+    CHECK_EQ(get_mods(), 0);
+
+    capture("run_wt", "RUN_WT: GUI+R, wt.exe, Enter", run_wt, "<08+0x15>wt.exe\n");
+    capture("run_notepad", "RUN_NOTEPAD: GUI+R, notepad.exe, Enter", run_notepad, "<08+0x15>notepad.exe\n");
+
+    capture("secret_locked", "E_PASS1 while locked: nothing", secret_locked, "");
+    capture("secret_unlock", "PIN_ENTRY 2468 Enter: nothing typed", secret_unlock, "");
+    CHECK(is_secrets_unlocked());
+    capture("secret_pin", "E_PIN: the PIN secret, then Enter", secret_pin, "2468\n");
+    capture("secret_pass_1", "E_PASS1: a password with shifted symbols, then Enter", secret_pass_1, "Tr0ub4dor&3\n");
+    capture("secret_pass_3", "E_PASS3: a password with a space and repeats, then Enter", secret_pass_3, "p@ss w0rd!\n");
+    capture("secret_select_7", "SECRET_SELECT 7 Enter: tagged secret 7, then Enter", secret_select_7, "tagged seven\n");
+    return test_done("golden");
+}
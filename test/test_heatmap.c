@@ -0,0 +1,159 @@
+/**
+ * @file test_heatmap.c
+ * @brief The heatmap only redraws what changed, and decays only what is hot
+ *
+ * heatmap.c is built into this test with RGB_MATRIX_ENABLE, against the
+ * rgb_matrix stand-in of test/qmk/rgb_matrix.h, and rendered frame by
+ * frame the way rgb_matrix_task() calls an effect: iter 0, 1, ... until it
+ * reports every LED done. Per frame the test counts the rgb_matrix_set_color()
+ * calls and the LEDs decay() visits, for the worst case (every LED hot,
+ * every one changing) and for an idle keyboard, where both have to be zero.
+ */
+
+#define RGB_MATRIX_ENABLE
+#define HEATMAP_ENABLE
+
+#include "sim.h"
+#include "test.h"
+
+static uint32_t draws, decay_visits;
+
+// decay() takes one __builtin_ctz() per LED it visits, and nothing else in
+// heatmap.c calls it
+#define __builtin_ctz(bits) (decay_visits++, __builtin_ctz(bits))
+#include "features/heatmap.c"
+#undef __builtin_ctz
+
+// ==== RGB MATRIX STAND-IN ====
+
+led_config_t g_led_config;
+rgb_config_t rgb_matrix_config = {.hsv = {0, 255, 255}, .speed = 255};
+
+RGB hsv_to_rgb(HSV hsv) {
+    return (RGB){hsv.v, hsv.v, hsv.v};
+}
+
+void rgb_matrix_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
+    CHECK(index >= 0 && index < RGB_MATRIX_LED_COUNT);
+    draws++;
+}
+
+bool rgb_matrix_is_enabled(void) {
+    return true;
+}
+
+uint8_t rgb_matrix_get_mode(void) {
+    return RGB_MATRIX_CUSTOM_HEATMAP;
+}
+
+// ==== HELPERS ====
+
+/**
+ * @brief Render one frame, counting from zero
+ */
+static void frame(bool init) {
+    effect_params_t params = {.flags = LED_FLAG_ALL, .init = init};
+
+    draws = decay_visits = 0;
+    while (heatmap_render(&params)) {
+        params.iter++;
+        params.init = false;
+    }
+}
+
+/**
+ * @brief Press every key once
+ */
+static void hit_all(void) {
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            keyrecord_t record = {.event = MAKE_KEYEVENT(row, col, true)};
+            heatmap_record(&record);
+        }
+    }
+}
+
+static bool any_active(void) {
+    for (uint8_t w = 0; w < LED_WORDS; w++) {
+        if (active[w]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// ==== TESTS ====
+
+static void test_idle(void) {
+    // The first frame draws everything once, then nothing is left to do
+    frame(true);
+    CHECK_EQ(draws, RGB_MATRIX_LED_COUNT);
+    CHECK_EQ(decay_visits, 0);
+
+    for (uint8_t i = 0; i < 10; i++) {
+        sim_advance(decay_interval());
+        frame(false);
+        CHECK_EQ(draws, 0);
+        CHECK_EQ(decay_visits, 0);
+    }
+}
+
+static void test_all_hot(void) {
+    hit_all();
+    frame(false);
+    CHECK_EQ(draws, RGB_MATRIX_LED_COUNT);
+    CHECK_EQ(decay_visits, 0);
+
+    // Full heat: every step changes every LED's shown level
+    for (uint8_t i = 0; i < 4; i++) {
+        hit_all();
+    }
+    sim_advance(decay_interval());
+    frame(false);
+    CHECK_EQ(draws, RGB_MATRIX_LED_COUNT);
+    CHECK_EQ(decay_visits, RGB_MATRIX_LED_COUNT);
+    CHECK_EQ(heat[0], UINT16_MAX - (UINT16_MAX >> HEATMAP_DECAY_SHIFT) - 1);
+
+    // A long pause is caught up in one visit per LED, HEATMAP_MAX_DECAY_STEPS deep
+    uint16_t h = heat[0];
+    for (uint8_t s = 0; s < HEATMAP_MAX_DECAY_STEPS; s++) {
+        h -= (h >> HEATMAP_DECAY_SHIFT) + 1;
+    }
+    sim_advance(100 * decay_interval());
+    frame(false);
+    CHECK_EQ(draws, RGB_MATRIX_LED_COUNT);
+    CHECK_EQ(decay_visits, RGB_MATRIX_LED_COUNT);
+    CHECK_EQ(heat[0], h);
+}
+
+static void test_cools_to_idle(void) {
+    for (uint16_t i = 0; i < 1000 && any_active(); i++) {
+        sim_advance(decay_interval());
+        frame(false);
+        CHECK(draws <= RGB_MATRIX_LED_COUNT);
+        CHECK(decay_visits <= RGB_MATRIX_LED_COUNT);
+    }
+    CHECK(!any_active());
+
+    sim_advance(decay_interval());
+    frame(false);
+    CHECK_EQ(draws, 0);
+    CHECK_EQ(decay_visits, 0);
+}
+
+int main(void) {
+    sim_boot(0);
+
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            g_led_config.matrix_co[row][col]            = row * MATRIX_COLS + col;
+            g_led_config.flags[row * MATRIX_COLS + col] = LED_FLAG_KEYLIGHT;
+        }
+    }
+
+    test_idle();
+    test_all_hot();
+    test_cools_to_idle();
+
+    return test_done("heatmap");
+}
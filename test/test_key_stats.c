@@ -0,0 +1,213 @@
+/**
+ * @file test_key_stats.c
+ * @brief Keystroke statistics count typing, and never secret input
+ *
+ * The counters go to EEPROM and out over raw HID, so after a
+ * KEY_STATS_CLEAR the matrix counts of a PIN's digits would tell which
+ * digits it has. Nothing typed during PIN entry or SECRET_SELECT is
+ * counted.
+ *
+ * The counters saturate rather than wrap, a bigram's interval is a running
+ * mean over its first eight samples and a 1/8 moving average after, the
+ * WPM rate drops a second's typing once it leaves the window, and a flush
+ * writes at most KEY_STATS_FLUSH_CHUNK bytes per scan.
+ */
+
+#include "sim.h"
+#include "test.h"
+#include "custom_keycodes.h"
+#include "features/key_stats.h"
+#include "features/eeprom_layout.h"
+#include "features/secrets_manager.h"
+#include <stddef.h>
+
+#define HOME_A LGUI_T(KC_A) // First two keys of KEY_STATS_HOME_ROW
+#define HOME_R LALT_T(KC_R)
+
+/**
+ * @brief Hand one press to key_stats_record(), at a given time
+ */
+static void press_at(uint16_t keycode, uint8_t row, uint8_t col, uint16_t time) {
+    keyrecord_t record = {.event = MAKE_KEYEVENT(row, col, true)};
+    record.event.time  = time;
+    record.tap.count   = 1;
+    key_stats_record(keycode, &record);
+}
+
+static void press(uint16_t keycode) {
+    press_at(keycode, 0, 1, timer_read());
+}
+
+/**
+ * @brief Time an A then R roll, after a key that breaks any earlier pair
+ */
+static void roll(uint16_t interval) {
+    press(KC_X);
+    press_at(HOME_A, 3, 1, 1000);
+    press_at(HOME_R, 3, 2, 1000 + interval);
+}
+
+static void test_pin_not_counted(void) {
+    key_stats_t before;
+
+    secrets_lock();
+    key_stats_clear();
+    sim_tap(PIN_ENTRY);
+    memcpy(&before, key_stats_get(), sizeof(before));
+    sim_type("2468\n");
+    CHECK(is_secrets_unlocked());
+    CHECK(!memcmp(key_stats_get()->matrix, before.matrix, sizeof(before.matrix)));
+    CHECK_EQ(key_stats_get()->presses, before.presses);
+
+    sim_tap(SECRET_SELECT);
+    memcpy(&before, key_stats_get(), sizeof(before));
+    sim_type("7\n");
+    sim_drain(10000);
+    CHECK(!memcmp(key_stats_get()->matrix, before.matrix, sizeof(before.matrix)));
+    CHECK_EQ(key_stats_get()->presses, before.presses);
+
+    // Ordinary typing is counted again
+    sim_type("2");
+    CHECK_EQ(key_stats_get()->presses, before.presses + 1);
+}
+
+static void test_saturation(void) {
+    key_stats_clear();
+    for (uint32_t i = 0; i < UINT16_MAX + 10; i++) {
+        press_at(KC_Q, 2, 5, 0);
+    }
+    CHECK_EQ(key_stats_get()->matrix[2][5], UINT16_MAX);
+    CHECK_EQ(key_stats_get()->presses, UINT16_MAX + 10);
+
+    // 255 characters in the last second and more: the bucket stops at 255,
+    // and the rate it gives is capped rather than wrapped
+    sim_idle(1000);
+    CHECK_EQ(key_stats_get()->wpm, UINT8_MAX);
+    CHECK_EQ(key_stats_get()->peak_wpm, UINT8_MAX);
+
+    // Combos report positions outside the matrix, which are only counted overall
+    uint32_t presses = key_stats_get()->presses;
+    press_at(KC_Q, KEYLOC_COMBO, KEYLOC_COMBO, 0);
+    CHECK_EQ(key_stats_get()->presses, presses + 1);
+}
+
+static void test_bigram_mean(void) {
+    const uint16_t a = 0, r = 1;
+
+    key_stats_clear();
+    roll(100);
+    CHECK_EQ(key_stats_get()->bigram_count[a][r], 1);
+    CHECK_EQ(key_stats_get()->bigram_ms[a][r], 100);
+    roll(200);
+    CHECK_EQ(key_stats_get()->bigram_ms[a][r], 150);
+    roll(300);
+    CHECK_EQ(key_stats_get()->bigram_ms[a][r], 200);
+    for (uint8_t i = 3; i < 8; i++) {
+        roll(200);
+    }
+    CHECK_EQ(key_stats_get()->bigram_count[a][r], 8);
+    CHECK_EQ(key_stats_get()->bigram_ms[a][r], 200);
+
+    // From the eighth sample on, each new one moves the average by 1/8
+    roll(280);
+    CHECK_EQ(key_stats_get()->bigram_ms[a][r], 210);
+    roll(130);
+    CHECK_EQ(key_stats_get()->bigram_ms[a][r], 200);
+
+    // A pause isn't a roll, and isn't counted
+    roll(KEY_STATS_BIGRAM_MAX_MS + 1);
+    CHECK_EQ(key_stats_get()->bigram_count[a][r], 10);
+    CHECK_EQ(key_stats_get()->bigram_ms[a][r], 200);
+
+    // Nor is a pair broken by another key
+    press_at(HOME_A, 3, 1, 1000);
+    press_at(KC_X, 0, 1, 1050);
+    press_at(HOME_R, 3, 2, 1100);
+    CHECK_EQ(key_stats_get()->bigram_count[a][r], 10);
+}
+
+static void test_wpm_window(void) {
+    key_stats_clear();
+    sim_idle(KEY_STATS_WPM_WINDOW * 1000);
+    CHECK_EQ(key_stats_get()->wpm, 0);
+
+    // 50 characters in one second are 60 WPM over a ten second window
+    for (uint8_t i = 0; i < 50; i++) {
+        press(KC_E);
+    }
+    sim_idle(1000);
+    CHECK_EQ(key_stats_get()->wpm, 50 * 60 / (5 * KEY_STATS_WPM_WINDOW));
+
+    // They stay in the rate until their second rolls out of the window
+    sim_idle((KEY_STATS_WPM_WINDOW - 2) * 1000);
+    CHECK_EQ(key_stats_get()->wpm, 50 * 60 / (5 * KEY_STATS_WPM_WINDOW));
+    sim_idle(1000);
+    CHECK_EQ(key_stats_get()->wpm, 0);
+    CHECK_EQ(key_stats_get()->peak_wpm, 50 * 60 / (5 * KEY_STATS_WPM_WINDOW));
+
+    // Held modifiers and layer keys aren't typing
+    press(KC_LSFT);
+    keyrecord_t held = {.event = MAKE_KEYEVENT(3, 1, true)};
+    key_stats_record(HOME_A, &held);
+    sim_idle(1000);
+    CHECK_EQ(key_stats_get()->wpm, 0);
+}
+
+/**
+ * @brief Scan until a flush has started and finished; returns its writes
+ */
+static uint32_t scan_flush(uint32_t limit_ms) {
+    uint32_t writes = sim_eeprom_writes, start = sim_now();
+
+    while (sim_eeprom_writes == writes && sim_now() - start < limit_ms) {
+        sim_scan();
+    }
+    for (;;) {
+        uint32_t before = sim_eeprom_writes;
+        sim_scan();
+        CHECK(sim_eeprom_writes - before <= 1); // One chunk per scan
+        if (sim_eeprom_writes == before) {
+            return sim_eeprom_writes - writes;
+        }
+    }
+}
+
+static void test_chunked_flush(void) {
+    const uint32_t chunks = (sizeof(key_stats_t) + KEY_STATS_FLUSH_CHUNK - 1) / KEY_STATS_FLUSH_CHUNK;
+    const uint8_t *stored = sim_eeprom + EEPROM_KEY_STATS_OFFSET;
+    const size_t   counts = offsetof(key_stats_t, presses); // wpm before it is live
+
+    // A clear is written out right away
+    key_stats_clear();
+    CHECK_EQ(scan_flush(1), chunks);
+    CHECK(!memcmp(stored + counts, (const uint8_t *)key_stats_get() + counts, sizeof(key_stats_t) - counts));
+
+    // A change waits for KEY_STATS_FLUSH_MS since the last flush started
+    press(KC_Q);
+    uint32_t start = sim_now();
+    CHECK_EQ(scan_flush(KEY_STATS_FLUSH_MS + 10), chunks);
+    CHECK(sim_now() - start <= KEY_STATS_FLUSH_MS + chunks + 2);
+    CHECK_EQ(((const key_stats_t *)stored)->presses, 1);
+
+    uint32_t writes = sim_eeprom_writes;
+    press(KC_Q);
+    sim_idle(KEY_STATS_FLUSH_MS - chunks - 10);
+    CHECK_EQ(sim_eeprom_writes, writes);
+    CHECK_EQ(scan_flush(100), chunks);
+    CHECK_EQ(((const key_stats_t *)stored)->presses, 2);
+
+    // Nothing changed, nothing written
+    writes = sim_eeprom_writes;
+    sim_idle(KEY_STATS_FLUSH_MS + 100);
+    CHECK_EQ(sim_eeprom_writes, writes);
+}
+
+int main(void) {
+    sim_boot(0);
+    test_pin_not_counted();
+    test_saturation();
+    test_bigram_mean();
+    test_wpm_window();
+    test_chunked_flush();
+    return test_done("key stats");
+}
@@ -0,0 +1,347 @@
+/**
+ * @file test_keymap_overrides.c
+ * @brief Overrides stay sorted, fit their capacity, and reach EEPROM in chunks
+ *
+ * Overrides are written over raw HID as tools/keymap_overrides.py does.
+ * The list has to stay sorted for the binary search, a write that would
+ * overflow it must change nothing, and writing a position's compiled-in
+ * keycode has to drop its override. A stored list that is out of order,
+ * out of range or from another layout is dropped at init, and the flush
+ * writes at most KEYMAP_OVERRIDES_FLUSH_CHUNK bytes per scan, and only the
+ * valid entries.
+ */
+
+#include "sim.h"
+#include "test.h"
+#include "features/eeprom_layout.h"
+#include "features/hid_protocol.h"
+#include "features/keymap_overrides.h"
+#include <stddef.h>
+
+#define POSITIONS (MATRIX_ROWS * MATRIX_COLS)
+
+static keymap_overrides_t *stored(void) {
+    return (keymap_overrides_t *)(sim_eeprom + EEPROM_KEYMAP_OVERRIDES_OFFSET);
+}
+
+static uint16_t keycode_at(uint8_t layer, uint8_t pos) {
+    return keycode_at_keymap_location(layer, pos / MATRIX_COLS, pos % MATRIX_COLS);
+}
+
+static uint16_t keycode_default(uint8_t layer, uint8_t pos) {
+    return keycode_at_keymap_location_raw(layer, pos / MATRIX_COLS, pos % MATRIX_COLS);
+}
+
+/**
+ * @brief A keycode other than the position's own
+ */
+static uint16_t custom(uint8_t layer, uint8_t pos) {
+    return keycode_default(layer, pos) ^ 0x5A00;
+}
+
+/**
+ * @brief Send a request and return the status it got
+ */
+static uint8_t request(uint8_t *packet) {
+    packet[0] = HID_CMD_KEYMAP;
+    sim_raw_hid(packet);
+    return packet[1];
+}
+
+/**
+ * @brief Write n keycodes from pos on; returns the status
+ */
+static uint8_t write(uint8_t layer, uint8_t pos, uint8_t n, const uint16_t *keycodes) {
+    uint8_t packet[HID_PACKET_SIZE] = {0, KEYMAP_OVERRIDES_WRITE, layer, pos, n};
+    for (uint8_t i = 0; i < n && i < KEYMAP_OVERRIDES_CHUNK; i++) {
+        packet[5 + 2 * i] = keycodes[i];
+        packet[6 + 2 * i] = keycodes[i] >> 8;
+    }
+    return request(packet);
+}
+
+static uint8_t write_one(uint8_t layer, uint8_t pos, uint16_t keycode) {
+    return write(layer, pos, 1, &keycode);
+}
+
+static uint8_t override_count(void) {
+    uint8_t packet[HID_PACKET_SIZE] = {0, KEYMAP_OVERRIDES_INFO};
+    CHECK_EQ(request(packet), HID_STATUS_OK);
+    return packet[6];
+}
+
+static void reset(void) {
+    uint8_t packet[HID_PACKET_SIZE] = {0, KEYMAP_OVERRIDES_RESET};
+    CHECK_EQ(request(packet), HID_STATUS_OK);
+    sim_scan();
+}
+
+/**
+ * @brief Wait out the quiet time and the flush
+ */
+static void flush(void) {
+    sim_idle(KEYMAP_OVERRIDES_FLUSH_MS + 50);
+}
+
+/**
+ * @brief Whether the stored entries are strictly ascending by (layer, pos)
+ */
+static bool stored_sorted(void) {
+    for (uint8_t i = 1; i < stored()->count; i++) {
+        const keymap_override_t *a = &stored()->entries[i - 1], *b = &stored()->entries[i];
+        if (a->layer > b->layer || (a->layer == b->layer && a->pos >= b->pos)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ==== TESTS ====
+
+static void test_sorted_insert_remove(void) {
+    static const uint8_t order[][2] = {{1, 40}, {0, 50}, {0, 3}, {2, 0}, {0, 4}, {1, 39}};
+
+    reset();
+    for (uint8_t i = 0; i < sizeof(order) / sizeof(order[0]); i++) {
+        CHECK_EQ(write_one(order[i][0], order[i][1], custom(order[i][0], order[i][1])), HID_STATUS_OK);
+    }
+    // A range running over the end of a row, landing among existing entries
+    uint16_t run[4];
+    for (uint8_t i = 0; i < 4; i++) {
+        run[i] = custom(0, MATRIX_COLS - 2 + i);
+    }
+    CHECK_EQ(write(0, MATRIX_COLS - 2, 4, run), HID_STATUS_OK);
+    CHECK_EQ(override_count(), 10);
+
+    flush();
+    CHECK_EQ(stored()->count, 10);
+    CHECK(stored_sorted());
+    for (uint8_t i = 0; i < sizeof(order) / sizeof(order[0]); i++) {
+        CHECK_EQ(keycode_at(order[i][0], order[i][1]), custom(order[i][0], order[i][1]));
+    }
+    CHECK_EQ(keycode_at(0, MATRIX_COLS + 1), custom(0, MATRIX_COLS + 1));
+    CHECK_EQ(keycode_at(0, 5), keycode_default(0, 5));
+    CHECK_EQ(keycode_at(1, 41), keycode_default(1, 41));
+
+    // Changing an override in place keeps the count
+    CHECK_EQ(write_one(0, 50, custom(0, 50) ^ 1), HID_STATUS_OK);
+    CHECK_EQ(override_count(), 10);
+    CHECK_EQ(keycode_at(0, 50), custom(0, 50) ^ 1);
+
+    // Removing from the front, the middle and the back
+    CHECK_EQ(write_one(0, 3, keycode_default(0, 3)), HID_STATUS_OK);
+    CHECK_EQ(write_one(1, 39, keycode_default(1, 39)), HID_STATUS_OK);
+    CHECK_EQ(write_one(2, 0, keycode_default(2, 0)), HID_STATUS_OK);
+    CHECK_EQ(override_count(), 7);
+    flush();
+    CHECK_EQ(stored()->count, 7);
+    CHECK(stored_sorted());
+    CHECK_EQ(keycode_at(0, 4), custom(0, 4));
+    CHECK_EQ(keycode_at(1, 40), custom(1, 40));
+    CHECK_EQ(keycode_at(0, 3), keycode_default(0, 3));
+    CHECK_EQ(keycode_at(2, 0), keycode_default(2, 0));
+}
+
+static void test_revert_to_default(void) {
+    reset();
+    CHECK_EQ(write_one(0, 7, custom(0, 7)), HID_STATUS_OK);
+    CHECK_EQ(override_count(), 1);
+
+    uint8_t packet[HID_PACKET_SIZE] = {0, KEYMAP_OVERRIDES_READ, 0, 6, 3};
+    CHECK_EQ(request(packet), HID_STATUS_OK);
+    CHECK_EQ(packet[3], 0x02);
+    CHECK_EQ(packet[7] | packet[8] << 8, custom(0, 7));
+
+    // Writing the compiled-in keycode drops the override rather than storing it
+    CHECK_EQ(write_one(0, 7, keycode_default(0, 7)), HID_STATUS_OK);
+    CHECK_EQ(override_count(), 0);
+    CHECK_EQ(keycode_at(0, 7), keycode_default(0, 7));
+
+    uint8_t again[HID_PACKET_SIZE] = {0, KEYMAP_OVERRIDES_READ, 0, 6, 3};
+    CHECK_EQ(request(again), HID_STATUS_OK);
+    CHECK_EQ(again[3], 0);
+    CHECK_EQ(again[7] | again[8] << 8, keycode_default(0, 7));
+
+    // Nor does writing it over a position that has none add one
+    CHECK_EQ(write_one(0, 8, keycode_default(0, 8)), HID_STATUS_OK);
+    CHECK_EQ(override_count(), 0);
+    flush();
+    CHECK_EQ(stored()->count, 0);
+}
+
+static void test_capacity(void) {
+    uint16_t keycodes[KEYMAP_OVERRIDES_CHUNK];
+
+    reset();
+    for (uint8_t pos = 0; pos < KEYMAP_OVERRIDES_MAX; pos += KEYMAP_OVERRIDES_CHUNK) {
+        uint8_t n = KEYMAP_OVERRIDES_MAX - pos < KEYMAP_OVERRIDES_CHUNK ? KEYMAP_OVERRIDES_MAX - pos : KEYMAP_OVERRIDES_CHUNK;
+        for (uint8_t i = 0; i < n; i++) {
+            keycodes[i] = custom(1, pos + i);
+        }
+        CHECK_EQ(write(1, pos, n, keycodes), HID_STATUS_OK);
+    }
+    CHECK_EQ(override_count(), KEYMAP_OVERRIDES_MAX);
+
+    // One more is refused, and a refused range changes none of its positions
+    CHECK_EQ(write_one(1, KEYMAP_OVERRIDES_MAX, custom(1, KEYMAP_OVERRIDES_MAX)), HID_STATUS_BAD_ARG);
+    keycodes[0] = custom(1, 0) ^ 1;
+    keycodes[1] = custom(1, KEYMAP_OVERRIDES_MAX);
+    CHECK_EQ(write(1, KEYMAP_OVERRIDES_MAX - 1, 2, keycodes), HID_STATUS_BAD_ARG);
+    CHECK_EQ(override_count(), KEYMAP_OVERRIDES_MAX);
+    CHECK_EQ(keycode_at(1, KEYMAP_OVERRIDES_MAX - 1), custom(1, KEYMAP_OVERRIDES_MAX - 1));
+    CHECK_EQ(keycode_at(1, KEYMAP_OVERRIDES_MAX), keycode_default(1, KEYMAP_OVERRIDES_MAX));
+
+    // The precheck nets removals against additions within one write
+    keycodes[0] = keycode_default(1, KEYMAP_OVERRIDES_MAX - 1);
+    keycodes[1] = custom(1, KEYMAP_OVERRIDES_MAX);
+    CHECK_EQ(write(1, KEYMAP_OVERRIDES_MAX - 1, 2, keycodes), HID_STATUS_OK);
+    CHECK_EQ(override_count(), KEYMAP_OVERRIDES_MAX);
+    CHECK_EQ(keycode_at(1, KEYMAP_OVERRIDES_MAX - 1), keycode_default(1, KEYMAP_OVERRIDES_MAX - 1));
+    CHECK_EQ(keycode_at(1, KEYMAP_OVERRIDES_MAX), custom(1, KEYMAP_OVERRIDES_MAX));
+
+    // And a full list still takes changes to positions it has
+    CHECK_EQ(write_one(1, 0, custom(1, 0) ^ 1), HID_STATUS_OK);
+    CHECK_EQ(keycode_at(1, 0), custom(1, 0) ^ 1);
+
+    // Ranges that don't fit the packet or the matrix
+    CHECK_EQ(write(1, 0, 0, keycodes), HID_STATUS_BAD_ARG);
+    CHECK_EQ(write(1, 0, KEYMAP_OVERRIDES_CHUNK + 1, keycodes), HID_STATUS_BAD_ARG);
+    CHECK_EQ(write(1, POSITIONS - 1, 2, keycodes), HID_STATUS_BAD_ARG);
+    CHECK_EQ(write(keymap_layer_count(), 0, 1, keycodes), HID_STATUS_BAD_ARG);
+
+    flush();
+    CHECK_EQ(stored()->count, KEYMAP_OVERRIDES_MAX);
+    CHECK(stored_sorted());
+}
+
+/**
+ * @brief Store a list of n overrides, as an earlier build might have left it
+ */
+static void store_list(const keymap_override_t *entries, uint8_t n) {
+    memset(stored(), 0, EEPROM_KEYMAP_OVERRIDES_SIZE);
+    stored()->version = KEYMAP_OVERRIDES_VERSION;
+    stored()->rows    = MATRIX_ROWS;
+    stored()->cols    = MATRIX_COLS;
+    stored()->count   = n;
+    memcpy(stored()->entries, entries, n * sizeof(*entries));
+}
+
+/**
+ * @brief Run init on the stored list; true if it was kept
+ */
+static bool init_keeps(void) {
+    keymap_overrides_init();
+    sim_scan();
+    return override_count() != 0;
+}
+
+static void test_init_validation(void) {
+    keymap_override_t list[3] = {
+        {.layer = 0, .pos = 2, .keycode = custom(0, 2)},
+        {.layer = 0, .pos = 9, .keycode = custom(0, 9)},
+        {.layer = 1, .pos = 0, .keycode = custom(1, 0)},
+    };
+
+    reset();
+    store_list(list, 3);
+    CHECK(init_keeps());
+    CHECK_EQ(override_count(), 3);
+    CHECK_EQ(keycode_at(0, 9), custom(0, 9));
+    CHECK_EQ(keycode_at(1, 0), custom(1, 0));
+
+    // Out of order
+    list[1].pos = 1;
+    store_list(list, 3);
+    CHECK(!init_keeps());
+    CHECK_EQ(keycode_at(0, 2), keycode_default(0, 2));
+
+    // The empty list went back to EEPROM, header first
+    CHECK_EQ(stored()->version, KEYMAP_OVERRIDES_VERSION);
+    CHECK_EQ(stored()->count, 0);
+
+    // Duplicate position
+    list[1].pos = 2;
+    store_list(list, 3);
+    CHECK(!init_keeps());
+    list[1].pos = 9;
+
+    // Layer or position out of range
+    list[2].layer = keymap_layer_count();
+    store_list(list, 3);
+    CHECK(!init_keeps());
+    list[2].layer = 1;
+    list[2].pos   = POSITIONS;
+    store_list(list, 3);
+    CHECK(!init_keeps());
+    list[2].pos = 0;
+
+    // Another layout, matrix, or a count past the capacity
+    store_list(list, 3);
+    stored()->version = KEYMAP_OVERRIDES_VERSION + 1;
+    CHECK(!init_keeps());
+    store_list(list, 3);
+    stored()->cols = MATRIX_COLS + 1;
+    CHECK(!init_keeps());
+    store_list(list, 3);
+    stored()->count = KEYMAP_OVERRIDES_MAX + 1;
+    CHECK(!init_keeps());
+
+    // Erased EEPROM
+    memset(stored(), 0xFF, EEPROM_KEYMAP_OVERRIDES_SIZE);
+    CHECK(!init_keeps());
+    CHECK_EQ(stored()->count, 0);
+}
+
+static void test_chunked_flush(void) {
+    const uint8_t  n    = 40;
+    const uint16_t size = offsetof(keymap_overrides_t, entries) + n * sizeof(keymap_override_t);
+    uint16_t       keycodes[KEYMAP_OVERRIDES_CHUNK];
+
+    reset();
+    memset(stored(), 0xAA, EEPROM_KEYMAP_OVERRIDES_SIZE);
+    for (uint8_t pos = 0; pos < n; pos += KEYMAP_OVERRIDES_CHUNK) {
+        uint8_t k = n - pos < KEYMAP_OVERRIDES_CHUNK ? n - pos : KEYMAP_OVERRIDES_CHUNK;
+        for (uint8_t i = 0; i < k; i++) {
+            keycodes[i] = custom(2, pos + i);
+        }
+        CHECK_EQ(write(2, pos, k, keycodes), HID_STATUS_OK);
+    }
+
+    // Nothing until the quiet time is over
+    uint32_t writes = sim_eeprom_writes;
+    sim_idle(KEYMAP_OVERRIDES_FLUSH_MS - 10);
+    CHECK_EQ(sim_eeprom_writes, writes);
+
+    // Then one chunk per scan, never two
+    uint16_t scans = 0;
+    while (stored()->count != n || stored()->entries[n - 1].keycode != custom(2, n - 1)) {
+        uint32_t before = sim_eeprom_writes;
+        sim_scan();
+        CHECK(sim_eeprom_writes - before <= 1);
+        if (++scans > 100) {
+            break;
+        }
+    }
+    sim_idle(10);
+    CHECK_EQ(sim_eeprom_writes - writes, (size + KEYMAP_OVERRIDES_FLUSH_CHUNK - 1) / KEYMAP_OVERRIDES_FLUSH_CHUNK);
+    CHECK(stored_sorted());
+    for (uint8_t i = 0; i < n; i++) {
+        CHECK_EQ(stored()->entries[i].keycode, custom(2, i));
+    }
+
+    // The unused entries were not written
+    CHECK_EQ(((const uint8_t *)stored())[size], 0xAA);
+    CHECK_EQ(((const uint8_t *)stored())[EEPROM_KEYMAP_OVERRIDES_SIZE - 1], 0xAA);
+}
+
+int main(void) {
+    sim_boot(0);
+
+    test_sorted_insert_remove();
+    test_revert_to_default();
+    test_capacity();
+    test_init_validation();
+    test_chunked_flush();
+
+    return test_done("keymap overrides");
+}
@@ -0,0 +1,56 @@
+/**
+ * @file test_leader.c
+ * @brief The leader consumes only the keys typed into its sequence
+ *
+ * A key pressed just before QK_LEAD is often still down when QK_LEAD goes
+ * down, and comes up during the sequence. Its press went to the host, so
+ * its release has to as well, or the host sees it held until it's tapped
+ * again. The keys of the sequence itself go nowhere, releases included.
+ */
+
+#include "sim.h"
+#include "test.h"
+#include "custom_keycodes.h"
+
+static bool key_down(uint16_t n, uint8_t keycode) {
+    return sim_report(n)->keys[keycode / 8] & (1 << (keycode % 8));
+}
+
+static void test_rollover_into_leader(void) {
+    sim_reports_clear();
+    sim_press(KC_X);
+    sim_scan();
+    sim_press(QK_LEAD);
+    sim_scan();
+    sim_release(KC_X);
+    sim_scan();
+    sim_release(QK_LEAD);
+    sim_scan();
+    CHECK(sim_report_count() > 0);
+    CHECK(!key_down(sim_report_count() - 1, KC_X));
+
+    // The sequence is still waiting, and times out with nothing typed
+    sim_idle(LEADER_TIMEOUT + 10);
+    sim_drain(10000);
+    CHECK_STR(sim_typed(), "x");
+    CHECK(!key_down(sim_report_count() - 1, KC_X));
+}
+
+static void test_sequence_consumed(void) {
+    sim_reports_clear();
+    sim_tap(QK_LEAD);
+    sim_tap(KC_T);
+    sim_drain(10000);
+    CHECK(strstr(sim_typed(), "wt.exe") != NULL);
+    CHECK(strchr(sim_typed(), 't') == strstr(sim_typed(), "wt.exe") + 1);
+    CHECK(!key_down(sim_report_count() - 1, KC_T));
+}
+
+int main(void) {
+    sim_boot(0);
+
+    test_rollover_into_leader();
+    test_sequence_consumed();
+
+    return test_done("leader");
+}
@@ -0,0 +1,108 @@
+/**
+ * @file test_macro_recorder.c
+ * @brief Macros survive the trip through EEPROM, and never hold secrets
+ *
+ * A macro is recorded, saved to its EEPROM slot in chunks, read back and
+ * replayed both with its recorded timing and at full speed. A key still
+ * down when recording stopped has its press recorded but not its release,
+ * so the replay has to let go of it at the end. Starting PIN entry drops
+ * a recording, and no recording starts during it.
+ */
+
+#include "sim.h"
+#include "test.h"
+#include "custom_keycodes.h"
+#include "features/eeprom_layout.h"
+#include "features/macro_recorder.h"
+#include "features/secrets_manager.h"
+
+#define GAP_MS 200 // Pause recorded between the keys
+
+static const macro_slot_t *stored(uint8_t slot) {
+    return (const macro_slot_t *)(sim_eeprom + EEPROM_MACROS_OFFSET + slot * EEPROM_MACROS_SLOT_SIZE);
+}
+
+/**
+ * @brief Play slot 0 and return the ms from its first report to its last
+ */
+static uint32_t play(bool fast) {
+    sim_reports_clear();
+    sim_tap(MACRO_PLAY_1);
+    if (fast) {
+        sim_tap(MACRO_PLAY_1);
+    }
+    sim_idle(2 * GAP_MS + 500);
+    CHECK_STR(sim_typed(), "abX");
+
+    // Shift was still down when recording stopped, and is let go of here
+    const sim_report_t *last = sim_report(sim_report_count() - 1);
+    CHECK_EQ(last->mods, 0);
+    for (uint8_t i = 0; i < sizeof(last->keys); i++) {
+        CHECK_EQ(last->keys[i], 0);
+    }
+    return last->time - sim_report(0)->time;
+}
+
+static void test_round_trip(void) {
+    uint32_t writes = sim_eeprom_writes;
+
+    sim_tap(MACRO_REC_1);
+    CHECK(macro_recorder_recording());
+    sim_tap(KC_A);
+    sim_idle(GAP_MS);
+    sim_tap(KC_B);
+    sim_idle(GAP_MS);
+    sim_press(KC_LSFT);
+    sim_scan();
+    sim_tap(KC_X);
+    sim_tap(MACRO_REC_1);
+    sim_release(KC_LSFT);
+    sim_scan();
+    CHECK(!macro_recorder_recording());
+
+    // Saved over the next scans, never in the keypress that stopped it
+    sim_idle(10);
+    CHECK(sim_eeprom_writes > writes);
+    CHECK_EQ(stored(0)->version, MACRO_RECORDER_VERSION);
+    CHECK(stored(0)->length > 0);
+    CHECK(stored(0)->length <= 3 * 6); // Two or three bytes per tap, one per modifier
+
+    uint32_t recorded = play(false);
+    CHECK(recorded >= 2 * GAP_MS - MACRO_RECORDER_TICK_MS);
+    CHECK(recorded <= 2 * GAP_MS + 4 * MACRO_RECORDER_TICK_MS);
+    CHECK(play(true) < 20);
+}
+
+static void test_secret_input_not_recorded(void) {
+    secrets_lock();
+
+    // PIN entry drops the recording, and the slot keeps what it had
+    sim_tap(MACRO_REC_2);
+    sim_type("ab");
+    sim_tap(PIN_ENTRY);
+    CHECK(!macro_recorder_recording());
+    sim_type("24");
+
+    // No recording starts until the PIN is in
+    sim_tap(MACRO_REC_2);
+    CHECK(!macro_recorder_recording());
+    sim_type("68\n");
+    CHECK(is_secrets_unlocked());
+    CHECK(!macro_recorder_recording());
+    sim_idle(10);
+    CHECK_EQ(stored(1)->length, 0);
+
+    sim_reports_clear();
+    sim_tap(MACRO_PLAY_2);
+    sim_idle(100);
+    CHECK_STR(sim_typed(), "");
+}
+
+int main(void) {
+    sim_boot(0);
+
+    test_round_trip();
+    test_secret_input_not_recorded();
+
+    return test_done("macro recorder");
+}
@@ -0,0 +1,176 @@
+/**
+ * @file test_pin.c
+ * @brief PIN and tag digits stay out of everything that keeps typed keys
+ *
+ * PIN entry runs ahead of the key history, leader, snippets, autocorrect
+ * and the macro recorder, so after unlocking nothing in RAM outside the
+ * vault ever saw a digit, and nothing was typed. A macro being recorded is
+ * dropped, never saved, since the digits' releases would still reach it.
+ * Other keys typed between a tag's digits are dropped too.
+ * Nor does the event log tell one PIN length from another.
+ */
+
+#include "sim.h"
+#include "test.h"
+#include "custom_keycodes.h"
+#include "features/event_log.h"
+#include "features/key_history.h"
+#include "features/macro_recorder.h"
+#include "features/secrets_manager.h"
+
+/**
+ * @brief Whether any of the keys in the history is a digit
+ */
+static bool history_has_digit(void) {
+    for (uint8_t n = 0; n < KEY_HISTORY_SIZE; n++) {
+        uint8_t key_class = key_history_class(n);
+        if (key_class >= KEY_HISTORY_CLASS(KC_1) && key_class <= KEY_HISTORY_CLASS(KC_0)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void test_pin_leaves_no_digits(void) {
+    sim_type("abc ");
+    uint16_t reports = sim_report_count();
+
+    sim_tap(PIN_ENTRY);
+    CHECK(is_pin_entry_mode());
+    sim_type("2468");
+    CHECK(!history_has_digit());
+    sim_tap(KC_ENT);
+
+    CHECK(is_secrets_unlocked());
+    CHECK(!is_pin_entry_mode());
+    CHECK(!history_has_digit());
+    CHECK_EQ(key_history_class(0), 0); // Cleared on the way out
+    CHECK_EQ(sim_report_count(), reports);
+}
+
+static void test_cancelled_pin_leaves_no_digits(void) {
+    secrets_lock();
+    uint16_t reports = sim_report_count();
+
+    sim_tap(PIN_ENTRY);
+    sim_type("13");
+    sim_tap(KC_ESC);
+
+    CHECK(!is_pin_entry_mode());
+    CHECK(!is_secrets_unlocked());
+    CHECK(!history_has_digit());
+    CHECK_EQ(sim_report_count(), reports);
+}
+
+static void test_tag_leaves_no_digits(void) {
+    sim_tap(PIN_ENTRY);
+    sim_type("2468\n");
+    CHECK(is_secrets_unlocked());
+
+    sim_reports_clear();
+    sim_tap(SECRET_SELECT);
+    sim_type("42\n");
+    CHECK(!history_has_digit());
+    sim_drain(10000);
+    CHECK_STR(sim_typed(), "tagged forty-two\n");
+    CHECK(!history_has_digit());
+}
+
+static void test_tag_swallows_other_keys(void) {
+    // A stray letter between the digits goes nowhere, and the tag still works
+    sim_reports_clear();
+    sim_tap(SECRET_SELECT);
+    sim_type("4x2");
+    CHECK(is_secret_input_mode());
+    CHECK_EQ(sim_report_count(), 0);
+    sim_type("\n");
+    sim_drain(10000);
+    CHECK_STR(sim_typed(), "tagged forty-two\n");
+
+    // Shift is still let through, and typed nothing by itself
+    sim_reports_clear();
+    sim_tap(SECRET_SELECT);
+    sim_press(KC_LSFT);
+    sim_scan();
+    CHECK(sim_report_count() > 0);
+    sim_release(KC_LSFT);
+    sim_scan();
+    sim_tap(KC_ESC);
+    CHECK(!is_secret_input_mode());
+    CHECK_STR(sim_typed(), "");
+}
+
+static void test_pin_drops_recording(void) {
+    secrets_lock();
+    sim_drain(10000);
+    uint32_t writes = sim_eeprom_writes;
+
+    sim_tap(MACRO_REC_1);
+    sim_type("user");
+    CHECK(macro_recorder_recording());
+    sim_tap(PIN_ENTRY);
+    CHECK(!macro_recorder_recording());
+    sim_type("2468\n");
+    sim_tap(MACRO_REC_1); // Would have stopped and saved it
+    sim_idle(100);
+    CHECK(is_secrets_unlocked());
+    CHECK_EQ(sim_eeprom_writes, writes);
+    CHECK(macro_recorder_recording()); // Pressed after the PIN: a new recording
+    sim_tap(MACRO_REC_1);
+    sim_idle(100);
+}
+
+static void test_no_recording_during_secret_input(void) {
+    secrets_lock();
+    sim_tap(PIN_ENTRY);
+    sim_tap(MACRO_REC_2);
+    CHECK(!macro_recorder_recording());
+    sim_type("2468\n");
+    CHECK(!macro_recorder_recording());
+
+    sim_tap(MACRO_REC_2);
+    sim_type("x");
+    sim_tap(SECRET_SELECT);
+    CHECK(!macro_recorder_recording());
+    sim_tap(MACRO_REC_2);
+    CHECK(!macro_recorder_recording());
+    sim_type("7\n");
+    sim_drain(10000);
+}
+
+/**
+ * @brief Submit a PIN and copy out what it logged at the default level
+ */
+static uint8_t pin_events(const char *pin, event_record_t *out, uint8_t max) {
+    uint16_t cursor = event_log_head;
+    sim_tap(PIN_ENTRY);
+    sim_type(pin);
+    return event_log_read(&cursor, out, max);
+}
+
+static void test_log_leaves_no_length(void) {
+    event_record_t short_pin[8], long_pin[8];
+
+    secrets_lock();
+    uint8_t count = pin_events("13\n", short_pin, 8);
+    CHECK(!is_secrets_unlocked());
+    CHECK_EQ(pin_events("135791\n", long_pin, 8), count);
+    CHECK(!is_secrets_unlocked());
+    for (uint8_t i = 0; i < count; i++) {
+        CHECK_EQ(long_pin[i].id, short_pin[i].id);
+        CHECK_EQ(long_pin[i].a, short_pin[i].a);
+        CHECK_EQ(long_pin[i].b, short_pin[i].b);
+    }
+}
+
+int main(void) {
+    sim_boot(0);
+    test_pin_leaves_no_digits();
+    test_cancelled_pin_leaves_no_digits();
+    test_tag_leaves_no_digits();
+    test_tag_swallows_other_keys();
+    test_pin_drops_recording();
+    test_no_recording_during_secret_input();
+    test_log_leaves_no_length();
+    return test_done("pin");
+}
@@ -0,0 +1,98 @@
+/**
+ * @file test_secrets_hid.c
+ * @brief Raw HID deliveries never reuse a counter an earlier boot sent
+ *
+ * A HELLO recorded on the wire can be replayed to the keyboard after a
+ * reboot, so the companion's nonce alone doesn't keep (counter, nonce)
+ * pairs unique: the counter has to continue from the EEPROM epoch the
+ * earlier boots left, not start over.
+ */
+
+#include "sim.h"
+#include "test.h"
+#include "custom_keycodes.h"
+#include "features/chacha20.h"
+#include "features/hid_protocol.h"
+#include "features/poly1305.h"
+#include "features/secrets_manager.h"
+
+/**
+ * @brief SECRETS_HID_KEY of test/secrets.h, as ChaCha20 key words
+ */
+static void channel_key(uint32_t key[CHACHA20_KEY_WORDS]) {
+    for (uint8_t i = 0; i < CHACHA20_KEY_WORDS; i++) {
+        key[i] = (4 * i) | (4 * i + 1) << 8 | (4 * i + 2) << 16 | (uint32_t)(4 * i + 3) << 24;
+    }
+}
+
+/**
+ * @brief Send the companion's HELLO for this nonce, tagged as
+ *        tools/secrets_companion.py does
+ */
+static void hello(const uint8_t host[SECRETS_HID_NONCE_SIZE]) {
+    uint8_t  packet[HID_PACKET_SIZE] = {HID_CMD_SECRET, SECRETS_HID_HELLO};
+    uint32_t key[CHACHA20_KEY_WORDS], block[CHACHA20_BLOCK_WORDS];
+    uint8_t  poly_key[POLY1305_KEY_SIZE], message[32] = {0}, tag[POLY1305_TAG_SIZE];
+
+    memcpy(packet + 2, host, SECRETS_HID_NONCE_SIZE);
+    const uint32_t nonce[CHACHA20_NONCE_WORDS] = {2, (uint32_t)host[0] << 16 | (uint32_t)host[1] << 24,
+                                                  host[2] | host[3] << 8 | host[4] << 16 | (uint32_t)host[5] << 24};
+    channel_key(key);
+    chacha20_block(key, 0, nonce, block);
+    for (uint8_t i = 0; i < POLY1305_KEY_SIZE; i++) {
+        poly_key[i] = chacha20_byte(block, i);
+    }
+    memcpy(message, packet, 2 + SECRETS_HID_NONCE_SIZE);
+    message[16] = 2 + SECRETS_HID_NONCE_SIZE;
+    poly1305_mac(poly_key, message, sizeof(message), tag);
+    memcpy(packet + 2 + SECRETS_HID_NONCE_SIZE, tag, SECRETS_HID_TAG_SIZE);
+
+    sim_raw_hid(packet);
+    CHECK_EQ(packet[1], HID_STATUS_OK);
+}
+
+/**
+ * @brief Tap a password key and return the counter its first packet carries
+ */
+static uint32_t deliver(void) {
+    uint8_t packet[HID_PACKET_SIZE];
+    sim_tap(E_PASS1);
+    if (!sim_raw_hid_pop(packet)) {
+        CHECK(!"no DELIVER packet");
+        return 0;
+    }
+    CHECK_EQ(packet[2], SECRETS_HID_DELIVER);
+    while (sim_raw_hid_pop(packet + 0)) {
+    }
+
+    // No ACK: the password is typed instead, and the next one can go
+    sim_idle(1000);
+    sim_drain(10000);
+    return packet[4] | packet[5] << 8 | packet[6] << 16 | (uint32_t)packet[7] << 24;
+}
+
+int main(void) {
+    static const uint8_t host[SECRETS_HID_NONCE_SIZE] = {1, 2, 3, 4, 5, 6};
+    uint8_t             *epoch                        = sim_eeprom + EEPROM_SECRETS_HID_OFFSET;
+
+    // Earlier boots took epochs up to 41
+    epoch[0] = 1;
+    epoch[1] = 0;
+    epoch[2] = 41;
+
+    sim_boot(0);
+    sim_tap(PIN_ENTRY);
+    sim_type("2468\n");
+    CHECK(is_secrets_unlocked());
+
+    hello(host);
+    CHECK_EQ(deliver(), 42ul << 16 | 1);
+    CHECK_EQ(epoch[1] << 8 | epoch[2], 42);
+
+    // The same HELLO again, in the same boot: the next counter of the epoch
+    hello(host);
+    CHECK_EQ(deliver(), 42ul << 16 | 2);
+    CHECK_EQ(epoch[1] << 8 | epoch[2], 42);
+
+    return test_done("secrets hid");
+}
@@ -0,0 +1,180 @@
+/**
+ * @file test_settings.c
+ * @brief Settings rotate through their slots, and load the newest good one
+ *
+ * settings_init() runs before the first scan, so it has to stay within a
+ * fixed budget: one read of the settings region and no write. Saved
+ * settings go to the slot after the last one with the next sequence
+ * number; loading skips a slot whose checksum fails, and compares sequence
+ * numbers as int8 so the newest slot still wins after they wrap past 255.
+ */
+
+#include "sim.h"
+#include "test.h"
+#include "custom_keycodes.h"
+#include "features/eeprom_layout.h"
+#include "features/sentence_case.h"
+#include "features/settings.h"
+#include <stddef.h>
+
+/**
+ * @brief What settings_init() may cost before the first scan
+ */
+#define LOAD_BUDGET_BYTES  EEPROM_SETTINGS_SIZE
+#define LOAD_BUDGET_WRITES 0
+
+static settings_t *stored(uint8_t slot) {
+    return (settings_t *)(sim_eeprom + EEPROM_SETTINGS_OFFSET + slot * EEPROM_SETTINGS_SLOT_SIZE);
+}
+
+/**
+ * @brief Store s in a slot as settings.c would, checksum and all
+ */
+static void store(uint8_t slot, settings_t s, uint8_t sequence) {
+    const uint8_t *bytes = (const uint8_t *)&s;
+    uint8_t        a = 0x5A, b = 0;
+
+    s.sequence = sequence;
+    s.version  = SETTINGS_VERSION;
+    for (uint8_t i = 0; i < offsetof(settings_t, check); i++) {
+        a += bytes[i];
+        b += a;
+    }
+    s.check       = a ^ b;
+    *stored(slot) = s;
+}
+
+/**
+ * @brief Change a setting and wait for it to be saved
+ */
+static void toggle_and_save(void) {
+    uint8_t sequence = settings_get()->sequence;
+
+    sim_tap(SENTENCE_CASE_TOGGLE);
+    sim_idle(SETTINGS_WRITE_DELAY_MS + 10);
+    CHECK_EQ(settings_get()->sequence, (uint8_t)(sequence + 1));
+}
+
+// ==== TESTS ====
+
+static void test_load_budget(void) {
+    // Every slot valid is the most work a load can have
+    for (uint8_t i = 0; i < EEPROM_SETTINGS_SLOTS; i++) {
+        store(i, *settings_get(), i + 1);
+    }
+    uint32_t reads = sim_eeprom_reads, writes = sim_eeprom_writes;
+    settings_init();
+    CHECK(sim_eeprom_reads - reads <= LOAD_BUDGET_BYTES);
+    CHECK_EQ(sim_eeprom_writes - writes, LOAD_BUDGET_WRITES);
+    CHECK_EQ(settings_get()->sequence, EEPROM_SETTINGS_SLOTS);
+
+    // And a boot with nothing stored does no more
+    memset(sim_eeprom + EEPROM_SETTINGS_OFFSET, 0, EEPROM_SETTINGS_SIZE);
+    reads = sim_eeprom_reads;
+    settings_init();
+    CHECK(sim_eeprom_reads - reads <= LOAD_BUDGET_BYTES);
+    CHECK_EQ(sim_eeprom_writes - writes, LOAD_BUDGET_WRITES);
+}
+
+static void test_rotation(void) {
+    memset(sim_eeprom + EEPROM_SETTINGS_OFFSET, 0, EEPROM_SETTINGS_SIZE);
+    settings_init();
+
+    // One write per change burst, each to the next slot, round and round
+    for (uint8_t n = 1; n <= EEPROM_SETTINGS_SLOTS + 2; n++) {
+        toggle_and_save();
+        uint8_t slot = (n - 1) % EEPROM_SETTINGS_SLOTS;
+        CHECK_EQ(stored(slot)->sequence, n);
+        CHECK_EQ(stored(slot)->flags & SETTINGS_SENTENCE_CASE, is_sentence_case_on() ? SETTINGS_SENTENCE_CASE : 0);
+    }
+
+    // A burst of changes within the delay is one write
+    sim_tap(SENTENCE_CASE_TOGGLE);
+    sim_idle(100);
+    sim_tap(SENTENCE_CASE_TOGGLE);
+    sim_idle(100);
+    sim_tap(SENTENCE_CASE_TOGGLE);
+    sim_idle(SETTINGS_WRITE_DELAY_MS + 10);
+    CHECK_EQ(settings_get()->sequence, EEPROM_SETTINGS_SLOTS + 3);
+    CHECK_EQ(stored(3)->sequence, 4);
+    CHECK_EQ(stored(2)->sequence, EEPROM_SETTINGS_SLOTS + 3);
+}
+
+static void test_corrupted_slot(void) {
+    memset(sim_eeprom + EEPROM_SETTINGS_OFFSET, 0, EEPROM_SETTINGS_SIZE);
+    settings_init();
+    toggle_and_save();
+    bool older = is_sentence_case_on();
+    toggle_and_save();
+    CHECK_EQ(stored(1)->sequence, 2);
+
+    // A write cut short leaves a slot whose checksum fails
+    stored(1)->flags ^= SETTINGS_SENTENCE_CASE;
+    settings_init();
+    CHECK_EQ(settings_get()->sequence, 1);
+    CHECK_EQ(is_sentence_case_on(), older);
+
+    // An erased slot fails it too
+    memset(stored(1), 0xFF, EEPROM_SETTINGS_SLOT_SIZE);
+    settings_init();
+    CHECK_EQ(settings_get()->sequence, 1);
+
+    // The next save overwrites the bad slot
+    toggle_and_save();
+    CHECK_EQ(stored(1)->sequence, 2);
+    CHECK_EQ(stored(1)->check, settings_get()->check);
+
+    // With every slot bad the features keep what they have
+    memset(sim_eeprom + EEPROM_SETTINGS_OFFSET, 0xFF, EEPROM_SETTINGS_SIZE);
+    bool current = is_sentence_case_on();
+    settings_init();
+    CHECK_EQ(is_sentence_case_on(), current);
+    toggle_and_save();
+    CHECK_EQ(stored(0)->sequence, settings_get()->sequence);
+}
+
+static void test_sequence_wrap(void) {
+    settings_t s = *settings_get();
+
+    // Slots 5, 6, 7 and 0 hold sequences 254, 255, 0 and 1: slot 0 is newest
+    memset(sim_eeprom + EEPROM_SETTINGS_OFFSET, 0, EEPROM_SETTINGS_SIZE);
+    s.flags = 0;
+    store(5, s, 254);
+    store(6, s, 255);
+    store(7, s, 0);
+    s.flags = SETTINGS_SENTENCE_CASE;
+    store(0, s, 1);
+    settings_init();
+    CHECK_EQ(settings_get()->sequence, 1);
+    CHECK(is_sentence_case_on());
+
+    toggle_and_save();
+    CHECK_EQ(stored(1)->sequence, 2);
+
+    // Newest in the middle of the region, the slot after it the oldest
+    memset(sim_eeprom + EEPROM_SETTINGS_OFFSET, 0, EEPROM_SETTINGS_SIZE);
+    s.flags = 0;
+    for (uint8_t i = 0; i < EEPROM_SETTINGS_SLOTS - 1; i++) {
+        store((3 + i) % EEPROM_SETTINGS_SLOTS, s, 250 + i);
+    }
+    s.flags = SETTINGS_SENTENCE_CASE;
+    store(2, s, (uint8_t)(250 + EEPROM_SETTINGS_SLOTS - 1));
+    settings_init();
+    CHECK_EQ(settings_get()->sequence, (uint8_t)(250 + EEPROM_SETTINGS_SLOTS - 1));
+    CHECK(is_sentence_case_on());
+
+    toggle_and_save();
+    CHECK_EQ(stored(3)->sequence, (uint8_t)(250 + EEPROM_SETTINGS_SLOTS));
+}
+
+int main(void) {
+    sim_boot(0);
+    CHECK(sim_eeprom_reads <= EEPROM_USER_DATA_SIZE); // The whole boot reads each region at most once
+
+    test_load_budget();
+    test_rotation();
+    test_corrupted_slot();
+    test_sequence_wrap();
+
+    return test_done("settings");
+}
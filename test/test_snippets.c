@@ -0,0 +1,88 @@
+/**
+ * @file test_snippets.c
+ * @brief Snippets type their text whatever modifiers the trigger left held
+ *
+ * Triggers are matched by key, so "ADDR:" typed with Shift held fires
+ * "addr;". The expansion goes out through the output queue while Shift is
+ * still down, and has to come out as written, both typed one character at
+ * a time and in NKRO bursts.
+ *
+ * Sentence case saw the trigger's keys but not the text, so its states are
+ * rewritten to follow the text: the next sentence starts after it, and
+ * Backspace over it rewinds to what was before the trigger.
+ */
+
+#include "sim.h"
+#include "test.h"
+#include "features/output_queue.h"
+
+#define ADDRESS "221B Baker Street, London NW1 6XE"
+
+static void expand_shifted(bool nkro) {
+    keymap_config.nkro = nkro;
+    sim_reports_clear();
+
+    sim_press(KC_LSFT);
+    sim_scan();
+    sim_type("addr;");
+    sim_drain(10000);
+    CHECK_STR(sim_typed(), ADDRESS);
+
+    // Shift is still held, and still applies to what's typed next
+    sim_tap(KC_A);
+    sim_release(KC_LSFT);
+    sim_scan();
+    CHECK_STR(sim_typed(), ADDRESS "A");
+    sim_drain(10000);
+}
+
+static void test_sentence_after_expansion(void) {
+    // The text ends a sentence its trigger never did
+    sim_reports_clear();
+    sim_type("ok. tyvm;");
+    sim_drain(10000);
+    sim_type(" x");
+    sim_drain(10000);
+    CHECK_STR(sim_typed(), "ok. Thank you very much! X");
+    sim_type("\n");
+}
+
+static void test_backspace_into_trigger(void) {
+    // Over all of "me@example.com": the next letter starts the sentence again
+    sim_reports_clear();
+    sim_type("ok. mail;");
+    sim_drain(10000);
+    sim_type("\b\b\b\b\b\b\b\b\b\b\b\b\b\bx");
+    sim_drain(10000);
+    CHECK_STR(sim_typed(), "ok. X");
+    sim_type("\n");
+}
+
+static void test_trigger_while_busy(void) {
+    // Nothing expands while the queue types, so sentence case follows the
+    // trigger as typed, Backspace included
+    sim_reports_clear();
+    sim_type("ok. ");
+    sim_drain(10000);
+    output_queue_push_taps(KC_NO, 100);
+    sim_type("tyvm;");
+    CHECK(output_queue_busy());
+    sim_type("\b\b\b\b\bx");
+    sim_drain(10000);
+    CHECK_STR(sim_typed(), "ok. X");
+    sim_type("\n");
+}
+
+int main(void) {
+    sim_boot(0);
+
+    expand_shifted(false);
+    expand_shifted(true);
+
+    keymap_config.nkro = false;
+    test_sentence_after_expansion();
+    test_backspace_into_trigger();
+    test_trigger_while_busy();
+
+    return test_done("snippets");
+}
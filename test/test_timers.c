@@ -0,0 +1,90 @@
+/**
+ * @file test_timers.c
+ * @brief Timeouts on the virtual clock, including across timer wraps
+ *
+ * The secrets auto-lock runs for minutes and sentence case's idle timeout
+ * for seconds; both are checked a little before and a little after they
+ * are due, with the 32-bit and 16-bit timers wrapping in between.
+ */
+
+#include "sim.h"
+#include "test.h"
+#include "custom_keycodes.h"
+#include "features/secrets_manager.h"
+#include "features/sentence_case.h"
+
+#define LOCK_TIMEOUT_MS 300000 // features/secrets_manager.c default
+#define SENTENCE_CASE_TIMEOUT 5000 // features/sentence_case.c default
+
+static void unlock(void) {
+    sim_tap(PIN_ENTRY);
+    sim_type("2468\n");
+}
+
+/**
+ * @brief The auto-lock fires after LOCK_TIMEOUT_MS, not at a timer wrap
+ */
+static void test_auto_lock_across_wrap(void) {
+    // Jump to 100 s before the 32-bit timer wraps; the 16-bit one wraps
+    // every 65 s while the lock waits
+    sim_advance(0xFFFFFFFFUL - 100000 - sim_now());
+    sim_scan();
+    unlock();
+    CHECK(is_secrets_unlocked());
+
+    sim_idle(LOCK_TIMEOUT_MS - 1000);
+    CHECK(sim_now() < 0x80000000UL); // Wrapped
+    CHECK(is_secrets_unlocked());
+
+    sim_idle(2000);
+    CHECK(!is_secrets_unlocked());
+}
+
+/**
+ * @brief A wrong PIN leaves the secrets locked, with nothing typed
+ */
+static void test_wrong_pin(void) {
+    uint16_t reports = sim_report_count();
+    sim_tap(PIN_ENTRY);
+    sim_type("1357\n");
+    CHECK(!is_secrets_unlocked());
+    CHECK(!is_pin_entry_mode());
+    CHECK_EQ(sim_report_count(), reports);
+}
+
+/**
+ * @brief Sentence case forgets a sentence ending after its idle timeout,
+ *        with the 16-bit timer wrapping while it waits
+ */
+static void test_sentence_case_timeout(void) {
+    sim_reports_clear();
+    sim_type("end. ");
+    CHECK(is_sentence_case_primed());
+    sim_type("now");
+    CHECK_STR(sim_typed(), "end. Now");
+
+    // Prime 1 s before the 16-bit timer wraps
+    sim_idle((uint16_t)(0xFFFF - 1000 - (uint16_t)sim_now()));
+    sim_reports_clear();
+    sim_type("end. ");
+    CHECK(is_sentence_case_primed());
+
+    sim_idle(SENTENCE_CASE_TIMEOUT - 100);
+    CHECK((uint16_t)sim_now() < 0x8000); // Wrapped
+    CHECK(is_sentence_case_primed());
+
+    sim_idle(200);
+    CHECK(!is_sentence_case_primed());
+    sim_type("later");
+    CHECK_STR(sim_typed(), "end. later");
+}
+
+int main(void) {
+    sim_boot(0);
+    CHECK(is_sentence_case_on());
+
+    test_sentence_case_timeout();
+    test_wrong_pin();
+    test_auto_lock_across_wrap();
+    return test_done("timers");
+}
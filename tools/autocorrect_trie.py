@@ -0,0 +1,216 @@
+#!/usr/bin/env python3
+"""
+Compile autocorrect_dictionary.txt into the PROGMEM trie used by features/autocorrect.c.
+
+Typos are stored reversed, so the firmware walks from the newest key in the
+shared key history backwards. Keys are history classes (features/key_history.h):
+a-z are 1-26, ' is 49 and 0 stands for any word boundary. The trie is a flat
+uint8_t array of nodes, each starting with a byte whose top two bits give
+its type and low six bits a count:
+
+    chain   00LLLLLL  then L classes that must all match, followed directly
+                      by the next node (runs of single-child nodes)
+    branch  01NNNNNN  then N (class, offset low, offset high) entries sorted
+                      by class; offset is the child's index in the array
+    leaf    10BBBBBB  a typo ends here: B backspaces, then the NUL-terminated
+                      text to type
+
+The root is at index 0 and is never a leaf.
+
+Besides the header, this prints the flash the trie costs and the worst-case
+number of comparisons one key press can take. Measured cycles come from the
+autocorrect cycle probe (CYCLE_PROFILE_ENABLE, read with tools/telemetry.py).
+
+Usage:
+    tools/autocorrect_trie.py            # regenerate features/autocorrect_data.h
+    tools/autocorrect_trie.py --check    # exit 1 if the committed header is stale
+"""
+
+import argparse
+import sys
+from pathlib import Path
+
+KEYMAP_DIR = Path(__file__).resolve().parent.parent
+DICTIONARY = KEYMAP_DIR / "autocorrect_dictionary.txt"
+DATA_H = KEYMAP_DIR / "features" / "autocorrect_data.h"
+
+CHAIN, BRANCH, LEAF = 0x00, 0x40, 0x80
+MAX_COUNT = 0x3F
+
+# KEY_HISTORY_CLASS(): KC_A is 1, so KC_QUOT (0x34) is 49
+CLASSES = {c: i + 1 for i, c in enumerate("abcdefghijklmnopqrstuvwxyz")}
+CLASSES["'"] = 0x34 - 0x04 + 1
+CLASSES[":"] = 0
+NAMES = {v: k for k, v in CLASSES.items()}
+CORRECTION_CHARS = set("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ' ")
+
+
+def load_dictionary(path=DICTIONARY):
+    """Returns [(typo, correction)] with the typo still holding its ':' boundaries."""
+    entries = []
+    for number, line in enumerate(Path(path).read_text().splitlines(), 1):
+        line = line.split("#", 1)[0].strip()
+        if not line:
+            continue
+        if "->" not in line:
+            raise ValueError("line {}: expected 'typo -> correction'".format(number))
+        typo, correction = (part.strip() for part in line.split("->", 1))
+        word = typo.strip(":")
+        if not word or ":" in word or any(c not in CLASSES for c in word):
+            raise ValueError("line {}: typo '{}' may only use a-z and ', with ':' at either end".format(number, typo))
+        if not correction or any(c not in CORRECTION_CHARS for c in correction):
+            raise ValueError("line {}: correction '{}' may only use letters, ' and spaces".format(number, correction))
+        entries.append((typo, correction))
+    return entries
+
+
+def check_conflicts(entries):
+    typos = sorted((typo for typo, _ in entries), key=len)
+    for i, short in enumerate(typos):
+        for long in typos[i + 1:]:
+            if short in long:
+                raise ValueError("'{}' contains '{}', which would always fire first".format(long, short))
+        if short in typos[:i]:
+            raise ValueError("typo '{}' listed twice".format(short))
+
+
+def leaf_for(typo, correction):
+    """Returns (backspaces, text to type) for a matched typo."""
+    word = typo.strip(":")
+    # Without a trailing boundary the last letter is the key being pressed,
+    # which the firmware swallows instead of typing
+    typed = word if typo.endswith(":") else word[:-1]
+    common = 0
+    while common < min(len(typed), len(correction)) and typed[common] == correction[common]:
+        common += 1
+    backspaces = len(typed) - common
+    if backspaces > MAX_COUNT:
+        raise ValueError("typo '{}' needs more than {} backspaces".format(typo, MAX_COUNT))
+    return backspaces, correction[common:]
+
+
+def build(entries):
+    """Returns the root of a reversed trie of dicts: {"leaf": (bs, text)|None, "children": {}}."""
+    root = {"leaf": None, "children": {}}
+    for typo, correction in entries:
+        node = root
+        for c in reversed(typo):
+            node = node["children"].setdefault(CLASSES[c], {"leaf": None, "children": {}})
+        node["leaf"] = leaf_for(typo, correction)
+    return root
+
+
+def chain_of(node):
+    """Follows single-child nodes; returns (classes, node after the chain)."""
+    classes = []
+    while node["leaf"] is None and len(node["children"]) == 1 and len(classes) < MAX_COUNT:
+        (c, child), = node["children"].items()
+        classes.append(c)
+        node = child
+    return classes, node
+
+
+def size(node):
+    if node["leaf"] is not None:
+        return 2 + len(node["leaf"][1])
+    classes, tail = chain_of(node)
+    if classes:
+        return 1 + len(classes) + size(tail)
+    return 1 + 3 * len(node["children"]) + sum(size(child) for child in node["children"].values())
+
+
+def serialize(node, base=0, path=""):
+    """Lays the trie out depth first; returns [(path, [bytes])] per node."""
+    if node["leaf"] is not None:
+        backspaces, text = node["leaf"]
+        words = ["0x{:02X}".format(LEAF | backspaces)] + ["'{}'".format("\\'" if c == "'" else c) for c in text] + ["0"]
+        return [(path, words)]
+
+    classes, tail = chain_of(node)
+    if classes:
+        words = ["0x{:02X}".format(CHAIN | len(classes))] + [str(c) for c in classes]
+        rest = serialize(tail, base + len(words), path + "".join(NAMES[c] for c in classes))
+        return [(path, words)] + rest
+
+    children = sorted(node["children"].items())
+    if len(children) > MAX_COUNT:
+        raise ValueError("more than {} typos branch after '{}'".format(MAX_COUNT, path))
+    words = ["0x{:02X}".format(BRANCH | len(children))]
+    offset, out = base + 1 + 3 * len(children), []
+    for c, child in children:
+        words += [str(c), str(offset & 0xFF), str(offset >> 8)]
+        out += serialize(child, offset, path + NAMES[c])
+        offset += size(child)
+    return [(path, words)] + out
+
+
+def worst_case(node):
+    """Most class comparisons a single walk of the firmware can make."""
+    if node["leaf"] is not None:
+        return 0
+    classes, tail = chain_of(node)
+    if classes:
+        return len(classes) + worst_case(tail)
+    children = sorted(node["children"].items())
+    return max(i + 1 + worst_case(child) for i, (_, child) in enumerate(children))
+
+
+def render(entries):
+    check_conflicts(entries)
+    root = build(entries)
+    nodes = serialize(root)
+    total = size(root)
+    depth = max(len(typo) for typo, _ in entries)
+    stats = {
+        "typos": len(entries),
+        "bytes": total,
+        "max_typo_len": depth,
+        "worst_case": worst_case(root),
+    }
+    lines = [
+        "// Generated by tools/autocorrect_trie.py from autocorrect_dictionary.txt - do not edit.",
+        "// Layout is described in tools/autocorrect_trie.py. Paths read newest key first.",
+        "",
+        "#pragma once",
+        "",
+        "#define AUTOCORRECT_TYPOS {}".format(stats["typos"]),
+        "#define AUTOCORRECT_MAX_TYPO_LEN {}".format(depth),
+        "#define AUTOCORRECT_WORST_CASE_STEPS {}".format(stats["worst_case"]),
+        "#define AUTOCORRECT_TRIE_SIZE {}".format(total),
+        "",
+        "static const uint8_t autocorrect_trie[AUTOCORRECT_TRIE_SIZE] PROGMEM = {",
+    ]
+    for path, words in nodes:
+        lines.append("    /* {:<{}} */ {},".format("'{}'".format(path) if path else "root", depth + 2, ", ".join(words)))
+    lines.append("};")
+    return "\n".join(lines) + "\n", stats
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("--check", action="store_true", help="fail if the header is out of date")
+    parser.add_argument("--dictionary", type=Path, default=DICTIONARY)
+    parser.add_argument("--output", type=Path, default=DATA_H)
+    args = parser.parse_args()
+
+    try:
+        text, stats = render(load_dictionary(args.dictionary))
+    except ValueError as e:
+        print("error: {}".format(e), file=sys.stderr)
+        return 1
+
+    if args.check:
+        if not args.output.exists() or args.output.read_text() != text:
+            print("{} is stale, run tools/autocorrect_trie.py".format(args.output), file=sys.stderr)
+            return 1
+        return 0
+
+    args.output.write_text(text)
+    print("wrote {}".format(args.output))
+    print("{typos} typos, {bytes} bytes of flash, longest typo {max_typo_len} keys".format(**stats))
+    print("at most {worst_case} comparisons per key press".format(**stats))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,143 @@
+#!/usr/bin/env python3
+"""
+Turn plain text into a keystroke trace for the host tests in test/.
+
+Each line of the corpus is typed the way someone relying on sentence case
+would type it: a capital right after a sentence ending (. ! or ? then
+spaces) is typed in lower case and left to sentence case, every other
+capital and shifted symbol is typed with Left Shift held, and the line ends
+with Enter. The home row letters are typed as their home row mod keycodes
+from keymap_aliases.h, as the real keyboard sends them.
+
+Typing is made realistic with a seeded random generator, so a trace is
+reproducible:
+
+    --typos P    a letter is mistyped, then fixed with Backspace, with
+                 probability P, and a sentence's first letter with 10 P:
+                 that's where sentence case has to rewind correctly
+    --pause P    after a sentence ending, the typist stops to think with
+                 probability P, for 1 to 8 s (longer than sentence case's
+                 5 s idle timeout about half the time)
+
+Trace format, read by test/bench_sentence_case.c and test/bench_replay.c:
+
+    # comment
+    = the expected text of the next line (ground truth)
+    <ms> down 0x<keycode>
+    <ms> up 0x<keycode>
+
+Times are in ms from the start of the trace.
+
+Usage:
+    tools/corpus_trace.py test/corpus/prose.txt > prose.trace
+    tools/corpus_trace.py corpus.txt --typos 0.05 --pause 0.2 --seed 7 -o corpus.trace
+"""
+
+import argparse
+import random
+import re
+import sys
+from pathlib import Path
+
+from key_stats import layer_names
+from report_decode import KEYS
+
+ALIASES_H = Path(__file__).resolve().parent.parent / "keymap_aliases.h"
+
+KC_BSPC, KC_ENT, KC_LSFT = 0x2A, 0x28, 0xE1
+MODS = {"LCTL": 0x01, "LSFT": 0x02, "LALT": 0x04, "LGUI": 0x08,
+        "RCTL": 0x11, "RSFT": 0x12, "RALT": 0x14, "RGUI": 0x18}
+QK_MOD_TAP, QK_LAYER_TAP = 0x2000, 0x4000
+
+KEY_MS = 90      # Between key presses, about 130 words per minute
+HOLD_MS = 40     # From press to release
+SHIFT_MS = 15    # Shift down before, and up after, the key it shifts
+
+
+def home_row_mods(header=ALIASES_H):
+    """Letter keycode -> its home row mod keycode, from keymap_aliases.h."""
+    layers = {name: number for number, name in layer_names().items()}
+    keys = {}
+    text = Path(header).read_text()
+    for mod, kc in re.findall(r"#define HOME_\w+\s+(\w+)_T\(KC_(\w)\)", text):
+        letter = KEYS[kc.lower()][0]
+        keys[letter] = QK_MOD_TAP | (MODS[mod] & 0x1F) << 8 | letter
+    for layer, kc in re.findall(r"#define HOME_\w+\s+LT\((\w+),\s*KC_(\w)\)", text):
+        letter = KEYS[kc.lower()][0]
+        keys[letter] = QK_LAYER_TAP | (layers[layer] & 0xF) << 8 | letter
+    return keys
+
+
+def sentence_starts(line):
+    """Indexes of the letters that begin a sentence after an ending in line."""
+    return {m.end() for m in re.finditer(r"[.!?]['\")]* +(?=[A-Za-z])", line)}
+
+
+class Trace:
+    def __init__(self, out, home):
+        self.out, self.home, self.time = out, home, 0
+
+    def event(self, down, keycode):
+        self.out.write("{} {} 0x{:04X}\n".format(self.time, "down" if down else "up", keycode))
+
+    def tap(self, keycode, shifted=False):
+        if keycode in self.home:
+            keycode = self.home[keycode]
+        if shifted:
+            self.event(True, KC_LSFT)
+            self.time += SHIFT_MS
+        self.event(True, keycode)
+        self.time += HOLD_MS
+        self.event(False, keycode)
+        if shifted:
+            self.time += SHIFT_MS
+            self.event(False, KC_LSFT)
+        self.time += KEY_MS - HOLD_MS
+
+    def char(self, c, lower=False):
+        keycode, shifted = KEYS[c]
+        self.tap(keycode, shifted and not lower)
+
+
+def convert(text, out, typos, pause, rng):
+    bad = sorted(set(c for c in text if c != "\n" and c not in KEYS))
+    if bad:
+        raise ValueError("no US layout key for {}".format(", ".join(repr(c) for c in bad)))
+
+    trace = Trace(out, home_row_mods())
+    letters = [KEYS[c][0] for c in "abcdefghijklmnopqrstuvwxyz"]
+    for line in text.splitlines():
+        out.write("= {}\n".format(line))
+        starts = sentence_starts(line)
+        for i, c in enumerate(line):
+            if i in starts and rng.random() < pause:
+                trace.time += rng.randint(1000, 8000)
+            if c.isalpha() and rng.random() < typos * (10 if i in starts else 1):
+                trace.tap(rng.choice([kc for kc in letters if kc != KEYS[c][0]]))
+                trace.tap(KC_BSPC)
+            trace.char(c, lower=i in starts)
+        trace.tap(KC_ENT)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("corpus", type=argparse.FileType("r"))
+    parser.add_argument("-o", "--output", type=argparse.FileType("w"), default=sys.stdout)
+    parser.add_argument("--typos", type=float, default=0.02, help="typo rate per letter (default 0.02)")
+    parser.add_argument("--pause", type=float, default=0.1, help="pause rate per sentence (default 0.1)")
+    parser.add_argument("--seed", type=int, default=1)
+    args = parser.parse_args()
+
+    text = args.corpus.read()
+    args.output.write("# tools/corpus_trace.py {} --typos {} --pause {} --seed {}\n".format(
+        Path(args.corpus.name).name, args.typos, args.pause, args.seed))
+    try:
+        convert(text, args.output, args.typos, args.pause, random.Random(args.seed))
+    except ValueError as e:
+        print("error: {}".format(e), file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
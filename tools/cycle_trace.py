@@ -0,0 +1,118 @@
+#!/usr/bin/env python3
+"""
+Dump the slowest key events CYCLE_PROFILE kept, as a replayable trace.
+
+With CYCLE_PROFILE_ENABLE = yes the keyboard keeps its slowest
+process_record_user() calls together with the keycode, modifiers and layer
+they ran under (features/cycle_profile.h). This reads them over raw HID, or
+from the `trace kc=...` lines cycle_profile_print() writes to the debug
+console, and writes them in the trace format of tools/corpus_trace.py, one
+event per second, each preceded by a state line restoring its mods and
+layer:
+
+    # 1: 41230 cycles, 0x0028 down
+    0 state 0x00 0
+    0 down 0x0028
+    40 up 0x0028
+
+A release is replayed after a press of the same key. Events during PIN
+entry or SECRET_SELECT come back as KC_NO and are listed but not replayed. test/bench_replay.c
+then runs the trace through the host build, where the path can be timed,
+stepped through in a debugger or profiled. Paths that depend on what was
+typed before (autocorrect, snippets, PIN entry) only take the same branch
+with that context; replay a corpus trace ahead of the dump to provide it.
+
+Usage:
+    tools/cycle_trace.py > worst.trace             # over raw HID
+    tools/cycle_trace.py --console qmk.log         # from a saved `qmk console`
+    tools/cycle_trace.py --loopback                # no keyboard needed
+    test/build/bench/bench_replay worst.trace      # after make -C test bench
+"""
+
+import argparse
+import re
+import sys
+
+import qmkhid
+
+EVENT_MS = 1000  # Between replayed events, so timeouts settle
+HOLD_MS = 40     # From press to release
+
+CONSOLE_LINE = re.compile(r"trace kc=0x([0-9A-Fa-f]+) (down|up) mods=0x([0-9A-Fa-f]+) "
+                          r"layer=(\d+) t=(\d+) cycles=(\d+)")
+
+
+def read_device(device):
+    """Reads the slowest events, slowest first, as (cycles, keycode, time, mods, layer, pressed)."""
+    events, count = [], 1
+    while len(events) < count:
+        payload = device.request(qmkhid.HID_CMD_CYCLE_TRACE, [len(events)])
+        count, n = payload[0], payload[2]
+        if n == 0:
+            break
+        for i in range(n):
+            events.append(qmkhid.CYCLE_EVENT.unpack_from(payload, 3 + qmkhid.CYCLE_EVENT.size * i))
+    return events
+
+
+def read_console(lines):
+    """The same, from cycle_profile_print() output; the last dump wins."""
+    events = []
+    for line in lines:
+        m = CONSOLE_LINE.search(line)
+        if not m:
+            continue
+        kc, action, mods, layer, t, cycles = m.groups()
+        event = (int(cycles), int(kc, 16), int(t), int(mods, 16), int(layer), action == "down")
+        if events and event[0] > events[-1][0]:
+            events = []  # Slowest first, so a bigger one starts a new dump
+        events.append(event)
+    return events
+
+
+def write_trace(events, out):
+    out.write("# tools/cycle_trace.py: {} slowest key events\n".format(len(events)))
+    for i, (cycles, keycode, _, mods, layer, pressed) in enumerate(events):
+        t = i * EVENT_MS
+        if not keycode:
+            # KC_NO: the firmware masks keys typed during PIN entry or SECRET_SELECT
+            out.write("# {}: {} cycles, secret input, not replayed\n".format(i + 1, cycles))
+            continue
+        out.write("# {}: {} cycles, 0x{:04X} {}\n".format(i + 1, cycles, keycode, "down" if pressed else "up"))
+        out.write("{} state 0x{:02X} {}\n".format(t, mods, layer))
+        out.write("{} down 0x{:04X}\n".format(t, keycode))
+        out.write("{} up 0x{:04X}\n".format(t + HOLD_MS, keycode))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("--console", type=argparse.FileType("r"), metavar="LOG",
+                        help="parse cycle_profile_print() lines instead of asking over raw HID")
+    parser.add_argument("-o", "--output", type=argparse.FileType("w"), default=sys.stdout)
+    parser.add_argument("--loopback", action="store_true", help="use the in-process stand-in")
+    parser.add_argument("--vid", type=lambda v: int(v, 16), help="USB vendor id (hex)")
+    parser.add_argument("--pid", type=lambda v: int(v, 16), help="USB product id (hex)")
+    args = parser.parse_args()
+
+    if args.console:
+        events = read_console(args.console)
+    else:
+        try:
+            device = qmkhid.open_device(args.vid, args.pid, loopback=args.loopback)
+            try:
+                events = read_device(device)
+            finally:
+                device.close()
+        except (qmkhid.HidError, ImportError) as e:
+            print("error: {}".format(e), file=sys.stderr)
+            return 1
+
+    if not events:
+        print("error: no slow events recorded (CYCLE_PROFILE_ENABLE = yes?)", file=sys.stderr)
+        return 1
+    write_trace(events, args.output)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
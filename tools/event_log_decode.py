@@ -0,0 +1,82 @@
+#!/usr/bin/env python3
+"""
+Decode a raw dump of the keyboard's binary event log into readable text.
+
+The event ids and their format strings are read straight from the
+EVENT_LOG_EVENTS table in features/event_log.h, so the decoder never drifts
+from the firmware. Records are 8 bytes, little-endian:
+
+    uint16 time | uint8 id | uint8 seq | uint16 a | uint16 b
+
+Input is either a binary file (--binary) or text containing hex bytes, such
+as the output of a HID dump tool ("0x1f 0x02 ..." or "1f02...").
+
+Usage:
+    tools/event_log_decode.py dump.txt
+    tools/event_log_decode.py --binary dump.bin
+    some_hid_dump | tools/event_log_decode.py -
+"""
+
+import argparse
+import re
+import struct
+import sys
+from pathlib import Path
+
+KEYMAP_DIR = Path(__file__).resolve().parent.parent
+EVENT_LOG_H = KEYMAP_DIR / "features" / "event_log.h"
+RECORD = struct.Struct("<HBBHH")
+
+EVENT_RE = re.compile(r'_\(\s*(EV_\w+)\s*,\s*"((?:[^"\\]|\\.)*)"\s*\)')
+CONVERSION_RE = re.compile(r"%[-0-9]*[uXxd]")
+
+
+def load_events(header=EVENT_LOG_H):
+    """Returns [(name, format)] indexed by event id."""
+    text = Path(header).read_text()
+    table = text[text.index("#define EVENT_LOG_EVENTS"):]
+    table = table[:table.index("\n\n")]
+    return EVENT_RE.findall(table)
+
+
+def parse_hex(text):
+    text = re.sub(r"0x", "", text, flags=re.IGNORECASE)
+    return bytes.fromhex("".join(re.findall(r"[0-9a-fA-F]{2}", text)))
+
+
+def decode_records(data, events):
+    """Yields one line of text per 8-byte record, flagging sequence gaps."""
+    last_seq = None
+    for offset in range(0, len(data) - RECORD.size + 1, RECORD.size):
+        time, event_id, seq, a, b = RECORD.unpack_from(data, offset)
+        if last_seq is not None and seq != (last_seq + 1) & 0xFF:
+            yield "... {} record(s) lost ...".format((seq - last_seq - 1) & 0xFF)
+        last_seq = seq
+        if event_id < len(events):
+            name, fmt = events[event_id]
+            args = (a, b)[:len(CONVERSION_RE.findall(fmt))]
+            message = fmt % args
+        else:
+            name, message = "EV_{}".format(event_id), "unknown event a={} b={}".format(a, b)
+        yield "t={:>5} #{:<3} {:<18} {}".format(time, seq, name, message)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("dump", help="dump file, or - for stdin")
+    parser.add_argument("--binary", action="store_true", help="dump is raw bytes, not hex text")
+    parser.add_argument("--header", type=Path, default=EVENT_LOG_H, help="event table to decode against")
+    args = parser.parse_args()
+
+    if args.dump == "-":
+        data = sys.stdin.buffer.read() if args.binary else parse_hex(sys.stdin.read())
+    else:
+        data = Path(args.dump).read_bytes() if args.binary else parse_hex(Path(args.dump).read_text())
+
+    for line in decode_records(data, load_events(args.header)):
+        print(line)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
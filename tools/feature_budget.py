@@ -0,0 +1,222 @@
+#!/usr/bin/env python3
+"""
+Per-feature flash and RAM budget report.
+
+Builds the keymap with `qmk compile` (or reuses an existing build), walks the
+GNU ld map file and attributes every input section to the feature whose object
+file it came from. Prints a .text/.rodata/.data/.bss table per feature and
+fails with exit status 1 when a feature exceeds the limits configured in
+tools/feature_budget.json.
+
+With --toggled it instead rebuilds once per rules.mk feature switch (e.g.
+RUN_CMDS_ENABLE=no) and reports how much the whole image shrinks. That also
+covers header-only features and the dispatch code they add to keymap.c.
+
+Usage:
+    tools/feature_budget.py                      # compile, report, check
+    tools/feature_budget.py --map path/to.map    # reuse an existing build
+    tools/feature_budget.py --no-check           # report only
+    tools/feature_budget.py --toggled            # one build per feature switch
+"""
+
+import argparse
+import fnmatch
+import json
+import re
+import subprocess
+import sys
+from collections import defaultdict
+from pathlib import Path
+
+KEYMAP_DIR = Path(__file__).resolve().parent.parent
+DEFAULT_CONFIG = KEYMAP_DIR / "tools" / "feature_budget.json"
+SECTIONS = ("text", "rodata", "data", "bss")
+
+# Input section line, either on one line or with the name wrapped onto its own
+# line when it is long:
+#   .text.foo      0x08001234       0x98 path/to/file.o
+#                  0x08001234       0x98 path/to/file.o
+SECTION_RE = re.compile(r"^ (\.?[\w.$]+|COMMON)?\s+0x([0-9a-f]+)\s+0x([0-9a-f]+)\s+(\S+\.o)\)?$")
+NAME_ONLY_RE = re.compile(r"^ (\.[\w.$]+|COMMON)$")
+
+
+def section_kind(name):
+    """Maps an input section name to one of SECTIONS, or None to ignore it."""
+    if name == "COMMON":
+        return "bss"
+    for kind in SECTIONS:
+        if name == "." + kind or name.startswith("." + kind + "."):
+            return kind
+    return None
+
+
+def parse_map(map_path):
+    """Yields (section name, size, object path) for every placed input section."""
+    pending = None
+    in_memory_map = False
+    with open(map_path) as f:
+        for line in f:
+            line = line.rstrip("\n")
+            if not in_memory_map:
+                # Everything before this header is discarded sections.
+                in_memory_map = line.startswith("Linker script and memory map")
+                continue
+            m = NAME_ONLY_RE.match(line)
+            if m:
+                pending = m.group(1)
+                continue
+            m = SECTION_RE.match(line)
+            if m:
+                name = m.group(1) or pending
+                pending = None
+                if name is None or int(m.group(2), 16) == 0:
+                    continue
+                yield name, int(m.group(3), 16), m.group(4)
+            else:
+                pending = None
+
+
+def feature_of(obj_path, features):
+    for feature, patterns in features.items():
+        if any(fnmatch.fnmatch(obj_path, p) for p in patterns):
+            return feature
+    return None
+
+
+def attribute(map_path, features):
+    """Returns ({feature: {kind: bytes}}, {feature: [(size, symbol)]})."""
+    totals = defaultdict(lambda: dict.fromkeys(SECTIONS, 0))
+    symbols = defaultdict(list)
+    for name, size, obj in parse_map(map_path):
+        kind = section_kind(name)
+        feature = feature_of(obj, features)
+        if kind is None or feature is None:
+            continue
+        totals[feature][kind] += size
+        # With -ffunction-sections/-fdata-sections the section is the symbol.
+        symbol = name.split(".", 2)[-1] if name.count(".") >= 2 else name
+        symbols[feature].append((size, symbol))
+    return totals, symbols
+
+
+def compile_keymap(keyboard, keymap, env):
+    cmd = ["qmk", "compile", "-kb", keyboard, "-km", keymap]
+    for assignment in env:
+        cmd += ["-e", assignment]
+    subprocess.run(cmd, check=True)
+
+
+def find_build_file(keyboard, keymap, suffix):
+    target = "{}_{}".format(keyboard.replace("/", "_"), keymap)
+    qmk_home = subprocess.run(["qmk", "config", "-ro", "user.qmk_home"],
+                              check=True, capture_output=True, text=True)
+    home = Path(qmk_home.stdout.strip().split("=", 1)[-1])
+    return home / ".build" / (target + suffix)
+
+
+def elf_totals(elf_path):
+    """Whole-image section totals from `size -A`."""
+    out = subprocess.run(["arm-none-eabi-size", "-A", str(elf_path)],
+                         check=True, capture_output=True, text=True).stdout
+    totals = dict.fromkeys(SECTIONS, 0)
+    for line in out.splitlines():
+        parts = line.split()
+        if len(parts) >= 2 and parts[1].isdigit():
+            kind = section_kind(parts[0])
+            if kind:
+                totals[kind] += int(parts[1])
+    return totals
+
+
+def print_table(rows, top_symbols, top):
+    header = "{:<18}" + "{:>9}" * (len(SECTIONS) + 2)
+    print(header.format("feature", *SECTIONS, "flash", "ram"))
+    for feature, sizes in rows:
+        flash = sizes["text"] + sizes["rodata"] + sizes["data"]
+        ram = sizes["data"] + sizes["bss"]
+        print(header.format(feature, *(sizes[k] for k in SECTIONS), flash, ram))
+    if top:
+        for feature, _ in rows:
+            largest = sorted(top_symbols.get(feature, ()), reverse=True)[:top]
+            if largest:
+                print("\n{} largest symbols:".format(feature))
+                for size, symbol in largest:
+                    print("  {:>7}  {}".format(size, symbol))
+
+
+def toggled_report(config):
+    """Builds with each feature switched off; returns {feature: {kind: saved}}."""
+    keyboard, keymap = config["keyboard"], config["keymap"]
+    elf = find_build_file(keyboard, keymap, ".elf")
+    compile_keymap(keyboard, keymap, [])
+    baseline = elf_totals(elf)
+    savings = {}
+    for feature, switch in config["toggles"].items():
+        compile_keymap(keyboard, keymap, [switch + "=no"])
+        sizes = elf_totals(elf)
+        savings[feature] = {k: baseline[k] - sizes[k] for k in SECTIONS}
+    return savings
+
+
+def check_limits(totals, limits):
+    """Returns a list of human-readable budget violations."""
+    failures = []
+    for feature, caps in limits.items():
+        sizes = totals.get(feature, dict.fromkeys(SECTIONS, 0))
+        derived = dict(sizes,
+                       flash=sizes["text"] + sizes["rodata"] + sizes["data"],
+                       ram=sizes["data"] + sizes["bss"])
+        for kind, cap in caps.items():
+            if derived[kind] > cap:
+                failures.append("{}: {} is {} bytes, budget {}".format(
+                    feature, kind, derived[kind], cap))
+    return failures
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("--config", type=Path, default=DEFAULT_CONFIG)
+    parser.add_argument("--map", type=Path, help="reuse this map file instead of compiling")
+    parser.add_argument("--elf", type=Path, help="ELF for whole-image totals")
+    parser.add_argument("--top", type=int, default=5, help="largest symbols to list per feature")
+    parser.add_argument("--no-check", action="store_true", help="report only, never fail")
+    parser.add_argument("--toggled", action="store_true",
+                        help="rebuild with each feature switched off and report the savings")
+    args = parser.parse_args()
+
+    config = json.loads(args.config.read_text())
+    features = config["features"]
+
+    if args.toggled:
+        savings = toggled_report(config)
+        print_table(list(savings.items()), {}, 0)
+        compile_keymap(config["keyboard"], config["keymap"], [])  # leave a full build behind
+        if args.no_check:
+            return 0
+        failures = check_limits(savings, config.get("limits", {}))
+        for failure in failures:
+            print("BUDGET EXCEEDED: " + failure, file=sys.stderr)
+        return 1 if failures else 0
+
+    map_path, elf_path = args.map, args.elf
+    if map_path is None:
+        compile_keymap(config["keyboard"], config["keymap"], [])
+        map_path = find_build_file(config["keyboard"], config["keymap"], ".map")
+        elf_path = elf_path or find_build_file(config["keyboard"], config["keymap"], ".elf")
+
+    totals, symbols = attribute(map_path, features)
+    rows = [(f, totals.get(f, dict.fromkeys(SECTIONS, 0))) for f in features]
+    if elf_path:
+        rows.append(("(whole image)", elf_totals(elf_path)))
+    print_table(rows, symbols, args.top)
+
+    if args.no_check:
+        return 0
+    failures = check_limits(totals, config.get("limits", {}))
+    for failure in failures:
+        print("BUDGET EXCEEDED: " + failure, file=sys.stderr)
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,144 @@
+#!/usr/bin/env python3
+"""
+Read the keyboard's keystroke statistics over raw HID.
+
+Prints what features/key_stats.c has counted: the busiest matrix positions,
+presses per layer, rolling and peak WPM, and the count and average interval
+of every bigram between home row dual-role keys. Fast home row bigrams are
+where mod-taps misfire, so the bigram table is the one to read before
+touching TAPPING_TERM.
+
+Needs KEY_STATS_ENABLE = yes in rules.mk and the `hid` package
+(pip install hidapi). --loopback talks to an in-process stand-in instead.
+
+Usage:
+    tools/key_stats.py                 # summary
+    tools/key_stats.py --top 20        # more matrix positions
+    tools/key_stats.py --json          # everything, machine readable
+    tools/key_stats.py --clear         # zero the counters on the keyboard
+"""
+
+import argparse
+import json
+import re
+import sys
+from pathlib import Path
+
+import qmkhid
+
+KEYMAP_DIR = Path(__file__).resolve().parent.parent
+LAYERS_H = KEYMAP_DIR / "layers.h"
+KEY_STATS_H = KEYMAP_DIR / "features" / "key_stats.h"
+
+
+def read_blob(device):
+    """Reads key_stats_t in HID-sized chunks, sized from its own header."""
+    data = b""
+    size = qmkhid.KEY_STATS_HEADER.size
+    while len(data) < size:
+        offset = len(data)
+        payload = device.request(qmkhid.HID_CMD_KEY_STATS,
+                                 [qmkhid.KEY_STATS_READ, offset & 0xFF, offset >> 8])
+        if payload[0] == 0:
+            break
+        data += payload[1:1 + payload[0]]
+        if offset == 0:
+            _, rows, cols, layers, home, *_ = qmkhid.KEY_STATS_HEADER.unpack_from(data)
+            size = qmkhid.key_stats_struct(rows, cols, layers, home).size
+    return data[:size]
+
+
+def decode(data):
+    version, rows, cols, layers, home, wpm, peak, presses = qmkhid.KEY_STATS_HEADER.unpack_from(data)
+    values = qmkhid.key_stats_struct(rows, cols, layers, home).unpack_from(data)[8:]
+    matrix, values = values[:rows * cols], values[rows * cols:]
+    layer, values = values[:layers], values[layers:]
+    counts, avg = values[:home * home], values[home * home:]
+    return {
+        "version": version, "rows": rows, "cols": cols,
+        "wpm": wpm, "peak_wpm": peak, "presses": presses,
+        "matrix": [list(matrix[r * cols:(r + 1) * cols]) for r in range(rows)],
+        "layers": list(layer),
+        "bigram_count": [list(counts[i * home:(i + 1) * home]) for i in range(home)],
+        "bigram_ms": [list(avg[i * home:(i + 1) * home]) for i in range(home)],
+    }
+
+
+def layer_names(header=LAYERS_H):
+    names = {}
+    for name, value in re.findall(r"(_\w+)\s*=\s*(\d+)", Path(header).read_text()):
+        names[int(value)] = name
+    return names
+
+
+def home_row_names(header=KEY_STATS_H):
+    text = Path(header).read_text()
+    match = re.search(r"define KEY_STATS_HOME_ROW (.+)", text)
+    return [kc.strip().replace("KC_", "") for kc in match.group(1).split(",")] if match else []
+
+
+def format_stats(stats, top):
+    names = layer_names()
+    home = home_row_names()
+    lines = [
+        "presses      {:>10}".format(stats["presses"]),
+        "wpm          {:>10}   (peak {})".format(stats["wpm"], stats["peak_wpm"]),
+        "",
+        "busiest positions (row, col):",
+    ]
+    positions = sorted(((n, r, c) for r, row in enumerate(stats["matrix"]) for c, n in enumerate(row)),
+                       reverse=True)
+    for n, r, c in positions[:top]:
+        if n:
+            lines.append("  ({:>2}, {:>2}) {:>8}".format(r, c, n))
+
+    lines += ["", "layers:"]
+    total = sum(stats["layers"]) or 1
+    for i, n in enumerate(stats["layers"]):
+        if n:
+            lines.append("  {:<8} {:>8}  {:5.1f}%".format(names.get(i, str(i)), n, 100 * n / total))
+
+    size = len(stats["bigram_count"])
+    if len(home) != size:
+        home = [str(i) for i in range(size)]
+    lines += ["", "home row bigrams, count / avg ms (row = first key):",
+              "      " + "".join("{:>9}".format(h) for h in home)]
+    for i in range(size):
+        cells = []
+        for j in range(size):
+            n = stats["bigram_count"][i][j]
+            cells.append("{:>9}".format("{}/{}".format(n, stats["bigram_ms"][i][j]) if n else "."))
+        lines.append("  {:<4}".format(home[i]) + "".join(cells))
+    return "\n".join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("--top", type=int, default=10, help="matrix positions to list")
+    parser.add_argument("--json", action="store_true", help="dump everything as JSON")
+    parser.add_argument("--clear", action="store_true", help="zero the counters on the keyboard")
+    parser.add_argument("--loopback", action="store_true", help="use the in-process stand-in")
+    parser.add_argument("--vid", type=lambda v: int(v, 16), help="USB vendor id (hex)")
+    parser.add_argument("--pid", type=lambda v: int(v, 16), help="USB product id (hex)")
+    args = parser.parse_args()
+
+    try:
+        device = qmkhid.open_device(args.vid, args.pid, loopback=args.loopback)
+        try:
+            if args.clear:
+                device.request(qmkhid.HID_CMD_KEY_STATS, [qmkhid.KEY_STATS_CLEAR])
+                print("statistics cleared")
+                return 0
+            stats = decode(read_blob(device))
+        finally:
+            device.close()
+    except (qmkhid.HidError, ImportError) as e:
+        print("error: {}".format(e), file=sys.stderr)
+        return 1
+
+    print(json.dumps(stats, indent=2) if args.json else format_stats(stats, args.top))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
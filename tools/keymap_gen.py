@@ -0,0 +1,230 @@
+#!/usr/bin/env python3
+"""
+Generate layers.h and keymaps.h from the layers in keymap.json.
+
+Each layer in keymap.json's "user_keymap" is a name, a one-line brief, a doc
+comment and its keys, one list per physical row of the GMMK2 P96 LAYOUT().
+Layers are numbered densely in file order, so keymaps[] has no empty
+layers in between and later layers take priority, as usual.
+
+Every row must have exactly as many keys as that row of LAYOUT(); anything
+else fails before a file is written.
+
+Besides keymaps[], keymaps.h gets two masks per layer, one bit per LAYOUT()
+key in argument order (bit i of byte i / 8). On this board the i-th key is
+also LED i, so a mask doubles as an LED mask:
+
+    keymap_trans_mask   the key is KC_TRNS / _______ and falls through
+    keymap_led_mask     the key does something on this layer (neither
+                        transparent nor KC_NO / XXXXXXX)
+
+Usage:
+    tools/keymap_gen.py            # regenerate layers.h and keymaps.h
+    tools/keymap_gen.py --check    # exit 1 if either header is stale
+"""
+
+import argparse
+import json
+import re
+import sys
+from pathlib import Path
+
+KEYMAP_DIR = Path(__file__).resolve().parent.parent
+KEYMAP_JSON = KEYMAP_DIR / "keymap.json"
+LAYERS_H = KEYMAP_DIR / "layers.h"
+KEYMAPS_H = KEYMAP_DIR / "keymaps.h"
+
+# Keys per row of the GMMK2 P96 LAYOUT() macro
+LAYOUT_ROWS = (18, 18, 18, 16, 17, 12)
+LAYOUT_KEYS = sum(LAYOUT_ROWS)
+MASK_BYTES = (LAYOUT_KEYS + 7) // 8
+
+TRANSPARENT = {"KC_TRNS", "KC_TRANSPARENT", "_______"}
+NO_KEY = {"KC_NO", "XXXXXXX"}
+NAME_RE = re.compile(r"_[A-Z0-9_]+$")
+KEY_RE = re.compile(r"[A-Za-z_][\w(), ]*$")
+
+HEADER = "// Generated by tools/keymap_gen.py from keymap.json - do not edit."
+
+
+def load_layers(path=KEYMAP_JSON):
+    layers = json.loads(Path(path).read_text(encoding="utf-8"))["user_keymap"]["layers"]
+    if not layers:
+        raise ValueError("no layers")
+
+    seen = set()
+    for layer in layers:
+        name = layer.get("name", "")
+        if not NAME_RE.match(name):
+            raise ValueError("layer name {!r} must look like _NAME".format(name))
+        if name in seen:
+            raise ValueError("layer {} defined twice".format(name))
+        seen.add(name)
+
+        rows = layer["keys"]
+        if len(rows) != len(LAYOUT_ROWS):
+            raise ValueError("{}: {} rows, LAYOUT has {}".format(name, len(rows), len(LAYOUT_ROWS)))
+        for i, (row, expected) in enumerate(zip(rows, LAYOUT_ROWS)):
+            if len(row) != expected:
+                raise ValueError("{}: row {} has {} keys, LAYOUT has {}".format(name, i, len(row), expected))
+            for key in row:
+                if not isinstance(key, str) or not KEY_RE.match(key) or key.count("(") != key.count(")"):
+                    raise ValueError("{}: row {}: bad key {!r}".format(name, i, key))
+    return layers
+
+
+def mask(keys, test):
+    bits = [0] * MASK_BYTES
+    for i, key in enumerate(keys):
+        if test(key):
+            bits[i // 8] |= 1 << (i % 8)
+    return bits
+
+
+def format_mask(bits):
+    return "{" + ", ".join("0x{:02X}".format(b) for b in bits) + "}"
+
+
+def doc_comment(lines, indent=""):
+    out = [indent + "/**"]
+    out += [(indent + " * " + line).rstrip() for line in lines]
+    out.append(indent + " */")
+    return out
+
+
+def render_layers_h(layers):
+    width = max(len(layer["name"]) for layer in layers) + len(" = 99,")
+    lines = [
+        HEADER,
+        "",
+        "/**",
+        " * @file layers.h",
+        " * @brief Layer numbers, and the per-layer key masks from keymaps.h",
+        " *",
+        " * Layers are numbered densely in keymap.json order; a later layer takes",
+        " * priority over an earlier one.",
+        " */",
+        "",
+        "#pragma once",
+        "",
+        "#include <stdint.h>",
+        "",
+        "/**",
+        " * @enum custom_layers",
+        " * @brief Enumeration of all keyboard layers",
+        " */",
+        "enum custom_layers {",
+    ]
+    for i, layer in enumerate(layers):
+        lines.append("    {:<{}} /**< {} */".format("{} = {},".format(layer["name"], i), width, layer["brief"]))
+    lines += [
+        "};",
+        "",
+        "/**",
+        " * @brief Number of layers in keymaps[]",
+        " */",
+        "#define LAYER_COUNT {}".format(len(layers)),
+        "",
+        "/**",
+        " * @brief Keys in LAYOUT(), and bytes in one layer's mask",
+        " */",
+        "#define KEYMAP_LAYOUT_KEYS {}".format(LAYOUT_KEYS),
+        "#define KEYMAP_MASK_BYTES {}".format(MASK_BYTES),
+        "",
+        "/**",
+        " * @brief Per-layer masks, bit i for the i-th LAYOUT() key (LED i)",
+        " *",
+        " * keymap_trans_mask marks KC_TRNS keys, keymap_led_mask keys bound to",
+        " * something on that layer. See tools/keymap_gen.py.",
+        " */",
+        "extern const uint8_t keymap_trans_mask[LAYER_COUNT][KEYMAP_MASK_BYTES];",
+        "extern const uint8_t keymap_led_mask[LAYER_COUNT][KEYMAP_MASK_BYTES];",
+    ]
+    return "\n".join(lines) + "\n"
+
+
+def render_keymaps_h(layers):
+    lines = [
+        HEADER,
+        "",
+        "/**",
+        " * @file keymaps.h",
+        " * @brief Keyboard keymap and layer definitions",
+        " *",
+        " * Edit the layers in keymap.json and run tools/keymap_gen.py; aliases such",
+        " * as the home row mods live in keymap_aliases.h. Included by keymap.c only.",
+        " */",
+        "",
+        "#pragma once",
+        "",
+        "#include QMK_KEYBOARD_H",
+        "#include \"custom_keycodes.h\"",
+        "#include \"layers.h\"",
+        "#include \"keymap_aliases.h\"",
+        "",
+        "const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {",
+    ]
+    for i, layer in enumerate(layers):
+        widths = [max(len(row[c]) for row in layer["keys"] if c < len(row)) + 1 for c in range(max(LAYOUT_ROWS))]
+        lines += doc_comment(layer["doc"], "    ")
+        lines.append("    [{}] = LAYOUT(".format(layer["name"]))
+        for r, row in enumerate(layer["keys"]):
+            last = r == len(layer["keys"]) - 1
+            cells = ["{:<{}}".format(key + ",", widths[c]) for c, key in enumerate(row[:-1])]
+            cells.append(row[-1] + (")" if last else ","))
+            lines.append("        " + " ".join(cells).rstrip())
+        if i != len(layers) - 1:
+            lines[-1] += ","
+            lines.append("")
+    name_width = max(len(layer["name"]) for layer in layers) + 2
+    lines += [
+        "};",
+        "",
+        "_Static_assert(sizeof(keymaps) / sizeof(keymaps[0]) == LAYER_COUNT, \"keymaps.h is stale, run tools/keymap_gen.py\");",
+        "",
+        "const uint8_t PROGMEM keymap_trans_mask[LAYER_COUNT][KEYMAP_MASK_BYTES] = {",
+    ]
+    for layer in layers:
+        keys = [key for row in layer["keys"] for key in row]
+        lines.append("    {:<{}} = {},".format("[{}]".format(layer["name"]), name_width, format_mask(mask(keys, lambda k: k in TRANSPARENT))))
+    lines += [
+        "};",
+        "",
+        "const uint8_t PROGMEM keymap_led_mask[LAYER_COUNT][KEYMAP_MASK_BYTES] = {",
+    ]
+    for layer in layers:
+        keys = [key for row in layer["keys"] for key in row]
+        lines.append("    {:<{}} = {},".format("[{}]".format(layer["name"]), name_width, format_mask(mask(keys, lambda k: k not in TRANSPARENT | NO_KEY))))
+    lines.append("};")
+    return "\n".join(lines) + "\n"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("--check", action="store_true", help="fail if a header is out of date")
+    parser.add_argument("--keymap", type=Path, default=KEYMAP_JSON)
+    parser.add_argument("--layers-h", type=Path, default=LAYERS_H)
+    parser.add_argument("--keymaps-h", type=Path, default=KEYMAPS_H)
+    args = parser.parse_args()
+
+    try:
+        layers = load_layers(args.keymap)
+    except (ValueError, KeyError, TypeError, OSError) as e:
+        print("error: {}".format(e), file=sys.stderr)
+        return 1
+    outputs = [(args.layers_h, render_layers_h(layers)), (args.keymaps_h, render_keymaps_h(layers))]
+
+    if args.check:
+        stale = [path for path, text in outputs if not path.exists() or path.read_text(encoding="utf-8") != text]
+        for path in stale:
+            print("{} is stale, run tools/keymap_gen.py".format(path), file=sys.stderr)
+        return 1 if stale else 0
+
+    for path, text in outputs:
+        path.write_text(text, encoding="utf-8")
+        print("wrote {}".format(path))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
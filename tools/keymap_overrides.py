@@ -0,0 +1,183 @@
+#!/usr/bin/env python3
+"""
+Read and rebind the keyboard's keys over raw HID, without reflashing.
+
+Talks to features/keymap_overrides.c: bindings are read and written in
+chunks of consecutive matrix positions, and the keyboard keeps them in
+EEPROM. Writing a position's compiled-in keycode drops its override.
+
+Keycodes are given as numbers (0x0029) or as basic KC_ names (KC_ESC,
+KC_A, KC_F5, ...); anything fancier is easiest to write as a number.
+
+Needs KEYMAP_OVERRIDES_ENABLE = yes in rules.mk and the `hid` package
+(pip install hidapi). --loopback talks to an in-process stand-in instead.
+
+Usage:
+    tools/keymap_overrides.py                              # list overrides
+    tools/keymap_overrides.py --set 0 3 0 KC_ESC           # layer row col keycode
+    tools/keymap_overrides.py --save overrides.json        # back them up
+    tools/keymap_overrides.py --load overrides.json        # restore in bulk
+    tools/keymap_overrides.py --dump bindings.json          # every binding of every layer
+    tools/keymap_overrides.py --reset                      # back to keymaps.h
+"""
+
+import argparse
+import json
+import struct
+import sys
+from pathlib import Path
+
+import qmkhid
+from key_stats import layer_names
+
+# Basic HID keycodes by name, enough for the usual remaps
+KEYCODES = {"KC_NO": 0x00, "KC_TRNS": 0x01}
+KEYCODES.update({"KC_" + chr(ord("A") + i): 0x04 + i for i in range(26)})
+KEYCODES.update({"KC_{}".format((i + 1) % 10): 0x1E + i for i in range(10)})
+KEYCODES.update({"KC_F{}".format(i + 1): 0x3A + i for i in range(12)})
+KEYCODES.update(zip(
+    ["KC_ENT", "KC_ESC", "KC_BSPC", "KC_TAB", "KC_SPC", "KC_MINS", "KC_EQL", "KC_LBRC",
+     "KC_RBRC", "KC_BSLS", "KC_NUHS", "KC_SCLN", "KC_QUOT", "KC_GRV", "KC_COMM", "KC_DOT",
+     "KC_SLSH", "KC_CAPS"], range(0x28, 0x3A)))
+KEYCODES.update(zip(
+    ["KC_PSCR", "KC_SCRL", "KC_PAUS", "KC_INS", "KC_HOME", "KC_PGUP", "KC_DEL", "KC_END",
+     "KC_PGDN", "KC_RGHT", "KC_LEFT", "KC_DOWN", "KC_UP"], range(0x46, 0x53)))
+KEYCODES.update(zip(
+    ["KC_LCTL", "KC_LSFT", "KC_LALT", "KC_LGUI", "KC_RCTL", "KC_RSFT", "KC_RALT", "KC_RGUI"],
+    range(0xE0, 0xE8)))
+KEYCODE_NAMES = {value: name for name, value in KEYCODES.items()}
+
+
+def parse_keycode(text):
+    if text.upper() in KEYCODES:
+        return KEYCODES[text.upper()]
+    try:
+        keycode = int(text, 0)
+    except ValueError:
+        raise argparse.ArgumentTypeError("unknown keycode {!r}".format(text))
+    if not 0 <= keycode <= 0xFFFF:
+        raise argparse.ArgumentTypeError("keycode {!r} out of range".format(text))
+    return keycode
+
+
+def keycode_name(keycode):
+    return KEYCODE_NAMES.get(keycode, "0x{:04X}".format(keycode))
+
+
+def info(device):
+    layers, rows, cols, capacity, count = device.request(qmkhid.HID_CMD_KEYMAP, [qmkhid.KEYMAP_OVERRIDES_INFO])[:5]
+    return {"layers": layers, "rows": rows, "cols": cols, "capacity": capacity, "count": count}
+
+
+def read_layer(device, layer, positions):
+    """Returns (keycodes, overridden) for every position of a layer."""
+    keycodes, overridden = [], []
+    for pos in range(0, positions, qmkhid.KEYMAP_OVERRIDES_CHUNK):
+        n = min(qmkhid.KEYMAP_OVERRIDES_CHUNK, positions - pos)
+        payload = device.request(qmkhid.HID_CMD_KEYMAP, [qmkhid.KEYMAP_OVERRIDES_READ, layer, pos, n])
+        bits = payload[1] | payload[2] << 8
+        keycodes += struct.unpack_from("<{}H".format(n), payload, 3)
+        overridden += [bool(bits >> i & 1) for i in range(n)]
+    return keycodes, overridden
+
+
+def read_overrides(device, shape):
+    overrides = []
+    for layer in range(shape["layers"]):
+        keycodes, overridden = read_layer(device, layer, shape["rows"] * shape["cols"])
+        for pos, keycode in enumerate(keycodes):
+            if overridden[pos]:
+                row, col = divmod(pos, shape["cols"])
+                overrides.append({"layer": layer, "row": row, "col": col, "keycode": keycode})
+    return overrides
+
+
+def write_overrides(device, shape, overrides):
+    """Writes bindings, one request per run of consecutive positions."""
+    bindings = {}
+    for entry in overrides:
+        layer, row, col = entry["layer"], entry["row"], entry["col"]
+        if layer >= shape["layers"] or row >= shape["rows"] or col >= shape["cols"]:
+            raise qmkhid.HidError("position {}/{}/{} is outside the keymap".format(layer, row, col))
+        bindings[(layer, row * shape["cols"] + col)] = entry["keycode"]
+
+    runs = []
+    for layer, pos in sorted(bindings):
+        run = runs[-1] if runs else None
+        if run and run[0] == layer and run[1] + len(run[2]) == pos and len(run[2]) < qmkhid.KEYMAP_OVERRIDES_CHUNK:
+            run[2].append(bindings[(layer, pos)])
+        else:
+            runs.append((layer, pos, [bindings[(layer, pos)]]))
+
+    count = None
+    for layer, pos, keycodes in runs:
+        payload = device.request(qmkhid.HID_CMD_KEYMAP, [qmkhid.KEYMAP_OVERRIDES_WRITE, layer, pos, len(keycodes)]
+                                 + list(struct.pack("<{}H".format(len(keycodes)), *keycodes)))
+        count = payload[0]
+    return len(runs), count
+
+
+def format_overrides(overrides, shape):
+    names = layer_names()
+    lines = ["{} of {} override slots used".format(len(overrides), shape["capacity"])]
+    for entry in overrides:
+        layer = names.get(entry["layer"], str(entry["layer"]))
+        lines.append("  {:<6} row {:>2} col {:>2}  {}".format(layer, entry["row"], entry["col"],
+                                                           keycode_name(entry["keycode"])))
+    return "\n".join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("--set", nargs=4, action="append", default=[], metavar=("LAYER", "ROW", "COL", "KEYCODE"),
+                        help="bind one position (repeatable)")
+    parser.add_argument("--load", type=Path, help="write the overrides in a --save file")
+    parser.add_argument("--save", type=Path, help="save the current overrides as JSON")
+    parser.add_argument("--dump", type=Path, help="save every binding of every layer as JSON")
+    parser.add_argument("--reset", action="store_true", help="drop every override")
+    parser.add_argument("--loopback", action="store_true", help="use the in-process stand-in")
+    parser.add_argument("--vid", type=lambda v: int(v, 16), help="USB vendor id (hex)")
+    parser.add_argument("--pid", type=lambda v: int(v, 16), help="USB product id (hex)")
+    args = parser.parse_args()
+
+    try:
+        changes = [{"layer": int(layer, 0), "row": int(row, 0), "col": int(col, 0), "keycode": parse_keycode(keycode)}
+                   for layer, row, col, keycode in args.set]
+        if args.load:
+            changes += json.loads(args.load.read_text())["overrides"]
+    except (ValueError, KeyError, TypeError, OSError, argparse.ArgumentTypeError) as e:
+        print("error: {}".format(e), file=sys.stderr)
+        return 1
+
+    try:
+        device = qmkhid.open_device(args.vid, args.pid, loopback=args.loopback)
+        try:
+            shape = info(device)
+            if args.reset:
+                device.request(qmkhid.HID_CMD_KEYMAP, [qmkhid.KEYMAP_OVERRIDES_RESET])
+                print("overrides dropped")
+            if changes:
+                requests, count = write_overrides(device, shape, changes)
+                print("wrote {} binding(s) in {} request(s), {} override(s) stored".format(len(changes), requests, count))
+            if args.dump:
+                positions = shape["rows"] * shape["cols"]
+                layers = [read_layer(device, layer, positions)[0] for layer in range(shape["layers"])]
+                args.dump.write_text(json.dumps({**shape, "keymap": layers}, indent=1) + "\n")
+                print("wrote {}".format(args.dump))
+            overrides = read_overrides(device, shape)
+        finally:
+            device.close()
+    except (qmkhid.HidError, ImportError) as e:
+        print("error: {}".format(e), file=sys.stderr)
+        return 1
+
+    if args.save:
+        args.save.write_text(json.dumps({"overrides": overrides}, indent=1) + "\n")
+        print("wrote {}".format(args.save))
+    if not (changes or args.reset or args.dump or args.save):
+        print(format_overrides(overrides, shape))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
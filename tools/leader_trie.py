@@ -0,0 +1,143 @@
+#!/usr/bin/env python3
+"""
+Compile leader_sequences.h into the PROGMEM trie used by features/leader.c.
+
+The trie is a flat uint16_t array. Each node is:
+
+    header       child count in bits 0-7, LEADER_TRIE_ACTION (0x8000) if a
+                 sequence ends here
+    [action]     keycode to fire, present only with LEADER_TRIE_ACTION
+    key, offset  one pair per child, sorted by key; offset is the child's
+                 index in the array
+
+The root is at index 0. Matching a key scans one node's children, so the
+cost per key depends on the branching at that point, never on how many
+sequences exist.
+
+Usage:
+    tools/leader_trie.py            # regenerate features/leader_trie.h
+    tools/leader_trie.py --check    # exit 1 if the committed header is stale
+"""
+
+import argparse
+import re
+import sys
+from pathlib import Path
+
+KEYMAP_DIR = Path(__file__).resolve().parent.parent
+SEQUENCES_H = KEYMAP_DIR / "leader_sequences.h"
+TRIE_H = KEYMAP_DIR / "features" / "leader_trie.h"
+
+ENTRY_RE = re.compile(r'_\(\s*"([^"]*)"\s*,\s*(\w+)\s*\)')
+ACTION_FLAG = 0x8000
+
+KEYS = {c: "KC_" + c.upper() for c in "abcdefghijklmnopqrstuvwxyz1234567890"}
+KEYS.update({".": "KC_DOT", ",": "KC_COMM", "/": "KC_SLSH", ";": "KC_SCLN", "-": "KC_MINS"})
+# Sort children by HID usage so the firmware could stop scanning early
+ORDER = {kc: i for i, kc in enumerate(
+    [KEYS[c] for c in "abcdefghijklmnopqrstuvwxyz1234567890"]
+    + ["KC_MINS", "KC_SCLN", "KC_COMM", "KC_DOT", "KC_SLSH"])}
+
+
+def load_sequences(path=SEQUENCES_H):
+    text = Path(path).read_text()
+    table = text[text.index("#define LEADER_SEQUENCES"):]
+    return ENTRY_RE.findall(table)
+
+
+def build(sequences):
+    """Returns the root of a trie of dicts: {"action": str|None, "children": {}}."""
+    root = {"action": None, "children": {}}
+    seen = {}
+    for seq, action in sequences:
+        if not seq:
+            raise ValueError("empty sequence for {}".format(action))
+        if seq in seen:
+            raise ValueError("sequence '{}' bound to both {} and {}".format(seq, seen[seq], action))
+        seen[seq] = action
+        node = root
+        for c in seq:
+            if c not in KEYS:
+                raise ValueError("unsupported key '{}' in sequence '{}'".format(c, seq))
+            node = node["children"].setdefault(KEYS[c], {"action": None, "children": {}})
+        node["action"] = action
+    return root
+
+
+def serialize(root):
+    """Lays nodes out breadth first; returns [(prefix, [words])] per node."""
+    order, queue = [], [("", root)]
+    while queue:
+        prefix, node = queue.pop(0)
+        order.append((prefix, node))
+        for kc in sorted(node["children"], key=ORDER.get):
+            queue.append((prefix + kc[3:].lower(), node["children"][kc]))
+
+    offsets, index = {}, 0
+    for prefix, node in order:
+        offsets[id(node)] = index
+        index += 1 + (node["action"] is not None) + 2 * len(node["children"])
+
+    out = []
+    for prefix, node in order:
+        header = len(node["children"])
+        words = []
+        if node["action"] is not None:
+            words.append("0x{:04X}".format(header | ACTION_FLAG))
+            words.append(node["action"])
+        else:
+            words.append("0x{:04X}".format(header))
+        for kc in sorted(node["children"], key=ORDER.get):
+            words += [kc, str(offsets[id(node["children"][kc])])]
+        out.append((prefix, words))
+    return out, index
+
+
+def render(sequences):
+    nodes, size = serialize(build(sequences))
+    depth = max(len(seq) for seq, _ in sequences)
+    lines = [
+        "// Generated by tools/leader_trie.py from leader_sequences.h - do not edit.",
+        "// Layout is described in tools/leader_trie.py.",
+        "",
+        "#pragma once",
+        "",
+        "#define LEADER_TRIE_SEQUENCES {}".format(len(sequences)),
+        "#define LEADER_TRIE_CHARS {}".format(sum(len(seq) for seq, _ in sequences)),
+        "#define LEADER_TRIE_MAX_DEPTH {}".format(depth),
+        "#define LEADER_TRIE_SIZE {}".format(size),
+        "",
+        "static const uint16_t leader_trie[LEADER_TRIE_SIZE] PROGMEM = {",
+    ]
+    for prefix, words in nodes:
+        lines.append("    /* {:<{}} */ {},".format("'{}'".format(prefix) if prefix else "root", depth + 2, ", ".join(words)))
+    lines.append("};")
+    return "\n".join(lines) + "\n"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("--check", action="store_true", help="fail if the header is out of date")
+    parser.add_argument("--sequences", type=Path, default=SEQUENCES_H)
+    parser.add_argument("--output", type=Path, default=TRIE_H)
+    args = parser.parse_args()
+
+    try:
+        text = render(load_sequences(args.sequences))
+    except ValueError as e:
+        print("error: {}".format(e), file=sys.stderr)
+        return 1
+
+    if args.check:
+        if not args.output.exists() or args.output.read_text() != text:
+            print("{} is stale, run tools/leader_trie.py".format(args.output), file=sys.stderr)
+            return 1
+        return 0
+
+    args.output.write_text(text)
+    print("wrote {}".format(args.output))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,324 @@
+#!/usr/bin/env python3
+"""
+Raw HID transport shared by the host tools.
+
+Packets are 32 bytes. A request starts with a command byte; the keyboard
+answers in a packet carrying the command byte, a status byte and a payload.
+The command and status values mirror features/hid_protocol.h.
+
+open_device() finds the keyboard by QMK's raw HID usage page (0xFF60) and
+usage (0x61) using the `hid` package (pip install hidapi). For tests and for
+working on the tools without a keyboard attached, open_device(loopback=True)
+returns a LoopbackDevice that answers in-process the way the firmware does.
+"""
+
+import struct
+import time
+
+PACKET_SIZE = 32
+USAGE_PAGE = 0xFF60
+USAGE = 0x61
+
+# features/hid_protocol.h
+HID_CMD_TELEMETRY = 0x01
+HID_CMD_EVENT_LOG = 0x02
+HID_CMD_KEY_STATS = 0x03
+HID_CMD_SECRET = 0x04
+HID_CMD_KEYMAP = 0x05
+HID_CMD_CYCLE_TRACE = 0x06
+
+# features/key_stats.h
+KEY_STATS_READ = 0
+KEY_STATS_CLEAR = 1
+
+# features/keymap_overrides.h
+KEYMAP_OVERRIDES_INFO = 0
+KEYMAP_OVERRIDES_READ = 1
+KEYMAP_OVERRIDES_WRITE = 2
+KEYMAP_OVERRIDES_RESET = 3
+KEYMAP_OVERRIDES_CHUNK = 13
+
+HID_STATUS_OK = 0x00
+HID_STATUS_UNSUPPORTED = 0x01
+HID_STATUS_BAD_ARG = 0x02
+
+
+class HidError(Exception):
+    pass
+
+
+class HidDevice:
+    """A keyboard's raw HID interface, opened through hidapi."""
+
+    def __init__(self, handle):
+        self._handle = handle
+
+    def request(self, command, args=b"", timeout_ms=500):
+        """Sends one request and returns the response payload (after status)."""
+        self.send(command, args)
+        response = self.receive(timeout_ms)
+        if response is None:
+            raise HidError("no response to command 0x{:02X}".format(command))
+        return check_response(command, response)
+
+    def send(self, command, args=b""):
+        """Sends one packet without waiting for the answer."""
+        packet = bytes([command]) + bytes(args)
+        # hidapi wants a leading report id byte, which QMK does not use
+        self._handle.write(b"\x00" + packet.ljust(PACKET_SIZE, b"\x00"))
+
+    def receive(self, timeout_ms):
+        """Returns the next packet from the keyboard, or None after timeout_ms."""
+        response = bytes(self._handle.read(PACKET_SIZE, timeout_ms))
+        return response if len(response) >= 2 else None
+
+    def close(self):
+        self._handle.close()
+
+
+def check_response(command, response):
+    if response[0] != command:
+        raise HidError("response for 0x{:02X}, expected 0x{:02X}".format(response[0], command))
+    if response[1] == HID_STATUS_UNSUPPORTED:
+        raise HidError("command 0x{:02X} not supported (feature disabled in rules.mk?)".format(command))
+    if response[1] != HID_STATUS_OK:
+        raise HidError("command 0x{:02X} failed with status {}".format(command, response[1]))
+    return response[2:]
+
+
+def open_device(vid=None, pid=None, loopback=False):
+    """Returns the first raw HID interface matching the QMK usage page."""
+    if loopback:
+        return LoopbackDevice()
+
+    import hid
+
+    for info in hid.enumerate(vid or 0, pid or 0):
+        if info["usage_page"] == USAGE_PAGE and info["usage"] == USAGE:
+            handle = hid.device()
+            handle.open_path(info["path"])
+            return HidDevice(handle)
+    raise HidError("no QMK raw HID interface found")
+
+
+# ==== LOOPBACK ====
+
+# Layout of telemetry_block_t in features/telemetry.h, for PROBE_COUNT probes
+TELEMETRY_HEADER = struct.Struct("<BBIHHIIHHHHHHH")
+PROBE_NAMES = ["process_record", "matrix_scan", "rgb_indicators",
+               "sentence_case", "secrets", "virtual_desktop", "heatmap",
+               "autocorrect", "settings_load", "snippets"]
+
+
+def telemetry_struct(probe_count):
+    return struct.Struct(TELEMETRY_HEADER.format + "{0}I{0}I".format(probe_count))
+
+
+# Layout of key_stats_t in features/key_stats.h
+KEY_STATS_HEADER = struct.Struct("<BBBBBBBI")
+
+
+# One slowest-event record of features/cycle_profile.h: cycles, keycode,
+# time, mods, layer, pressed
+CYCLE_EVENT = struct.Struct("<IHHBBB")
+CYCLE_TRACE_PER_PACKET = 2
+
+
+def key_stats_struct(rows, cols, layers, home_keys):
+    return struct.Struct(KEY_STATS_HEADER.format + "{}H{}I{}H{}H".format(
+        rows * cols, layers, home_keys * home_keys, home_keys * home_keys))
+
+
+class LoopbackDevice:
+    """Answers requests in-process with the firmware's packet formats."""
+
+    def __init__(self):
+        self.start = time.monotonic()
+        self.events = []
+        self.event_cursor = 0
+        self.counters = dict(scan_rate=1000, event_rate=6, scans=0, events=0,
+                             queue_depth=0, queue_peak=4, secrets_unlocks=2,
+                             secrets_failures=1, secrets_locks=2,
+                             secrets_auto_locks=1, sentence_caps=17)
+        self.key_stats = self.sample_key_stats()
+        self.outbox = []
+        # Secrets channel stand-in, see press_secret()
+        self.secret_key = None
+        self.secret_hello = None
+        self.secret_counter = 1 << 16 | 1  # Epoch 1: a keyboard's first boot
+        self.secret_pending = None
+        self.typed = []
+        # Keymap overrides stand-in: 12 layers of 8x14, letters on layer 0
+        self.keymap_shape = (12, 8, 14)
+        self.keymap_max = 64
+        self.keymap_overrides = {}
+        # Slowest key events, slowest first: Enter ending a PIN, a snippet
+        # trigger, a VD key under Meta, a shifted letter
+        self.cycle_worst = [(41230, 0x0028, 5120, 0x00, 0, 1),
+                            (18804, 0x0037, 9811, 0x02, 0, 1),
+                            (9120, 0x7E4D, 12044, 0x00, 6, 1),
+                            (3310, 0x0004, 12391, 0x02, 0, 0)]
+
+    def keymap_default(self, layer, pos):
+        return 0x04 + pos % 26 if layer == 0 else 0x01
+
+    @staticmethod
+    def sample_key_stats(rows=8, cols=14, layers=16, home=10):
+        matrix = [(r * 7 + c * 13) % 97 for r in range(rows) for c in range(cols)]
+        layer = [sum(matrix)] + [40, 0, 0, 120] + [0] * 5 + [60, 25] + [0] * (layers - 12)
+        counts = [0 if i == j else (i * 3 + j) % 20 for i in range(home) for j in range(home)]
+        avg = [0 if n == 0 else 90 + (i * 11) % 80 for i, n in enumerate(counts)]
+        return key_stats_struct(rows, cols, layers, home).pack(
+            1, rows, cols, layers, home, 42, 97, sum(matrix), *matrix, *layer, *counts, *avg)
+
+    def log(self, event_id, a=0, b=0):
+        """Appends a record, as EVLOG_WRITE() would on the keyboard."""
+        now = int((time.monotonic() - self.start) * 1000) & 0xFFFF
+        self.events.append(struct.pack("<HBBHH", now, event_id, len(self.events) & 0xFF, a, b))
+
+    def telemetry_block(self):
+        uptime = int((time.monotonic() - self.start) * 1000)
+        c = self.counters
+        probes = len(PROBE_NAMES)
+        return telemetry_struct(probes).pack(
+            1, probes, uptime, c["scan_rate"], c["event_rate"],
+            uptime, uptime // 150, c["queue_depth"], c["queue_peak"],
+            c["secrets_unlocks"], c["secrets_failures"], c["secrets_locks"],
+            c["secrets_auto_locks"], c["sentence_caps"],
+            *([1200] * probes), *([4800] * probes))
+
+    def respond(self, packet):
+        command = packet[0]
+        out = bytearray(PACKET_SIZE)
+        out[0] = command
+        if command == HID_CMD_TELEMETRY:
+            page_size = PACKET_SIZE - 4
+            block = self.telemetry_block()
+            pages = (len(block) + page_size - 1) // page_size
+            if packet[1] >= pages:
+                out[1] = HID_STATUS_BAD_ARG
+            else:
+                chunk = block[packet[1] * page_size:][:page_size]
+                out[2:4] = bytes([packet[1], pages])
+                out[4:4 + len(chunk)] = chunk
+        elif command == HID_CMD_EVENT_LOG:
+            records = self.events[self.event_cursor:self.event_cursor + 3]
+            self.event_cursor += len(records)
+            out[2] = len(records)
+            data = b"".join(records)
+            out[3:3 + len(data)] = data
+        elif command == HID_CMD_KEY_STATS:
+            if packet[1] == KEY_STATS_READ:
+                offset = packet[2] | packet[3] << 8
+                chunk = self.key_stats[offset:][:PACKET_SIZE - 3]
+                out[2] = len(chunk)
+                out[3:3 + len(chunk)] = chunk
+            elif packet[1] == KEY_STATS_CLEAR:
+                header = self.key_stats[:KEY_STATS_HEADER.size - 6]
+                self.key_stats = header + bytes(len(self.key_stats) - len(header))
+            else:
+                out[1] = HID_STATUS_BAD_ARG
+        elif command == HID_CMD_KEYMAP:
+            out[1:] = self.respond_keymap(packet)[1:]
+        elif command == HID_CMD_CYCLE_TRACE:
+            index = packet[1]
+            if index > len(self.cycle_worst):
+                out[1] = HID_STATUS_BAD_ARG
+            else:
+                events = self.cycle_worst[index:index + CYCLE_TRACE_PER_PACKET]
+                out[2:5] = bytes([len(self.cycle_worst), index, len(events)])
+                for i, event in enumerate(events):
+                    CYCLE_EVENT.pack_into(out, 5 + CYCLE_EVENT.size * i, *event)
+        elif command == HID_CMD_SECRET and self.secret_key is not None:
+            out[1:] = self.respond_secret(packet)[1:]
+        else:
+            out[1] = HID_STATUS_UNSUPPORTED
+        return bytes(out)
+
+    def respond_keymap(self, packet):
+        """features/keymap_overrides.c, with the overrides in a dict."""
+        layers, rows, cols = self.keymap_shape
+        op, layer, pos, n = packet[1:5]
+        out = bytearray(PACKET_SIZE)
+        out[0] = packet[0]
+        if op == KEYMAP_OVERRIDES_INFO:
+            out[2:7] = bytes([layers, rows, cols, self.keymap_max, len(self.keymap_overrides)])
+        elif op == KEYMAP_OVERRIDES_RESET:
+            self.keymap_overrides.clear()
+        elif op in (KEYMAP_OVERRIDES_READ, KEYMAP_OVERRIDES_WRITE) \
+                and layer < layers and 0 < n <= KEYMAP_OVERRIDES_CHUNK and pos + n <= rows * cols:
+            if op == KEYMAP_OVERRIDES_WRITE:
+                overrides = dict(self.keymap_overrides)
+                for i, keycode in enumerate(struct.unpack_from("<{}H".format(n), packet, 5)):
+                    if keycode == self.keymap_default(layer, pos + i):
+                        overrides.pop((layer, pos + i), None)
+                    else:
+                        overrides[(layer, pos + i)] = keycode
+                if len(overrides) > self.keymap_max:
+                    out[1] = HID_STATUS_BAD_ARG
+                else:
+                    self.keymap_overrides = overrides
+                    out[2] = len(overrides)
+            else:
+                out[2] = n
+                for i in range(n):
+                    key = (layer, pos + i)
+                    if key in self.keymap_overrides:
+                        out[3 + i // 8] |= 1 << (i % 8)
+                    struct.pack_into("<H", out, 5 + 2 * i,
+                                     self.keymap_overrides.get(key, self.keymap_default(*key)))
+        else:
+            out[1] = HID_STATUS_BAD_ARG
+        return bytes(out)
+
+    def respond_secret(self, packet):
+        """HELLO and ACK handling of features/secrets_manager.c."""
+        import secrets_companion as channel
+
+        op = packet[1]
+        status = HID_STATUS_BAD_ARG
+        if op == channel.HELLO:
+            self.secret_hello = (bytes(packet[2:8]), bytes(packet[8:16]), time.monotonic())
+            status = HID_STATUS_OK
+        elif op == channel.ACK and self.secret_pending:
+            counter, nonce, _ = self.secret_pending
+            expected = channel.ack_packet(self.secret_key, counter, nonce)
+            if packet[:len(expected)] == expected:
+                self.secret_pending = None
+                status = HID_STATUS_OK
+        return bytes([packet[0], status, op]).ljust(PACKET_SIZE, b"\x00")
+
+    def press_secret(self, text):
+        """Acts like pressing a password key: sends text to the companion or types it."""
+        import secrets_companion as channel
+
+        hello = self.secret_hello
+        fresh = hello and time.monotonic() - hello[2] < channel.PRESENCE_S
+        if not fresh or self.secret_pending or len(text) > channel.MAX_LENGTH \
+                or channel.hello_packet(self.secret_key, hello[0])[2:16] != hello[0] + hello[1]:
+            self.typed.append(text)
+            return False
+        self.outbox += channel.seal_secret(self.secret_key, self.secret_counter, hello[0], text)
+        self.secret_pending = (self.secret_counter, hello[0], text)
+        self.secret_counter += 1
+        return True
+
+    def expire_secret(self):
+        """The ACK timeout ran out: type the pending secret as the keyboard would."""
+        if self.secret_pending:
+            self.typed.append(self.secret_pending[2])
+            self.secret_pending = None
+
+    def request(self, command, args=b"", timeout_ms=500):
+        packet = (bytes([command]) + bytes(args)).ljust(PACKET_SIZE, b"\x00")
+        return check_response(command, self.respond(packet))
+
+    def send(self, command, args=b""):
+        packet = (bytes([command]) + bytes(args)).ljust(PACKET_SIZE, b"\x00")
+        self.outbox.append(self.respond(packet))
+
+    def receive(self, timeout_ms):
+        return self.outbox.pop(0) if self.outbox else None
+
+    def close(self):
+        pass
@@ -0,0 +1,170 @@
+#!/usr/bin/env python3
+"""
+Decode a stream of keyboard reports back into the text a host would see.
+
+Reads one report per line as hex bytes, the way usbmon, Wireshark or a
+firmware simulation print them:
+
+    NKRO     modifiers, then the key bitmap (bit n of byte n/8 is keycode n)
+    boot     8 bytes: modifiers, reserved, six keycodes
+
+Like a host, it turns every key that is down in a report but wasn't in the
+one before into a key press: NKRO keys in ascending keycode order, boot keys
+in array order, all with the report's modifiers. Presses are mapped through
+the US layout; Backspace deletes, and keys with Ctrl, Alt or GUI held come
+out as <mods+0xNN> markers.
+
+--simulate packs TEXT the way features/output_queue.c types it in NKRO
+bursts, decodes the result as an NKRO host would see it (in ascending and
+in descending keycode order, as something in between may reorder a
+report's keys) and as a boot-protocol host would, and compares the report
+count with typing one key at a time.
+
+Usage:
+    tools/report_decode.py reports.txt                  # print the typed text
+    tools/report_decode.py reports.txt --expect "hi"    # exit 1 unless it matches
+    tools/report_decode.py --report-id < capture.txt    # drop a leading report ID
+    tools/report_decode.py --simulate "Some text"       # check the burst packing
+"""
+
+import argparse
+import sys
+
+SHIFT = 0x22  # Left or Right Shift
+OTHER_MODS = 0xDD
+BURST_KEYS = 6  # OUTPUT_QUEUE_BURST_KEYS
+KC_BSPC = 0x2A
+
+# US layout: keycode -> (unshifted, shifted)
+LAYOUT = {0x04 + i: (c, c.upper()) for i, c in enumerate("abcdefghijklmnopqrstuvwxyz")}
+LAYOUT.update({0x1E + i: pair for i, pair in enumerate(zip("1234567890", "!@#$%^&*()"))})
+LAYOUT.update({0x28: ("\n", "\n"), 0x2B: ("\t", "\t"), 0x2C: (" ", " ")})
+LAYOUT.update({0x2D + i: pair for i, pair in enumerate(zip("-=[]\\", "_+{}|"))})
+LAYOUT.update({0x33 + i: pair for i, pair in enumerate(zip(";'`,./", ':"~<>?'))})
+# Character -> (keycode, shifted)
+KEYS = {c: (kc, 1) for kc, (_, c) in LAYOUT.items()}
+KEYS.update({c: (kc, 0) for kc, (c, _) in LAYOUT.items()})
+
+
+def parse(line, report_id=False):
+    """Returns (mods, [keycodes in press order]) for one hex report line."""
+    data = bytes.fromhex("".join(line.split()))
+    if report_id:
+        data = data[1:]
+    if not data:
+        raise ValueError("empty report")
+    if len(data) == 8:
+        return data[0], [kc for kc in data[2:] if kc]
+    return data[0], [kc for kc in range(8 * (len(data) - 1)) if data[1 + kc // 8] >> (kc % 8) & 1]
+
+
+def decode(reports):
+    """Text typed by a sequence of (mods, keys) reports."""
+    out, down = [], set()
+    for mods, keys in reports:
+        for kc in keys:
+            if kc in down:
+                continue
+            if mods & OTHER_MODS:
+                out.append("<{:02x}+0x{:02x}>".format(mods, kc))
+            elif kc == KC_BSPC:
+                if out:
+                    out.pop()
+            elif kc in LAYOUT:
+                out.append(LAYOUT[kc][bool(mods & SHIFT)])
+            else:
+                out.append("<0x{:02x}>".format(kc))
+        down = set(keys)
+    return "".join(out)
+
+
+def pack_burst(text, limit=BURST_KEYS):
+    """Reports output_queue.c sends for text with NKRO on: one new key per report."""
+    reports, held, shift, i = [], [], 0, 0
+    while i < len(text):
+        kc, shifted = KEYS[text[i]]
+        if kc in held:
+            # A repeat comes up in a report of its own
+            held, shift = [], 0
+            reports.append((0, []))
+            continue
+        if held and (shifted != shift or len(held) == limit):
+            held = []
+        if not held:
+            shift = shifted
+        held = held + [kc]
+        reports.append((0x02 if shift else 0, held))
+        i += 1
+    if held:
+        reports.append((0, []))
+    return reports
+
+
+def pack_single(text):
+    """Reports send_char() sends for text: Shift and the key each in their own report."""
+    reports = []
+    for c in text:
+        kc, shifted = KEYS[c]
+        mods = 0x02 if shifted else 0
+        if shifted:
+            reports.append((mods, []))
+        reports += [(mods, [kc]), (mods, [])]
+        if shifted:
+            reports.append((0, []))
+    return reports
+
+
+def simulate(text):
+    bad = sorted(set(c for c in text if c not in KEYS))
+    if bad:
+        print("error: no US layout key for {}".format(", ".join(repr(c) for c in bad)), file=sys.stderr)
+        return 1
+
+    burst, single = pack_burst(text), pack_single(text)
+    nkro = decode((mods, sorted(keys)) for mods, keys in burst)
+    reordered = decode((mods, sorted(keys, reverse=True)) for mods, keys in burst)
+    boot = decode(burst) if all(len(keys) <= 6 for _, keys in burst) else None
+    print("{} characters".format(len(text)))
+    print("  one key at a time  {:5} reports".format(len(single)))
+    print("  NKRO bursts        {:5} reports ({:.1f}x fewer)".format(len(burst), len(single) / max(len(burst), 1)))
+
+    failed = False
+    for name, decoded in (("NKRO", nkro), ("reordered", reordered), ("boot", boot), ("single", decode(single))):
+        if decoded != text:
+            print("error: {} decode gives {!r}".format(name, decoded), file=sys.stderr)
+            failed = True
+    return 1 if failed else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("file", nargs="?", type=argparse.FileType("r"), default=sys.stdin)
+    parser.add_argument("--report-id", action="store_true", help="reports start with a report ID byte")
+    parser.add_argument("--expect", metavar="TEXT", help="exit 1 unless the reports type TEXT")
+    parser.add_argument("--simulate", metavar="TEXT", help="pack TEXT into bursts and verify it round trips")
+    args = parser.parse_args()
+
+    if args.simulate is not None:
+        return simulate(args.simulate.encode().decode("unicode_escape"))
+
+    try:
+        reports = [parse(line, args.report_id) for line in args.file if line.strip()]
+    except ValueError as e:
+        print("error: {}".format(e), file=sys.stderr)
+        return 1
+
+    text = decode(reports)
+    if args.expect is not None:
+        expect = args.expect.encode().decode("unicode_escape")
+        if text != expect:
+            print("error: reports type {!r}, expected {!r}".format(text, expect), file=sys.stderr)
+            return 1
+        print("{} reports type the expected {} characters".format(len(reports), len(text)))
+        return 0
+
+    sys.stdout.write(text)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,255 @@
+#!/usr/bin/env python3
+"""
+Receive secrets from the keyboard over raw HID and paste or type them.
+
+With SECRETS_HID_ENABLE = yes, the keyboard sends E_PASS1..E_PASS4 and
+tagged secrets here instead of typing them, as long as this companion is
+running: one or two packets per secret instead of a keystroke per
+character, and nothing for a keylogger or IME to see. If the companion
+stops answering, the keyboard goes back to typing.
+
+Packets are sealed with ChaCha20-Poly1305 (RFC 8439, tag cut to 8 bytes)
+under SECRETS_HID_KEY from secrets.h. The layout is documented with
+enum secrets_hid_op in features/secrets_manager.h:
+
+    companion: [cmd][HELLO][nonce 6][tag 8]            every second
+    keyboard:  [cmd][status][DELIVER][index][counter 4][length][chunk 15][tag 8]
+    companion: [cmd][ACK][counter 4][tag 8]
+
+The companion draws a fresh nonce for every HELLO and accepts a delivery
+sealed under any of its last few nonces, each counter only once.
+
+Needs the `hid` package (pip install hidapi), plus pyperclip for the
+clipboard or pyautogui for --type. --loopback runs a delivery and a typing
+fallback against the in-process stand-in from tools/qmkhid.py.
+
+Usage:
+    tools/secrets_companion.py --new-key       # print a SECRETS_HID_KEY for secrets.h
+    tools/secrets_companion.py                 # put received secrets on the clipboard
+    tools/secrets_companion.py --type          # type them and press Enter instead
+    tools/secrets_companion.py --loopback      # no keyboard needed
+"""
+
+import argparse
+import collections
+import os
+import struct
+import sys
+import time
+from pathlib import Path
+
+import qmkhid
+from secrets_vault import SECRETS_H, chacha20_block, load_hid_key
+
+# features/secrets_manager.h
+HELLO, DELIVER, ACK = 0x00, 0x01, 0x02
+NONCE_SIZE = 6
+TAG_SIZE = 8
+CHUNK = 15
+MAX_PACKETS = 2             # SECRETS_HID_MAX_PACKETS
+MAX_LENGTH = MAX_PACKETS * CHUNK
+PRESENCE_S = 3.0            # SECRETS_HID_PRESENCE_MS
+HELLO_INTERVAL_S = 1.0
+
+# Nonce direction byte, enum secrets_hid_direction in features/secrets_manager.c
+DIR_DELIVER, DIR_ACK, DIR_HELLO = 0, 1, 2
+
+RECENT_NONCES = 4
+
+
+# ==== CRYPTO ====
+
+def poly1305(key, message):
+    r = int.from_bytes(key[:16], "little") & 0x0FFFFFFC0FFFFFFC0FFFFFFC0FFFFFFF
+    s = int.from_bytes(key[16:32], "little")
+    p = (1 << 130) - 5
+    acc = 0
+    for i in range(0, len(message), 16):
+        acc = (acc + int.from_bytes(message[i:i + 16] + b"\x01", "little")) * r % p
+    return ((acc + s) & ((1 << 128) - 1)).to_bytes(16, "little")
+
+
+def packet_nonce(direction, index, counter, host_nonce):
+    return list(struct.unpack("<3I", bytes([direction, index]) + struct.pack("<I", counter) + host_nonce))
+
+
+def pad16(data):
+    return data + bytes(-len(data) % 16)
+
+
+def tag(key, nonce, aad, cipher=b""):
+    """RFC 8439 AEAD tag, cut to TAG_SIZE bytes."""
+    poly_key = struct.pack("<16I", *chacha20_block(key, 0, nonce))[:32]
+    message = pad16(aad) + pad16(cipher) + struct.pack("<QQ", len(aad), len(cipher))
+    return poly1305(poly_key, message)[:TAG_SIZE]
+
+
+def keystream(key, nonce):
+    return struct.pack("<16I", *chacha20_block(key, 1, nonce))
+
+
+# ==== PACKETS ====
+
+def hello_packet(key, host_nonce):
+    head = bytes([qmkhid.HID_CMD_SECRET, HELLO]) + host_nonce
+    return head + tag(key, packet_nonce(DIR_HELLO, 0, 0, host_nonce), head)
+
+
+def ack_packet(key, counter, host_nonce):
+    head = bytes([qmkhid.HID_CMD_SECRET, ACK]) + struct.pack("<I", counter)
+    return head + tag(key, packet_nonce(DIR_ACK, 0, counter, host_nonce), head)
+
+
+def seal_secret(key, counter, host_nonce, text):
+    """The DELIVER packets the keyboard sends for text (used by the loopback stand-in)."""
+    plain = text.encode()
+    packets = []
+    for index in range(max(1, (len(plain) + CHUNK - 1) // CHUNK)):
+        head = bytes([qmkhid.HID_CMD_SECRET, qmkhid.HID_STATUS_OK, DELIVER, index]) \
+            + struct.pack("<I", counter) + bytes([len(plain)])
+        nonce = packet_nonce(DIR_DELIVER, index, counter, host_nonce)
+        chunk = plain[index * CHUNK:][:CHUNK].ljust(CHUNK, b"\x00")
+        cipher = bytes(a ^ b for a, b in zip(chunk, keystream(key, nonce)))
+        packets.append(head + cipher + tag(key, nonce, head, cipher))
+    return packets
+
+
+class Receiver:
+    """Checks and reassembles DELIVER packets."""
+
+    def __init__(self, key):
+        self.key = key
+        self.nonces = collections.deque(maxlen=RECENT_NONCES)
+        self.seen = set()
+        self.partial = {}
+        self.last_hello = None
+
+    def new_nonce(self):
+        nonce = os.urandom(NONCE_SIZE)
+        self.nonces.append(nonce)
+        return nonce
+
+    def open(self, packet):
+        """Returns (host nonce, plaintext chunk) if the packet is genuine, else None."""
+        head, cipher, packet_tag = packet[:9], packet[9:9 + CHUNK], packet[9 + CHUNK:9 + CHUNK + TAG_SIZE]
+        index, counter = packet[3], struct.unpack_from("<I", packet, 4)[0]
+        for host_nonce in reversed(self.nonces):
+            nonce = packet_nonce(DIR_DELIVER, index, counter, host_nonce)
+            if tag(self.key, nonce, head, cipher) == packet_tag:
+                return host_nonce, bytes(a ^ b for a, b in zip(cipher, keystream(self.key, nonce)))
+        return None
+
+    def feed(self, packet):
+        """Returns (counter, host nonce, secret) once a whole secret is in, else None."""
+        opened = self.open(packet)
+        if opened is None:
+            return None
+        host_nonce, chunk = opened
+        index, counter, length = packet[3], struct.unpack_from("<I", packet, 4)[0], packet[8]
+        if (host_nonce, counter) in self.seen:
+            return None  # Replayed
+        chunks = self.partial.setdefault((host_nonce, counter), {})
+        chunks[index] = chunk
+        needed = max(1, (length + CHUNK - 1) // CHUNK)
+        if len(chunks) < needed:
+            return None
+        del self.partial[(host_nonce, counter)]
+        self.seen.add((host_nonce, counter))
+        secret = b"".join(chunks[i] for i in range(needed))[:length]
+        return counter, host_nonce, secret.decode()
+
+
+# ==== DELIVERY ====
+
+def clipboard_sink(secret):
+    import pyperclip
+
+    pyperclip.copy(secret)
+    print("secret copied to the clipboard")
+
+
+def type_sink(secret):
+    import pyautogui
+
+    pyautogui.write(secret)
+    pyautogui.press("enter")
+
+
+def serve(device, receiver, sink, rounds=None):
+    """Sends HELLOs and hands every secret received to sink; rounds limits the loop for tests."""
+    key = receiver.key
+    while rounds is None or rounds > 0:
+        if receiver.last_hello is None or time.monotonic() - receiver.last_hello >= HELLO_INTERVAL_S:
+            device.send(qmkhid.HID_CMD_SECRET, hello_packet(key, receiver.new_nonce())[1:])
+            receiver.last_hello = time.monotonic()
+        packet = device.receive(100)
+        if rounds is not None:
+            rounds -= 1
+        if packet is None or packet[0] != qmkhid.HID_CMD_SECRET:
+            continue
+        if packet[2] == DELIVER:
+            received = receiver.feed(packet)
+            if received:
+                counter, host_nonce, secret = received
+                # ACK first: the keyboard types the secret itself if this is late
+                device.send(qmkhid.HID_CMD_SECRET, ack_packet(key, counter, host_nonce)[1:])
+                sink(secret)
+        elif packet[1] != qmkhid.HID_STATUS_OK:
+            print("keyboard rejected {} (status {})".format("HELLO" if packet[2] == HELLO else "ACK", packet[1]),
+                  file=sys.stderr)
+
+
+def loopback_demo(key):
+    """One delivery through the companion, then one typed fallback with it gone."""
+    device = qmkhid.open_device(loopback=True)
+    device.secret_key = key
+    receiver = Receiver(key)
+    received = []
+
+    serve(device, receiver, received.append, rounds=1)  # HELLO
+    device.press_secret("correct horse battery staple")
+    serve(device, receiver, received.append, rounds=3)  # DELIVER x2, ACK answer
+    print("companion received: {}".format(received))
+    print("keyboard typed:     {}".format(device.typed))
+
+    device.secret_hello = None                          # Companion gone
+    device.press_secret("typed instead")
+    device.expire_secret()
+    print("with no companion, keyboard typed: {}".format(device.typed))
+    return 0 if received == ["correct horse battery staple"] and device.typed == ["typed instead"] else 1
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("--new-key", action="store_true", help="print a fresh SECRETS_HID_KEY")
+    parser.add_argument("--type", action="store_true", help="type secrets and press Enter instead of copying them")
+    parser.add_argument("--loopback", action="store_true", help="talk to an in-process stand-in")
+    parser.add_argument("--secrets", type=Path, default=SECRETS_H)
+    args = parser.parse_args()
+
+    if args.new_key:
+        print('#define SECRETS_HID_KEY "{}"'.format(os.urandom(32).hex()))
+        return 0
+
+    try:
+        key = load_hid_key(args.secrets)
+    except (OSError, ValueError) as e:
+        if not args.loopback:
+            print("error: {}".format(e), file=sys.stderr)
+            return 1
+        key = None
+    if args.loopback:
+        return loopback_demo(key or list(struct.unpack("<8I", os.urandom(32))))
+    if key is None:
+        print("error: {} has no SECRETS_HID_KEY (make one with --new-key)".format(args.secrets), file=sys.stderr)
+        return 1
+
+    try:
+        serve(qmkhid.open_device(), Receiver(key), type_sink if args.type else clipboard_sink)
+    except KeyboardInterrupt:
+        pass
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
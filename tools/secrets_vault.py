@@ -0,0 +1,277 @@
+#!/usr/bin/env python3
+"""
+Encrypt the secrets in secrets.h into secrets_vault.h for features/secrets_manager.c.
+
+The firmware never sees the plaintext: secrets_vault.h holds only a random
+salt, a key check value and the ChaCha20 ciphertext of every secret, and the
+key is derived from the PIN as it is typed. Both secrets.h and the vault are
+gitignored; regenerate the vault whenever secrets.h changes (a fresh salt is
+drawn every time).
+
+Key derivation, with block(key, counter, nonce) the ChaCha20 block function
+and nonces written as (domain, value, 0):
+
+    s = salt
+    for each PIN digit d:   s = block(s, 0, (1, d, 0)) words 0-7
+    vault key = block(s, 0, (2, 0, 0)) words 0-7
+    check     = block(s, 0, (2, 0, 0)) words 8-11
+
+The firmware folds each digit into s as it is typed and keeps no digits,
+so Enter only has the last block and the check left to do.
+
+Secret i is XORed with the keystream block(vault key, n, (0, i, 0)) for
+n = 0, 1, ..., so the firmware can decrypt any character from its position
+alone, one 64-byte block at a time.
+
+Entries are SECRETS_LIST first, one per secret keycode (E_PIN..E_PASS4), then
+the optional SECRETS_TAGGED list sorted by tag. vault_tags holds just the
+sorted tags, so the firmware finds the secret for a typed tag by binary
+search straight from flash: the lookup costs O(log n) reads and no RAM
+however large the vault grows.
+
+If secrets.h defines SECRETS_HID_KEY (64 hex digits, see
+tools/secrets_companion.py --new-key), the key for the raw HID channel is
+stored too, XORed with block(vault key, 0, (3, 0, 0)) words 0-7, so the
+firmware can only read it while unlocked.
+
+Nothing here makes a short PIN strong: anyone with a flash dump can try
+every PIN offline against the check value, so the vault is only as good as
+the PIN's entropy. It does keep the secrets out of a casual dump.
+
+Usage:
+    tools/secrets_vault.py            # regenerate secrets_vault.h from secrets.h
+    tools/secrets_vault.py --check    # exit 1 if the vault doesn't match secrets.h
+"""
+
+import argparse
+import ast
+import os
+import re
+import struct
+import sys
+from pathlib import Path
+
+KEYMAP_DIR = Path(__file__).resolve().parent.parent
+SECRETS_H = KEYMAP_DIR / "secrets.h"
+VAULT_H = KEYMAP_DIR / "secrets_vault.h"
+
+PIN_NAME = "SECRET_PIN"
+MAX_PIN_LENGTH = 31
+MAX_TAG = 9999      # VAULT_TAG_DIGITS in features/secrets_manager.c
+MAX_DATA = 0xFFFF   # vault_offsets are uint16_t
+
+# Nonce domains, as VAULT_NONCE_* in features/secrets_manager.c
+NONCE_DATA, NONCE_DIGIT, NONCE_KEY, NONCE_HID = 0, 1, 2, 3
+
+ENTRY_RE = re.compile(r'_\(\s*(\w+)\s*,\s*("(?:[^"\\\n]|\\.)*")\s*\)')
+MACRO_RE = r"#define\s+{}\(_\)((?:[^\n]*\\\n)*[^\n]*)"
+HID_KEY_RE = re.compile(r'#define\s+SECRETS_HID_KEY\s+"([^"]*)"')
+
+
+def rotl(v, n):
+    return ((v << n) | (v >> (32 - n))) & 0xFFFFFFFF
+
+
+def chacha20_block(key, counter, nonce):
+    """RFC 8439 block function on lists of words; returns 16 words."""
+    state = [0x61707865, 0x3320646E, 0x79622D32, 0x6B206574] + list(key) + [counter] + list(nonce)
+    x = list(state)
+
+    def quarter_round(a, b, c, d):
+        x[a] = (x[a] + x[b]) & 0xFFFFFFFF
+        x[d] = rotl(x[d] ^ x[a], 16)
+        x[c] = (x[c] + x[d]) & 0xFFFFFFFF
+        x[b] = rotl(x[b] ^ x[c], 12)
+        x[a] = (x[a] + x[b]) & 0xFFFFFFFF
+        x[d] = rotl(x[d] ^ x[a], 8)
+        x[c] = (x[c] + x[d]) & 0xFFFFFFFF
+        x[b] = rotl(x[b] ^ x[c], 7)
+
+    for _ in range(10):
+        quarter_round(0, 4, 8, 12)
+        quarter_round(1, 5, 9, 13)
+        quarter_round(2, 6, 10, 14)
+        quarter_round(3, 7, 11, 15)
+        quarter_round(0, 5, 10, 15)
+        quarter_round(1, 6, 11, 12)
+        quarter_round(2, 7, 8, 13)
+        quarter_round(3, 4, 9, 14)
+    return [(a + b) & 0xFFFFFFFF for a, b in zip(x, state)]
+
+
+def keystream(key, entry, length):
+    out = b""
+    for counter in range((length + 63) // 64):
+        out += struct.pack("<16I", *chacha20_block(key, counter, [NONCE_DATA, entry, 0]))
+    return out[:length]
+
+
+def derive(salt, pin):
+    """Returns (vault key words, check words) for a PIN string."""
+    s = salt
+    for digit in pin:
+        s = chacha20_block(s, 0, [NONCE_DIGIT, int(digit), 0])[:8]
+    block = chacha20_block(s, 0, [NONCE_KEY, 0, 0])
+    return block[:8], block[8:12]
+
+
+def macro_entries(text, macro):
+    """Returns [(key, value)] from a #define MACRO(_) list, or None if it isn't defined."""
+    match = re.search(MACRO_RE.format(macro), text)
+    if not match:
+        return None
+    entries = []
+    for key, literal in ENTRY_RE.findall(match.group(1)):
+        value = ast.literal_eval(literal)
+        if any(not 32 <= ord(c) < 127 for c in value):
+            raise ValueError("{} entry {} may only hold printable ASCII".format(macro, key))
+        entries.append((key, value))
+    return entries
+
+
+def load_secrets(path=SECRETS_H):
+    """Returns ([(label, value)] in vault order, number of tagged entries, PIN)."""
+    text = Path(path).read_text()
+    entries = macro_entries(text, "SECRETS_LIST")
+    if not entries:
+        raise ValueError("{} has no SECRETS_LIST(_) entries".format(path))
+    pins = [value for name, value in entries if name == PIN_NAME]
+    if len(pins) != 1:
+        raise ValueError("SECRETS_LIST needs exactly one {}".format(PIN_NAME))
+    if not pins[0].isdigit() or len(pins[0]) > MAX_PIN_LENGTH:
+        raise ValueError("{} must be 1-{} digits".format(PIN_NAME, MAX_PIN_LENGTH))
+
+    tagged = {}
+    for key, value in macro_entries(text, "SECRETS_TAGGED") or []:
+        if not key.isdigit() or int(key) > MAX_TAG:
+            raise ValueError("SECRETS_TAGGED tag '{}' must be a number 0-{}".format(key, MAX_TAG))
+        if int(key) in tagged:
+            raise ValueError("SECRETS_TAGGED tag {} listed twice".format(int(key)))
+        tagged[int(key)] = value
+    entries += [("tag {}".format(tag), tagged[tag]) for tag in sorted(tagged)]
+    return entries, sorted(tagged), pins[0]
+
+
+def load_hid_key(path=SECRETS_H):
+    """Returns SECRETS_HID_KEY from secrets.h as 8 words, or None if it isn't defined."""
+    match = HID_KEY_RE.search(Path(path).read_text())
+    if not match:
+        return None
+    if not re.fullmatch(r"[0-9a-fA-F]{64}", match.group(1)):
+        raise ValueError("SECRETS_HID_KEY must be 64 hex digits")
+    return list(struct.unpack("<8I", bytes.fromhex(match.group(1))))
+
+
+def wrap_hid_key(key, hid_key):
+    """XORs the channel key with its keystream; the same call unwraps it."""
+    return [a ^ b for a, b in zip(hid_key, chacha20_block(key, 0, [NONCE_HID, 0, 0]))]
+
+
+def encrypt(entries, pin, salt):
+    key, check = derive(salt, pin)
+    offsets, data = [0], b""
+    for entry, (_, value) in enumerate(entries):
+        plain = value.encode()
+        data += bytes(p ^ k for p, k in zip(plain, keystream(key, entry, len(plain))))
+        offsets.append(len(data))
+    if len(data) > MAX_DATA:
+        raise ValueError("{} bytes of secrets, the vault holds at most {}".format(len(data), MAX_DATA))
+    return check, offsets, data
+
+
+def render(entries, tags, pin, salt, hid_key=None):
+    check, offsets, data = encrypt(entries, pin, salt)
+
+    def rows(values, fmt, per_row):
+        return ["    " + ", ".join(fmt.format(v) for v in values[i:i + per_row]) + "," for i in range(0, len(values), per_row)]
+
+    lines = [
+        "// Generated by tools/secrets_vault.py from secrets.h - do not edit, do not commit.",
+        "// Key derivation and layout are described in tools/secrets_vault.py.",
+        "",
+        "#pragma once",
+        "",
+        "#define VAULT_ENTRIES {}".format(len(entries)),
+        "#define VAULT_KEYCODE_ENTRIES {}".format(len(entries) - len(tags)),
+        "#define VAULT_TAGS {}".format(len(tags)),
+        "#define VAULT_DATA_SIZE {}".format(len(data)),
+        "#define VAULT_HID_KEY {}".format(int(hid_key is not None)),
+        "",
+        "static const uint32_t vault_salt[8] PROGMEM = {",
+    ]
+    lines += rows(salt, "0x{:08X}", 4)
+    lines += ["};", "", "static const uint32_t vault_check[4] PROGMEM = {"]
+    lines += rows(check, "0x{:08X}", 4)
+    if hid_key is not None:
+        lines += ["};", "", "// SECRETS_HID_KEY, wrapped with the vault key",
+                  "static const uint32_t vault_hid_key[8] PROGMEM = {"]
+        lines += rows(wrap_hid_key(derive(salt, pin)[0], hid_key), "0x{:08X}", 4)
+    lines += ["};", "", "// Sorted; tag i is entry VAULT_KEYCODE_ENTRIES + i. the trailing 65535 only keeps the array non-empty",
+              "static const uint16_t vault_tags[VAULT_TAGS + 1] PROGMEM = {"]
+    lines += rows(tags + [0xFFFF], "{}", 16)
+    lines += ["};", "", "// Secret i is vault_data[vault_offsets[i]] up to vault_offsets[i + 1]",
+              "static const uint16_t vault_offsets[VAULT_ENTRIES + 1] PROGMEM = {"]
+    for (name, _), offset in zip(entries + [("end", None)], offsets):
+        lines.append("    {}, // {}".format(offset, name))
+    lines += ["};", "", "static const uint8_t vault_data[VAULT_DATA_SIZE + 1] PROGMEM = {"]
+    lines += rows(list(data) + [0], "0x{:02X}", 16)
+    lines.append("};")
+    return "\n".join(lines) + "\n"
+
+
+def parse_vault(text):
+    """Reads (salt, check, offsets, data) back out of a generated header."""
+    def array(name):
+        body = re.search(r"\b{}\[[^]]*\] PROGMEM = \{{(.*?)\}};".format(name), text, re.S).group(1)
+        body = re.sub(r"//[^\n]*", "", body)
+        return [int(v, 0) for v in re.findall(r"0x[0-9A-F]+|\d+", body)]
+    hid_key = array("vault_hid_key") if "vault_hid_key[" in text else None
+    return (array("vault_salt"), array("vault_check"), array("vault_tags")[:-1], array("vault_offsets"),
+            bytes(array("vault_data")[:-1]), hid_key)
+
+
+def check_vault(entries, tags, pin, hid_key, text):
+    salt, check, vault_tags, offsets, data, wrapped = parse_vault(text)
+    key, expected = derive(salt, pin)
+    if check != expected or vault_tags != tags or len(offsets) != len(entries) + 1:
+        return False
+    if (wrapped and wrap_hid_key(key, wrapped)) != hid_key:
+        return False
+    for entry, (_, value) in enumerate(entries):
+        cipher = data[offsets[entry]:offsets[entry + 1]]
+        plain = bytes(c ^ k for c, k in zip(cipher, keystream(key, entry, len(cipher))))
+        if plain != value.encode():
+            return False
+    return True
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("--check", action="store_true", help="fail if the vault doesn't decrypt to secrets.h")
+    parser.add_argument("--secrets", type=Path, default=SECRETS_H)
+    parser.add_argument("--output", type=Path, default=VAULT_H)
+    args = parser.parse_args()
+
+    try:
+        entries, tags, pin = load_secrets(args.secrets)
+        hid_key = load_hid_key(args.secrets)
+        if not args.check:
+            text = render(entries, tags, pin, list(struct.unpack("<8I", os.urandom(32))), hid_key)
+    except (OSError, ValueError, SyntaxError) as e:
+        print("error: {}".format(e), file=sys.stderr)
+        return 1
+
+    if args.check:
+        if not args.output.exists() or not check_vault(entries, tags, pin, hid_key, args.output.read_text()):
+            print("{} is stale, run tools/secrets_vault.py".format(args.output), file=sys.stderr)
+            return 1
+        return 0
+
+    args.output.write_text(text)
+    print("wrote {}".format(args.output))
+    print("{} secrets ({} tagged), {} bytes of ciphertext".format(len(entries), len(tags), sum(len(v) for _, v in entries)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,214 @@
+#!/usr/bin/env python3
+"""
+Compile snippet_expansions.h into the PROGMEM automaton used by features/snippets.c.
+
+Triggers are matched with an Aho-Corasick automaton over key history
+classes (features/key_history.h), resolved into a full transition table
+so the firmware takes exactly one step per key press, whatever the number
+of snippets:
+
+    snippets_symbol   64 bytes mapping a history class to a column; classes
+                      no trigger uses share column 0
+    snippets_next     one row per state, one next state per column. State 0
+                      is the root, and each state stands for the longest
+                      typed suffix that is also the start of some trigger
+    snippets_match    per state, the snippet whose trigger ends there plus
+                      one, or 0
+
+No trigger may contain another, so a state completes at most one trigger
+and a trigger is never hidden behind a shorter one. The expansion texts
+themselves stay in snippet_expansions.h; only triggers end up here.
+
+Besides the header, this prints the flash the tables cost.
+
+Usage:
+    tools/snippet_automaton.py            # regenerate features/snippets_data.h
+    tools/snippet_automaton.py --check    # exit 1 if the committed header is stale
+"""
+
+import argparse
+import re
+import sys
+from pathlib import Path
+
+KEYMAP_DIR = Path(__file__).resolve().parent.parent
+EXPANSIONS_H = KEYMAP_DIR / "snippet_expansions.h"
+DATA_H = KEYMAP_DIR / "features" / "snippets_data.h"
+
+STRING = r'"((?:[^"\\\n]|\\.)*)"'
+ENTRY_RE = re.compile(r"_\(\s*" + STRING + r"\s*,\s*" + STRING + r"\s*\)")
+ESCAPES = {"n": "\n", "t": "\t", "\\": "\\", '"': '"', "'": "'"}
+
+# Unshifted character -> HID keycode, for the keys KEY_HISTORY_CLASS() covers
+KEYCODES = {c: 0x04 + i for i, c in enumerate("abcdefghijklmnopqrstuvwxyz")}
+KEYCODES.update({c: 0x1E + i for i, c in enumerate("1234567890")})
+KEYCODES.update(zip(" -=[]\\", range(0x2C, 0x32)))
+KEYCODES.update(zip(";'`,./", range(0x33, 0x39)))
+# KEY_HISTORY_CLASS(): KC_A is 1
+CLASSES = {c: kc - 0x04 + 1 for c, kc in KEYCODES.items()}
+CLASS_COUNT = 64
+TEXT_CHARS = set(chr(c) for c in range(0x20, 0x7F)) | {"\n", "\t"}
+MAX_SNIPPETS = 254
+
+
+def unescape(text, number):
+    out, i = [], 0
+    while i < len(text):
+        if text[i] == "\\":
+            if text[i + 1] not in ESCAPES:
+                raise ValueError("snippet {}: unsupported escape '\\{}'".format(number, text[i + 1]))
+            out.append(ESCAPES[text[i + 1]])
+            i += 2
+        else:
+            out.append(text[i])
+            i += 1
+    return "".join(out)
+
+
+def load_snippets(path=EXPANSIONS_H):
+    """Returns [(trigger, text)] in snippet_expansions.h order."""
+    source = Path(path).read_text()
+    table = source[source.index("#define SNIPPET_EXPANSIONS"):]
+    snippets = []
+    for number, (trigger, text) in enumerate(ENTRY_RE.findall(table), 1):
+        trigger, text = unescape(trigger, number), unescape(text, number)
+        if len(trigger) < 2 or any(c not in CLASSES for c in trigger):
+            raise ValueError("trigger '{}' needs two or more of a-z 0-9 space and -=[]\\;'`,./".format(trigger))
+        if not text or any(c not in TEXT_CHARS for c in text):
+            raise ValueError("text for '{}' must be non-empty printable ASCII, \\n or \\t".format(trigger))
+        snippets.append((trigger, text))
+    if not snippets:
+        raise ValueError("no snippets in {}".format(path))
+    if len(snippets) > MAX_SNIPPETS:
+        raise ValueError("more than {} snippets".format(MAX_SNIPPETS))
+    return snippets
+
+
+def check_conflicts(snippets):
+    triggers = sorted((trigger for trigger, _ in snippets), key=len)
+    for i, short in enumerate(triggers):
+        if short in triggers[:i]:
+            raise ValueError("trigger '{}' listed twice".format(short))
+        for long in triggers[i + 1:]:
+            if short in long:
+                raise ValueError("'{}' contains '{}', which would always fire first".format(long, short))
+
+
+def build(snippets):
+    """Returns (symbols, next rows, matches, prefixes) of the resolved automaton."""
+    used = sorted({CLASSES[c] for trigger, _ in snippets for c in trigger})
+    symbol = {cls: i + 1 for i, cls in enumerate(used)}
+    width = len(used) + 1
+
+    # Goto trie, states numbered breadth first
+    goto, match, prefixes = [{}], [0], [""]
+    for index, (trigger, _) in enumerate(snippets):
+        state = 0
+        for c in trigger:
+            if c not in goto[state]:
+                goto.append({})
+                match.append(0)
+                prefixes.append(prefixes[state] + c)
+                goto[state][c] = len(goto) - 1
+            state = goto[state][c]
+        match[state] = index + 1
+    order = sorted(range(len(goto)), key=lambda s: (len(prefixes[s]), prefixes[s]))
+    renumber = {old: new for new, old in enumerate(order)}
+    goto = [{c: renumber[t] for c, t in goto[old].items()} for old in order]
+    match = [match[old] for old in order]
+    prefixes = [prefixes[old] for old in order]
+
+    # Failure links resolved into full rows, parents before children
+    rows = [[0] * width for _ in goto]
+    fail = [0] * len(goto)
+    for state in range(len(goto)):
+        for c, target in goto[state].items():
+            if state:
+                fail[target] = rows[fail[state]][symbol[CLASSES[c]]]
+        for col in range(1, width):
+            rows[state][col] = rows[fail[state]][col] if state else 0
+        for c, target in goto[state].items():
+            rows[state][symbol[CLASSES[c]]] = target
+
+    symbols = [0] * CLASS_COUNT
+    for cls, col in symbol.items():
+        symbols[cls] = col
+    return symbols, rows, match, prefixes
+
+
+def render(snippets):
+    check_conflicts(snippets)
+    symbols, rows, match, prefixes = build(snippets)
+    state_bytes = 1 if len(rows) <= 0x100 else 2
+    state_type = "uint8_t" if state_bytes == 1 else "uint16_t"
+    depth = max(len(trigger) for trigger, _ in snippets)
+    stats = {
+        "snippets": len(snippets),
+        "states": len(rows),
+        "symbols": len(rows[0]),
+        "bytes": CLASS_COUNT + len(rows) * len(rows[0]) * state_bytes + len(rows),
+    }
+    lines = [
+        "// Generated by tools/snippet_automaton.py from snippet_expansions.h - do not edit.",
+        "// Layout is described in tools/snippet_automaton.py.",
+        "",
+        "#pragma once",
+        "",
+        "#define SNIPPETS_COUNT {}".format(len(snippets)),
+        "#define SNIPPETS_TRIGGER_CHARS {}".format(sum(len(trigger) for trigger, _ in snippets)),
+        "#define SNIPPETS_MAX_TRIGGER_LEN {}".format(depth),
+        "#define SNIPPETS_STATES {}".format(stats["states"]),
+        "#define SNIPPETS_SYMBOLS {}".format(stats["symbols"]),
+        "",
+        "typedef {} snippets_state_t;".format(state_type),
+        "",
+        "static const uint8_t snippets_symbol[{}] PROGMEM = {{".format(CLASS_COUNT),
+    ]
+    for start in range(0, CLASS_COUNT, 16):
+        lines.append("    " + ", ".join(str(s) for s in symbols[start:start + 16]) + ",")
+    lines += [
+        "};",
+        "",
+        "static const snippets_state_t snippets_next[SNIPPETS_STATES][SNIPPETS_SYMBOLS] PROGMEM = {",
+    ]
+    for prefix, row in zip(prefixes, rows):
+        label = "'{}'".format(prefix.replace("\\", "\\\\")) if prefix else "root"
+        lines.append("    /* {:<{}} */ {{{}}},".format(label, depth + 4, ", ".join(str(t) for t in row)))
+    lines += [
+        "};",
+        "",
+        "static const uint8_t snippets_match[SNIPPETS_STATES] PROGMEM = {",
+    ]
+    for start in range(0, len(match), 16):
+        lines.append("    " + ", ".join(str(m) for m in match[start:start + 16]) + ",")
+    lines.append("};")
+    return "\n".join(lines) + "\n", stats
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("--check", action="store_true", help="fail if the header is out of date")
+    parser.add_argument("--snippets", type=Path, default=EXPANSIONS_H)
+    parser.add_argument("--output", type=Path, default=DATA_H)
+    args = parser.parse_args()
+
+    try:
+        text, stats = render(load_snippets(args.snippets))
+    except ValueError as e:
+        print("error: {}".format(e), file=sys.stderr)
+        return 1
+
+    if args.check:
+        if not args.output.exists() or args.output.read_text() != text:
+            print("{} is stale, run tools/snippet_automaton.py".format(args.output), file=sys.stderr)
+            return 1
+        return 0
+
+    args.output.write_text(text)
+    print("wrote {}".format(args.output))
+    print("{snippets} snippets, {states} states x {symbols} columns, {bytes} bytes of flash".format(**stats))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
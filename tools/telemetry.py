@@ -0,0 +1,124 @@
+#!/usr/bin/env python3
+"""
+Read the keyboard's telemetry counters over raw HID.
+
+Prints the counters block from features/telemetry.h: matrix scan rate, key
+events per second, per-handler cycle timings, output queue depth, secrets
+lock/unlock counts and sentence case capitalisations. The handler timings
+are only measured in builds with CYCLE_PROFILE_ENABLE = yes; without it the
+keyboard reports no probes and the timings are left out. With --events it also
+drains the binary event log and decodes it with tools/event_log_decode.py.
+
+Needs TELEMETRY_ENABLE = yes in rules.mk (EVENT_LOG_ENABLE too for --events)
+and the `hid` package (pip install hidapi). --loopback talks to an in-process
+stand-in instead of a keyboard.
+
+Usage:
+    tools/telemetry.py                 # one snapshot
+    tools/telemetry.py --watch 1       # refresh every second
+    tools/telemetry.py --events        # snapshot plus new event log records
+    tools/telemetry.py --loopback      # no keyboard needed
+"""
+
+import argparse
+import sys
+import time
+
+import event_log_decode
+import qmkhid
+
+FIELDS = ["version", "probe_count", "uptime_ms", "scan_rate", "event_rate",
+          "scans", "events", "queue_depth", "queue_peak", "secrets_unlocks",
+          "secrets_failures", "secrets_locks", "secrets_auto_locks", "sentence_caps"]
+
+
+def read_telemetry(device):
+    """Reads every page of the block and returns it as a dict."""
+    data = b""
+    page, pages = 0, 1
+    while page < pages:
+        payload = device.request(qmkhid.HID_CMD_TELEMETRY, [page])
+        pages = payload[1]
+        data += payload[2:]
+        page += 1
+
+    header = qmkhid.TELEMETRY_HEADER
+    block = dict(zip(FIELDS, header.unpack_from(data)))
+    count = block["probe_count"]
+    values = qmkhid.telemetry_struct(count).unpack_from(data)[len(FIELDS):]
+    block["handler_avg"] = values[:count]
+    block["handler_max"] = values[count:]
+    return block
+
+
+def read_events(device):
+    """Drains the records written since the last read, as raw bytes."""
+    data = b""
+    while True:
+        payload = device.request(qmkhid.HID_CMD_EVENT_LOG)
+        count = payload[0]
+        data += payload[1:1 + 8 * count]
+        if count == 0:
+            return data
+
+
+def format_block(block):
+    lines = [
+        "uptime          {:>10.1f} s".format(block["uptime_ms"] / 1000),
+        "scan rate       {:>10} scans/s   ({} total)".format(block["scan_rate"], block["scans"]),
+        "key events      {:>10} events/s  ({} total)".format(block["event_rate"], block["events"]),
+        "output queue    {:>10} pending   (peak {})".format(block["queue_depth"], block["queue_peak"]),
+        "secrets         {:>10} unlocks   ({} failed, {} locks, {} by timeout)".format(
+            block["secrets_unlocks"], block["secrets_failures"],
+            block["secrets_locks"], block["secrets_auto_locks"]),
+        "sentence case   {:>10} capitalisations".format(block["sentence_caps"]),
+        "",
+    ]
+    if block["probe_count"] == 0:
+        # The keyboard sends the timing fields all zero, not measured
+        lines.append("handler and RGB timings not measured: build with CYCLE_PROFILE_ENABLE = yes")
+        return "\n".join(lines)
+    lines.append("{:<18} {:>10} {:>10}".format("handler", "avg cyc", "max cyc"))
+    for i, (avg, worst) in enumerate(zip(block["handler_avg"], block["handler_max"])):
+        name = qmkhid.PROBE_NAMES[i] if i < len(qmkhid.PROBE_NAMES) else "probe {}".format(i)
+        lines.append("{:<18} {:>10} {:>10}".format(name, avg, worst))
+    return "\n".join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("--watch", type=float, metavar="SECONDS", help="poll repeatedly")
+    parser.add_argument("--events", action="store_true", help="also drain the event log")
+    parser.add_argument("--loopback", action="store_true", help="use the in-process stand-in")
+    parser.add_argument("--vid", type=lambda v: int(v, 16), help="USB vendor id (hex)")
+    parser.add_argument("--pid", type=lambda v: int(v, 16), help="USB product id (hex)")
+    args = parser.parse_args()
+
+    try:
+        device = qmkhid.open_device(args.vid, args.pid, loopback=args.loopback)
+    except (qmkhid.HidError, ImportError) as e:
+        print("error: {}".format(e), file=sys.stderr)
+        return 1
+
+    events = event_log_decode.load_events() if args.events else None
+    try:
+        while True:
+            print(format_block(read_telemetry(device)))
+            if events is not None:
+                for line in event_log_decode.decode_records(read_events(device), events):
+                    print(line)
+            if not args.watch:
+                return 0
+            time.sleep(args.watch)
+            print()
+    except qmkhid.HidError as e:
+        print("error: {}".format(e), file=sys.stderr)
+        return 1
+    except KeyboardInterrupt:
+        return 0
+    finally:
+        device.close()
+
+
+if __name__ == "__main__":
+    sys.exit(main())